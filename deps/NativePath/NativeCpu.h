@@ -0,0 +1,239 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+//
+//  NativeCpu.h
+//  NativePath
+//
+//  Runtime CPU feature detection, and selection of kernel variants compiled for several instruction sets.
+//
+//  The native libraries are compiled for the baseline of each target (SSE2 on x64), so wider instruction sets are only used by
+//  functions marked with one of the NP_TARGET_* attributes. A kernel ships a baseline variant and one or more of those, listed
+//  best first in an npCpuVariant table; npCpuDispatch binds the first variant the CPU supports on first call and caches it
+//  until npCpuDisableFeatures changes the features:
+//
+//    NP_CPU_INLINE void Cull(...) { ... }
+//    static void CullDefault(...) { Cull(...); }
+//    NP_TARGET_AVX2 static void CullAvx2(...) { Cull(...); }
+//
+//    static const npCpuVariant CullVariants[] = { { NP_CPU_TARGET_AVX2, (void*)CullAvx2 }, { 0, (void*)CullDefault } };
+//    static npCpuSlot CullSlot;
+//    ((CullDelegate)npCpuDispatch(&CullSlot, CullVariants, 2))(...);
+//
+//  Variants usually share a body marked NP_CPU_INLINE: inlined into a NP_TARGET_* function, the generic vector code of that
+//  body is compiled for the wider instruction set. NP_TARGET_* and NP_CPU_TARGET_* are only defined when NP_CPU_X86 is.
+//  Note that FMA being enabled by NP_TARGET_AVX2, a * b + c expressions can be contracted, so float results may differ in the
+//  last bit between variants.
+//
+//  This header declares the API; exactly one source file of each native library defines NATIVEPATH_CPU_IMPLEMENTATION before
+//  including it to compile the implementation.
+//
+
+#ifndef NativeCpu_h
+#define NativeCpu_h
+
+#include "NativePath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define NP_CPU_X86 1
+#endif
+
+// x86
+#define NP_CPU_SSE2    0x0001
+#define NP_CPU_SSE3    0x0002
+#define NP_CPU_SSSE3   0x0004
+#define NP_CPU_SSE41   0x0008
+#define NP_CPU_SSE42   0x0010
+#define NP_CPU_POPCNT  0x0020
+#define NP_CPU_AVX     0x0040
+#define NP_CPU_F16C    0x0080
+#define NP_CPU_FMA     0x0100
+#define NP_CPU_AVX2    0x0200
+#define NP_CPU_BMI1    0x0400
+#define NP_CPU_BMI2    0x0800
+#define NP_CPU_AVX512  0x1000 // F, CD, BW, DQ and VL (Skylake-X and later)
+// ARM
+#define NP_CPU_NEON    0x10000
+
+#ifdef NP_CPU_X86
+// Features of the targets below, including everything the CPUs supporting them have in common
+#define NP_TARGET_SSE41 __attribute__((target("sse4.1,ssse3,sse3")))
+#define NP_TARGET_AVX2 __attribute__((target("avx2,avx,fma,f16c,bmi,bmi2,popcnt,sse4.2,sse4.1,ssse3,sse3")))
+#define NP_TARGET_AVX512 __attribute__((target("avx512f,avx512cd,avx512bw,avx512dq,avx512vl,avx2,avx,fma,f16c,bmi,bmi2,popcnt,sse4.2,sse4.1,ssse3,sse3")))
+
+// Feature sets matching the NP_TARGET_* attributes, to use in npCpuVariant
+#define NP_CPU_TARGET_SSE41 (NP_CPU_SSE41 | NP_CPU_SSSE3 | NP_CPU_SSE3)
+#define NP_CPU_TARGET_AVX2 (NP_CPU_AVX2 | NP_CPU_AVX | NP_CPU_FMA | NP_CPU_F16C | NP_CPU_BMI1 | NP_CPU_BMI2 | NP_CPU_POPCNT | NP_CPU_SSE42 | NP_CPU_TARGET_SSE41)
+#define NP_CPU_TARGET_AVX512 (NP_CPU_AVX512 | NP_CPU_TARGET_AVX2)
+#endif
+
+// Body shared by several variants, always inlined so that it's compiled for the instruction set of each of them
+#define NP_CPU_INLINE static inline __attribute__((always_inline))
+
+typedef struct npCpuVariant
+{
+	uint32_t Features; // NP_CPU_* flags the variant needs, 0 for the baseline
+	void* Function;
+} npCpuVariant;
+
+// Variant of a kernel bound by npCpuDispatch, zero initialized
+typedef struct npCpuSlot
+{
+	void* Function;
+	uint32_t Generation; // npCpuGeneration() when Function was selected
+} npCpuSlot;
+
+// NP_CPU_* flags supported by the CPU and the OS, minus the ones disabled by npCpuDisableFeatures
+extern uint32_t npCpuFeatures();
+
+// Makes the CPU look like it doesn't support features (replacing the previously disabled ones, 0 enables everything again),
+// so that tests can run the baseline variants next to the ones picked for this CPU. Kernels select their variant again on their next call.
+extern void npCpuDisableFeatures(uint32_t features);
+
+// Incremented by every npCpuDisableFeatures call
+extern uint32_t npCpuGeneration();
+
+// Returns the function of the first variant whose features are all supported, the last variant being the fallback
+extern void* npCpuSelect(const npCpuVariant* variants, int count);
+
+// Returns the function cached in slot, selecting it from variants on first call and after the features changed
+// (concurrent calls select the same one)
+static inline void* npCpuDispatch(npCpuSlot* slot, const npCpuVariant* variants, int count)
+{
+	uint32_t generation = npCpuGeneration();
+	void* function = __atomic_load_n(&slot->Function, __ATOMIC_ACQUIRE);
+	if (!function || __atomic_load_n(&slot->Generation, __ATOMIC_RELAXED) != generation)
+	{
+		// A concurrent npCpuDisableFeatures at worst leaves an older generation, which selects again on next call
+		function = npCpuSelect(variants, count);
+		__atomic_store_n(&slot->Generation, generation, __ATOMIC_RELAXED);
+		__atomic_store_n(&slot->Function, function, __ATOMIC_RELEASE);
+	}
+	return function;
+}
+
+#ifdef NATIVEPATH_CPU_IMPLEMENTATION
+
+static volatile uint32_t npCpuDetectedFeatures;
+static volatile uint32_t npCpuDisabledFeatures;
+static volatile uint32_t npCpuFeaturesGeneration;
+
+#ifdef NP_CPU_X86
+
+// Inline assembly rather than __cpuid/_xgetbv, whose headers are not available on all platforms
+static inline void npCpuId(uint32_t leaf, uint32_t subleaf, uint32_t registers[4])
+{
+	__asm__ __volatile__("cpuid" : "=a"(registers[0]), "=b"(registers[1]), "=c"(registers[2]), "=d"(registers[3]) : "a"(leaf), "c"(subleaf));
+}
+
+static inline uint64_t npCpuXgetbv(uint32_t index)
+{
+	uint32_t low, high;
+	__asm__ __volatile__("xgetbv" : "=a"(low), "=d"(high) : "c"(index));
+	return ((uint64_t)high << 32) | low;
+}
+
+static uint32_t npCpuDetect()
+{
+	uint32_t registers[4];
+	npCpuId(0, 0, registers);
+	uint32_t maxLeaf = registers[0];
+
+	npCpuId(1, 0, registers);
+	uint32_t ecx1 = registers[2], edx1 = registers[3];
+
+	uint32_t features = 0;
+	if (edx1 & (1u << 26)) features |= NP_CPU_SSE2;
+	if (ecx1 & (1u << 0)) features |= NP_CPU_SSE3;
+	if (ecx1 & (1u << 9)) features |= NP_CPU_SSSE3;
+	if (ecx1 & (1u << 19)) features |= NP_CPU_SSE41;
+	if (ecx1 & (1u << 20)) features |= NP_CPU_SSE42;
+	if (ecx1 & (1u << 23)) features |= NP_CPU_POPCNT;
+
+	// AVX registers must also be saved by the OS on context switches (XCR0 bits 1 and 2, plus 5 to 7 for AVX-512)
+	uint64_t xcr0 = (ecx1 & (1u << 27)) ? npCpuXgetbv(0) : 0;
+	int avxState = (xcr0 & 0x06) == 0x06;
+	int avx512State = (xcr0 & 0xe6) == 0xe6;
+
+	if (avxState && (ecx1 & (1u << 28)))
+	{
+		features |= NP_CPU_AVX;
+		if (ecx1 & (1u << 29)) features |= NP_CPU_F16C;
+		if (ecx1 & (1u << 12)) features |= NP_CPU_FMA;
+	}
+
+	if (maxLeaf >= 7)
+	{
+		npCpuId(7, 0, registers);
+		uint32_t ebx7 = registers[1];
+		if (ebx7 & (1u << 3)) features |= NP_CPU_BMI1;
+		if (ebx7 & (1u << 8)) features |= NP_CPU_BMI2;
+		if ((features & NP_CPU_AVX) && (ebx7 & (1u << 5))) features |= NP_CPU_AVX2;
+
+		// F (16), DQ (17), CD (28), BW (30), VL (31)
+		const uint32_t avx512Bits = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+		if ((features & NP_CPU_AVX2) && avx512State && (ebx7 & avx512Bits) == avx512Bits) features |= NP_CPU_AVX512;
+	}
+
+	return features;
+}
+
+#else
+
+static uint32_t npCpuDetect()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__) || defined(_M_ARM64)
+	// Mandatory on ARM64, and a compile time choice on ARMv7
+	return NP_CPU_NEON;
+#else
+	return 0;
+#endif
+}
+
+#endif
+
+uint32_t npCpuFeatures()
+{
+	// Bit 31 marks the detection as done, detecting twice concurrently is harmless
+	uint32_t features = __atomic_load_n(&npCpuDetectedFeatures, __ATOMIC_RELAXED);
+	if (!features)
+	{
+		features = npCpuDetect() | 0x80000000u;
+		__atomic_store_n(&npCpuDetectedFeatures, features, __ATOMIC_RELAXED);
+	}
+	return features & ~__atomic_load_n(&npCpuDisabledFeatures, __ATOMIC_RELAXED) & 0x7fffffffu;
+}
+
+void npCpuDisableFeatures(uint32_t features)
+{
+	__atomic_store_n(&npCpuDisabledFeatures, features, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&npCpuFeaturesGeneration, 1, __ATOMIC_RELEASE);
+}
+
+uint32_t npCpuGeneration()
+{
+	return __atomic_load_n(&npCpuFeaturesGeneration, __ATOMIC_ACQUIRE);
+}
+
+void* npCpuSelect(const npCpuVariant* variants, int count)
+{
+	uint32_t features = npCpuFeatures();
+	for (int i = 0; i < count - 1; i++)
+	{
+		if ((variants[i].Features & features) == variants[i].Features)
+			return variants[i].Function;
+	}
+	return variants[count - 1].Function;
+}
+
+#endif /* NATIVEPATH_CPU_IMPLEMENTATION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NativeCpu_h */
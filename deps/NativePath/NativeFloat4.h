@@ -0,0 +1,348 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+//
+//  NativeFloat4.h
+//  NativePath
+//
+//  Portable operations on the float4/int4 vectors of NativePath.h.
+//
+//  Like NativePath.h, this header only compiles with clang: float4 and int4 are ext_vector_type vectors, and shuffles and
+//  conversions use __builtin_shufflevector and __builtin_convertvector. There is no GCC or MSVC backend.
+//
+//  Arithmetic, comparisons and bitwise operators already work on every target through clang vector extensions. This header
+//  covers what they can't express: min/max, rounding, approximate reciprocals, selects, dot products, horizontal reductions,
+//  masks, shuffles and gathers. Each operation has an SSE2, a NEON and a scalar implementation, picked at compile time:
+//
+//  NP_SIMD_SSE    x86 and x64, SSE2 being the baseline of both
+//  NP_SIMD_NEON   ARMv7 with NEON, ARM64
+//  NP_SIMD_SCALAR anything else, or when NP_SIMD_FORCE_SCALAR is defined
+//
+//  The NEON paths use the __builtin_elementwise_* builtins when the clang version has them, and the scalar code otherwise.
+//
+//  The native libraries are compiled for the baseline of each architecture, so on x86 only SSE2 is used here, including in
+//  functions compiled with NP_TARGET_AVX2 (target attributes don't change the preprocessor). Kernels that benefit from wider
+//  instruction sets get them through the runtime dispatch of NativeCpu.h, where clang vectorizes the shared code for the target.
+//
+//  x86 paths call the clang builtins behind the intrinsics headers directly, since the native libraries are compiled without
+//  the compiler include directory on some platforms. Results differ between backends in NaN lanes, in the precision of
+//  npRcpF4/npRsqrtF4 (approximations on SSE2), and in the rounding of npMulAddF4 (fused on NEON with FMA).
+//
+
+#ifndef NativeFloat4_h
+#define NativeFloat4_h
+
+#include "NativePath.h"
+
+#ifndef __clang__
+#error "NativeFloat4.h requires clang vector extensions"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// clang defines __SSE2__ on every x64 target, and __ARM_NEON on ARM64 and on ARMv7 with NEON
+#if defined(NP_SIMD_FORCE_SCALAR)
+#define NP_SIMD_SCALAR 1
+#elif defined(__SSE2__)
+#define NP_SIMD_SSE 1
+#elif defined(__ARM_NEON)
+#define NP_SIMD_NEON 1
+#else
+#define NP_SIMD_SCALAR 1
+#endif
+
+// Type of the x86 builtins, which don't take ext_vector_type arguments
+typedef float npSimdV4f __attribute__((__vector_size__(16)));
+
+// Lanes of v reordered, each index selecting a lane of v (0 to 3)
+#define npShuffleF4(v, x, y, z, w) __builtin_shufflevector((v), (v), x, y, z, w)
+#define npShuffleI4(v, x, y, z, w) __builtin_shufflevector((v), (v), x, y, z, w)
+
+// Lanes picked from a (indices 0 to 3) and b (indices 4 to 7)
+#define npShuffle2F4(a, b, x, y, z, w) __builtin_shufflevector((a), (b), x, y, z, w)
+#define npShuffle2I4(a, b, x, y, z, w) __builtin_shufflevector((a), (b), x, y, z, w)
+
+static inline float4 npLoadF4(const float* source)
+{
+	float4 result;
+	memcpy(&result, source, sizeof(float4));
+	return result;
+}
+
+// x, y and z from source, w set to 0
+static inline float4 npLoad3F4(const float* source)
+{
+	float4 result = { source[0], source[1], source[2], 0.0f };
+	return result;
+}
+
+static inline void npStoreF4(float* destination, float4 value)
+{
+	memcpy(destination, &value, sizeof(float4));
+}
+
+static inline int4 npLoadI4(const int32_t* source)
+{
+	int4 result;
+	memcpy(&result, source, sizeof(int4));
+	return result;
+}
+
+static inline void npStoreI4(int32_t* destination, int4 value)
+{
+	memcpy(destination, &value, sizeof(int4));
+}
+
+// mask lanes must be all ones (true) or all zeros (false), as returned by comparisons
+static inline float4 npSelectF4(int4 mask, float4 whenTrue, float4 whenFalse)
+{
+	return (float4)(((int4)whenTrue & mask) | ((int4)whenFalse & ~mask));
+}
+
+static inline int4 npSelectI4(int4 mask, int4 whenTrue, int4 whenFalse)
+{
+	return (whenTrue & mask) | (whenFalse & ~mask);
+}
+
+// Same as left < right ? left : right per lane
+static inline float4 npMinF4(float4 left, float4 right)
+{
+#if NP_SIMD_SSE
+	return (float4)__builtin_ia32_minps((npSimdV4f)left, (npSimdV4f)right);
+#elif NP_SIMD_NEON && __has_builtin(__builtin_elementwise_min)
+	return __builtin_elementwise_min(left, right);
+#else
+	return npSelectF4(left < right, left, right);
+#endif
+}
+
+// Same as left > right ? left : right per lane
+static inline float4 npMaxF4(float4 left, float4 right)
+{
+#if NP_SIMD_SSE
+	return (float4)__builtin_ia32_maxps((npSimdV4f)left, (npSimdV4f)right);
+#elif NP_SIMD_NEON && __has_builtin(__builtin_elementwise_max)
+	return __builtin_elementwise_max(left, right);
+#else
+	return npSelectF4(left > right, left, right);
+#endif
+}
+
+static inline float4 npClampF4(float4 value, float4 minimum, float4 maximum)
+{
+	return npMinF4(npMaxF4(value, minimum), maximum);
+}
+
+static inline int4 npMinI4(int4 left, int4 right)
+{
+	return npSelectI4(left < right, left, right);
+}
+
+static inline int4 npMaxI4(int4 left, int4 right)
+{
+	return npSelectI4(left > right, left, right);
+}
+
+static inline float4 npAbsF4(float4 value)
+{
+	return (float4)((int4)value & 0x7fffffff);
+}
+
+// a * b + c, fused when the target has FMA
+static inline float4 npMulAddF4(float4 a, float4 b, float4 c)
+{
+#if NP_SIMD_NEON && defined(__ARM_FEATURE_FMA) && __has_builtin(__builtin_elementwise_fma)
+	return __builtin_elementwise_fma(a, b, c);
+#else
+	return a * b + c;
+#endif
+}
+
+static inline float4 npSqrtF4(float4 value)
+{
+#if NP_SIMD_SSE
+	return (float4)__builtin_ia32_sqrtps((npSimdV4f)value);
+#else
+	float4 result = { __builtin_sqrtf(value.x), __builtin_sqrtf(value.y), __builtin_sqrtf(value.z), __builtin_sqrtf(value.w) };
+	return result;
+#endif
+}
+
+// Approximate 1 / value, relative error below 0.04% after one Newton-Raphson step
+static inline float4 npRcpF4(float4 value)
+{
+#if NP_SIMD_SSE
+	float4 estimate = (float4)__builtin_ia32_rcpps((npSimdV4f)value);
+	return estimate * (2.0f - value * estimate);
+#else
+	return 1.0f / value;
+#endif
+}
+
+// Approximate 1 / sqrt(value), relative error below 0.04% after one Newton-Raphson step
+static inline float4 npRsqrtF4(float4 value)
+{
+#if NP_SIMD_SSE
+	float4 estimate = (float4)__builtin_ia32_rsqrtps((npSimdV4f)value);
+	return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#else
+	return 1.0f / npSqrtF4(value);
+#endif
+}
+
+// Rounding to the integers below, above, nearest (ties to even) and toward zero
+#if NP_SIMD_NEON && __has_builtin(__builtin_elementwise_floor) && __has_builtin(__builtin_elementwise_roundeven)
+
+static inline float4 npFloorF4(float4 value)
+{
+	return __builtin_elementwise_floor(value);
+}
+
+static inline float4 npCeilF4(float4 value)
+{
+	return __builtin_elementwise_ceil(value);
+}
+
+static inline float4 npRoundF4(float4 value)
+{
+	return __builtin_elementwise_roundeven(value);
+}
+
+static inline float4 npTruncateF4(float4 value)
+{
+	return __builtin_elementwise_trunc(value);
+}
+
+#else
+
+// Through int conversion, values at or above 2^23 in magnitude being already integers
+static inline float4 npTruncateF4(float4 value)
+{
+	float4 truncated = __builtin_convertvector(__builtin_convertvector(value, int4), float4);
+	return npSelectF4(npAbsF4(value) < 8388608.0f, (float4)((int4)truncated | ((int4)value & (int)0x80000000)), value);
+}
+
+static inline float4 npFloorF4(float4 value)
+{
+	float4 truncated = npTruncateF4(value);
+	return truncated - (float4)((int4)(float4)1.0f & (truncated > value));
+}
+
+static inline float4 npCeilF4(float4 value)
+{
+	float4 truncated = npTruncateF4(value);
+	return truncated + (float4)((int4)(float4)1.0f & (truncated < value));
+}
+
+// Adding and subtracting 2^23 rounds to the nearest even integer in the default rounding mode
+static inline float4 npRoundF4(float4 value)
+{
+	float4 magic = (float4)((int4)(float4)8388608.0f | ((int4)value & (int)0x80000000));
+	float4 rounded = (value + magic) - magic;
+	return npSelectF4(npAbsF4(value) < 8388608.0f, rounded, value);
+}
+
+#endif
+
+// Conversions, float to int truncating toward zero
+static inline int4 npConvertF4ToI4(float4 value)
+{
+	return __builtin_convertvector(value, int4);
+}
+
+static inline float4 npConvertI4ToF4(int4 value)
+{
+	return __builtin_convertvector(value, float4);
+}
+
+// Sums of all lanes
+static inline float npHorizontalAddF4(float4 value)
+{
+	float4 pairs = value + npShuffleF4(value, 2, 3, 0, 1);
+	return pairs.x + pairs.y;
+}
+
+static inline float npHorizontalMinF4(float4 value)
+{
+	float4 pairs = npMinF4(value, npShuffleF4(value, 2, 3, 0, 1));
+	return npMinF4(pairs, npShuffleF4(pairs, 1, 0, 3, 2)).x;
+}
+
+static inline float npHorizontalMaxF4(float4 value)
+{
+	float4 pairs = npMaxF4(value, npShuffleF4(value, 2, 3, 0, 1));
+	return npMaxF4(pairs, npShuffleF4(pairs, 1, 0, 3, 2)).x;
+}
+
+static inline int32_t npHorizontalAddI4(int4 value)
+{
+	int4 pairs = value + npShuffleI4(value, 2, 3, 0, 1);
+	return pairs.x + pairs.y;
+}
+
+static inline float npDot4F4(float4 left, float4 right)
+{
+	return npHorizontalAddF4(left * right);
+}
+
+// Dot product of x, y and z, ignoring w
+static inline float npDot3F4(float4 left, float4 right)
+{
+	float4 product = left * right;
+	return product.x + product.y + product.z;
+}
+
+// Bit i set when lane i of mask is true (sign bit set)
+static inline int npMaskI4(int4 mask)
+{
+#if NP_SIMD_SSE
+	return __builtin_ia32_movmskps((npSimdV4f)mask);
+#else
+	uint4 bits = ((uint4)mask >> 31) << (uint4){ 0, 1, 2, 3 };
+	return (int)(bits.x | bits.y | bits.z | bits.w);
+#endif
+}
+
+static inline npBool npAnyI4(int4 mask)
+{
+	return npMaskI4(mask) != 0;
+}
+
+static inline npBool npAllI4(int4 mask)
+{
+	return npMaskI4(mask) == 0xf;
+}
+
+// base[indices[i]] in lane i
+static inline float4 npGatherF4(const float* base, int4 indices)
+{
+	float4 result = { base[indices.x], base[indices.y], base[indices.z], base[indices.w] };
+	return result;
+}
+
+static inline int4 npGatherI4(const int32_t* base, int4 indices)
+{
+	int4 result = { base[indices.x], base[indices.y], base[indices.z], base[indices.w] };
+	return result;
+}
+
+// Transposes the 4x4 matrix stored as 4 rows
+static inline void npTransposeF4(float4 rows[4])
+{
+	float4 t0 = npShuffle2F4(rows[0], rows[1], 0, 4, 1, 5);
+	float4 t1 = npShuffle2F4(rows[2], rows[3], 0, 4, 1, 5);
+	float4 t2 = npShuffle2F4(rows[0], rows[1], 2, 6, 3, 7);
+	float4 t3 = npShuffle2F4(rows[2], rows[3], 2, 6, 3, 7);
+	rows[0] = npShuffle2F4(t0, t1, 0, 1, 4, 5);
+	rows[1] = npShuffle2F4(t0, t1, 2, 3, 6, 7);
+	rows[2] = npShuffle2F4(t2, t3, 0, 1, 4, 5);
+	rows[3] = npShuffle2F4(t2, t3, 2, 3, 6, 7);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NativeFloat4_h */
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #define nativemath_h
 
 #include "NativePath.h"
+#include "NativeFloat4.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -148,7 +149,7 @@ static inline float4 npCrossProductF4(float4 left, float4 right)
 
 static inline float4 npTransformNormalF4(float4 normal, float4 matrix[4])
 {
-    return normal.xxxx * matrix[0].xyzw + normal.yyyy * matrix[1].xyzw + normal.zzzz * matrix[2].xyzw + normal.wwww * matrix[3].xyzw;
+    return npMulAddF4(normal.wwww, matrix[3], npMulAddF4(normal.zzzz, matrix[2], npMulAddF4(normal.yyyy, matrix[1], normal.xxxx * matrix[0])));
 }
 
 static void npMatrixIdentityF4(float4* outMatrix)
@@ -163,9 +164,40 @@ static void npMatrixIdentityF4(float4* outMatrix)
     outMatrix[3].w = 1.0f;
 }
 
-static float npLengthF4(float4 vec)
+static inline float npLengthF4(float4 vec)
 {
-    return sqrtf(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w);
+    return sqrtf(npDot4F4(vec, vec));
+}
+
+//
+// Cephes single precision sine and cosine, 4 lanes at once
+// Range reduction by pi/4 with extended precision constants
+// ~2 ulp for |x| < 8192
+//
+static inline void npSinCosF4(float4 x, float4* outSin, float4* outCos)
+{
+    int4 signSin = (int4)x & (int)0x80000000;
+    x = (float4)((int4)x & 0x7fffffff);
+
+    //scale by 4/pi and round to the even octant
+    int4 octant = __builtin_convertvector(x * 1.27323954473516f, int4);
+    octant = (octant + 1) & ~1;
+    float4 y = __builtin_convertvector(octant, float4);
+
+    signSin ^= (octant & 4) << 29;
+    int4 signCos = (~(octant - 2) & 4) << 29;
+    int4 sinPolyMask = (octant & 2) == 0;
+
+    x = ((x - y * 0.78515625f) - y * 2.4187564849853515625e-4f) - y * 3.77489497744594108e-8f;
+
+    float4 z = x * x;
+    float4 cosPoly = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+    float4 sinPoly = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * x + x;
+
+    int4 sinBits = ((int4)sinPoly & sinPolyMask) | ((int4)cosPoly & ~sinPolyMask);
+    int4 cosBits = ((int4)cosPoly & sinPolyMask) | ((int4)sinPoly & ~sinPolyMask);
+    *outSin = (float4)(sinBits ^ signSin);
+    *outCos = (float4)(cosBits ^ signCos);
 }
 
 #undef sqrtf
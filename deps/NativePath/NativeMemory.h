@@ -37,21 +37,508 @@ THE SOFTWARE.
 extern "C" {
 #endif
 
-extern void* npMalloc(size_t size);
-#define malloc npMalloc
+// The implementation below is compiled into each native library that defines NATIVEPATH_MEMORY_IMPLEMENTATION. Its symbols are
+// prefixed with NP_LIBRARY (the library name, set by Stride.Native.targets), so that libraries linked statically into the same
+// binary, as on iOS, each keep their own arenas and counters instead of defining the same symbols twice.
+#ifndef NP_LIBRARY_SYMBOL
+#ifdef NP_LIBRARY
+#define NP_LIBRARY_SYMBOL_JOIN(library, name) library##_##name
+#define NP_LIBRARY_SYMBOL_EXPAND(library, name) NP_LIBRARY_SYMBOL_JOIN(library, name)
+#define NP_LIBRARY_SYMBOL(name) NP_LIBRARY_SYMBOL_EXPAND(NP_LIBRARY, name)
+#else
+#define NP_LIBRARY_SYMBOL(name) name
+#endif
+#endif
 
-extern void npFree(void* block);
-#define free npFree
+#define npMemoryGetStats NP_LIBRARY_SYMBOL(npMemoryGetStats)
+#define npTrackedMalloc NP_LIBRARY_SYMBOL(npTrackedMalloc)
+#define npTrackedFree NP_LIBRARY_SYMBOL(npTrackedFree)
+#define npTrackedRealloc NP_LIBRARY_SYMBOL(npTrackedRealloc)
+#define npTrackedMallocSize NP_LIBRARY_SYMBOL(npTrackedMallocSize)
+#define npTrackedCalloc NP_LIBRARY_SYMBOL(npTrackedCalloc)
+#define npArenaCreate NP_LIBRARY_SYMBOL(npArenaCreate)
+#define npArenaDestroy NP_LIBRARY_SYMBOL(npArenaDestroy)
+#define npArenaAlloc NP_LIBRARY_SYMBOL(npArenaAlloc)
+#define npArenaReset NP_LIBRARY_SYMBOL(npArenaReset)
+#define npArenaGetMarker NP_LIBRARY_SYMBOL(npArenaGetMarker)
+#define npArenaRewind NP_LIBRARY_SYMBOL(npArenaRewind)
+#define npFrameArena NP_LIBRARY_SYMBOL(npFrameArena)
+#define npFrameArenaDestroy NP_LIBRARY_SYMBOL(npFrameArenaDestroy)
 
+extern void* npMalloc(size_t size);
+extern void npFree(void* block);
 extern void* npRealloc(void* ptr, size_t size);
-#define realloc npRealloc
-
 extern size_t npMallocSize(void* ptr);
-#define malloc_size npMallocSize
-
 extern void* npCalloc(size_t num, size_t size);
+
+//
+//  Allocation tracking: when NP_MEMORY_TRACKING is defined, malloc and co. are redirected to tracked versions that tag each
+//  allocation with the NP_MEMORY_SUBSYSTEM defined before including this header (NP_MEMORY_SUBSYSTEM_GENERAL by default).
+//  Every thread counts its allocations and frees in its own counters, which npMemoryGetStats sums up.
+//  All the sources of a library must be built with the same NP_MEMORY_TRACKING setting, since tracked blocks start with a header.
+//
+
+#define NP_MEMORY_SUBSYSTEM_GENERAL 0
+#define NP_MEMORY_SUBSYSTEM_ARENA 1
+#define NP_MEMORY_SUBSYSTEM_AUDIO 2
+#define NP_MEMORY_SUBSYSTEM_CODEC 3
+#define NP_MEMORY_SUBSYSTEM_GEOMETRY 4
+#define NP_MEMORY_SUBSYSTEM_COUNT 8
+
+// Size class c counts the allocations of [2^(c - 1), 2^c) bytes (class 0 for empty ones)
+#define NP_MEMORY_SIZE_CLASS_COUNT 32
+
+typedef struct npMemorySubsystemStats
+{
+	int64_t LiveBytes;
+	int64_t PeakBytes; // Highest LiveBytes reached, updated on every allocation
+	int64_t AllocationCount;
+	int64_t FreeCount;
+} npMemorySubsystemStats;
+
+typedef struct npMemoryStats
+{
+	int32_t Enabled; // 0 when the library was built without NP_MEMORY_TRACKING, and everything else is 0
+	int32_t Padding;
+	npMemorySubsystemStats Total;
+	npMemorySubsystemStats Subsystems[NP_MEMORY_SUBSYSTEM_COUNT];
+	int64_t SizeClassCounts[NP_MEMORY_SIZE_CLASS_COUNT];
+} npMemoryStats;
+
+extern void npMemoryGetStats(npMemoryStats* stats);
+
+#ifdef NP_MEMORY_TRACKING
+
+#ifndef NP_MEMORY_SUBSYSTEM
+#define NP_MEMORY_SUBSYSTEM NP_MEMORY_SUBSYSTEM_GENERAL
+#endif
+
+extern void* npTrackedMalloc(size_t size, int subsystem);
+extern void npTrackedFree(void* block);
+extern void* npTrackedRealloc(void* ptr, size_t size, int subsystem);
+extern size_t npTrackedMallocSize(void* ptr);
+extern void* npTrackedCalloc(size_t num, size_t size, int subsystem);
+
+static inline void* npTaggedMalloc(size_t size)
+{
+	return npTrackedMalloc(size, NP_MEMORY_SUBSYSTEM);
+}
+
+static inline void* npTaggedRealloc(void* ptr, size_t size)
+{
+	return npTrackedRealloc(ptr, size, NP_MEMORY_SUBSYSTEM);
+}
+
+static inline void* npTaggedCalloc(size_t num, size_t size)
+{
+	return npTrackedCalloc(num, size, NP_MEMORY_SUBSYSTEM);
+}
+
+#define malloc npTaggedMalloc
+#define free npTrackedFree
+#define realloc npTaggedRealloc
+#define malloc_size npTrackedMallocSize
+#define calloc npTaggedCalloc
+
+#else
+
+#define malloc npMalloc
+#define free npFree
+#define realloc npRealloc
+#define malloc_size npMallocSize
 #define calloc npCalloc
 
+#endif
+
+//
+//  Arenas: bump allocators over a list of blocks taken from npMalloc, for transient allocations that are all released at once.
+//  Reset and rewind keep the blocks, so an arena used every frame stops hitting the heap once it has grown to its peak size.
+//  An arena is not thread-safe, npFrameArena gives each thread its own one.
+//
+//  The functions are compiled by the source file of each native library that defines NATIVEPATH_MEMORY_IMPLEMENTATION
+//  before including this header.
+//
+
+#define NP_ARENA_ALIGNMENT 16
+#define NP_ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+typedef struct npArenaBlock
+{
+	struct npArenaBlock* Next;
+	size_t Size;
+	size_t Used;
+} npArenaBlock;
+
+typedef struct npArena
+{
+	npArenaBlock* First;
+	npArenaBlock* Current;
+	size_t BlockSize;
+} npArena;
+
+// Position in an arena, to release everything allocated after it
+typedef struct npArenaMarker
+{
+	npArenaBlock* Block;
+	size_t Used;
+} npArenaMarker;
+
+// blockSize is the minimum size of the blocks (0 for NP_ARENA_DEFAULT_BLOCK_SIZE), larger allocations get their own block
+extern npArena* npArenaCreate(size_t blockSize);
+extern void npArenaDestroy(npArena* arena);
+
+// Returns size bytes aligned on NP_ARENA_ALIGNMENT, or NULL when out of memory
+extern void* npArenaAlloc(npArena* arena, size_t size);
+
+// Releases every allocation, keeping the blocks
+extern void npArenaReset(npArena* arena);
+
+extern npArenaMarker npArenaGetMarker(npArena* arena);
+extern void npArenaRewind(npArena* arena, npArenaMarker marker);
+
+// Scratch arena of the calling thread, created on first use. Code that owns a frame loop resets it every frame, and
+// functions use it as a stack by rewinding to a marker on return. npFrameArenaDestroy frees it, before the thread exits.
+extern npArena* npFrameArena();
+extern void npFrameArenaDestroy();
+
+#ifdef NATIVEPATH_MEMORY_IMPLEMENTATION
+
+#ifdef __cplusplus
+#define NP_THREAD_LOCAL thread_local
+#else
+#define NP_THREAD_LOCAL _Thread_local
+#endif
+
+static NP_THREAD_LOCAL npArena* npFrameArenaInstance;
+
+#ifdef NP_MEMORY_TRACKING
+#define NP_ARENA_MALLOC(size) npTrackedMalloc(size, NP_MEMORY_SUBSYSTEM_ARENA)
+#define NP_ARENA_FREE(block) npTrackedFree(block)
+#else
+#define NP_ARENA_MALLOC(size) npMalloc(size)
+#define NP_ARENA_FREE(block) npFree(block)
+#endif
+
+static inline uint8_t* npArenaBlockData(npArenaBlock* block)
+{
+	return (uint8_t*)(block + 1);
+}
+
+// Aligned start of the next allocation in a block
+static inline size_t npArenaBlockOffset(npArenaBlock* block, size_t used)
+{
+	uintptr_t start = (uintptr_t)npArenaBlockData(block) + used;
+	return used + (((start + NP_ARENA_ALIGNMENT - 1) & ~(uintptr_t)(NP_ARENA_ALIGNMENT - 1)) - start);
+}
+
+static npArenaBlock* npArenaNewBlock(size_t size)
+{
+	npArenaBlock* block = (npArenaBlock*)NP_ARENA_MALLOC(sizeof(npArenaBlock) + size);
+	if (!block)
+		return NULL;
+	block->Next = NULL;
+	block->Size = size;
+	block->Used = 0;
+	return block;
+}
+
+npArena* npArenaCreate(size_t blockSize)
+{
+	npArena* arena = (npArena*)NP_ARENA_MALLOC(sizeof(npArena));
+	if (!arena)
+		return NULL;
+	arena->BlockSize = blockSize > 0 ? blockSize : NP_ARENA_DEFAULT_BLOCK_SIZE;
+	arena->First = npArenaNewBlock(arena->BlockSize);
+	arena->Current = arena->First;
+	if (!arena->First)
+	{
+		NP_ARENA_FREE(arena);
+		return NULL;
+	}
+	return arena;
+}
+
+void npArenaDestroy(npArena* arena)
+{
+	if (!arena)
+		return;
+	npArenaBlock* block = arena->First;
+	while (block)
+	{
+		npArenaBlock* next = block->Next;
+		NP_ARENA_FREE(block);
+		block = next;
+	}
+	NP_ARENA_FREE(arena);
+}
+
+void* npArenaAlloc(npArena* arena, size_t size)
+{
+	npArenaBlock* block = arena->Current;
+	size_t offset = npArenaBlockOffset(block, block->Used);
+	while (offset + size > block->Size)
+	{
+		// Move on to the next block kept by a reset, or insert a new one large enough
+		npArenaBlock* next = block->Next;
+		if (!next || size + NP_ARENA_ALIGNMENT > next->Size)
+		{
+			size_t blockSize = size + NP_ARENA_ALIGNMENT > arena->BlockSize ? size + NP_ARENA_ALIGNMENT : arena->BlockSize;
+			npArenaBlock* newBlock = npArenaNewBlock(blockSize);
+			if (!newBlock)
+				return NULL;
+			newBlock->Next = next;
+			block->Next = newBlock;
+			next = newBlock;
+		}
+
+		block = next;
+		block->Used = 0;
+		arena->Current = block;
+		offset = npArenaBlockOffset(block, 0);
+	}
+
+	block->Used = offset + size;
+	return npArenaBlockData(block) + offset;
+}
+
+void npArenaReset(npArena* arena)
+{
+	arena->Current = arena->First;
+	arena->First->Used = 0;
+}
+
+npArenaMarker npArenaGetMarker(npArena* arena)
+{
+	npArenaMarker marker;
+	marker.Block = arena->Current;
+	marker.Used = arena->Current->Used;
+	return marker;
+}
+
+void npArenaRewind(npArena* arena, npArenaMarker marker)
+{
+	arena->Current = marker.Block;
+	marker.Block->Used = marker.Used;
+}
+
+npArena* npFrameArena()
+{
+	if (!npFrameArenaInstance)
+		npFrameArenaInstance = npArenaCreate(0);
+	return npFrameArenaInstance;
+}
+
+void npFrameArenaDestroy()
+{
+	npArenaDestroy(npFrameArenaInstance);
+	npFrameArenaInstance = NULL;
+}
+
+#ifdef NP_MEMORY_TRACKING
+
+#define NP_MEMORY_HEADER_SIZE 16
+
+// Stored before each tracked block, keeps its 16 bytes alignment
+typedef struct npMemoryHeader
+{
+	uint64_t Size;
+	uint32_t Subsystem;
+	uint32_t Reserved;
+} npMemoryHeader;
+
+// Counters written by a single thread, read by npMemoryGetStats. Never freed, since threads can't be notified of their exit.
+typedef struct npMemoryThreadCounters
+{
+	struct npMemoryThreadCounters* Next;
+	int64_t AllocatedBytes[NP_MEMORY_SUBSYSTEM_COUNT];
+	int64_t FreedBytes[NP_MEMORY_SUBSYSTEM_COUNT];
+	int64_t AllocationCounts[NP_MEMORY_SUBSYSTEM_COUNT];
+	int64_t FreeCounts[NP_MEMORY_SUBSYSTEM_COUNT];
+	int64_t SizeClassCounts[NP_MEMORY_SIZE_CLASS_COUNT];
+} npMemoryThreadCounters;
+
+static npMemoryThreadCounters* volatile npMemoryCountersList;
+static NP_THREAD_LOCAL npMemoryThreadCounters* npMemoryThreadCountersInstance;
+// Live bytes per subsystem (and in total, last entry), shared by all threads so that the peak is updated on each allocation
+static int64_t npMemoryLiveBytes[NP_MEMORY_SUBSYSTEM_COUNT + 1];
+static int64_t npMemoryPeakBytes[NP_MEMORY_SUBSYSTEM_COUNT + 1];
+
+static npMemoryThreadCounters* npMemoryGetThreadCounters()
+{
+	npMemoryThreadCounters* counters = npMemoryThreadCountersInstance;
+	if (counters)
+		return counters;
+
+	counters = (npMemoryThreadCounters*)npCalloc(1, sizeof(npMemoryThreadCounters));
+	if (!counters)
+		return NULL;
+
+	npMemoryThreadCounters* head = __atomic_load_n(&npMemoryCountersList, __ATOMIC_RELAXED);
+	do
+	{
+		counters->Next = head;
+	} while (!__atomic_compare_exchange_n(&npMemoryCountersList, &head, counters, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	npMemoryThreadCountersInstance = counters;
+	return counters;
+}
+
+// Only the owner thread writes, so there's no need for atomic read-modify-write
+static inline void npMemoryAddCounter(int64_t* counter, int64_t value)
+{
+	__atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+static inline int npMemorySizeClass(size_t size)
+{
+	if (size == 0)
+		return 0;
+	int sizeClass = 64 - __builtin_clzll((uint64_t)size);
+	return sizeClass < NP_MEMORY_SIZE_CLASS_COUNT ? sizeClass : NP_MEMORY_SIZE_CLASS_COUNT - 1;
+}
+
+static inline void npMemoryUpdatePeak(int64_t* peak, int64_t value)
+{
+	int64_t current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+	while (value > current && !__atomic_compare_exchange_n(peak, &current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+	}
+}
+
+static inline void npMemoryCountAllocation(size_t size, int subsystem)
+{
+	int64_t live = __atomic_add_fetch(&npMemoryLiveBytes[subsystem], (int64_t)size, __ATOMIC_RELAXED);
+	npMemoryUpdatePeak(&npMemoryPeakBytes[subsystem], live);
+	int64_t totalLive = __atomic_add_fetch(&npMemoryLiveBytes[NP_MEMORY_SUBSYSTEM_COUNT], (int64_t)size, __ATOMIC_RELAXED);
+	npMemoryUpdatePeak(&npMemoryPeakBytes[NP_MEMORY_SUBSYSTEM_COUNT], totalLive);
+
+	npMemoryThreadCounters* counters = npMemoryGetThreadCounters();
+	if (!counters)
+		return;
+	npMemoryAddCounter(&counters->AllocatedBytes[subsystem], (int64_t)size);
+	npMemoryAddCounter(&counters->AllocationCounts[subsystem], 1);
+	npMemoryAddCounter(&counters->SizeClassCounts[npMemorySizeClass(size)], 1);
+}
+
+static inline void npMemoryCountFree(size_t size, int subsystem)
+{
+	__atomic_sub_fetch(&npMemoryLiveBytes[subsystem], (int64_t)size, __ATOMIC_RELAXED);
+	__atomic_sub_fetch(&npMemoryLiveBytes[NP_MEMORY_SUBSYSTEM_COUNT], (int64_t)size, __ATOMIC_RELAXED);
+
+	npMemoryThreadCounters* counters = npMemoryGetThreadCounters();
+	if (!counters)
+		return;
+	npMemoryAddCounter(&counters->FreedBytes[subsystem], (int64_t)size);
+	npMemoryAddCounter(&counters->FreeCounts[subsystem], 1);
+}
+
+static inline void* npMemoryInitHeader(npMemoryHeader* header, size_t size, int subsystem)
+{
+	if (subsystem < 0 || subsystem >= NP_MEMORY_SUBSYSTEM_COUNT)
+		subsystem = NP_MEMORY_SUBSYSTEM_GENERAL;
+	header->Size = size;
+	header->Subsystem = (uint32_t)subsystem;
+	header->Reserved = 0;
+	npMemoryCountAllocation(size, subsystem);
+	return (uint8_t*)header + NP_MEMORY_HEADER_SIZE;
+}
+
+static inline npMemoryHeader* npMemoryGetHeader(void* block)
+{
+	return (npMemoryHeader*)((uint8_t*)block - NP_MEMORY_HEADER_SIZE);
+}
+
+void* npTrackedMalloc(size_t size, int subsystem)
+{
+	npMemoryHeader* header = (npMemoryHeader*)npMalloc(size + NP_MEMORY_HEADER_SIZE);
+	return header ? npMemoryInitHeader(header, size, subsystem) : NULL;
+}
+
+void npTrackedFree(void* block)
+{
+	if (!block)
+		return;
+	npMemoryHeader* header = npMemoryGetHeader(block);
+	npMemoryCountFree((size_t)header->Size, (int)header->Subsystem);
+	npFree(header);
+}
+
+void* npTrackedRealloc(void* ptr, size_t size, int subsystem)
+{
+	if (!ptr)
+		return npTrackedMalloc(size, subsystem);
+
+	// Counted as a free and an allocation, in the subsystem of the original block
+	npMemoryHeader* header = npMemoryGetHeader(ptr);
+	size_t oldSize = (size_t)header->Size;
+	int oldSubsystem = (int)header->Subsystem;
+	npMemoryHeader* newHeader = (npMemoryHeader*)npRealloc(header, size + NP_MEMORY_HEADER_SIZE);
+	if (!newHeader)
+		return NULL;
+	npMemoryCountFree(oldSize, oldSubsystem);
+	return npMemoryInitHeader(newHeader, size, oldSubsystem);
+}
+
+size_t npTrackedMallocSize(void* ptr)
+{
+	return ptr ? (size_t)npMemoryGetHeader(ptr)->Size : 0;
+}
+
+void* npTrackedCalloc(size_t num, size_t size, int subsystem)
+{
+	if (size != 0 && num > ((size_t)-1 - NP_MEMORY_HEADER_SIZE) / size)
+		return NULL;
+	void* block = npTrackedMalloc(num * size, subsystem);
+	if (block)
+		memset(block, 0, num * size);
+	return block;
+}
+
+void npMemoryGetStats(npMemoryStats* stats)
+{
+	memset(stats, 0, sizeof(npMemoryStats));
+	stats->Enabled = 1;
+
+	for (npMemoryThreadCounters* counters = __atomic_load_n(&npMemoryCountersList, __ATOMIC_ACQUIRE); counters; counters = counters->Next)
+	{
+		for (int i = 0; i < NP_MEMORY_SUBSYSTEM_COUNT; i++)
+		{
+			npMemorySubsystemStats* subsystem = &stats->Subsystems[i];
+			subsystem->LiveBytes += __atomic_load_n(&counters->AllocatedBytes[i], __ATOMIC_RELAXED) - __atomic_load_n(&counters->FreedBytes[i], __ATOMIC_RELAXED);
+			subsystem->AllocationCount += __atomic_load_n(&counters->AllocationCounts[i], __ATOMIC_RELAXED);
+			subsystem->FreeCount += __atomic_load_n(&counters->FreeCounts[i], __ATOMIC_RELAXED);
+		}
+		for (int i = 0; i < NP_MEMORY_SIZE_CLASS_COUNT; i++)
+			stats->SizeClassCounts[i] += __atomic_load_n(&counters->SizeClassCounts[i], __ATOMIC_RELAXED);
+	}
+
+	for (int i = 0; i < NP_MEMORY_SUBSYSTEM_COUNT; i++)
+	{
+		npMemorySubsystemStats* subsystem = &stats->Subsystems[i];
+		// Counters are read while other threads allocate: keep the peak at least as high as the returned LiveBytes
+		npMemoryUpdatePeak(&npMemoryPeakBytes[i], subsystem->LiveBytes);
+		subsystem->PeakBytes = __atomic_load_n(&npMemoryPeakBytes[i], __ATOMIC_RELAXED);
+
+		stats->Total.LiveBytes += subsystem->LiveBytes;
+		stats->Total.AllocationCount += subsystem->AllocationCount;
+		stats->Total.FreeCount += subsystem->FreeCount;
+	}
+
+	npMemoryUpdatePeak(&npMemoryPeakBytes[NP_MEMORY_SUBSYSTEM_COUNT], stats->Total.LiveBytes);
+	stats->Total.PeakBytes = __atomic_load_n(&npMemoryPeakBytes[NP_MEMORY_SUBSYSTEM_COUNT], __ATOMIC_RELAXED);
+}
+
+#else
+
+void npMemoryGetStats(npMemoryStats* stats)
+{
+	memset(stats, 0, sizeof(npMemoryStats));
+}
+
+#endif
+
+#endif /* NATIVEPATH_MEMORY_IMPLEMENTATION */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,242 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+//
+//  NativeTrace.h
+//  NativePath
+//
+//  Scoped-zone tracing on top of npSeconds.
+//
+//  A zone is named by a static string (usually a literal), whose address is its id: names are never copied, so they must
+//  outlive the traced library. When a zone ends, its name, begin and end times are pushed to a ring buffer owned by the
+//  calling thread, without locks; zones ending while the buffer is full are dropped. npTraceDrain collects the zones of
+//  every thread, typically once per frame, for the managed profiler (whose ChromeTracingProfileWriter handles offline captures).
+//
+//  Tracing is disabled until npTraceEnable is called, in which case a zone costs a single branch. Defining NP_TRACE_DISABLED
+//  compiles the macros out entirely.
+//
+//  This header declares the API; exactly one source file of each native library defines NATIVEPATH_TRACE_IMPLEMENTATION
+//  before including it to compile the implementation.
+//
+
+#ifndef NativeTrace_h
+#define NativeTrace_h
+
+#include "NativePath.h"
+#include "NativeTime.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compiled into each library that defines NATIVEPATH_TRACE_IMPLEMENTATION, with library-prefixed symbols (see NativeMemory.h)
+#ifndef NP_LIBRARY_SYMBOL
+#ifdef NP_LIBRARY
+#define NP_LIBRARY_SYMBOL_JOIN(library, name) library##_##name
+#define NP_LIBRARY_SYMBOL_EXPAND(library, name) NP_LIBRARY_SYMBOL_JOIN(library, name)
+#define NP_LIBRARY_SYMBOL(name) NP_LIBRARY_SYMBOL_EXPAND(NP_LIBRARY, name)
+#else
+#define NP_LIBRARY_SYMBOL(name) name
+#endif
+#endif
+
+#define npTraceEnabled NP_LIBRARY_SYMBOL(npTraceEnabled)
+#define npTraceEnable NP_LIBRARY_SYMBOL(npTraceEnable)
+#define npTraceZone NP_LIBRARY_SYMBOL(npTraceZone)
+#define npTraceDrain NP_LIBRARY_SYMBOL(npTraceDrain)
+#define npTraceDroppedCount NP_LIBRARY_SYMBOL(npTraceDroppedCount)
+
+// Number of zones each thread can hold until the next drain, must be a power of two
+#ifndef NP_TRACE_BUFFER_SIZE
+#define NP_TRACE_BUFFER_SIZE 4096
+#endif
+
+typedef struct npTraceEvent
+{
+	const char* Name;
+	double Begin; // npSeconds
+	double End;
+	int32_t ThreadIndex; // Order in which threads first ended a zone, starting at 0
+	int32_t Padding;
+} npTraceEvent;
+
+// Read inline by the macros, use npTraceEnable to change it
+extern volatile int32_t npTraceEnabled;
+
+extern void npTraceEnable(npBool enabled);
+
+// Pushes a zone to the buffer of the calling thread
+extern void npTraceZone(const char* name, double begin, double end);
+
+// Moves up to capacity zones out of the thread buffers, returns the number of zones written to events
+extern int npTraceDrain(npTraceEvent* events, int capacity);
+
+// Number of zones dropped because a thread buffer was full, since the start
+extern int64_t npTraceDroppedCount();
+
+#ifdef __cplusplus
+}
+#endif
+
+#define NP_TRACE_CONCAT_INNER(a, b) a##b
+#define NP_TRACE_CONCAT(a, b) NP_TRACE_CONCAT_INNER(a, b)
+
+#ifdef NP_TRACE_DISABLED
+
+#define NP_TRACE_BEGIN(zone)
+#define NP_TRACE_END(zone, name)
+#define NP_TRACE_SCOPE(name)
+
+#else
+
+// Begins a zone stored in the local variable zone, to end with NP_TRACE_END in the same scope (C or C++)
+#define NP_TRACE_BEGIN(zone) double zone = npTraceEnabled ? npSeconds() : -1.0
+#define NP_TRACE_END(zone, name) do { if (zone >= 0.0) npTraceZone(name, zone, npSeconds()); } while (0)
+
+#ifdef __cplusplus
+
+// Ends the zone when leaving the scope, including early returns
+struct npTraceScope
+{
+	const char* Name;
+	double Begin;
+
+	npTraceScope(const char* name) : Name(name), Begin(npTraceEnabled ? npSeconds() : -1.0)
+	{
+	}
+
+	~npTraceScope()
+	{
+		if (Begin >= 0.0)
+			npTraceZone(Name, Begin, npSeconds());
+	}
+};
+
+// Traces the rest of the enclosing scope
+#define NP_TRACE_SCOPE(name) npTraceScope NP_TRACE_CONCAT(npTraceScope, __LINE__)(name)
+
+#endif
+
+#endif
+
+#ifdef NATIVEPATH_TRACE_IMPLEMENTATION
+
+#include "NativeMemory.h"
+#include "NativeThreading.h"
+
+#define NP_TRACE_BUFFER_MASK (NP_TRACE_BUFFER_SIZE - 1)
+
+#ifndef NP_THREAD_LOCAL
+#ifdef __cplusplus
+#define NP_THREAD_LOCAL thread_local
+#else
+#define NP_THREAD_LOCAL _Thread_local
+#endif
+#endif
+
+// Single producer (the owner thread), single consumer (npTraceDrain, under npTraceDrainLock).
+// Never freed, since threads can't be notified of their exit.
+typedef struct npTraceBuffer
+{
+	struct npTraceBuffer* Next;
+	int32_t ThreadIndex;
+	volatile uint32_t Head; // Written by the owner
+	volatile uint32_t Tail; // Written by the consumer
+	npTraceEvent Events[NP_TRACE_BUFFER_SIZE];
+} npTraceBuffer;
+
+volatile int32_t npTraceEnabled;
+
+static npTraceBuffer* volatile npTraceBufferList;
+static NP_THREAD_LOCAL npTraceBuffer* npTraceBufferInstance;
+static volatile int32_t npTraceThreadCount;
+static volatile int32_t npTraceDrainLock;
+static volatile int64_t npTraceDropped;
+
+static npTraceBuffer* npTraceGetBuffer()
+{
+	npTraceBuffer* buffer = npTraceBufferInstance;
+	if (buffer)
+		return buffer;
+
+	buffer = (npTraceBuffer*)npCalloc(1, sizeof(npTraceBuffer));
+	if (!buffer)
+		return NULL;
+
+	buffer->ThreadIndex = __atomic_fetch_add(&npTraceThreadCount, 1, __ATOMIC_RELAXED);
+
+	npTraceBuffer* head = __atomic_load_n(&npTraceBufferList, __ATOMIC_RELAXED);
+	do
+	{
+		buffer->Next = head;
+	} while (!__atomic_compare_exchange_n(&npTraceBufferList, &head, buffer, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	npTraceBufferInstance = buffer;
+	return buffer;
+}
+
+void npTraceEnable(npBool enabled)
+{
+	__atomic_store_n(&npTraceEnabled, enabled ? 1 : 0, __ATOMIC_RELAXED);
+}
+
+void npTraceZone(const char* name, double begin, double end)
+{
+	npTraceBuffer* buffer = npTraceGetBuffer();
+	if (!buffer)
+		return;
+
+	uint32_t head = __atomic_load_n(&buffer->Head, __ATOMIC_RELAXED);
+	uint32_t tail = __atomic_load_n(&buffer->Tail, __ATOMIC_ACQUIRE);
+	if (head - tail >= NP_TRACE_BUFFER_SIZE)
+	{
+		__atomic_fetch_add(&npTraceDropped, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	npTraceEvent* event = &buffer->Events[head & NP_TRACE_BUFFER_MASK];
+	event->Name = name;
+	event->Begin = begin;
+	event->End = end;
+	event->ThreadIndex = buffer->ThreadIndex;
+	event->Padding = 0;
+
+	// Publishes the event to the consumer
+	__atomic_store_n(&buffer->Head, head + 1, __ATOMIC_RELEASE);
+}
+
+int npTraceDrain(npTraceEvent* events, int capacity)
+{
+	while (__atomic_exchange_n(&npTraceDrainLock, 1, __ATOMIC_ACQUIRE))
+	{
+		while (__atomic_load_n(&npTraceDrainLock, __ATOMIC_RELAXED))
+			npThreadYield();
+	}
+
+	int count = 0;
+	for (npTraceBuffer* buffer = __atomic_load_n(&npTraceBufferList, __ATOMIC_ACQUIRE); buffer && count < capacity; buffer = buffer->Next)
+	{
+		uint32_t tail = buffer->Tail;
+		uint32_t head = __atomic_load_n(&buffer->Head, __ATOMIC_ACQUIRE);
+		while (tail != head && count < capacity)
+		{
+			events[count++] = buffer->Events[tail & NP_TRACE_BUFFER_MASK];
+			tail++;
+		}
+
+		// Gives the slots back to the owner
+		__atomic_store_n(&buffer->Tail, tail, __ATOMIC_RELEASE);
+	}
+
+	__atomic_store_n(&npTraceDrainLock, 0, __ATOMIC_RELEASE);
+	return count;
+}
+
+int64_t npTraceDroppedCount()
+{
+	return __atomic_load_n(&npTraceDropped, __ATOMIC_RELAXED);
+}
+
+#endif
+
+#endif /* NativeTrace_h */
@@ -0,0 +1,27 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#ifndef TINYSTL_ARENA_ALLOCATOR_H
+#define TINYSTL_ARENA_ALLOCATOR_H
+
+#include <TINYSTL/stddef.h>
+#include <NativeMemory.h>
+
+namespace tinystl {
+
+	// Allocates from the arena returned by GetArena, memory is only released when the arena is reset or rewound
+	template<npArena* (*GetArena)()>
+	struct arena_allocator {
+		static void* static_allocate(size_t bytes) {
+			return npArenaAlloc(GetArena(), bytes);
+		}
+
+		static void static_deallocate(void* /*ptr*/, size_t /*bytes*/) {
+		}
+	};
+
+	// Scratch containers of the calling thread, see npFrameArena
+	typedef arena_allocator<npFrameArena> frame_allocator;
+}
+
+#endif
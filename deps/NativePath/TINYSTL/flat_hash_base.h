@@ -0,0 +1,384 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#ifndef TINYSTL_FLAT_HASH_BASE_H
+#define TINYSTL_FLAT_HASH_BASE_H
+
+#include <TINYSTL/stddef.h>
+#include <TINYSTL/hash.h>
+#include <TINYSTL/hash_base.h>
+#include <TINYSTL/new.h>
+
+/*
+ * Open addressing hash table shared by flat_hash_map and flat_hash_set.
+ *
+ * Nodes are stored inline in a single power of two array, with linear probing and Robin Hood ordering: a node never sits
+ * further from its home slot than the nodes it passed, which bounds lookups and lets them stop as soon as a closer node is
+ * met. A separate byte array holds the probe length of each slot (0 when empty, 1 in the home slot), so lookups and
+ * iteration mostly touch that array. Erasing shifts the following nodes back instead of leaving tombstones.
+ *
+ * Unlike the node based containers, inserting and erasing move nodes: they invalidate iterators and node pointers.
+ */
+
+namespace tinystl {
+
+	template<typename Key, typename Value>
+	struct flat_hash_node {
+		flat_hash_node(const Key& key, const Value& value);
+
+		const Key first;
+		Value second;
+
+	private:
+		flat_hash_node& operator=(const flat_hash_node&);
+	};
+
+	template<typename Key, typename Value>
+	flat_hash_node<Key, Value>::flat_hash_node(const Key& key, const Value& value)
+		: first(key)
+		, second(value)
+	{
+	}
+
+	template<typename Key>
+	struct flat_hash_node<Key, void> {
+		flat_hash_node(const Key& key);
+
+		const Key first;
+
+	private:
+		flat_hash_node& operator=(const flat_hash_node&);
+	};
+
+	template<typename Key>
+	flat_hash_node<Key, void>::flat_hash_node(const Key& key)
+		: first(key)
+	{
+	}
+
+	template<typename Node>
+	struct flat_hash_iterator {
+		Node* operator->() const;
+		Node& operator*() const;
+		Node* node;
+		const unsigned char* probe;
+		const unsigned char* probe_end;
+	};
+
+	template<typename Node>
+	struct flat_hash_iterator<const Node> {
+
+		flat_hash_iterator() {}
+		flat_hash_iterator(flat_hash_iterator<Node> other)
+			: node(other.node)
+			, probe(other.probe)
+			, probe_end(other.probe_end)
+		{
+		}
+
+		const Node* operator->() const;
+		const Node& operator*() const;
+		const Node* node;
+		const unsigned char* probe;
+		const unsigned char* probe_end;
+	};
+
+	template<typename Key>
+	struct flat_hash_iterator<const flat_hash_node<Key, void> > {
+		const Key* operator->() const;
+		const Key& operator*() const;
+		const flat_hash_node<Key, void>* node;
+		const unsigned char* probe;
+		const unsigned char* probe_end;
+	};
+
+	template<typename LNode, typename RNode>
+	static inline bool operator==(const flat_hash_iterator<LNode>& lhs, const flat_hash_iterator<RNode>& rhs) {
+		return lhs.node == rhs.node;
+	}
+
+	template<typename LNode, typename RNode>
+	static inline bool operator!=(const flat_hash_iterator<LNode>& lhs, const flat_hash_iterator<RNode>& rhs) {
+		return lhs.node != rhs.node;
+	}
+
+	template<typename Node>
+	static inline void operator++(flat_hash_iterator<Node>& lhs) {
+		do {
+			++lhs.node;
+			++lhs.probe;
+		} while (lhs.probe != lhs.probe_end && !*lhs.probe);
+	}
+
+	template<typename Node>
+	inline Node* flat_hash_iterator<Node>::operator->() const {
+		return node;
+	}
+
+	template<typename Node>
+	inline Node& flat_hash_iterator<Node>::operator*() const {
+		return *node;
+	}
+
+	template<typename Node>
+	inline const Node* flat_hash_iterator<const Node>::operator->() const {
+		return node;
+	}
+
+	template<typename Node>
+	inline const Node& flat_hash_iterator<const Node>::operator*() const {
+		return *node;
+	}
+
+	template<typename Key>
+	inline const Key* flat_hash_iterator<const flat_hash_node<Key, void> >::operator->() const {
+		return &node->first;
+	}
+
+	template<typename Key>
+	inline const Key& flat_hash_iterator<const flat_hash_node<Key, void> >::operator*() const {
+		return node->first;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	class flat_hash_table {
+	public:
+		typedef flat_hash_node<Key, Value> node;
+
+		flat_hash_table();
+		flat_hash_table(const flat_hash_table& other);
+		~flat_hash_table();
+
+		// Slot of key, or capacity() when it's missing
+		size_t find(const Key& key) const;
+
+		// Constructs newnode's copy in a free slot (key must be missing), returns the slot
+		size_t insert(const node& newnode);
+
+		void erase(size_t slot);
+		void clear();
+		void swap(flat_hash_table& other);
+
+		// Slot of the first node, or capacity() when empty
+		size_t first() const;
+
+		size_t size() const { return m_size; }
+		size_t capacity() const { return m_capacity; }
+		node* nodes() const { return m_nodes; }
+		const unsigned char* probes() const { return m_probes; }
+
+	private:
+		flat_hash_table& operator=(const flat_hash_table&);
+
+		// Probe lengths are stored in a byte, tables with longer probes grow
+		enum { max_probe = 255, min_capacity = 8 };
+
+		size_t home(const Key& key) const;
+		void allocate(size_t capacity);
+		void rehash(size_t capacity);
+
+		node* m_nodes;
+		unsigned char* m_probes;
+		size_t m_size;
+		size_t m_capacity;
+		unsigned m_shift;
+	};
+
+	template<typename Key, typename Value, typename Alloc>
+	flat_hash_table<Key, Value, Alloc>::flat_hash_table()
+		: m_nodes(0)
+		, m_probes(0)
+		, m_size(0)
+		, m_capacity(0)
+		, m_shift(64)
+	{
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	flat_hash_table<Key, Value, Alloc>::flat_hash_table(const flat_hash_table& other)
+		: m_nodes(0)
+		, m_probes(0)
+		, m_size(other.m_size)
+		, m_capacity(0)
+		, m_shift(64)
+	{
+		if (!other.m_capacity)
+			return;
+
+		allocate(other.m_capacity);
+		for (size_t slot = 0; slot < m_capacity; ++slot) {
+			m_probes[slot] = other.m_probes[slot];
+			if (m_probes[slot])
+				new(placeholder(), &m_nodes[slot]) node(other.m_nodes[slot]);
+		}
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	flat_hash_table<Key, Value, Alloc>::~flat_hash_table() {
+		clear();
+		if (m_capacity)
+			Alloc::static_deallocate(m_nodes, m_capacity * (sizeof(node) + 1));
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline size_t flat_hash_table<Key, Value, Alloc>::home(const Key& key) const {
+		// Fibonacci hashing, spreads hashes whose low bits are poor (aligned pointers) over the whole table
+		return (size_t)(((unsigned long long)hash(key) * 0x9e3779b97f4a7c15ull) >> m_shift);
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	void flat_hash_table<Key, Value, Alloc>::allocate(size_t capacity) {
+		// Nodes first, followed by the probe lengths
+		m_nodes = (node*)Alloc::static_allocate(capacity * (sizeof(node) + 1));
+		m_probes = (unsigned char*)(m_nodes + capacity);
+		for (size_t slot = 0; slot < capacity; ++slot)
+			m_probes[slot] = 0;
+
+		m_capacity = capacity;
+		m_shift = 64;
+		for (size_t c = capacity; c > 1; c >>= 1)
+			--m_shift;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	void flat_hash_table<Key, Value, Alloc>::rehash(size_t capacity) {
+		node* oldnodes = m_nodes;
+		unsigned char* oldprobes = m_probes;
+		const size_t oldcapacity = m_capacity;
+
+		allocate(capacity);
+		m_size = 0;
+		for (size_t slot = 0; slot < oldcapacity; ++slot) {
+			if (oldprobes[slot]) {
+				insert(oldnodes[slot]);
+				oldnodes[slot].~node();
+			}
+		}
+
+		if (oldcapacity)
+			Alloc::static_deallocate(oldnodes, oldcapacity * (sizeof(node) + 1));
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	size_t flat_hash_table<Key, Value, Alloc>::find(const Key& key) const {
+		if (!m_size)
+			return m_capacity;
+
+		const size_t mask = m_capacity - 1;
+		size_t slot = home(key);
+		for (unsigned probe = 1; m_probes[slot] >= probe; ++probe, slot = (slot + 1) & mask) {
+			// Nodes closer to their home than probe mean that key would have been placed before them
+			if (m_probes[slot] == probe && m_nodes[slot].first == key)
+				return slot;
+		}
+		return m_capacity;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	size_t flat_hash_table<Key, Value, Alloc>::insert(const node& newnode) {
+		// Keeps the load factor under 7/8
+		if ((m_size + 1) * 8 > m_capacity * 7)
+			rehash(m_capacity ? m_capacity * 2 : (size_t)min_capacity);
+
+		for (;;) {
+			const size_t mask = m_capacity - 1;
+
+			// The node goes before the first node closer to its home, the following nodes up to the next empty slot move one
+			// slot further, which keeps every cluster sorted by home slot
+			size_t slot = home(newnode.first);
+			unsigned probe = 1;
+			while (m_probes[slot] >= probe && probe < max_probe) {
+				++probe;
+				slot = (slot + 1) & mask;
+			}
+
+			size_t empty = slot;
+			bool overflow = probe >= max_probe;
+			while (m_probes[empty] && !overflow) {
+				overflow = m_probes[empty] >= max_probe;
+				empty = (empty + 1) & mask;
+			}
+
+			if (overflow) {
+				rehash(m_capacity * 2);
+				continue;
+			}
+
+			for (size_t to = empty; to != slot; ) {
+				const size_t from = (to - 1) & mask;
+				new(placeholder(), &m_nodes[to]) node(m_nodes[from]);
+				m_nodes[from].~node();
+				m_probes[to] = (unsigned char)(m_probes[from] + 1);
+				to = from;
+			}
+
+			new(placeholder(), &m_nodes[slot]) node(newnode);
+			m_probes[slot] = (unsigned char)probe;
+			++m_size;
+			return slot;
+		}
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	void flat_hash_table<Key, Value, Alloc>::erase(size_t slot) {
+		const size_t mask = m_capacity - 1;
+		m_nodes[slot].~node();
+
+		// Moves the following nodes one slot back, until one is already in its home slot
+		for (size_t next = (slot + 1) & mask; m_probes[next] > 1; slot = next, next = (next + 1) & mask) {
+			new(placeholder(), &m_nodes[slot]) node(m_nodes[next]);
+			m_nodes[next].~node();
+			m_probes[slot] = (unsigned char)(m_probes[next] - 1);
+		}
+
+		m_probes[slot] = 0;
+		--m_size;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	void flat_hash_table<Key, Value, Alloc>::clear() {
+		// Keeps the storage, to be reused by the next insertions
+		for (size_t slot = 0; slot < m_capacity; ++slot) {
+			if (m_probes[slot]) {
+				m_nodes[slot].~node();
+				m_probes[slot] = 0;
+			}
+		}
+		m_size = 0;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	void flat_hash_table<Key, Value, Alloc>::swap(flat_hash_table& other) {
+		node* tnodes = m_nodes;
+		m_nodes = other.m_nodes, other.m_nodes = tnodes;
+		unsigned char* tprobes = m_probes;
+		m_probes = other.m_probes, other.m_probes = tprobes;
+		size_t tsize = m_size;
+		m_size = other.m_size, other.m_size = tsize;
+		size_t tcapacity = m_capacity;
+		m_capacity = other.m_capacity, other.m_capacity = tcapacity;
+		unsigned tshift = m_shift;
+		m_shift = other.m_shift, other.m_shift = tshift;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline size_t flat_hash_table<Key, Value, Alloc>::first() const {
+		size_t slot = 0;
+		if (m_size) {
+			while (!m_probes[slot])
+				++slot;
+			return slot;
+		}
+		return m_capacity;
+	}
+
+	template<typename Iterator, typename Table>
+	static inline Iterator flat_hash_make_iterator(const Table& table, size_t slot) {
+		Iterator it;
+		it.node = table.nodes() + slot;
+		it.probe = table.probes() + slot;
+		it.probe_end = table.probes() + table.capacity();
+		return it;
+	}
+}
+#endif
@@ -0,0 +1,155 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#ifndef TINYSTL_FLAT_HASH_MAP_H
+#define TINYSTL_FLAT_HASH_MAP_H
+
+#include <TINYSTL/allocator.h>
+#include <TINYSTL/flat_hash_base.h>
+
+/*
+ * Same interface as unordered_map, stored in an open addressing table (see flat_hash_base.h).
+ * insert, operator[] (when adding a key) and erase invalidate iterators and pointers to values.
+ */
+
+namespace tinystl {
+
+	template<typename Key, typename Value, typename Alloc = TINYSTL_ALLOCATOR>
+	class flat_hash_map {
+	public:
+		flat_hash_map();
+		flat_hash_map(const flat_hash_map& other);
+		~flat_hash_map();
+
+		flat_hash_map& operator=(const flat_hash_map& other);
+
+
+		typedef pair<Key, Value> value_type;
+
+		typedef flat_hash_iterator<const flat_hash_node<Key, Value> > const_iterator;
+		typedef flat_hash_iterator<flat_hash_node<Key, Value> > iterator;
+
+		iterator begin();
+		iterator end();
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		void clear();
+		bool empty() const;
+		size_t size() const;
+
+		const_iterator find(const Key& key) const;
+		iterator find(const Key& key);
+		pair<iterator, bool> insert(const pair<Key, Value>& p);
+		void erase(const_iterator where);
+
+		Value& operator[](const Key& key);
+
+		void swap(flat_hash_map& other);
+
+	private:
+
+		flat_hash_table<Key, Value, Alloc> m_table;
+	};
+
+	template<typename Key, typename Value, typename Alloc>
+	flat_hash_map<Key, Value, Alloc>::flat_hash_map()
+	{
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	flat_hash_map<Key, Value, Alloc>::flat_hash_map(const flat_hash_map& other)
+		: m_table(other.m_table)
+	{
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	flat_hash_map<Key, Value, Alloc>::~flat_hash_map() {
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	flat_hash_map<Key, Value, Alloc>& flat_hash_map<Key, Value, Alloc>::operator=(const flat_hash_map<Key, Value, Alloc>& other) {
+		flat_hash_map<Key, Value, Alloc>(other).swap(*this);
+		return *this;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline typename flat_hash_map<Key, Value, Alloc>::iterator flat_hash_map<Key, Value, Alloc>::begin() {
+		return flat_hash_make_iterator<iterator>(m_table, m_table.first());
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline typename flat_hash_map<Key, Value, Alloc>::iterator flat_hash_map<Key, Value, Alloc>::end() {
+		return flat_hash_make_iterator<iterator>(m_table, m_table.capacity());
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline typename flat_hash_map<Key, Value, Alloc>::const_iterator flat_hash_map<Key, Value, Alloc>::begin() const {
+		return flat_hash_make_iterator<const_iterator>(m_table, m_table.first());
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline typename flat_hash_map<Key, Value, Alloc>::const_iterator flat_hash_map<Key, Value, Alloc>::end() const {
+		return flat_hash_make_iterator<const_iterator>(m_table, m_table.capacity());
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline bool flat_hash_map<Key, Value, Alloc>::empty() const {
+		return m_table.size() == 0;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline size_t flat_hash_map<Key, Value, Alloc>::size() const {
+		return m_table.size();
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline void flat_hash_map<Key, Value, Alloc>::clear() {
+		m_table.clear();
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline typename flat_hash_map<Key, Value, Alloc>::iterator flat_hash_map<Key, Value, Alloc>::find(const Key& key) {
+		return flat_hash_make_iterator<iterator>(m_table, m_table.find(key));
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline typename flat_hash_map<Key, Value, Alloc>::const_iterator flat_hash_map<Key, Value, Alloc>::find(const Key& key) const {
+		return flat_hash_make_iterator<const_iterator>(m_table, m_table.find(key));
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline pair<typename flat_hash_map<Key, Value, Alloc>::iterator, bool> flat_hash_map<Key, Value, Alloc>::insert(const pair<Key, Value>& p) {
+		pair<iterator, bool> result;
+		result.second = false;
+
+		size_t slot = m_table.find(p.first);
+		if (slot == m_table.capacity()) {
+			slot = m_table.insert(flat_hash_node<Key, Value>(p.first, p.second));
+			result.second = true;
+		}
+
+		result.first = flat_hash_make_iterator<iterator>(m_table, slot);
+		return result;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	inline void flat_hash_map<Key, Value, Alloc>::erase(const_iterator where) {
+		m_table.erase((size_t)(where.node - m_table.nodes()));
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	Value& flat_hash_map<Key, Value, Alloc>::operator[](const Key& key) {
+		size_t slot = m_table.find(key);
+		if (slot == m_table.capacity())
+			slot = m_table.insert(flat_hash_node<Key, Value>(key, Value()));
+		return m_table.nodes()[slot].second;
+	}
+
+	template<typename Key, typename Value, typename Alloc>
+	void flat_hash_map<Key, Value, Alloc>::swap(flat_hash_map& other) {
+		m_table.swap(other.m_table);
+	}
+}
+#endif
@@ -0,0 +1,134 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#ifndef TINYSTL_FLAT_HASH_SET_H
+#define TINYSTL_FLAT_HASH_SET_H
+
+#include <TINYSTL/allocator.h>
+#include <TINYSTL/flat_hash_base.h>
+
+/*
+ * Same interface as unordered_set, stored in an open addressing table (see flat_hash_base.h).
+ * insert and erase invalidate iterators.
+ */
+
+namespace tinystl {
+
+	template<typename Key, typename Alloc = TINYSTL_ALLOCATOR>
+	class flat_hash_set {
+	public:
+		flat_hash_set();
+		flat_hash_set(const flat_hash_set& other);
+		~flat_hash_set();
+
+		flat_hash_set& operator=(const flat_hash_set& other);
+
+		typedef flat_hash_iterator<const flat_hash_node<Key, void> > const_iterator;
+		typedef const_iterator iterator;
+
+		iterator begin() const;
+		iterator end() const;
+
+		void clear();
+		bool empty() const;
+		size_t size() const;
+
+		iterator find(const Key& key) const;
+		pair<iterator, bool> insert(const Key& key);
+		void erase(iterator where);
+		size_t erase(const Key& key);
+
+		void swap(flat_hash_set& other);
+
+	private:
+
+		flat_hash_table<Key, void, Alloc> m_table;
+	};
+
+	template<typename Key, typename Alloc>
+	flat_hash_set<Key, Alloc>::flat_hash_set()
+	{
+	}
+
+	template<typename Key, typename Alloc>
+	flat_hash_set<Key, Alloc>::flat_hash_set(const flat_hash_set& other)
+		: m_table(other.m_table)
+	{
+	}
+
+	template<typename Key, typename Alloc>
+	flat_hash_set<Key, Alloc>::~flat_hash_set() {
+	}
+
+	template<typename Key, typename Alloc>
+	flat_hash_set<Key, Alloc>& flat_hash_set<Key, Alloc>::operator=(const flat_hash_set<Key, Alloc>& other) {
+		flat_hash_set<Key, Alloc>(other).swap(*this);
+		return *this;
+	}
+
+	template<typename Key, typename Alloc>
+	inline typename flat_hash_set<Key, Alloc>::iterator flat_hash_set<Key, Alloc>::begin() const {
+		return flat_hash_make_iterator<iterator>(m_table, m_table.first());
+	}
+
+	template<typename Key, typename Alloc>
+	inline typename flat_hash_set<Key, Alloc>::iterator flat_hash_set<Key, Alloc>::end() const {
+		return flat_hash_make_iterator<iterator>(m_table, m_table.capacity());
+	}
+
+	template<typename Key, typename Alloc>
+	inline bool flat_hash_set<Key, Alloc>::empty() const {
+		return m_table.size() == 0;
+	}
+
+	template<typename Key, typename Alloc>
+	inline size_t flat_hash_set<Key, Alloc>::size() const {
+		return m_table.size();
+	}
+
+	template<typename Key, typename Alloc>
+	inline void flat_hash_set<Key, Alloc>::clear() {
+		m_table.clear();
+	}
+
+	template<typename Key, typename Alloc>
+	inline typename flat_hash_set<Key, Alloc>::iterator flat_hash_set<Key, Alloc>::find(const Key& key) const {
+		return flat_hash_make_iterator<iterator>(m_table, m_table.find(key));
+	}
+
+	template<typename Key, typename Alloc>
+	inline pair<typename flat_hash_set<Key, Alloc>::iterator, bool> flat_hash_set<Key, Alloc>::insert(const Key& key) {
+		pair<iterator, bool> result;
+		result.second = false;
+
+		size_t slot = m_table.find(key);
+		if (slot == m_table.capacity()) {
+			slot = m_table.insert(flat_hash_node<Key, void>(key));
+			result.second = true;
+		}
+
+		result.first = flat_hash_make_iterator<iterator>(m_table, slot);
+		return result;
+	}
+
+	template<typename Key, typename Alloc>
+	inline void flat_hash_set<Key, Alloc>::erase(iterator where) {
+		m_table.erase((size_t)(where.node - m_table.nodes()));
+	}
+
+	template<typename Key, typename Alloc>
+	inline size_t flat_hash_set<Key, Alloc>::erase(const Key& key) {
+		const size_t slot = m_table.find(key);
+		if (slot == m_table.capacity())
+			return 0;
+
+		m_table.erase(slot);
+		return 1;
+	}
+
+	template <typename Key, typename Alloc>
+	void flat_hash_set<Key, Alloc>::swap(flat_hash_set& other) {
+		m_table.swap(other.m_table);
+	}
+}
+#endif
@@ -0,0 +1,263 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#ifndef TINYSTL_RING_BUFFER_H
+#define TINYSTL_RING_BUFFER_H
+
+#include <TINYSTL/buffer.h>
+#include <TINYSTL/new.h>
+#include <TINYSTL/stddef.h>
+
+/*
+ * Double ended queue of at most N elements, stored inline and never allocating: pushing and popping at either end is O(1).
+ * Pushing to a full ring_buffer is not allowed, check full() first.
+ */
+
+namespace tinystl {
+	template<typename T, size_t N>
+	class ring_buffer;
+
+	template<typename Ring, typename T>
+	struct ring_buffer_iterator {
+		T& operator*() const;
+		T* operator->() const;
+		Ring* ring;
+		size_t index;
+	};
+
+	template<typename Ring, typename T>
+	static inline bool operator==(const ring_buffer_iterator<Ring, T>& lhs, const ring_buffer_iterator<Ring, T>& rhs) {
+		return lhs.index == rhs.index;
+	}
+
+	template<typename Ring, typename T>
+	static inline bool operator!=(const ring_buffer_iterator<Ring, T>& lhs, const ring_buffer_iterator<Ring, T>& rhs) {
+		return lhs.index != rhs.index;
+	}
+
+	template<typename Ring, typename T>
+	static inline void operator++(ring_buffer_iterator<Ring, T>& lhs) {
+		++lhs.index;
+	}
+
+	template<typename Ring, typename T>
+	inline T& ring_buffer_iterator<Ring, T>::operator*() const {
+		return (*ring)[index];
+	}
+
+	template<typename Ring, typename T>
+	inline T* ring_buffer_iterator<Ring, T>::operator->() const {
+		return &(*ring)[index];
+	}
+
+	template<typename T, size_t N>
+	class ring_buffer {
+	public:
+		ring_buffer();
+		ring_buffer(const ring_buffer& other);
+		~ring_buffer();
+
+		ring_buffer& operator=(const ring_buffer& other);
+
+		size_t size() const;
+		size_t capacity() const;
+		bool empty() const;
+		bool full() const;
+
+		// Element idx from the front
+		T& operator[](size_t idx);
+		const T& operator[](size_t idx) const;
+
+		const T& front() const;
+		T& front();
+		const T& back() const;
+		T& back();
+
+		void clear();
+
+		void push_back(const T& t);
+		void push_front(const T& t);
+		void pop_back();
+		void pop_front();
+
+		typedef T value_type;
+
+		typedef ring_buffer_iterator<ring_buffer, T> iterator;
+		iterator begin();
+		iterator end();
+
+		typedef ring_buffer_iterator<const ring_buffer, const T> const_iterator;
+		const_iterator begin() const;
+		const_iterator end() const;
+
+	private:
+		T* slot(size_t idx);
+		const T* slot(size_t idx) const;
+
+		size_t m_head;
+		size_t m_size;
+		alignas(T) unsigned char m_storage[N * sizeof(T)];
+	};
+
+	template<typename T, size_t N>
+	inline T* ring_buffer<T, N>::slot(size_t idx) {
+		idx += m_head;
+		return (T*)m_storage + (idx < N ? idx : idx - N);
+	}
+
+	template<typename T, size_t N>
+	inline const T* ring_buffer<T, N>::slot(size_t idx) const {
+		idx += m_head;
+		return (const T*)m_storage + (idx < N ? idx : idx - N);
+	}
+
+	template<typename T, size_t N>
+	inline ring_buffer<T, N>::ring_buffer()
+		: m_head(0)
+		, m_size(0)
+	{
+	}
+
+	template<typename T, size_t N>
+	inline ring_buffer<T, N>::ring_buffer(const ring_buffer& other)
+		: m_head(0)
+		, m_size(0)
+	{
+		for (size_t i = 0; i < other.m_size; ++i)
+			push_back(other[i]);
+	}
+
+	template<typename T, size_t N>
+	inline ring_buffer<T, N>::~ring_buffer() {
+		clear();
+	}
+
+	template<typename T, size_t N>
+	inline ring_buffer<T, N>& ring_buffer<T, N>::operator=(const ring_buffer& other) {
+		if (this != &other) {
+			clear();
+			for (size_t i = 0; i < other.m_size; ++i)
+				push_back(other[i]);
+		}
+		return *this;
+	}
+
+	template<typename T, size_t N>
+	inline size_t ring_buffer<T, N>::size() const {
+		return m_size;
+	}
+
+	template<typename T, size_t N>
+	inline size_t ring_buffer<T, N>::capacity() const {
+		return N;
+	}
+
+	template<typename T, size_t N>
+	inline bool ring_buffer<T, N>::empty() const {
+		return m_size == 0;
+	}
+
+	template<typename T, size_t N>
+	inline bool ring_buffer<T, N>::full() const {
+		return m_size == N;
+	}
+
+	template<typename T, size_t N>
+	inline T& ring_buffer<T, N>::operator[](size_t idx) {
+		return *slot(idx);
+	}
+
+	template<typename T, size_t N>
+	inline const T& ring_buffer<T, N>::operator[](size_t idx) const {
+		return *slot(idx);
+	}
+
+	template<typename T, size_t N>
+	inline const T& ring_buffer<T, N>::front() const {
+		return *slot(0);
+	}
+
+	template<typename T, size_t N>
+	inline T& ring_buffer<T, N>::front() {
+		return *slot(0);
+	}
+
+	template<typename T, size_t N>
+	inline const T& ring_buffer<T, N>::back() const {
+		return *slot(m_size - 1);
+	}
+
+	template<typename T, size_t N>
+	inline T& ring_buffer<T, N>::back() {
+		return *slot(m_size - 1);
+	}
+
+	template<typename T, size_t N>
+	inline void ring_buffer<T, N>::clear() {
+		while (m_size)
+			pop_back();
+		m_head = 0;
+	}
+
+	template<typename T, size_t N>
+	inline void ring_buffer<T, N>::push_back(const T& t) {
+		new(placeholder(), slot(m_size)) T(t);
+		++m_size;
+	}
+
+	template<typename T, size_t N>
+	inline void ring_buffer<T, N>::push_front(const T& t) {
+		m_head = m_head ? m_head - 1 : N - 1;
+		new(placeholder(), (T*)m_storage + m_head) T(t);
+		++m_size;
+	}
+
+	template<typename T, size_t N>
+	inline void ring_buffer<T, N>::pop_back() {
+		T* last = slot(m_size - 1);
+		buffer_destroy_range(last, last + 1);
+		--m_size;
+	}
+
+	template<typename T, size_t N>
+	inline void ring_buffer<T, N>::pop_front() {
+		T* first = slot(0);
+		buffer_destroy_range(first, first + 1);
+		m_head = m_head + 1 < N ? m_head + 1 : 0;
+		--m_size;
+	}
+
+	template<typename T, size_t N>
+	inline typename ring_buffer<T, N>::iterator ring_buffer<T, N>::begin() {
+		iterator it;
+		it.ring = this;
+		it.index = 0;
+		return it;
+	}
+
+	template<typename T, size_t N>
+	inline typename ring_buffer<T, N>::iterator ring_buffer<T, N>::end() {
+		iterator it;
+		it.ring = this;
+		it.index = m_size;
+		return it;
+	}
+
+	template<typename T, size_t N>
+	inline typename ring_buffer<T, N>::const_iterator ring_buffer<T, N>::begin() const {
+		const_iterator it;
+		it.ring = this;
+		it.index = 0;
+		return it;
+	}
+
+	template<typename T, size_t N>
+	inline typename ring_buffer<T, N>::const_iterator ring_buffer<T, N>::end() const {
+		const_iterator it;
+		it.ring = this;
+		it.index = m_size;
+		return it;
+	}
+}
+
+#endif
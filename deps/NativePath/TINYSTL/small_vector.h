@@ -0,0 +1,279 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#ifndef TINYSTL_SMALL_VECTOR_H
+#define TINYSTL_SMALL_VECTOR_H
+
+#include <TINYSTL/allocator.h>
+#include <TINYSTL/buffer.h>
+#include <TINYSTL/new.h>
+#include <TINYSTL/stddef.h>
+
+/*
+ * vector storing up to N elements inline, only allocating (with Alloc) once it grows past that. Containers that usually
+ * hold a few elements then live entirely in their owner, without allocation, which matters on real-time threads.
+ * Supports the push/pop/erase subset of the vector interface.
+ */
+
+namespace tinystl {
+	template<typename T, size_t N, typename Alloc = TINYSTL_ALLOCATOR>
+	class small_vector {
+	public:
+		small_vector();
+		small_vector(const small_vector& other);
+		~small_vector();
+
+		small_vector& operator=(const small_vector& other);
+
+		const T* data() const;
+		T* data();
+		size_t size() const;
+		size_t capacity() const;
+		bool empty() const;
+
+		T& operator[](size_t idx);
+		const T& operator[](size_t idx) const;
+
+		const T& front() const;
+		T& front();
+		const T& back() const;
+		T& back();
+
+		void resize(size_t size);
+		void resize(size_t size, const T& value);
+		void clear();
+		void reserve(size_t capacity);
+
+		void push_back(const T& t);
+		void pop_back();
+
+		typedef T value_type;
+
+		typedef T* iterator;
+		iterator begin();
+		iterator end();
+
+		typedef const T* const_iterator;
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		iterator erase(iterator where);
+		iterator erase(iterator first, iterator last);
+
+		iterator erase_unordered(iterator where);
+
+	private:
+		T* inline_storage();
+		void copy_from(const small_vector& other);
+
+		T* m_first;
+		T* m_last;
+		T* m_capacity;
+		alignas(T) unsigned char m_storage[N * sizeof(T)];
+	};
+
+	template<typename T, size_t N, typename Alloc>
+	inline T* small_vector<T, N, Alloc>::inline_storage() {
+		return (T*)m_storage;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline small_vector<T, N, Alloc>::small_vector()
+		: m_first(inline_storage())
+		, m_last(inline_storage())
+		, m_capacity(inline_storage() + N)
+	{
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline small_vector<T, N, Alloc>::small_vector(const small_vector& other)
+		: m_first(inline_storage())
+		, m_last(inline_storage())
+		, m_capacity(inline_storage() + N)
+	{
+		copy_from(other);
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline small_vector<T, N, Alloc>::~small_vector() {
+		buffer_destroy_range(m_first, m_last);
+		if (m_first != inline_storage())
+			Alloc::static_deallocate(m_first, (size_t)((char*)m_capacity - (char*)m_first));
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline small_vector<T, N, Alloc>& small_vector<T, N, Alloc>::operator=(const small_vector& other) {
+		if (this != &other) {
+			clear();
+			copy_from(other);
+		}
+		return *this;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void small_vector<T, N, Alloc>::copy_from(const small_vector& other) {
+		reserve(other.size());
+		for (const T* it = other.m_first; it != other.m_last; ++it, ++m_last)
+			new(placeholder(), m_last) T(*it);
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline const T* small_vector<T, N, Alloc>::data() const {
+		return m_first;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline T* small_vector<T, N, Alloc>::data() {
+		return m_first;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline size_t small_vector<T, N, Alloc>::size() const {
+		return (size_t)(m_last - m_first);
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline size_t small_vector<T, N, Alloc>::capacity() const {
+		return (size_t)(m_capacity - m_first);
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline bool small_vector<T, N, Alloc>::empty() const {
+		return m_last == m_first;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline T& small_vector<T, N, Alloc>::operator[](size_t idx) {
+		return m_first[idx];
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline const T& small_vector<T, N, Alloc>::operator[](size_t idx) const {
+		return m_first[idx];
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline const T& small_vector<T, N, Alloc>::front() const {
+		return m_first[0];
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline T& small_vector<T, N, Alloc>::front() {
+		return m_first[0];
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline const T& small_vector<T, N, Alloc>::back() const {
+		return m_last[-1];
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline T& small_vector<T, N, Alloc>::back() {
+		return m_last[-1];
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void small_vector<T, N, Alloc>::resize(size_t size) {
+		reserve(size);
+		buffer_fill_urange(m_last, m_first + size);
+		buffer_destroy_range(m_first + size, m_last);
+		m_last = m_first + size;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void small_vector<T, N, Alloc>::resize(size_t size, const T& value) {
+		reserve(size);
+		buffer_fill_urange(m_last, m_first + size, value);
+		buffer_destroy_range(m_first + size, m_last);
+		m_last = m_first + size;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void small_vector<T, N, Alloc>::clear() {
+		// Keeps the heap storage, if any
+		buffer_destroy_range(m_first, m_last);
+		m_last = m_first;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void small_vector<T, N, Alloc>::reserve(size_t capacity) {
+		if (m_first + capacity <= m_capacity)
+			return;
+
+		const size_t size = (size_t)(m_last - m_first);
+		T* newfirst = (T*)Alloc::static_allocate(sizeof(T) * capacity);
+		buffer_move_urange(newfirst, m_first, m_last);
+		if (m_first != inline_storage())
+			Alloc::static_deallocate(m_first, (size_t)((char*)m_capacity - (char*)m_first));
+
+		m_first = newfirst;
+		m_last = newfirst + size;
+		m_capacity = newfirst + capacity;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void small_vector<T, N, Alloc>::push_back(const T& t) {
+		if (m_last == m_capacity) {
+			// t may be an element of this vector
+			const T copy(t);
+			reserve(capacity() ? 2 * capacity() : 1);
+			new(placeholder(), m_last) T(copy);
+		} else {
+			new(placeholder(), m_last) T(t);
+		}
+		++m_last;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void small_vector<T, N, Alloc>::pop_back() {
+		buffer_destroy_range(m_last - 1, m_last);
+		--m_last;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::begin() {
+		return m_first;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::end() {
+		return m_last;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline typename small_vector<T, N, Alloc>::const_iterator small_vector<T, N, Alloc>::begin() const {
+		return m_first;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline typename small_vector<T, N, Alloc>::const_iterator small_vector<T, N, Alloc>::end() const {
+		return m_last;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::erase(iterator where) {
+		return erase(where, where + 1);
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::erase(iterator first, iterator last) {
+		const size_t count = (size_t)(last - first);
+		for (T* it = last, *dest = first; it != m_last; ++it, ++dest)
+			move(*dest, *it);
+
+		buffer_destroy_range(m_last - count, m_last);
+		m_last -= count;
+		return first;
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::erase_unordered(iterator where) {
+		if (where + 1 != m_last)
+			move(*where, *(m_last - 1));
+
+		pop_back();
+		return where;
+	}
+}
+
+#endif
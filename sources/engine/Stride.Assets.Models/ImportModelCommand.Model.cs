@@ -10,6 +10,7 @@ using Stride.Core.Extensions;
 using Stride.Core.Mathematics;
 using Stride.Core.Serialization;
 using Stride.Core.Serialization.Contents;
+using Stride.Core.Threading;
 using Stride.Extensions;
 using Stride.Graphics;
 using Stride.Graphics.Data;
@@ -25,6 +26,10 @@ namespace Stride.Assets.Models
 
         public bool MergeMeshes { get; set; }
 
+        public bool OptimizeMeshes { get; set; }
+
+        public bool CompressTextureCoordinates { get; set; }
+
         public bool Allow32BitIndex { get; set; }
         public int MaxInputSlots { get; set; }
         public bool DeduplicateMaterials { get; set; }
@@ -244,6 +249,23 @@ namespace Stride.Assets.Models
             // split the meshes if necessary
             model.Meshes = SplitExtensions.SplitMeshes(model.Meshes, Allow32BitIndex);
 
+            // Reorder triangles and vertices for the GPU caches and pack vertices, meshes don't share anything so they are processed in parallel
+            if (OptimizeMeshes || CompressTextureCoordinates)
+            {
+                var drawMeshes = model.Meshes.Select(x => x.Draw).Distinct().ToList();
+                Dispatcher.ForEach(drawMeshes, drawMesh =>
+                {
+                    if (OptimizeMeshes)
+                        drawMesh.Optimize();
+
+                    if (CompressTextureCoordinates)
+                    {
+                        for (int vbIdx = 0; vbIdx < drawMesh.VertexBuffers.Length; vbIdx++)
+                            HalfBufferExtensions.CompactHalfTextureCoordinates(ref drawMesh.VertexBuffers[vbIdx]);
+                    }
+                });
+            }
+
             // Refresh skeleton updater with asset skeleton
             hierarchyUpdater = new SkeletonUpdater(skeleton);
             hierarchyUpdater.UpdateMatrices();
@@ -76,6 +76,28 @@ namespace Stride.Assets.Models
         [DefaultValue(true)]
         public bool MergeMeshes { get; set; } = true;
 
+        /// <summary>
+        /// Gets or sets whether the triangles and vertices of the meshes are reordered for the GPU caches.
+        /// </summary>
+        /// <userdoc>
+        /// When checked, the triangles and vertices of the meshes are reordered so that the GPU transforms fewer vertices and draws fewer hidden pixels.
+        /// Duplicate vertices are merged. This doesn't change how the model looks.
+        /// </userdoc>
+        [DataMember(37)]
+        [DefaultValue(true)]
+        public bool OptimizeMeshes { get; set; } = true;
+
+        /// <summary>
+        /// Gets or sets whether texture coordinates are stored as half floats.
+        /// </summary>
+        /// <userdoc>
+        /// When checked, texture coordinates are stored as 16-bit floats, which makes vertices smaller.
+        /// They lose precision for textures larger than 2048 pixels or coordinates far from 0 (tiling), so check the model looks right.
+        /// </userdoc>
+        [DataMember(38)]
+        [DefaultValue(false)]
+        public bool CompressTextureCoordinates { get; set; }
+
         /// <inheritdoc/>
         [DataMember(40)]
         [MemberCollection(ReadOnly = true)]
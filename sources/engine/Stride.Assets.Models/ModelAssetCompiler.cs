@@ -65,6 +65,8 @@ namespace Stride.Assets.Models
             importModelCommand.ScaleImport = asset.ScaleImport;
             importModelCommand.PivotPosition = asset.PivotPosition;
             importModelCommand.MergeMeshes = asset.MergeMeshes;
+            importModelCommand.OptimizeMeshes = asset.OptimizeMeshes;
+            importModelCommand.CompressTextureCoordinates = asset.CompressTextureCoordinates;
             importModelCommand.DeduplicateMaterials = asset.DeduplicateMaterials;
             importModelCommand.ModelModifiers = asset.Modifiers;
 
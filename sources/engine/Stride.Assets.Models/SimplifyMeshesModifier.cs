@@ -0,0 +1,60 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.ComponentModel;
+using System.Linq;
+using Stride.Core;
+using Stride.Core.Annotations;
+using Stride.Core.BuildEngine;
+using Stride.Core.Threading;
+using Stride.Extensions;
+using Stride.Rendering;
+
+namespace Stride.Assets.Models
+{
+    /// <summary>
+    /// Reduces the number of triangles of the meshes of a model, to build a cheaper level of detail of another model.
+    /// </summary>
+    [DataContract("SimplifyMeshesModifier")]
+    [Display("Simplify meshes")]
+    public class SimplifyMeshesModifier : IModelModifier
+    {
+        /// <summary>
+        /// Gets or sets the fraction of the triangles of each mesh to keep.
+        /// </summary>
+        /// <userdoc>The fraction of the triangles of each mesh to keep. Meshes keep more triangles if removing them would exceed the maximum error.</userdoc>
+        [DataMember(10)]
+        [DefaultValue(0.5f)]
+        [DataMemberRange(0, 1, 0.01, 0.1, 2)]
+        public float TriangleRatio { get; set; } = 0.5f;
+
+        /// <summary>
+        /// Gets or sets the largest error allowed, relative to the size of each mesh.
+        /// </summary>
+        /// <userdoc>The largest change of shape allowed, relative to the size of each mesh (0.01 is 1% of its largest side).</userdoc>
+        [DataMember(20)]
+        [DefaultValue(0.01f)]
+        [DataMemberRange(0, 1, 0.001, 0.01, 3)]
+        public float MaximumError { get; set; } = 0.01f;
+
+        // Only the version is hashed, so it includes the settings (HashCode.Combine is not stable between runs)
+        /// <inheritdoc/>
+        public int Version => unchecked((1 * 397 + BitConverter.SingleToInt32Bits(TriangleRatio)) * 397 + BitConverter.SingleToInt32Bits(MaximumError));
+
+        /// <inheritdoc/>
+        public void Apply(ICommandContext commandContext, Model model)
+        {
+            // Each mesh only gets a new index buffer, so they are simplified in parallel
+            var drawMeshes = model.Meshes.Select(x => x.Draw).Distinct().ToList();
+            var simplified = new bool[drawMeshes.Count];
+            Dispatcher.For(0, drawMeshes.Count, i => simplified[i] = drawMeshes[i].Simplify(TriangleRatio, MaximumError, out _));
+
+            for (int i = 0; i < drawMeshes.Count; i++)
+            {
+                if (!simplified[i])
+                    commandContext.Logger.Warning("A mesh of the model could not be simplified, only indexed triangle lists with a single vertex buffer and float positions are supported.");
+            }
+        }
+    }
+}
@@ -297,7 +297,8 @@ namespace Stride.Audio
         /// <param name="pcm">The pointer to PCM data</param>
         /// <param name="bufferSize">The full size in bytes of PCM data</param>
         /// <param name="type">If this buffer is the last buffer of the stream set to true, if not false</param>
-        protected void FillBuffer(IntPtr pcm, int bufferSize, AudioLayer.BufferType type)
+        /// <returns><c>false</c> if the source already holds <see cref="MaxNumberOfBuffers"/> buffers, the data is then dropped</returns>
+        protected bool FillBuffer(IntPtr pcm, int bufferSize, AudioLayer.BufferType type)
         {
             if (bufferSize > nativeBufferSizeBytes)
             {
@@ -306,13 +307,24 @@ namespace Stride.Audio
             }
 
             var buffer = freeBuffers.Dequeue();
-            AudioLayer.SourceQueueBuffer(soundInstance.Source, buffer, pcm, bufferSize, type);
-            if (readyToPlay) return;
+            if (!AudioLayer.SourceQueueBuffer(soundInstance.Source, buffer, pcm, bufferSize, type))
+            {
+                Logger.Error("The audio source couldn't queue more buffers. Data will be dropped.");
+                freeBuffers.Enqueue(buffer);
+
+                // The source would otherwise never reach the end of the stream
+                if (type == AudioLayer.BufferType.EndOfStream)
+                    StopInternal(false);
+                return false;
+            }
+
+            if (readyToPlay) return true;
 
             prebufferedCount++;
-            if (prebufferedCount < prebufferedTarget) return;
+            if (prebufferedCount < prebufferedTarget) return true;
             readyToPlay = true;
             ReadyToPlay.TrySetResult(true);
+            return true;
         }
 
         /// <summary>
@@ -321,12 +333,12 @@ namespace Stride.Audio
         /// <param name="pcm">The array containing PCM data</param>
         /// <param name="bufferSize">The full size in bytes of PCM data</param>
         /// <param name="type">If this buffer is the last buffer of the stream set to true, if not false</param>
-        protected unsafe void FillBuffer(short[] pcm, int bufferSize, AudioLayer.BufferType type)
+        protected unsafe bool FillBuffer(short[] pcm, int bufferSize, AudioLayer.BufferType type)
         {
             Debug.Assert((uint)bufferSize <= (uint)pcm.Length << 1);
             fixed (void* pcmBuffer = pcm)
             {
-                FillBuffer(new IntPtr(pcmBuffer), bufferSize, type);
+                return FillBuffer(new IntPtr(pcmBuffer), bufferSize, type);
             }
         }
         /// <summary>
@@ -335,12 +347,12 @@ namespace Stride.Audio
         /// <param name="pcm">The array containing PCM data</param>
         /// <param name="bufferSize">The full size in bytes of PCM data</param>
         /// <param name="type">If this buffer is the last buffer of the stream set to true, if not false</param>
-        protected unsafe void FillBuffer(byte[] pcm, int bufferSize, AudioLayer.BufferType type)
+        protected unsafe bool FillBuffer(byte[] pcm, int bufferSize, AudioLayer.BufferType type)
         {
             Debug.Assert((uint)bufferSize <= (uint)pcm.Length);
             fixed (void* pcmBuffer = pcm)
             {
-                FillBuffer(new IntPtr(pcmBuffer), bufferSize, type);
+                return FillBuffer(new IntPtr(pcmBuffer), bufferSize, type);
             }
         }
 
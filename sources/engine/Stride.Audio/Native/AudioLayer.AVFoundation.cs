@@ -7,6 +7,7 @@ using System.Runtime.InteropServices;
 using AVFoundation;
 using Foundation;
 using Stride.Core.Mathematics;
+using Stride.Native;
 
 namespace Stride.Audio
 {
@@ -147,6 +148,27 @@ namespace Stride.Audio
             // AVAudioEngine is push-driven; no per-frame work required.
         }
 
+        internal static unsafe void MemoryGetStats(NativeMemoryStats* stats)
+        {
+            // No native allocations on this backend.
+            *stats = default;
+        }
+
+        internal static void TraceEnable(bool enabled)
+        {
+            // No native zones on this backend.
+        }
+
+        internal static unsafe int TraceDrain(NativeTraceEvent* events, int capacity)
+        {
+            return 0;
+        }
+
+        internal static long TraceDroppedCount()
+        {
+            return 0;
+        }
+
         public static void SetMasterVolume(Device device, float volume)
         {
             var dev = ResolveHandle<ManagedDevice>(device.Ptr);
@@ -332,11 +354,11 @@ namespace Stride.Audio
             }
         }
 
-        public static void SourceQueueBuffer(Source source, Buffer buffer, IntPtr pcm, int bufferSize, BufferType streamType)
+        public static bool SourceQueueBuffer(Source source, Buffer buffer, IntPtr pcm, int bufferSize, BufferType streamType)
         {
             var src = ResolveHandle<ManagedSource>(source.Ptr);
             var buf = ResolveHandle<ManagedBuffer>(buffer.Ptr);
-            if (src?.Player == null || buf == null) return;
+            if (src?.Player == null || buf == null) return false;
             // Caller already wrote PCM into the buffer's AVAudioPcmBuffer via BufferFill. Just schedule.
             buf.StreamType = streamType;
             buf.Scheduled = true;
@@ -354,6 +376,7 @@ namespace Stride.Audio
                     }
                 });
             }
+            return true;
         }
 
         public static Buffer SourceGetFreeBuffer(Source source)
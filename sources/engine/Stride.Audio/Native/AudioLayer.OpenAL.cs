@@ -5,6 +5,7 @@ using System;
 using System.Runtime.InteropServices;
 using System.Security;
 using Stride.Core.Mathematics;
+using Stride.Native;
 
 namespace Stride.Audio
 {
@@ -92,7 +93,7 @@ namespace Stride.Audio
 
         [SuppressUnmanagedCodeSecurity]
         [DllImport(NativeInvoke.Library, EntryPoint = "xnAudioSourceQueueBuffer", CallingConvention = CallingConvention.Cdecl)]
-        public static extern void SourceQueueBuffer(Source source, Buffer buffer, IntPtr pcm, int bufferSize, BufferType streamType);
+        public static extern bool SourceQueueBuffer(Source source, Buffer buffer, IntPtr pcm, int bufferSize, BufferType streamType);
 
         [SuppressUnmanagedCodeSecurity]
         [DllImport(NativeInvoke.Library, EntryPoint = "xnAudioSourceGetFreeBuffer", CallingConvention = CallingConvention.Cdecl)]
@@ -137,6 +138,34 @@ namespace Stride.Audio
         [SuppressUnmanagedCodeSecurity]
         [DllImport(NativeInvoke.Library, EntryPoint = "xnAudioSourceIsPlaying", CallingConvention = CallingConvention.Cdecl)]
         public static extern bool SourceIsPlaying(Source source);
+
+        /// <summary>
+        /// Fills <paramref name="stats"/> with the native allocations of libstrideaudio, which are only counted when it was built with native memory tracking.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(NativeInvoke.Library, EntryPoint = "xnAudioMemoryGetStats", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void MemoryGetStats(NativeMemoryStats* stats);
+
+        /// <summary>
+        /// Enables or disables the tracing of the native zones of libstrideaudio.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(NativeInvoke.Library, EntryPoint = "xnAudioTraceEnable", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void TraceEnable(bool enabled);
+
+        /// <summary>
+        /// Moves up to <paramref name="capacity"/> zones traced by libstrideaudio to <paramref name="events"/>, and returns their count.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(NativeInvoke.Library, EntryPoint = "xnAudioTraceDrain", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int TraceDrain(NativeTraceEvent* events, int capacity);
+
+        /// <summary>
+        /// Gets the number of zones of libstrideaudio dropped because a thread buffer was full.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(NativeInvoke.Library, EntryPoint = "xnAudioTraceDroppedCount", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern long TraceDroppedCount();
     }
 }
 #endif
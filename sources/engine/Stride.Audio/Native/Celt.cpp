@@ -2,6 +2,7 @@
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 
 #include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeTrace.h"
 #include "../../Stride.Native/StrideNative.h"
 #define HAVE_STDINT_H
 #include "../../../../deps/Celt/include/opus_custom.h"
@@ -58,21 +59,29 @@ extern "C" {
 
 	DLL_EXPORT_API int xnCeltEncodeFloat(StrideCelt* celt, float* inputSamples, int numberOfInputSamples, uint8_t* outputBuffer, int maxOutputSize)
 	{
+		NP_TRACE_SCOPE("xnCeltEncodeFloat");
+
 		return opus_custom_encode_float(celt->GetEncoder(), inputSamples, numberOfInputSamples, outputBuffer, maxOutputSize);
 	}
 
 	DLL_EXPORT_API int xnCeltDecodeFloat(StrideCelt* celt, uint8_t* inputBuffer, int inputBufferSize, float* outputBuffer, int numberOfOutputSamples)
 	{
+		NP_TRACE_SCOPE("xnCeltDecodeFloat");
+
 		return opus_custom_decode_float(celt->GetDecoder(), inputBuffer, inputBufferSize, outputBuffer, numberOfOutputSamples);
 	}
 
 	DLL_EXPORT_API int xnCeltEncodeShort(StrideCelt* celt, int16_t* inputSamples, int numberOfInputSamples, uint8_t* outputBuffer, int maxOutputSize)
 	{
+		NP_TRACE_SCOPE("xnCeltEncodeShort");
+
 		return opus_custom_encode(celt->GetEncoder(), inputSamples, numberOfInputSamples, outputBuffer, maxOutputSize);
 	}
 
 	DLL_EXPORT_API int xnCeltDecodeShort(StrideCelt* celt, uint8_t* inputBuffer, int inputBufferSize, int16_t* outputBuffer, int numberOfOutputSamples)
 	{
+		NP_TRACE_SCOPE("xnCeltDecodeShort");
+
 		return opus_custom_decode(celt->GetDecoder(), inputBuffer, inputBufferSize, outputBuffer, numberOfOutputSamples);
 	}
 }
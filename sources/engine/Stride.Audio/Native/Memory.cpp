@@ -0,0 +1,17 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#define NATIVEPATH_MEMORY_IMPLEMENTATION
+#include "../../../deps/NativePath/NativeMemory.h"
+#include "../../Stride.Native/StrideNative.h"
+
+extern "C" {
+	/*
+	* Fills stats with the native allocations of libstrideaudio, see npMemoryGetStats.
+	*/
+	DLL_EXPORT_API void xnAudioMemoryGetStats(npMemoryStats* stats)
+	{
+		npMemoryGetStats(stats);
+	}
+}
@@ -7,11 +7,13 @@
 
 #include "../../../deps/NativePath/NativePath.h"
 #include "../../../deps/NativePath/NativeDynamicLinking.h"
+#define NP_MEMORY_SUBSYSTEM NP_MEMORY_SUBSYSTEM_AUDIO
 #include "../../../deps/NativePath/NativeMemory.h"
 #include "../../../deps/NativePath/NativeThreading.h"
-#include "../../../deps/NativePath/TINYSTL/unordered_set.h"
-#include "../../../deps/NativePath/TINYSTL/unordered_map.h"
-#include "../../../deps/NativePath/TINYSTL/vector.h"
+#include "../../../deps/NativePath/NativeTrace.h"
+#include "../../../deps/NativePath/TINYSTL/flat_hash_set.h"
+#include "../../../deps/NativePath/TINYSTL/flat_hash_map.h"
+#include "../../../deps/NativePath/TINYSTL/small_vector.h"
 #include "../../Stride.Native/StrideNative.h"
 
 
@@ -211,7 +213,7 @@ extern "C" {
 		{
 			ALCdevice* device;
 			SpinLock deviceLock;
-			tinystl::unordered_set<xnAudioListener*> listeners;
+			tinystl::flat_hash_set<xnAudioListener*> listeners;
 		};
 
 		struct xnAudioBuffer
@@ -229,8 +231,8 @@ extern "C" {
 		{
 			xnAudioDevice* device;
 			ALCcontext* context;
-			tinystl::unordered_set<xnAudioSource*> sources;
-			tinystl::unordered_map<ALuint, xnAudioBuffer*> buffers;
+			tinystl::flat_hash_set<xnAudioSource*> sources;
+			tinystl::flat_hash_map<ALuint, xnAudioBuffer*> buffers;
 		};
 
 		struct xnAudioSource
@@ -246,7 +248,8 @@ extern "C" {
 
 			xnAudioBuffer* singleBuffer;
 
-			tinystl::vector<xnAudioBuffer*> freeBuffers;
+			// Inline for the few buffers of a streamed source, only flushing a source with many buffers allocates
+			tinystl::small_vector<xnAudioBuffer*, 8> freeBuffers;
 		};
 
 		DLL_EXPORT_API xnAudioDevice* xnAudioCreate(const char* deviceName, int flags)
@@ -271,6 +274,8 @@ extern "C" {
 
 		DLL_EXPORT_API void xnAudioUpdate(xnAudioDevice* device)
 		{
+			NP_TRACE_SCOPE("xnAudioUpdate");
+
 			device->deviceLock.Lock();
 
 			for (auto listener : device->listeners)
@@ -526,8 +531,10 @@ extern "C" {
 			SourceI(source->source, AL_BUFFER, buffer->buffer);
 		}
 
-		DLL_EXPORT_API void xnAudioSourceQueueBuffer(xnAudioSource* source, xnAudioBuffer* buffer, short* pcm, int bufferSize, BufferType type)
+		DLL_EXPORT_API npBool xnAudioSourceQueueBuffer(xnAudioSource* source, xnAudioBuffer* buffer, short* pcm, int bufferSize, BufferType type)
 		{
+			NP_TRACE_SCOPE("xnAudioSourceQueueBuffer");
+
 			ContextState lock(source->listener->context);
 
 			buffer->type = type;
@@ -535,6 +542,7 @@ extern "C" {
 			BufferData(buffer->buffer, source->mono ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16, pcm, bufferSize, source->sampleRate);
 			SourceQueueBuffers(source->source, 1, &buffer->buffer);
 			source->listener->buffers[buffer->buffer] = buffer;
+			return true;
 		}
 
 		DLL_EXPORT_API xnAudioBuffer* xnAudioSourceGetFreeBuffer(xnAudioSource* source)
@@ -706,6 +714,8 @@ extern "C" {
 
 		DLL_EXPORT_API void xnAudioBufferFill(xnAudioBuffer* buffer, short* pcm, int bufferSize, int sampleRate, npBool mono)
 		{
+			NP_TRACE_SCOPE("xnAudioBufferFill");
+
 			//we have to keep a copy sadly because we might need to offset the data at some point			
 			memcpy(buffer->pcm, pcm, bufferSize);
 			buffer->size = bufferSize;
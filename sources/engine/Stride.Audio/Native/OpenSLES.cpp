@@ -2,6 +2,7 @@
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 
 #include "Common.h"
+#define NP_MEMORY_SUBSYSTEM NP_MEMORY_SUBSYSTEM_AUDIO
 #include "../../../deps/NativePath/NativeMemory.h"
 
 #if defined(ANDROID) || !defined(__clang__)
@@ -10,8 +11,12 @@
 #include "../../../deps/NativePath/NativeDynamicLinking.h"
 #include "../../../deps/NativePath/NativeThreading.h"
 #include "../../../deps/NativePath/NativeMath.h"
+#include "../../../deps/NativePath/NativeFloat4.h"
+#include "../../../deps/NativePath/NativeTrace.h"
 #include "../../../deps/NativePath/TINYSTL/vector.h"
-#include "../../../deps/NativePath/TINYSTL/unordered_set.h"
+#include "../../../deps/NativePath/TINYSTL/small_vector.h"
+#include "../../../deps/NativePath/TINYSTL/ring_buffer.h"
+#include "../../../deps/NativePath/TINYSTL/flat_hash_set.h"
 #include "../../../../deps/OpenSLES/OpenSLES.h"
 #include "../../../../deps/OpenSLES/OpenSLES_Android.h"
 #include "../../Stride.Native/StrideNative.h"
@@ -87,7 +92,7 @@ extern "C" {
 			SLEngineItf engine;
 			SLObjectItf outputMix;
 			SpinLock deviceLock;
-			tinystl::unordered_set<xnAudioSource*> sources;
+			tinystl::flat_hash_set<xnAudioSource*> sources;
 			volatile float masterVolume = 1.0f;
 		};
 
@@ -107,6 +112,9 @@ extern "C" {
 			xnAudioDevice* audioDevice;
 		};
 
+// Buffers a source can queue, larger than what the streamed sources use (4)
+#define XN_AUDIO_MAX_SOURCE_BUFFERS 16
+
 		struct xnAudioSource
 		{
 			int sampleRate;
@@ -115,6 +123,7 @@ extern "C" {
 			bool looped;
 			volatile bool endOfStream;
 			bool canRateChange;
+			int maxQueuedBuffers;
 			SLpermille minRate;
 			SLpermille maxRate;
 			volatile float gain = 1.0f;
@@ -135,8 +144,9 @@ extern "C" {
 			SLVolumeItf volume;
 			SLPlaybackRateItf playRate;
 
-			tinystl::vector<xnAudioBuffer*> streamBuffers;
-			tinystl::vector<xnAudioBuffer*> freeBuffers;
+			// Stored inline, so that QueueCallback never allocates or shifts them on the audio thread
+			tinystl::ring_buffer<xnAudioBuffer*, XN_AUDIO_MAX_SOURCE_BUFFERS> streamBuffers;
+			tinystl::small_vector<xnAudioBuffer*, XN_AUDIO_MAX_SOURCE_BUFFERS> freeBuffers;
 			SpinLock buffersLock;
 		};
 
@@ -265,6 +275,8 @@ extern "C" {
 
 		void QueueCallback(SLAndroidSimpleBufferQueueItf bq, void *context)
 		{
+			NP_TRACE_SCOPE("QueueCallback");
+
 			(void)bq;
 			auto source = static_cast<xnAudioSource*>(context);
 			if(!source->streamed) //looped
@@ -296,7 +308,7 @@ extern "C" {
 				if (!source->streamBuffers.empty())
 				{
 					auto playedBuffer = source->streamBuffers.front();
-					source->streamBuffers.erase(source->streamBuffers.begin());
+					source->streamBuffers.pop_front();
 
 					if(playedBuffer->type == EndOfStream)
 					{
@@ -347,6 +359,7 @@ extern "C" {
 			res->mono = mono;
 			res->streamed = streamed;
 			res->looped = false;
+			res->maxQueuedBuffers = maxNBuffers < XN_AUDIO_MAX_SOURCE_BUFFERS ? maxNBuffers : XN_AUDIO_MAX_SOURCE_BUFFERS;
 
 			SLDataFormat_PCM format;
 			format.bitsPerSample = SL_PCMSAMPLEFORMAT_FIXED_16;
@@ -357,7 +370,7 @@ extern "C" {
 			format.endianness = SL_BYTEORDER_LITTLEENDIAN;
 			format.channelMask = mono ? SL_SPEAKER_FRONT_CENTER : SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT;
 
-			SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, (SLuint32) maxNBuffers };
+			SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, (SLuint32)res->maxQueuedBuffers };
 
 			SLDataSource audioSrc = { &bufferQueue, &format };
 			SLDataLocator_OutputMix outMix = { SL_DATALOCATOR_OUTPUTMIX, listener->audioDevice->outputMix };
@@ -571,9 +584,12 @@ extern "C" {
 			source->buffersLock.Unlock();
 		}
 
-		void xnAudioSourceQueueBuffer(xnAudioSource* source, xnAudioBuffer* buffer, short* pcm, int bufferSize, BufferType type)
+		// Returns false when the source already has as many queued buffers as given to xnAudioSourceCreate, the buffer then stays with the caller
+		npBool xnAudioSourceQueueBuffer(xnAudioSource* source, xnAudioBuffer* buffer, short* pcm, int bufferSize, BufferType type)
 		{
-			if (!source->streamed) return;
+			NP_TRACE_SCOPE("xnAudioSourceQueueBuffer");
+
+			if (!source->streamed) return false;
 
 			buffer->type = type;
 			buffer->dataLength = bufferSize;
@@ -581,10 +597,18 @@ extern "C" {
 
 			source->buffersLock.Lock();
 
+			// The OpenSL queue has the same capacity, so both are full at the same time
+			if ((int)source->streamBuffers.size() >= source->maxQueuedBuffers || (*source->queue)->Enqueue(source->queue, (void*)buffer->dataPtr, buffer->dataLength) != SL_RESULT_SUCCESS)
+			{
+				source->buffersLock.Unlock();
+				return false;
+			}
+
 			source->streamBuffers.push_back(buffer);
-			(*source->queue)->Enqueue(source->queue, (void*)buffer->dataPtr, buffer->dataLength);
 
 			source->buffersLock.Unlock();
+
+			return true;
 		}
 
 		xnAudioBuffer* xnAudioSourceGetFreeBuffer(xnAudioSource* source)
@@ -663,17 +687,10 @@ extern "C" {
 
 		void xnAudioListenerPush3D(xnAudioListener* listener, float* pos, float* forward, float* up, float* vel, Matrix* worldTransform)
 		{
-			memcpy(&listener->pos, pos, sizeof(float) * 3);
-			memcpy(&listener->forward, forward, sizeof(float) * 3);
-			memcpy(&listener->up, up, sizeof(float) * 3);
-			memcpy(&listener->velocity, vel, sizeof(float) * 3);
-
-#ifdef __clang__ //resharper does not know about opencl vectors
-			listener->pos.w = 0;
-			listener->forward.w = 0;
-			listener->up.w = 0;
-			listener->velocity.w = 0;
-#endif
+			listener->pos = npLoad3F4(pos);
+			listener->forward = npLoad3F4(forward);
+			listener->up = npLoad3F4(up);
+			listener->velocity = npLoad3F4(vel);
 		}
 
 		const float SoundSpeed = 343.0f;
@@ -685,22 +702,11 @@ extern "C" {
 
 		void xnAudioSourcePush3D(xnAudioSource* source, float* ppos, float* pforward, float* pup, float* pvel, Matrix* worldTransform)
 		{
-			float4 pos;
-			memcpy(&pos, ppos, sizeof(float) * 3);
-			float4 forward;
-			memcpy(&forward, pforward, sizeof(float) * 3);
-			float4 up;
-			memcpy(&up, pup, sizeof(float) * 3);
-			float4 vel;
-			memcpy(&vel, pvel, sizeof(float) * 3);
+			float4 pos = npLoad3F4(ppos);
+			float4 vel = npLoad3F4(pvel);
 
 #ifdef __clang__ //resharper does not know about opencl vectors
 
-			pos.w = 0;
-			forward.w = 0;
-			up.w = 0;
-			vel.w = 0;
-
 			// To evaluate the Doppler effect we calculate the distance to the listener from one wave to the next one and divide it by the sound speed
 			// we use 343m/s for the sound speed which correspond to the sound speed in the air.
 			// we use 600Hz for the sound frequency which correspond to the middle of the human hearable sounds frequencies.
@@ -711,7 +717,7 @@ extern "C" {
 			auto distListEmit = npLengthF4(vecListEmit);
 
 			// avoid useless calculations.
-			if (!(vel.x == 0 && vel.y == 0 && vel.z == 0 && source->listener->velocity.x == 0 && source->listener->velocity.y == 0 && source->listener->velocity.z == 0))
+			if (!npAllI4((vel == 0.0f) & (source->listener->velocity == 0.0f)))
 			{
 				auto vecListEmitNorm = vecListEmit;
 				if (distListEmit > ZeroTolerance)
@@ -721,7 +727,7 @@ extern "C" {
 				}
 
 				auto vecListEmitSpeed = vel - source->listener->velocity;
-				auto speedDot = vecListEmitSpeed[0] * vecListEmitNorm[0] + vecListEmitSpeed[1] * vecListEmitNorm[1] + vecListEmitSpeed[2] * vecListEmitNorm[2];
+				auto speedDot = npDot3F4(vecListEmitSpeed, vecListEmitNorm);
 				if (speedDot < -SoundSpeed) // emitter and listener are getting closer more quickly than the speed of the sound.
 				{
 					dopplerShift = MaxValue; //positive infinity
@@ -737,7 +743,7 @@ extern "C" {
 						lastWaveDistToListener = distListEmit - DistLastWave;
 
 					auto nextVecListEmit = vecListEmit + SoundPeriod * vecListEmitSpeed;
-					auto nextWaveDistToListener = sqrtf(nextVecListEmit[0] * nextVecListEmit[0] + nextVecListEmit[1] * nextVecListEmit[1] + nextVecListEmit[2] * nextVecListEmit[2]);
+					auto nextWaveDistToListener = sqrtf(npDot3F4(nextVecListEmit, nextVecListEmit));
 					auto timeBetweenTwoWaves = timeSinceLastWaveArrived + (nextWaveDistToListener - lastWaveDistToListener) / SoundSpeed;
 					auto apparentFrequency = 1 / timeBetweenTwoWaves;
 					dopplerShift = apparentFrequency / SoundFreq;
@@ -766,17 +772,9 @@ extern "C" {
 			auto repartRight = 0.5f;
 			float4 rightVec = npCrossProductF4(source->listener->forward, source->listener->up);
 
-			float4 worldToList[4];
-			npMatrixIdentityF4(worldToList);
-			worldToList[0].x = rightVec.x;
-			worldToList[0].y = source->listener->forward.x;
-			worldToList[0].z = source->listener->up.x;
-			worldToList[1].x = rightVec.y;
-			worldToList[1].y = source->listener->forward.y;
-			worldToList[1].z = source->listener->up.y;
-			worldToList[2].x = rightVec.z;
-			worldToList[2].y = source->listener->forward.z;
-			worldToList[2].z = source->listener->up.z;
+			// Rows are the listener base vectors, transposed into the world to listener rotation
+			float4 worldToList[4] = { rightVec, source->listener->forward, source->listener->up, { 0.0f, 0.0f, 0.0f, 1.0f } };
+			npTransposeF4(worldToList);
 
 			auto vecListEmitListBase = npTransformNormalF4(vecListEmit, worldToList);
 			auto vecListEmitListBaseLen = npLengthF4(vecListEmitListBase);
@@ -819,6 +817,8 @@ extern "C" {
 
 		void xnAudioBufferFill(xnAudioBuffer* buffer, short* pcm, int bufferSize, int sampleRate, npBool mono)
 		{
+			NP_TRACE_SCOPE("xnAudioBufferFill");
+
 			(void)sampleRate;
 			(void)mono;
 			buffer->type = EndOfStream;
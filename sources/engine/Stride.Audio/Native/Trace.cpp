@@ -0,0 +1,33 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#define NATIVEPATH_TRACE_IMPLEMENTATION
+#include "../../../deps/NativePath/NativeTrace.h"
+#include "../../Stride.Native/StrideNative.h"
+
+extern "C" {
+	/*
+	* Enables or disables the tracing of the zones of libstrideaudio.
+	*/
+	DLL_EXPORT_API void xnAudioTraceEnable(npBool enabled)
+	{
+		npTraceEnable(enabled);
+	}
+
+	/*
+	* Moves up to capacity zones traced by libstrideaudio to events, returns their count.
+	*/
+	DLL_EXPORT_API int xnAudioTraceDrain(npTraceEvent* events, int capacity)
+	{
+		return npTraceDrain(events, capacity);
+	}
+
+	/*
+	* Number of zones of libstrideaudio dropped because a thread buffer was full.
+	*/
+	DLL_EXPORT_API int64_t xnAudioTraceDroppedCount()
+	{
+		return npTraceDroppedCount();
+	}
+}
@@ -8,6 +8,7 @@
 #include "../../../deps/NativePath/NativePath.h"
 #include "../../../deps/NativePath/NativeThreading.h"
 #include "../../../deps/NativePath/NativeDynamicLinking.h"
+#include "../../../deps/NativePath/NativeTrace.h"
 #include "../../Stride.Native/StrideNative.h"
 
 extern "C" {
@@ -1686,8 +1687,10 @@ extern "C" {
 			}
 		}
 
-		DLL_EXPORT_API void xnAudioSourceQueueBuffer(xnAudioSource* source, xnAudioBuffer* buffer, short* pcm, int bufferSize, BufferType type)
+		DLL_EXPORT_API npBool xnAudioSourceQueueBuffer(xnAudioSource* source, xnAudioBuffer* buffer, short* pcm, int bufferSize, BufferType type)
 		{
+			NP_TRACE_SCOPE("xnAudioSourceQueueBuffer");
+
 			//used only when streaming, to fill a buffer, often..
 			source->streamed_ = true;
 
@@ -1697,7 +1700,7 @@ extern "C" {
 			
 			buffer->length_ = buffer->buffer_.AudioBytes = bufferSize;
 			memcpy(const_cast<char*>(buffer->buffer_.pAudioData), pcm, bufferSize);
-			source->source_voice_->SubmitSourceBuffer(&buffer->buffer_);
+			return !FAILED(source->source_voice_->SubmitSourceBuffer(&buffer->buffer_));
 		}
 
 		DLL_EXPORT_API void xnAudioSourcePause(xnAudioSource* source)
@@ -1769,8 +1772,7 @@ extern "C" {
 			{
 				Matrix localTransform;
 				Matrix invListener;
-				memcpy(&invListener, &source->listener_->worldTransform_, sizeof(Matrix));
-				xnMatrixInvert(&invListener);
+				xnMatrixInvert(&source->listener_->worldTransform_, &invListener);
 				xnMatrixMultiply(worldTransform, &invListener, &localTransform);
 
 				HrtfPosition hrtfEmitterPos{ localTransform.Flat.M41, localTransform.Flat.M42, localTransform.Flat.M43 };
@@ -1836,6 +1838,8 @@ extern "C" {
 
 		DLL_EXPORT_API void xnAudioBufferFill(xnAudioBuffer* buffer, short* pcm, int bufferSize, int sampleRate, npBool mono)
 		{
+			NP_TRACE_SCOPE("xnAudioBufferFill");
+
 			(void)sampleRate;
 			
 			buffer->buffer_.AudioBytes = bufferSize;
@@ -0,0 +1,50 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Native;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Runs native kernels with only the CPU features of their baseline variants, to compare them with the variants picked for this CPU.
+    /// </summary>
+    /// <remarks>
+    /// The features are global to libstride, so the tests using it belong to the non-parallel <see cref="NativeCpuFeaturesCollection"/>.
+    /// </remarks>
+    public sealed class NativeCpuFeaturesFixture : IDisposable
+    {
+        /// <summary>
+        /// Gets whether this CPU has features the baseline variants don't use, i.e. whether <see cref="RunBaseline"/> runs different code.
+        /// </summary>
+        public bool HasWiderVariants => (NativeInvoke.CpuFeatures() & ~NativeInvoke.BaselineCpuFeatures) != NativeCpuFeatures.None;
+
+        /// <summary>
+        /// Runs <paramref name="action"/> with the baseline variants of the kernels.
+        /// </summary>
+        public void RunBaseline(Action action)
+        {
+            NativeInvoke.CpuDisableFeatures(~NativeInvoke.BaselineCpuFeatures);
+            try
+            {
+                action();
+            }
+            finally
+            {
+                NativeInvoke.CpuDisableFeatures(NativeCpuFeatures.None);
+            }
+        }
+
+        public void Dispose()
+        {
+            NativeInvoke.CpuDisableFeatures(NativeCpuFeatures.None);
+        }
+    }
+
+    [CollectionDefinition(Name, DisableParallelization = true)]
+    public class NativeCpuFeaturesCollection : ICollectionFixture<NativeCpuFeaturesFixture>
+    {
+        public const string Name = "Native CPU features";
+    }
+}
@@ -0,0 +1,113 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Collections.Generic;
+using System.Runtime.CompilerServices;
+using Xunit;
+using Stride.Animations;
+using Stride.Core.Mathematics;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the native sampling of optimized float, <see cref="Vector3"/> and <see cref="Vector4"/> curves with the managed
+    /// <see cref="AnimationCurveEvaluatorOptimizedFloatGroup"/>, <see cref="AnimationCurveEvaluatorOptimizedVector3Group"/> and
+    /// <see cref="AnimationCurveEvaluatorOptimizedVector4Group"/>.
+    /// </summary>
+    /// <remarks>
+    /// Quaternions are not compared: the native linear interpolation is a normalized lerp, where the managed one is a slerp.
+    /// </remarks>
+    public class TestAnimationSampling
+    {
+        [Fact]
+        public void TestFloatMatchesManaged()
+        {
+            TestMatchesManaged(new AnimationCurveEvaluatorOptimizedFloatGroup(), random => NextFloat(random, -10, 10));
+        }
+
+        [Fact]
+        public void TestVector3MatchesManaged()
+        {
+            TestMatchesManaged(new AnimationCurveEvaluatorOptimizedVector3Group(), random => new Vector3(NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10)));
+        }
+
+        [Fact]
+        public void TestVector4MatchesManaged()
+        {
+            TestMatchesManaged(new AnimationCurveEvaluatorOptimizedVector4Group(), random => new Vector4(NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10)));
+        }
+
+        private static unsafe void TestMatchesManaged<T>(AnimationCurveEvaluatorOptimizedGroup managed, Func<Random, T> nextValue) where T : unmanaged
+        {
+            const int ChannelCount = 9;
+            var random = new Random(8080);
+
+            // Every interpolation type, with 1 to 8 keys per channel
+            var curves = new List<KeyValuePair<string, AnimationCurve<T>>>();
+            for (int channel = 0; channel < ChannelCount; channel++)
+            {
+                var curve = new AnimationCurve<T> { InterpolationType = (AnimationCurveInterpolationType)(channel % 3) };
+                var time = CompressedTimeSpan.Zero;
+                var keyCount = channel % 8 + 1;
+                for (int key = 0; key < keyCount; key++)
+                {
+                    curve.KeyFrames.Add(new KeyFrameData<T>(time, nextValue(random)));
+                    time += CompressedTimeSpan.FromSeconds(NextFloat(random, 0.05f, 0.5f));
+                }
+                curves.Add(new KeyValuePair<string, AnimationCurve<T>>($"Channel{channel}", curve));
+            }
+
+            var animationData = AnimationData<T>.FromAnimationChannels(curves);
+
+            var native = AnimationCurveEvaluatorOptimizedGroup.Create<T>();
+            Assert.NotEqual(managed.GetType(), native.GetType());
+
+            managed.Initialize(animationData);
+            native.Initialize(animationData);
+
+            // One channel is not bound and must not be written
+            var elementSize = Unsafe.SizeOf<T>();
+            for (int channel = 1; channel < ChannelCount; channel++)
+            {
+                managed.SetChannelOffset($"Channel{channel}", channel * elementSize);
+                native.SetChannelOffset($"Channel{channel}", channel * elementSize);
+            }
+
+            var expected = new float[ChannelCount * elementSize / sizeof(float)];
+            var actual = new float[expected.Length];
+
+            // Play forward past the end of every curve, then seek back and play again
+            var times = new List<CompressedTimeSpan>();
+            for (var seconds = 0.0; seconds < 4.5; seconds += 0.07)
+                times.Add(CompressedTimeSpan.FromSeconds(seconds));
+            times.Add(CompressedTimeSpan.FromSeconds(0.3));
+            times.Add(CompressedTimeSpan.FromSeconds(0.9));
+            times.Add(CompressedTimeSpan.FromSeconds(0.1));
+
+            fixed (float* expectedPtr = expected)
+            fixed (float* actualPtr = actual)
+            {
+                foreach (var time in times)
+                {
+                    managed.Evaluate(time, (IntPtr)expectedPtr, null);
+                    native.Evaluate(time, (IntPtr)actualPtr, null);
+
+                    for (int i = 0; i < expected.Length; i++)
+                    {
+                        var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i]));
+                        Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Float {i} at {time}: expected {expected[i]}, got {actual[i]}");
+                    }
+                }
+            }
+
+            managed.Cleanup();
+            native.Cleanup();
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+    }
+}
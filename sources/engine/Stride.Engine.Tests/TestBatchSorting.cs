@@ -0,0 +1,105 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Linq;
+using Xunit;
+using Stride.Graphics;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Checks the draw order of <see cref="BatchBase{TDrawInfo}"/>: elements with equal depths or textures keep the order they were drawn in,
+    /// and custom comparers are still used when they are installed.
+    /// </summary>
+    public class TestBatchSorting
+    {
+        private const int Count = 300;
+
+        [Fact]
+        public void TestBackToFrontKeepsOrderOfEqualDepths()
+        {
+            var depths = CreateDepths(new Random(31));
+
+            using var batch = new TestBatch();
+            var order = batch.GetDrawOrder(SpriteSortMode.BackToFront, depths, new Texture[Count]);
+
+            Assert.Equal(Enumerable.Range(0, Count).OrderBy(i => depths[i]), order);
+        }
+
+        [Fact]
+        public void TestFrontToBackKeepsOrderOfEqualDepths()
+        {
+            var depths = CreateDepths(new Random(32));
+
+            using var batch = new TestBatch();
+            var order = batch.GetDrawOrder(SpriteSortMode.FrontToBack, depths, new Texture[Count]);
+
+            Assert.Equal(Enumerable.Range(0, Count).OrderByDescending(i => depths[i]), order);
+        }
+
+        [Fact]
+        public void TestTextureGroupsByFirstUseAndKeepsOrder()
+        {
+            var random = new Random(33);
+            var texturePool = new[] { new Texture(), new Texture(), null, new Texture() };
+            var textures = new Texture[Count];
+            for (int i = 0; i < Count; i++)
+                textures[i] = texturePool[random.Next(texturePool.Length)];
+
+            using var batch = new TestBatch();
+            var order = batch.GetDrawOrder(SpriteSortMode.Texture, new float[Count], textures);
+
+            // Textures are drawn in the order they are first used, null being a texture of its own
+            var expected = Enumerable.Range(0, Count).OrderBy(i => Array.FindIndex(textures, x => ReferenceEquals(x, textures[i])));
+            Assert.Equal(expected, order);
+        }
+
+        [Fact]
+        public void TestCustomComparerIsUsed()
+        {
+            // Distinct depths, so that the order doesn't depend on the stability of Array.Sort
+            var depths = Enumerable.Range(0, Count).Select(i => (float)((i * 7919) % Count)).ToArray();
+
+            using var batch = new TestBatch();
+            batch.UseDescendingBackToFront();
+            var order = batch.GetDrawOrder(SpriteSortMode.BackToFront, depths, new Texture[Count]);
+
+            Assert.Equal(Enumerable.Range(0, Count).OrderByDescending(i => depths[i]), order);
+        }
+
+        // Few distinct depths, negative and positive zeros included, so that most elements share their depth with others
+        private static float[] CreateDepths(Random random)
+        {
+            var depths = new float[Count];
+            for (int i = 0; i < Count; i++)
+                depths[i] = random.Next(5) switch { 0 => -0.0f, 1 => 0.0f, 2 => -1.5f, 3 => 0.25f, _ => 100.0f };
+            return depths;
+        }
+
+        private class TestBatch : BatchBase<int>
+        {
+            public TestBatch() : base(16)
+            {
+            }
+
+            public void UseDescendingBackToFront()
+            {
+                BackToFrontComparer = new DescendingDepthComparer();
+            }
+
+            protected override void UpdateBufferValuesFromElementInfo(ref ElementInfo elementInfo, IntPtr vertexPointer, IntPtr indexPointer, int vexterStartOffset)
+            {
+                throw new NotSupportedException();
+            }
+
+            private class DescendingDepthComparer : QueueComparer<ElementInfo>
+            {
+                public override int Compare(int left, int right)
+                {
+                    return ImageInfos[right].Depth.CompareTo(ImageInfos[left].Depth);
+                }
+            }
+        }
+    }
+}
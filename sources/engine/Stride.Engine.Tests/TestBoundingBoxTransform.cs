@@ -0,0 +1,144 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Native;
+using Stride.Rendering;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the native bounding box transform and merge, and the skinned bounding boxes of <see cref="ModelComponent"/> that use it,
+    /// with <see cref="BoundingBoxExt.Transform"/> and <see cref="BoundingBox.Merge(BoundingBox, BoundingBox)"/>.
+    /// </summary>
+    public class TestBoundingBoxTransform
+    {
+        [Fact]
+        public unsafe void TestMatchesBoundingBoxExtTransform()
+        {
+            const int Count = 37;
+            const int GroupCount = 4;
+            var random = new Random(4321);
+
+            var boxes = new BoundingBox[Count];
+            var worlds = new Matrix[Count];
+            var groupIndex = new int[Count];
+            for (int i = 0; i < Count; i++)
+            {
+                var center = new Vector3(NextFloat(random, -5, 5), NextFloat(random, -5, 5), NextFloat(random, -5, 5));
+                var extent = new Vector3(NextFloat(random, 0.1f, 3), NextFloat(random, 0.1f, 3), NextFloat(random, 0.1f, 3));
+                boxes[i] = new BoundingBox(center - extent, center + extent);
+
+                var scale = new Vector3(NextFloat(random, 0.5f, 2), NextFloat(random, 0.5f, 2), NextFloat(random, 0.5f, 2));
+                var rotation = Quaternion.RotationYawPitchRoll(NextFloat(random, -3, 3), NextFloat(random, -3, 3), NextFloat(random, -3, 3));
+                var translation = new Vector3(NextFloat(random, -50, 50), NextFloat(random, -50, 50), NextFloat(random, -50, 50));
+                Matrix.Transformation(ref scale, ref rotation, ref translation, out worlds[i]);
+
+                // Some boxes don't belong to any group
+                groupIndex[i] = i % (GroupCount + 1) - 1;
+            }
+
+            var result = new BoundingBox[Count];
+            var groupBounds = new BoundingBox[GroupCount];
+            for (int group = 0; group < GroupCount; group++)
+                groupBounds[group] = BoundingBox.Empty;
+
+            fixed (BoundingBox* boxesPtr = boxes)
+            fixed (Matrix* worldsPtr = worlds)
+            fixed (BoundingBox* resultPtr = result)
+            fixed (int* groupIndexPtr = groupIndex)
+            fixed (BoundingBox* groupBoundsPtr = groupBounds)
+            {
+                NativeInvoke.BoundingBoxTransformMerge(boxesPtr, worldsPtr, resultPtr, groupIndexPtr, groupBoundsPtr, Count);
+            }
+
+            var expectedGroupBounds = new BoundingBox[GroupCount];
+            for (int group = 0; group < GroupCount; group++)
+                expectedGroupBounds[group] = BoundingBox.Empty;
+
+            for (int i = 0; i < Count; i++)
+            {
+                var expected = new BoundingBoxExt(boxes[i]);
+                expected.Transform(worlds[i]);
+                AssertNearEqual(expected.Minimum, result[i].Minimum);
+                AssertNearEqual(expected.Maximum, result[i].Maximum);
+
+                if (groupIndex[i] >= 0)
+                    expectedGroupBounds[groupIndex[i]] = BoundingBox.Merge(expectedGroupBounds[groupIndex[i]], (BoundingBox)expected);
+            }
+
+            for (int group = 0; group < GroupCount; group++)
+            {
+                AssertNearEqual(expectedGroupBounds[group].Minimum, groupBounds[group].Minimum);
+                AssertNearEqual(expectedGroupBounds[group].Maximum, groupBounds[group].Maximum);
+            }
+        }
+
+        [Theory]
+        [InlineData(ModelComponent.NativeBoundingBoxBoneCount - 1)]
+        [InlineData(ModelComponent.NativeBoundingBoxBoneCount + 5)]
+        public void TestSkinnedModelBoundingBox(int boneCount)
+        {
+            var random = new Random(8765);
+
+            // A chain of nodes, each one moved by a bone
+            var nodes = new ModelNodeDefinition[boneCount + 1];
+            nodes[0] = new ModelNodeDefinition { ParentIndex = -1, Transform = { Scale = Vector3.One, Rotation = Quaternion.Identity }, Flags = ModelNodeFlags.Default };
+            var bones = new MeshBoneDefinition[boneCount];
+            for (int i = 0; i < boneCount; i++)
+            {
+                var rotation = Quaternion.RotationYawPitchRoll(NextFloat(random, -1, 1), NextFloat(random, -1, 1), NextFloat(random, -1, 1));
+                var position = new Vector3(NextFloat(random, -2, 2), NextFloat(random, -2, 2), NextFloat(random, -2, 2));
+                nodes[i + 1] = new ModelNodeDefinition { ParentIndex = i, Transform = { Scale = new Vector3(NextFloat(random, 0.9f, 1.1f)), Rotation = rotation, Position = position }, Flags = ModelNodeFlags.Default };
+                bones[i] = new MeshBoneDefinition { NodeIndex = i + 1, LinkToMeshMatrix = Matrix.Translation(NextFloat(random, -1, 1), NextFloat(random, -1, 1), NextFloat(random, -1, 1)) };
+            }
+
+            var mesh = new Mesh
+            {
+                BoundingBox = new BoundingBox(new Vector3(-1, -2, -0.5f), new Vector3(1, 2, 0.5f)),
+                BoundingSphere = new BoundingSphere(Vector3.Zero, 2.5f),
+                Skinning = new MeshSkinningDefinition { Bones = bones },
+            };
+            var model = new Model { Skeleton = new Skeleton { Nodes = nodes } };
+            model.Meshes.Add(mesh);
+
+            var entity = new Entity { new ModelComponent(model) };
+            entity.Transform.Position = new Vector3(10, 0, -5);
+            entity.Transform.Rotation = Quaternion.RotationY(0.7f);
+            entity.Transform.UpdateWorldMatrix();
+
+            var modelComponent = entity.Get<ModelComponent>();
+            modelComponent.Update(entity.Transform);
+
+            var meshInfo = modelComponent.MeshInfos[0];
+            var expected = BoundingBox.Empty;
+            for (int i = 0; i < boneCount; i++)
+            {
+                var boneBoundingBox = new BoundingBoxExt(mesh.BoundingBox);
+                boneBoundingBox.Transform(meshInfo.BlendMatrices[i]);
+                expected = BoundingBox.Merge(expected, (BoundingBox)boneBoundingBox);
+            }
+
+            AssertNearEqual(expected.Minimum, meshInfo.BoundingBox.Minimum);
+            AssertNearEqual(expected.Maximum, meshInfo.BoundingBox.Maximum);
+            AssertNearEqual(expected.Minimum, modelComponent.BoundingBox.Minimum);
+            AssertNearEqual(expected.Maximum, modelComponent.BoundingBox.Maximum);
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(Vector3 expected, Vector3 actual)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i]));
+                Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Component {i}: expected {expected}, got {actual}");
+            }
+        }
+    }
+}
@@ -0,0 +1,409 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Collections.Generic;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Rendering;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the raycasts of <see cref="TriangleBvh"/> and <see cref="BoundingBoxBvh"/> with brute force tests of every primitive,
+    /// with the baseline packet width and the one picked for this CPU.
+    /// </summary>
+    /// <remarks>
+    /// Rays grazing an edge, or hitting two primitives at about the same distance, are skipped since rounding decides the result.
+    /// </remarks>
+    [Collection(NativeCpuFeaturesCollection.Name)]
+    public class TestBvh
+    {
+        private const double EdgeTolerance = 1e-4;
+        private const float DistanceTolerance = 1e-3f;
+
+        private readonly NativeCpuFeaturesFixture fixture;
+
+        public TestBvh(NativeCpuFeaturesFixture fixture)
+        {
+            this.fixture = fixture;
+        }
+
+        [Theory]
+        [InlineData(3000, 2000)]
+        // Enough triangles to build the subtrees on several threads
+        [InlineData(20000, 300)]
+        public void TestTriangleRaycast(int triangleCount, int rayCount)
+        {
+            var random = new Random(triangleCount);
+            var (positions, indices, degenerateStart) = CreateTriangles(random, triangleCount);
+            var bvh = new TriangleBvh(positions, indices);
+            Assert.Equal(indices.Length / 3, bvh.TriangleCount);
+
+            var (rays, maxDistances) = CreateRays(random, rayCount, positions, indices);
+
+            var baselineHits = new BvhHit[rayCount];
+            var hits = new BvhHit[rayCount];
+            fixture.RunBaseline(() => bvh.Raycast(rays, maxDistances, baselineHits));
+            bvh.Raycast(rays, maxDistances, hits);
+
+            int checkedHits = 0, checkedMisses = 0;
+            for (int i = 0; i < rayCount; i++)
+            {
+                if (!FindClosestTriangle(positions, indices, rays[i], maxDistances[i], out var expectedDistance))
+                    continue;
+
+                bvh.Raycast(rays[i], maxDistances[i], out var hit);
+                foreach (var actual in new[] { baselineHits[i], hits[i], hit })
+                {
+                    if (float.IsPositiveInfinity(expectedDistance))
+                    {
+                        Assert.False(actual.Succeeded, $"Ray {i} {rays[i]} should miss, but hit triangle {actual.PrimitiveIndex} at {actual.Distance}");
+                        Assert.True(float.IsPositiveInfinity(actual.Distance));
+                        continue;
+                    }
+
+                    Assert.True(actual.Succeeded, $"Ray {i} {rays[i]} should hit at {expectedDistance}");
+                    Assert.True(actual.PrimitiveIndex < degenerateStart, $"Ray {i} hit the degenerate triangle {actual.PrimitiveIndex}");
+                    AssertNearEqual(expectedDistance, actual.Distance, $"Ray {i}");
+
+                    // Any triangle at the closest distance will do, but the coordinates must be its own
+                    Assert.True(IntersectTriangle(positions, indices, actual.PrimitiveIndex, rays[i], out var distance, out var u, out var v, out _), $"Ray {i} doesn't hit triangle {actual.PrimitiveIndex}");
+                    AssertNearEqual((float)distance, actual.Distance, $"Ray {i}");
+                    AssertNearEqual((float)u, actual.U, $"Ray {i}");
+                    AssertNearEqual((float)v, actual.V, $"Ray {i}");
+                }
+
+                if (float.IsPositiveInfinity(expectedDistance))
+                    checkedMisses++;
+                else
+                    checkedHits++;
+            }
+
+            Assert.True(checkedHits > rayCount / 4, $"Only {checkedHits} hits were checked");
+            Assert.True(checkedMisses > rayCount / 10, $"Only {checkedMisses} misses were checked");
+        }
+
+        [Fact]
+        public void TestTriangleOcclusion()
+        {
+            var random = new Random(31);
+            var (positions, indices, _) = CreateTriangles(random, 2000);
+            var bvh = new TriangleBvh(positions, indices);
+            var (rays, maxDistances) = CreateRays(random, 1500, positions, indices);
+
+            var baselineOccluded = new byte[rays.Length];
+            var occluded = new byte[rays.Length];
+            fixture.RunBaseline(() => bvh.TestOcclusion(rays, maxDistances, baselineOccluded));
+            bvh.TestOcclusion(rays, maxDistances, occluded);
+
+            for (int i = 0; i < rays.Length; i++)
+            {
+                if (!FindClosestTriangle(positions, indices, rays[i], maxDistances[i], out var expectedDistance))
+                    continue;
+
+                var expected = float.IsPositiveInfinity(expectedDistance) ? 0 : 1;
+                Assert.True(expected == baselineOccluded[i], $"Ray {i} {rays[i]}: expected {expected} with the baseline variant");
+                Assert.True(expected == occluded[i], $"Ray {i} {rays[i]}: expected {expected}");
+            }
+        }
+
+        [Fact]
+        public void TestEmptyTriangleBvh()
+        {
+            var bvh = new TriangleBvh(ReadOnlySpan<Vector3>.Empty, ReadOnlySpan<int>.Empty);
+            Assert.False(bvh.Raycast(new Ray(Vector3.Zero, Vector3.UnitX), float.PositiveInfinity, out var hit));
+            Assert.Equal(-1, hit.PrimitiveIndex);
+
+            var hits = new BvhHit[3];
+            bvh.Raycast(new Ray[3], ReadOnlySpan<float>.Empty, hits);
+            Assert.All(hits, x => Assert.False(x.Succeeded));
+        }
+
+        [Fact]
+        public void TestBoundingBoxRaycast()
+        {
+            const int BoxCount = 3000;
+            const int RayCount = 2000;
+            var random = new Random(57);
+
+            var boxes = new BoundingBox[BoxCount];
+            for (int i = 0; i < BoxCount; i++)
+            {
+                var center = new Vector3(NextFloat(random, -50, 50), NextFloat(random, -50, 50), NextFloat(random, -50, 50));
+                var extent = new Vector3(NextFloat(random, 0, 2), NextFloat(random, 0, 2), NextFloat(random, 0, 2));
+                boxes[i] = new BoundingBox(center - extent, center + extent);
+            }
+            var bvh = new BoundingBoxBvh(boxes);
+
+            // Some rays start inside a box, some point away from all of them
+            var rays = new Ray[RayCount];
+            var maxDistances = new float[RayCount];
+            for (int i = 0; i < RayCount; i++)
+            {
+                var origin = i % 3 == 0 ? boxes[random.Next(BoxCount)].Center : NextVector(random, 70);
+                var direction = i % 5 == 0 ? Vector3.Normalize(origin) : NextDirection(random);
+                if (i % 5 == 0)
+                    origin = Vector3.Normalize(origin) * 90;
+                rays[i] = new Ray(origin, direction);
+                maxDistances[i] = i % 4 == 0 ? NextFloat(random, 1, 30) : float.PositiveInfinity;
+            }
+
+            var baselineHits = new BvhHit[RayCount];
+            var hits = new BvhHit[RayCount];
+            fixture.RunBaseline(() => bvh.Raycast(rays, maxDistances, baselineHits));
+            bvh.Raycast(rays, maxDistances, hits);
+
+            int checkedHits = 0, checkedMisses = 0;
+            for (int i = 0; i < RayCount; i++)
+            {
+                if (!FindClosestBox(boxes, rays[i], maxDistances[i], out var expectedDistance))
+                    continue;
+
+                bvh.Raycast(rays[i], maxDistances[i], out var hit);
+                foreach (var actual in new[] { baselineHits[i], hits[i], hit })
+                {
+                    if (float.IsPositiveInfinity(expectedDistance))
+                    {
+                        Assert.False(actual.Succeeded, $"Ray {i} {rays[i]} should miss, but hit box {actual.PrimitiveIndex} at {actual.Distance}");
+                        continue;
+                    }
+
+                    Assert.True(actual.Succeeded, $"Ray {i} {rays[i]} should hit at {expectedDistance}");
+                    AssertNearEqual(expectedDistance, actual.Distance, $"Ray {i}");
+                    Assert.True(IntersectBox(boxes[actual.PrimitiveIndex], rays[i], out var entry, out _), $"Ray {i} doesn't hit box {actual.PrimitiveIndex}");
+                    AssertNearEqual((float)entry, actual.Distance, $"Ray {i}");
+                }
+
+                if (float.IsPositiveInfinity(expectedDistance))
+                    checkedMisses++;
+                else
+                    checkedHits++;
+            }
+
+            Assert.True(checkedHits > RayCount / 4, $"Only {checkedHits} hits were checked");
+            Assert.True(checkedMisses > RayCount / 10, $"Only {checkedMisses} misses were checked");
+        }
+
+        /// <summary>
+        /// Random triangles in a cube, followed by triangles with no area: repeated vertices, and vertices on an axis-aligned line.
+        /// </summary>
+        private static (Vector3[] Positions, int[] Indices, int DegenerateStart) CreateTriangles(Random random, int triangleCount)
+        {
+            var positions = new List<Vector3>();
+            var indices = new List<int>();
+            for (int i = 0; i < triangleCount; i++)
+            {
+                var center = NextVector(random, 50);
+                for (int j = 0; j < 3; j++)
+                {
+                    indices.Add(positions.Count);
+                    positions.Add(center + NextVector(random, 4));
+                }
+            }
+
+            var degenerateStart = triangleCount;
+            for (int i = 0; i < 200; i++)
+            {
+                var start = new Vector3(random.Next(-40, 40), random.Next(-40, 40), random.Next(-40, 40));
+                var first = positions.Count;
+                positions.Add(start);
+                switch (i % 3)
+                {
+                    case 0:
+                        positions.Add(start + NextVector(random, 4));
+                        indices.AddRange(new[] { first, first, first + 1 });
+                        break;
+                    case 1:
+                        indices.AddRange(new[] { first, first, first });
+                        break;
+                    default:
+                        var axis = i % 2 == 0 ? Vector3.UnitX : Vector3.UnitY;
+                        positions.Add(start + axis * 2);
+                        positions.Add(start + axis * 5);
+                        indices.AddRange(new[] { first, first + 1, first + 2 });
+                        break;
+                }
+            }
+
+            return (positions.ToArray(), indices.ToArray(), degenerateStart);
+        }
+
+        /// <summary>
+        /// Rays aimed at triangles, in random directions, and pointing away from everything; some of them with a limited distance.
+        /// </summary>
+        private static (Ray[] Rays, float[] MaxDistances) CreateRays(Random random, int rayCount, Vector3[] positions, int[] indices)
+        {
+            var rays = new Ray[rayCount];
+            var maxDistances = new float[rayCount];
+            for (int i = 0; i < rayCount; i++)
+            {
+                var origin = NextVector(random, 80);
+                Vector3 direction;
+                switch (i % 4)
+                {
+                    case 0:
+                    case 1:
+                        var triangle = random.Next(indices.Length / 3);
+                        var target = (positions[indices[3 * triangle]] + positions[indices[3 * triangle + 1]] + positions[indices[3 * triangle + 2]]) / 3;
+                        direction = Vector3.Normalize(target - origin);
+                        break;
+                    case 2:
+                        direction = NextDirection(random);
+                        break;
+                    default:
+                        origin = Vector3.Normalize(origin) * 100;
+                        direction = Vector3.Normalize(origin);
+                        break;
+                }
+
+                rays[i] = new Ray(origin, direction);
+                maxDistances[i] = i % 3 == 0 ? NextFloat(random, 5, 120) : float.PositiveInfinity;
+            }
+
+            return (rays, maxDistances);
+        }
+
+        /// <returns><c>false</c> when rounding could change the result, otherwise the closest distance in <paramref name="closest"/> (infinite on miss).</returns>
+        private static bool FindClosestTriangle(Vector3[] positions, int[] indices, Ray ray, float maxDistance, out float closest)
+        {
+            // Hits past maxDistance count too, to skip the ones too close to the limit
+            var closestDistance = double.PositiveInfinity;
+            var closestAmbiguous = double.PositiveInfinity;
+            for (int t = 0; t < indices.Length / 3; t++)
+            {
+                var hit = IntersectTriangle(positions, indices, t, ray, out var distance, out _, out _, out var ambiguous);
+                if (ambiguous)
+                    closestAmbiguous = Math.Min(closestAmbiguous, distance);
+                else if (hit)
+                    closestDistance = Math.Min(closestDistance, distance);
+            }
+
+            closest = closestDistance < maxDistance ? (float)closestDistance : float.PositiveInfinity;
+            if (closestAmbiguous <= Math.Min(closestDistance, maxDistance) + DistanceTolerance)
+                return false;
+
+            return double.IsPositiveInfinity(maxDistance) || Math.Abs(closestDistance - maxDistance) > DistanceTolerance;
+        }
+
+        // Möller-Trumbore in double, hitting both sides; ambiguous when the ray grazes an edge or starts on the triangle
+        private static bool IntersectTriangle(Vector3[] positions, int[] indices, int triangle, Ray ray, out double distance, out double u, out double v, out bool ambiguous)
+        {
+            distance = double.PositiveInfinity;
+            u = v = 0;
+            ambiguous = false;
+
+            var p0 = positions[indices[3 * triangle]];
+            var p1 = positions[indices[3 * triangle + 1]];
+            var p2 = positions[indices[3 * triangle + 2]];
+            double e1x = p1.X - p0.X, e1y = p1.Y - p0.Y, e1z = p1.Z - p0.Z;
+            double e2x = p2.X - p0.X, e2y = p2.Y - p0.Y, e2z = p2.Z - p0.Z;
+            double dx = ray.Direction.X, dy = ray.Direction.Y, dz = ray.Direction.Z;
+
+            double px = dy * e2z - dz * e2y, py = dz * e2x - dx * e2z, pz = dx * e2y - dy * e2x;
+            var determinant = e1x * px + e1y * py + e1z * pz;
+
+            // No area, never hit
+            var normalLength = Math.Sqrt(Math.Pow(e1y * e2z - e1z * e2y, 2) + Math.Pow(e1z * e2x - e1x * e2z, 2) + Math.Pow(e1x * e2y - e1y * e2x, 2));
+            if (normalLength == 0)
+                return false;
+
+            // Parallel to the plane
+            if (Math.Abs(determinant) <= 1e-6 * normalLength)
+            {
+                ambiguous = true;
+                distance = 0;
+                return false;
+            }
+
+            double tx = ray.Position.X - p0.X, ty = ray.Position.Y - p0.Y, tz = ray.Position.Z - p0.Z;
+            u = (tx * px + ty * py + tz * pz) / determinant;
+            double qx = ty * e1z - tz * e1y, qy = tz * e1x - tx * e1z, qz = tx * e1y - ty * e1x;
+            v = (dx * qx + dy * qy + dz * qz) / determinant;
+            distance = (e2x * qx + e2y * qy + e2z * qz) / determinant;
+
+            var margin = Math.Min(Math.Min(u, v), 1 - u - v);
+            if (Math.Abs(margin) <= EdgeTolerance || Math.Abs(distance) <= DistanceTolerance)
+            {
+                ambiguous = margin >= -EdgeTolerance && distance >= -DistanceTolerance;
+                return false;
+            }
+
+            return margin > 0 && distance > 0;
+        }
+
+        private static bool FindClosestBox(BoundingBox[] boxes, Ray ray, float maxDistance, out float closest)
+        {
+            var closestDistance = double.PositiveInfinity;
+            for (int b = 0; b < boxes.Length; b++)
+            {
+                if (!IntersectBox(boxes[b], ray, out var entry, out var ambiguous))
+                {
+                    if (ambiguous)
+                    {
+                        closest = 0;
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (ambiguous || Math.Abs(entry - maxDistance) <= DistanceTolerance)
+                {
+                    closest = 0;
+                    return false;
+                }
+
+                if (entry < maxDistance)
+                    closestDistance = Math.Min(closestDistance, entry);
+            }
+
+            closest = (float)closestDistance;
+            return true;
+        }
+
+        // Slab test in double, entering at 0 when the ray starts inside; ambiguous when the ray grazes the box
+        private static bool IntersectBox(BoundingBox box, Ray ray, out double entry, out bool ambiguous)
+        {
+            entry = 0;
+            var exit = double.PositiveInfinity;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                var inverse = 1.0 / ray.Direction[axis];
+                var t0 = (box.Minimum[axis] - ray.Position[axis]) * inverse;
+                var t1 = (box.Maximum[axis] - ray.Position[axis]) * inverse;
+                entry = Math.Max(entry, Math.Min(t0, t1));
+                exit = Math.Min(exit, Math.Max(t0, t1));
+            }
+
+            ambiguous = Math.Abs(exit - entry) <= DistanceTolerance;
+            return entry <= exit;
+        }
+
+        private static void AssertNearEqual(float expected, float actual, string message)
+        {
+            var tolerance = DistanceTolerance * Math.Max(1.0f, Math.Abs(expected));
+            Assert.True(Math.Abs(expected - actual) <= tolerance, $"{message}: expected {expected}, got {actual}");
+        }
+
+        private static Vector3 NextVector(Random random, float range)
+        {
+            return new Vector3(NextFloat(random, -range, range), NextFloat(random, -range, range), NextFloat(random, -range, range));
+        }
+
+        private static Vector3 NextDirection(Random random)
+        {
+            Vector3 direction;
+            do
+            {
+                direction = NextVector(random, 1);
+            }
+            while (direction.LengthSquared() < 0.01f);
+            return Vector3.Normalize(direction);
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+    }
+}
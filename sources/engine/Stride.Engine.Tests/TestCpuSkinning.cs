@@ -0,0 +1,86 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Graphics;
+using Stride.Rendering;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares <see cref="CpuSkinning"/> with the blend matrix computation of <c>TransformationSkinning</c> done with managed math.
+    /// </summary>
+    public class TestCpuSkinning
+    {
+        [Theory]
+        [InlineData(61)]
+        [InlineData(CpuSkinning.ParallelThreshold + 3)]
+        public void TestMatchesManagedSkinning(int vertexCount)
+        {
+            const int BoneCount = 6;
+            var random = new Random(2024);
+
+            var bonePalette = new Matrix[BoneCount];
+            for (int i = 0; i < BoneCount; i++)
+            {
+                var scale = new Vector3(NextFloat(random, 0.8f, 1.2f));
+                var rotation = Quaternion.RotationYawPitchRoll(NextFloat(random, -3, 3), NextFloat(random, -3, 3), NextFloat(random, -3, 3));
+                var translation = new Vector3(NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10));
+                Matrix.Transformation(ref scale, ref rotation, ref translation, out bonePalette[i]);
+            }
+
+            var input = new VertexPositionNormalTexture[vertexCount];
+            var blendIndices = new ushort[4 * vertexCount];
+            var blendWeights = new float[4 * vertexCount];
+            for (int i = 0; i < vertexCount; i++)
+            {
+                var position = new Vector3(NextFloat(random, -2, 2), NextFloat(random, -2, 2), NextFloat(random, -2, 2));
+                var normal = Vector3.Normalize(new Vector3(NextFloat(random, -1, 1), NextFloat(random, -1, 1), NextFloat(random, 0.1f, 1)));
+                input[i] = new VertexPositionNormalTexture(position, normal, new Vector2(NextFloat(random, 0, 1), NextFloat(random, 0, 1)));
+
+                var totalWeight = 0.0f;
+                for (int j = 0; j < 4; j++)
+                {
+                    blendIndices[4 * i + j] = (ushort)random.Next(BoneCount);
+                    blendWeights[4 * i + j] = NextFloat(random, 0.1f, 1);
+                    totalWeight += blendWeights[4 * i + j];
+                }
+                for (int j = 0; j < 4; j++)
+                    blendWeights[4 * i + j] /= totalWeight;
+            }
+
+            var output = new VertexPositionNormalTexture[vertexCount];
+            CpuSkinning.SkinVertices(bonePalette, blendIndices, blendWeights, input, output);
+
+            for (int i = 0; i < vertexCount; i++)
+            {
+                var blendMatrix = new Matrix();
+                for (int j = 0; j < 4; j++)
+                    blendMatrix += bonePalette[blendIndices[4 * i + j]] * blendWeights[4 * i + j];
+
+                var expectedPosition = Vector3.TransformCoordinate(input[i].Position, blendMatrix);
+                var expectedNormal = Vector3.Normalize(Vector3.TransformNormal(input[i].Normal, blendMatrix));
+
+                AssertNearEqual(expectedPosition, output[i].Position);
+                AssertNearEqual(expectedNormal, output[i].Normal);
+                Assert.Equal(input[i].TextureCoordinate, output[i].TextureCoordinate);
+            }
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(Vector3 expected, Vector3 actual)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i]));
+                Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Component {i}: expected {expected}, got {actual}");
+            }
+        }
+    }
+}
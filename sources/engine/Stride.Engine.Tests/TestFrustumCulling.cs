@@ -0,0 +1,131 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Native;
+using Stride.Rendering;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the native frustum culling used by <see cref="VisibilityGroup"/> with <see cref="VisibilityGroup.FrustumContainsBox"/>,
+    /// with the baseline variant of the kernel and the one picked for this CPU.
+    /// </summary>
+    [Collection(NativeCpuFeaturesCollection.Name)]
+    public class TestFrustumCulling
+    {
+        // Boxes closer than this to a plane are skipped, since FMA can round the other way
+        private const float PlaneTolerance = 1e-3f;
+
+        private readonly NativeCpuFeaturesFixture fixture;
+
+        public TestFrustumCulling(NativeCpuFeaturesFixture fixture)
+        {
+            this.fixture = fixture;
+        }
+
+        [Theory]
+        [InlineData(false)]
+        [InlineData(true)]
+        public void TestMatchesFrustumContainsBox(bool ignoreDepthPlanes)
+        {
+            // Not a multiple of 8
+            const int Count = 1003;
+            var random = new Random(ignoreDepthPlanes ? 77 : 78);
+
+            var view = Matrix.LookAtRH(new Vector3(1, 2, 5), new Vector3(0, 0, -10), Vector3.UnitY);
+            var projection = Matrix.PerspectiveFovRH(1.2f, 1.5f, 1.0f, 40.0f);
+            var viewProjection = view * projection;
+            var frustum = new BoundingFrustum(ref viewProjection);
+
+            var boxes = new BoundingBoxExt[Count];
+            for (int i = 0; i < Count; i++)
+            {
+                var center = new Vector3(NextFloat(random, -30, 30), NextFloat(random, -30, 30), NextFloat(random, -60, 10));
+                var extent = new Vector3(NextFloat(random, 0, 3), NextFloat(random, 0, 3), NextFloat(random, 0, 3));
+                boxes[i] = new BoundingBoxExt(center - extent, center + extent);
+            }
+
+            var baseline = new byte[(Count + 7) / 8];
+            var actual = new byte[(Count + 7) / 8];
+            fixture.RunBaseline(() => Cull(ref frustum, ignoreDepthPlanes, boxes, baseline));
+            Cull(ref frustum, ignoreDepthPlanes, boxes, actual);
+
+            var visibleCount = 0;
+            for (int i = 0; i < Count; i++)
+            {
+                if (IsNearPlane(ref frustum, ref boxes[i], ignoreDepthPlanes))
+                    continue;
+
+                var expected = VisibilityGroup.FrustumContainsBox(ref frustum, ref boxes[i], ignoreDepthPlanes);
+                Assert.True(expected == ((baseline[i >> 3] & (1 << (i & 7))) != 0), $"Box {i} {boxes[i]}: expected {expected} with the baseline variant");
+                Assert.True(expected == ((actual[i >> 3] & (1 << (i & 7))) != 0), $"Box {i} {boxes[i]}: expected {expected}");
+                if (expected)
+                    visibleCount++;
+            }
+
+            Assert.True(visibleCount > 0, "No box is visible");
+            Assert.True(visibleCount < Count, "No box is culled");
+
+            // Bits past the last box are left clear
+            Assert.Equal(0, actual[^1] >> (Count & 7));
+        }
+
+        // Ranges starting on multiples of 8, as split by VisibilityGroup
+        private static unsafe void Cull(ref BoundingFrustum frustum, bool ignoreDepthPlanes, BoundingBoxExt[] boxes, byte[] visibility)
+        {
+            var centerX = new float[boxes.Length];
+            var centerY = new float[boxes.Length];
+            var centerZ = new float[boxes.Length];
+            var extentX = new float[boxes.Length];
+            var extentY = new float[boxes.Length];
+            var extentZ = new float[boxes.Length];
+            for (int i = 0; i < boxes.Length; i++)
+            {
+                centerX[i] = boxes[i].Center.X;
+                centerY[i] = boxes[i].Center.Y;
+                centerZ[i] = boxes[i].Center.Z;
+                extentX[i] = boxes[i].Extent.X;
+                extentY[i] = boxes[i].Extent.Y;
+                extentZ[i] = boxes[i].Extent.Z;
+            }
+
+            fixed (Plane* planes = &frustum.LeftPlane)
+            fixed (float* centerXPtr = centerX, centerYPtr = centerY, centerZPtr = centerZ)
+            fixed (float* extentXPtr = extentX, extentYPtr = extentY, extentZPtr = extentZ)
+            fixed (byte* visibilityPtr = visibility)
+            {
+                for (int start = 0; start < boxes.Length; start += 64)
+                {
+                    var end = Math.Min(start + 64, boxes.Length);
+                    NativeInvoke.FrustumCullBoxes(planes, ignoreDepthPlanes ? 4 : 6, centerXPtr, centerYPtr, centerZPtr, extentXPtr, extentYPtr, extentZPtr, visibilityPtr, start, end);
+                }
+            }
+        }
+
+        private static unsafe bool IsNearPlane(ref BoundingFrustum frustum, ref BoundingBoxExt box, bool ignoreDepthPlanes)
+        {
+            fixed (Plane* planes = &frustum.LeftPlane)
+            {
+                for (int i = 0; i < (ignoreDepthPlanes ? 4 : 6); i++)
+                {
+                    var normal = planes[i].Normal;
+                    var distance = Vector3.Dot(box.Center, normal)
+                        + box.Extent.X * Math.Abs(normal.X) + box.Extent.Y * Math.Abs(normal.Y) + box.Extent.Z * Math.Abs(normal.Z)
+                        + planes[i].D;
+                    if (Math.Abs(distance) <= PlaneTolerance * Math.Max(1.0f, Math.Abs(planes[i].D)))
+                        return true;
+                }
+            }
+
+            return false;
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+    }
+}
@@ -0,0 +1,335 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Native;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the native clustered light assignment with a brute force managed one: a light goes in the clusters of the tiles
+    /// the renderer used to give it (from the screen space bounds of its sphere), whose view space bounding box its sphere touches.
+    /// </summary>
+    /// <remarks>
+    /// Light/cluster pairs within rounding distance of one of the tests can go either way.
+    /// </remarks>
+    public class TestLightClustering
+    {
+        private const int ClusterSize = 64;
+        private const int ClusterSlices = 8;
+        private const float Epsilon = 1e-3f;
+
+        private enum Expectation
+        {
+            Out,
+            In,
+            Either,
+        }
+
+        // Same layout as LightClusterLight in the native code
+        [StructLayout(LayoutKind.Sequential)]
+        private struct ClusterLight
+        {
+            public Vector3 Position;
+            public float Radius;
+            public Vector3 Direction;
+            public float CosAngle;
+        }
+
+        // Same layout as LightClusterGrid in the native code
+        [StructLayout(LayoutKind.Sequential)]
+        private struct ClusterGrid
+        {
+            public Matrix Projection;
+            public int ClusterCountX;
+            public int ClusterCountY;
+            public int ClusterSlices;
+            public int ClusterSize;
+            public Vector2 ViewSize;
+            public float DepthScale;
+            public float DepthBias;
+        }
+
+        [Fact]
+        public unsafe void TestMatchesBruteForce()
+        {
+            var random = new Random(1618);
+
+            // Off center, so that the projection offsets are used
+            const float NearPlane = 0.1f, FarPlane = 100.0f, SpecialNearPlane = 2.0f;
+            Matrix.PerspectiveOffCenterRH(-0.06f, 0.1f, -0.04f, 0.05f, NearPlane, FarPlane, out var projection);
+
+            var viewSize = new Vector2(1280, 720);
+            var depthScale = (float)(Math.Pow(2.0f, ClusterSlices) - 2.0f) / (FarPlane - SpecialNearPlane);
+            var grid = new ClusterGrid
+            {
+                Projection = projection,
+                ClusterCountX = ((int)viewSize.X + ClusterSize - 1) / ClusterSize,
+                ClusterCountY = ((int)viewSize.Y + ClusterSize - 1) / ClusterSize,
+                ClusterSlices = ClusterSlices,
+                ClusterSize = ClusterSize,
+                ViewSize = viewSize,
+                DepthScale = depthScale,
+                DepthBias = 2.0f - depthScale * SpecialNearPlane,
+            };
+
+            // Some lights are behind the camera or out of the view
+            var pointLights = new ClusterLight[37];
+            for (int i = 0; i < pointLights.Length; i++)
+                pointLights[i] = new ClusterLight { Position = NextPosition(random), Radius = NextFloat(random, 0.5f, 15.0f) };
+
+            var spotLights = new ClusterLight[23];
+            for (int i = 0; i < spotLights.Length; i++)
+            {
+                spotLights[i] = new ClusterLight
+                {
+                    Position = NextPosition(random),
+                    Radius = NextFloat(random, 0.5f, 25.0f),
+                    Direction = Vector3.Normalize(new Vector3(NextFloat(random, -1, 1), NextFloat(random, -1, 1), NextFloat(random, -1, 1))),
+                    CosAngle = MathF.Cos(NextFloat(random, 0.1f, 1.2f)),
+                };
+            }
+
+            var clustersPerSlice = grid.ClusterCountX * grid.ClusterCountY;
+            var clusterInfos = new Int2[clustersPerSlice * ClusterSlices];
+            const int SliceCapacity = 1 << 16;
+            var sliceIndices = new int[SliceCapacity * ClusterSlices];
+            var sliceIndexCounts = new int[ClusterSlices];
+            int[] indices;
+
+            fixed (ClusterLight* pointLightsPtr = pointLights)
+            fixed (ClusterLight* spotLightsPtr = spotLights)
+            fixed (Int2* clusterInfosPtr = clusterInfos)
+            fixed (int* sliceIndicesPtr = sliceIndices)
+            fixed (int* sliceIndexCountsPtr = sliceIndexCounts)
+            {
+                NativeInvoke.LightClusterAssignRange(&grid, pointLightsPtr, pointLights.Length, spotLightsPtr, spotLights.Length, clusterInfosPtr, sliceIndicesPtr, SliceCapacity, sliceIndexCountsPtr, 0, ClusterSlices);
+
+                var totalIndexCount = 0;
+                foreach (var count in sliceIndexCounts)
+                {
+                    Assert.True(count <= SliceCapacity);
+                    totalIndexCount += count;
+                }
+
+                indices = new int[totalIndexCount];
+                fixed (int* indicesPtr = indices)
+                {
+                    NativeInvoke.LightClusterMerge(&grid, clusterInfosPtr, sliceIndicesPtr, SliceCapacity, sliceIndexCountsPtr, indicesPtr);
+                }
+            }
+
+            var pointTiles = Array.ConvertAll(pointLights, light => ComputeTiles(light, projection, viewSize));
+            var spotTiles = Array.ConvertAll(spotLights, light => ComputeTiles(light, projection, viewSize));
+            Matrix.Invert(ref projection, out var inverseProjection);
+
+            var assignedCount = 0;
+            for (int z = 0; z < ClusterSlices; z++)
+            {
+                var near = z == 0 ? 0.0f : ((1 << z) - grid.DepthBias) / grid.DepthScale;
+                var far = ((1 << (z + 1)) - grid.DepthBias) / grid.DepthScale;
+
+                for (int y = 0; y < grid.ClusterCountY; y++)
+                {
+                    for (int x = 0; x < grid.ClusterCountX; x++)
+                    {
+                        var bounds = ComputeClusterBounds(x, y, near, far, inverseProjection, viewSize);
+
+                        var clusterInfo = clusterInfos[x + (y + z * grid.ClusterCountY) * grid.ClusterCountX];
+                        var pointCount = clusterInfo.Y & 0xffff;
+                        var spotCount = clusterInfo.Y >> 16;
+                        var assignedPoints = new HashSet<int>();
+                        var assignedSpots = new HashSet<int>();
+                        for (int i = 0; i < pointCount; i++)
+                            Assert.True(assignedPoints.Add(indices[clusterInfo.X + i]), $"Point light assigned twice to cluster ({x}, {y}, {z})");
+                        for (int i = 0; i < spotCount; i++)
+                            Assert.True(assignedSpots.Add(indices[clusterInfo.X + pointCount + i]), $"Spot light assigned twice to cluster ({x}, {y}, {z})");
+                        assignedCount += pointCount + spotCount;
+
+                        for (int i = 0; i < pointLights.Length; i++)
+                        {
+                            var expected = Combine(pointTiles[i].Contains(x, y), SphereTouchesBox(pointLights[i], bounds));
+                            AssertExpectation(expected, assignedPoints.Contains(i), $"Point light {i} in cluster ({x}, {y}, {z})");
+                        }
+
+                        for (int i = 0; i < spotLights.Length; i++)
+                        {
+                            var expected = Combine(Combine(spotTiles[i].Contains(x, y), SphereTouchesBox(spotLights[i], bounds)), ConeTouchesSphere(spotLights[i], bounds));
+                            AssertExpectation(expected, assignedSpots.Contains(i), $"Spot light {i} in cluster ({x}, {y}, {z})");
+                        }
+                    }
+                }
+            }
+
+            Assert.True(assignedCount > 0, "No light was assigned");
+        }
+
+        private struct Tiles
+        {
+            // Tile ranges with the bounds rounded both ways, when they are within rounding distance of a tile border
+            public int StartXLow, StartXHigh, EndXLow, EndXHigh;
+            public int StartYLow, StartYHigh, EndYLow, EndYHigh;
+
+            public Expectation Contains(int x, int y)
+            {
+                if (x < StartXLow || x >= EndXHigh || y < StartYLow || y >= EndYHigh)
+                    return Expectation.Out;
+                if (x >= StartXHigh && x < EndXLow && y >= StartYHigh && y < EndYLow)
+                    return Expectation.In;
+                return Expectation.Either;
+            }
+        }
+
+        /// <summary>
+        /// The tiles covered by the light, computed like <c>LightClusteredPointSpotGroupRenderer</c> did before the assignment was moved to native code.
+        /// </summary>
+        private static Tiles ComputeTiles(ClusterLight light, Matrix projection, Vector2 viewSize)
+        {
+            var clipMin = new Vector2(-1.0f, -1.0f);
+            var clipMax = new Vector2(1.0f, 1.0f);
+            UpdateClipRegion(light.Position.X, -light.Position.Z, light.Radius, projection.M11, projection.M31, ref clipMin.X, ref clipMax.X);
+            UpdateClipRegion(light.Position.Y, -light.Position.Z, light.Radius, projection.M22, projection.M32, ref clipMin.Y, ref clipMax.Y);
+
+            var clusterCountX = ((int)viewSize.X + ClusterSize - 1) / ClusterSize;
+            var clusterCountY = ((int)viewSize.Y + ClusterSize - 1) / ClusterSize;
+
+            var startX = (clipMin.X * 0.5f + 0.5f) * viewSize.X / ClusterSize;
+            var endX = (clipMax.X * 0.5f + 0.5f) * viewSize.X / ClusterSize;
+            var startY = (-clipMax.Y * 0.5f + 0.5f) * viewSize.Y / ClusterSize;
+            var endY = (-clipMin.Y * 0.5f + 0.5f) * viewSize.Y / ClusterSize;
+
+            return new Tiles
+            {
+                StartXLow = MathUtil.Clamp((int)(startX - Epsilon), 0, clusterCountX),
+                StartXHigh = MathUtil.Clamp((int)(startX + Epsilon), 0, clusterCountX),
+                EndXLow = MathUtil.Clamp((int)(endX - Epsilon) + 1, 0, clusterCountX),
+                EndXHigh = MathUtil.Clamp((int)(endX + Epsilon) + 1, 0, clusterCountX),
+                StartYLow = MathUtil.Clamp((int)(startY - Epsilon), 0, clusterCountY),
+                StartYHigh = MathUtil.Clamp((int)(startY + Epsilon), 0, clusterCountY),
+                EndYLow = MathUtil.Clamp((int)(endY - Epsilon) + 1, 0, clusterCountY),
+                EndYHigh = MathUtil.Clamp((int)(endY + Epsilon) + 1, 0, clusterCountY),
+            };
+        }
+
+        private static void UpdateClipRegionRoot(float nc, float lc, float lz, float lightRadius, float cameraScale, float cameraOffset, ref float clipMin, ref float clipMax)
+        {
+            float nz = (lightRadius - nc * lc) / lz;
+            float pz = (lc * lc + lz * lz - lightRadius * lightRadius) / (lz - (nz / nc) * lc);
+
+            if (pz > 0.0f)
+            {
+                float c = -nz * cameraScale / nc - cameraOffset;
+                if (nc > 0.0f)
+                    clipMin = Math.Max(clipMin, c);
+                else
+                    clipMax = Math.Min(clipMax, c);
+            }
+        }
+
+        private static void UpdateClipRegion(float lc, float lz, float lightRadius, float cameraScale, float cameraOffset, ref float clipMin, ref float clipMax)
+        {
+            float rSq = lightRadius * lightRadius;
+            float lcSqPluslzSq = lc * lc + lz * lz;
+            float d = rSq * lc * lc - lcSqPluslzSq * (rSq - lz * lz);
+
+            if (d > 0)
+            {
+                float a = lightRadius * lc;
+                float b = MathF.Sqrt(d);
+                UpdateClipRegionRoot((a + b) / lcSqPluslzSq, lc, lz, lightRadius, cameraScale, cameraOffset, ref clipMin, ref clipMax);
+                UpdateClipRegionRoot((a - b) / lcSqPluslzSq, lc, lz, lightRadius, cameraScale, cameraOffset, ref clipMin, ref clipMax);
+            }
+        }
+
+        /// <summary>
+        /// View space bounding box of the frustum of tile (x, y) between depths <paramref name="near"/> and <paramref name="far"/>.
+        /// </summary>
+        private static BoundingBox ComputeClusterBounds(int x, int y, float near, float far, Matrix inverseProjection, Vector2 viewSize)
+        {
+            var bounds = BoundingBox.Empty;
+            for (int corner = 0; corner < 8; corner++)
+            {
+                var ndc = new Vector3(
+                    2.0f * (x + (corner & 1)) * ClusterSize / viewSize.X - 1.0f,
+                    1.0f - 2.0f * (y + ((corner >> 1) & 1)) * ClusterSize / viewSize.Y,
+                    0.5f);
+                var depth = (corner & 4) != 0 ? far : near;
+
+                // Any point of the view ray through ndc, moved to the depth
+                var position = Vector3.TransformCoordinate(ndc, inverseProjection);
+                position *= depth / -position.Z;
+
+                bounds.Minimum = Vector3.Min(bounds.Minimum, position);
+                bounds.Maximum = Vector3.Max(bounds.Maximum, position);
+            }
+            return bounds;
+        }
+
+        private static Expectation SphereTouchesBox(ClusterLight light, BoundingBox bounds)
+        {
+            var distanceSquared = 0.0;
+            for (int i = 0; i < 3; i++)
+            {
+                var distance = Math.Max(Math.Max(bounds.Minimum[i] - light.Position[i], light.Position[i] - bounds.Maximum[i]), 0.0);
+                distanceSquared += distance * distance;
+            }
+
+            var radiusSquared = (double)light.Radius * light.Radius;
+            return Compare(radiusSquared - distanceSquared, Epsilon * Math.Max(1.0, radiusSquared));
+        }
+
+        /// <summary>
+        /// Cone of a spot light against the bounding sphere of the cluster.
+        /// </summary>
+        private static Expectation ConeTouchesSphere(ClusterLight light, BoundingBox bounds)
+        {
+            var center = bounds.Center;
+            var radius = (double)bounds.Extent.Length();
+
+            var v = center - light.Position;
+            var alongAxis = (double)Vector3.Dot(v, light.Direction);
+            var sinAngle = Math.Sqrt(Math.Max(1.0 - (double)light.CosAngle * light.CosAngle, 0.0));
+            var distanceToCone = light.CosAngle * Math.Sqrt(Math.Max((double)v.LengthSquared() - alongAxis * alongAxis, 0.0)) - alongAxis * sinAngle;
+
+            var tolerance = Epsilon * Math.Max(1.0, radius + light.Radius);
+            return Combine(Combine(
+                Compare(radius - distanceToCone, tolerance),
+                Compare(radius + light.Radius - alongAxis, tolerance)),
+                Compare(alongAxis + radius, tolerance));
+        }
+
+        private static Expectation Compare(double margin, double tolerance)
+        {
+            return margin > tolerance ? Expectation.In : margin < -tolerance ? Expectation.Out : Expectation.Either;
+        }
+
+        private static Expectation Combine(Expectation left, Expectation right)
+        {
+            if (left == Expectation.Out || right == Expectation.Out)
+                return Expectation.Out;
+            return left == Expectation.In && right == Expectation.In ? Expectation.In : Expectation.Either;
+        }
+
+        private static void AssertExpectation(Expectation expected, bool assigned, string message)
+        {
+            if (expected == Expectation.In)
+                Assert.True(assigned, $"{message} is missing");
+            else if (expected == Expectation.Out)
+                Assert.False(assigned, $"{message} should have been culled");
+        }
+
+        private static Vector3 NextPosition(Random random)
+        {
+            return new Vector3(NextFloat(random, -40, 40), NextFloat(random, -25, 25), NextFloat(random, -110, 5));
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+    }
+}
@@ -0,0 +1,198 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Extensions;
+using Stride.Graphics;
+using Stride.Graphics.Data;
+using Stride.Native;
+using Stride.Rendering;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Checks that <see cref="MeshOptimizationExtensions.Optimize"/> lowers the vertex cache miss rate while drawing the same triangles.
+    /// </summary>
+    public class TestMeshOptimization
+    {
+        private const int GridSize = 48;
+
+        private const int GridVertexCount = (GridSize + 1) * (GridSize + 1);
+
+        [Theory]
+        [InlineData(true)]
+        [InlineData(false)]
+        public void TestScrambledGrid(bool is32Bit)
+        {
+            var random = new Random(1234);
+            var vertices = new List<VertexPositionNormalTexture>();
+            for (int i = 0; i < GridVertexCount; i++)
+                vertices.Add(GridVertex(i));
+
+            var triangles = new List<int[]>();
+            for (int z = 0; z < GridSize; z++)
+            {
+                for (int x = 0; x < GridSize; x++)
+                {
+                    var corner = z * (GridSize + 1) + x;
+                    triangles.Add([corner, corner + GridSize + 1, corner + 1]);
+                    triangles.Add([corner + 1, corner + GridSize + 1, corner + GridSize + 2]);
+                }
+            }
+
+            // Duplicate some vertices, as importers do when splitting faces, and add an unused one
+            foreach (var triangle in triangles.Where((_, i) => i % 5 == 0))
+            {
+                var original = triangle[1];
+                triangle[1] = vertices.Count;
+                vertices.Add(vertices[original]);
+            }
+            vertices.Add(GridVertex(0));
+
+            // Scramble triangle and vertex order
+            triangles = triangles.OrderBy(_ => random.Next()).ToList();
+            var shuffle = Enumerable.Range(0, vertices.Count).OrderBy(_ => random.Next()).ToArray();
+            var shuffledVertices = new VertexPositionNormalTexture[vertices.Count];
+            for (int i = 0; i < vertices.Count; i++)
+                shuffledVertices[shuffle[i]] = vertices[i];
+            var indices = triangles.SelectMany(x => x).Select(x => (uint)shuffle[x]).ToArray();
+
+            var meshDraw = CreateMeshDraw(shuffledVertices, indices, is32Bit);
+            var expectedTriangles = GetTriangleKeys(meshDraw);
+            var missRateBefore = AnalyzeVertexCache(meshDraw);
+
+            Assert.True(meshDraw.Optimize());
+
+            Assert.Equal(is32Bit, meshDraw.IndexBuffer.Is32Bit);
+            Assert.Equal(indices.Length, meshDraw.IndexBuffer.Count);
+            Assert.Equal(indices.Length, meshDraw.DrawCount);
+
+            // Duplicates are merged and the unused vertex is removed
+            Assert.Equal(GridVertexCount, meshDraw.VertexBuffers[0].Count);
+
+            // Every vertex is used, in order of first use, and kept its attributes
+            var optimizedIndices = ReadIndices(meshDraw);
+            var optimizedVertices = ReadVertices(meshDraw);
+            var nextVertex = 0u;
+            foreach (var index in optimizedIndices)
+            {
+                Assert.True(index <= nextVertex);
+                if (index == nextVertex)
+                    nextVertex++;
+            }
+            Assert.Equal((uint)GridVertexCount, nextVertex);
+            foreach (var vertex in optimizedVertices)
+                Assert.Equal(GridVertex(GetGridIndex(vertex)), vertex);
+
+            // Same triangles with the same winding
+            Assert.Equal(expectedTriangles, GetTriangleKeys(meshDraw));
+
+            var missRateAfter = AnalyzeVertexCache(meshDraw);
+            Assert.True(missRateAfter > 0.0f);
+            Assert.True(missRateAfter < missRateBefore * 0.5f, $"ACMR went from {missRateBefore} to {missRateAfter}");
+            Assert.True(missRateAfter < 1.0f, $"ACMR {missRateAfter}");
+        }
+
+        [Fact]
+        public void TestUnsupportedMeshesAreKept()
+        {
+            var vertices = Enumerable.Range(0, 4).Select(GridVertex).ToArray();
+            uint[] indices = [0, 1, 2, 2, 1, 3];
+
+            var strip = CreateMeshDraw(vertices, indices, true);
+            strip.PrimitiveType = PrimitiveType.TriangleStrip;
+            var stripIndexBuffer = strip.IndexBuffer;
+            Assert.False(strip.Optimize());
+            Assert.Same(stripIndexBuffer, strip.IndexBuffer);
+
+            var partial = CreateMeshDraw(vertices, indices, true);
+            partial.DrawCount = 3;
+            Assert.False(partial.Optimize());
+
+            var outOfRange = CreateMeshDraw(vertices, [0, 1, 4], true);
+            var outOfRangeVertexBuffer = outOfRange.VertexBuffers[0].Buffer;
+            Assert.False(outOfRange.Optimize());
+            Assert.Same(outOfRangeVertexBuffer, outOfRange.VertexBuffers[0].Buffer);
+        }
+
+        private static VertexPositionNormalTexture GridVertex(int index)
+        {
+            var x = index % (GridSize + 1);
+            var z = index / (GridSize + 1);
+            return new VertexPositionNormalTexture(new Vector3(x, 0, z), Vector3.UnitY, new Vector2(x, z) / GridSize);
+        }
+
+        private static int GetGridIndex(VertexPositionNormalTexture vertex)
+        {
+            return (int)vertex.Position.Z * (GridSize + 1) + (int)vertex.Position.X;
+        }
+
+        private static MeshDraw CreateMeshDraw(VertexPositionNormalTexture[] vertices, uint[] indices, bool is32Bit)
+        {
+            var vertexData = MemoryMarshal.AsBytes(vertices.AsSpan()).ToArray();
+            var indexData = is32Bit
+                ? MemoryMarshal.AsBytes(indices.AsSpan()).ToArray()
+                : MemoryMarshal.AsBytes(indices.Select(x => (ushort)x).ToArray().AsSpan()).ToArray();
+
+            return new MeshDraw
+            {
+                PrimitiveType = PrimitiveType.TriangleList,
+                DrawCount = indices.Length,
+                VertexBuffers = [new VertexBufferBinding(new BufferData(BufferFlags.VertexBuffer, vertexData).ToSerializableVersion(), VertexPositionNormalTexture.Layout, vertices.Length)],
+                IndexBuffer = new IndexBufferBinding(new BufferData(BufferFlags.IndexBuffer, indexData).ToSerializableVersion(), is32Bit, indices.Length),
+            };
+        }
+
+        private static uint[] ReadIndices(MeshDraw meshDraw)
+        {
+            var data = meshDraw.IndexBuffer.Buffer.GetSerializationData().Content.AsSpan(meshDraw.IndexBuffer.Offset);
+            return meshDraw.IndexBuffer.Is32Bit
+                ? MemoryMarshal.Cast<byte, uint>(data).Slice(0, meshDraw.IndexBuffer.Count).ToArray()
+                : MemoryMarshal.Cast<byte, ushort>(data).Slice(0, meshDraw.IndexBuffer.Count).ToArray().Select(x => (uint)x).ToArray();
+        }
+
+        private static VertexPositionNormalTexture[] ReadVertices(MeshDraw meshDraw)
+        {
+            var vertexBuffer = meshDraw.VertexBuffers[0];
+            var data = vertexBuffer.Buffer.GetSerializationData().Content.AsSpan(vertexBuffer.Offset);
+            return MemoryMarshal.Cast<byte, VertexPositionNormalTexture>(data).Slice(0, vertexBuffer.Count).ToArray();
+        }
+
+        /// <summary>
+        /// Returns the triangles as grid vertex indices, each one rotated to start with its smallest index so that the winding is kept, sorted.
+        /// </summary>
+        private static long[] GetTriangleKeys(MeshDraw meshDraw)
+        {
+            var indices = ReadIndices(meshDraw);
+            var vertices = ReadVertices(meshDraw);
+            var keys = new long[indices.Length / 3];
+            for (int i = 0; i < keys.Length; i++)
+            {
+                var a = GetGridIndex(vertices[indices[i * 3]]);
+                var b = GetGridIndex(vertices[indices[i * 3 + 1]]);
+                var c = GetGridIndex(vertices[indices[i * 3 + 2]]);
+                if (b < a && b < c)
+                    (a, b, c) = (b, c, a);
+                else if (c < a && c < b)
+                    (a, b, c) = (c, a, b);
+                keys[i] = ((long)a * GridVertexCount + b) * GridVertexCount + c;
+            }
+            Array.Sort(keys);
+            return keys;
+        }
+
+        private static unsafe float AnalyzeVertexCache(MeshDraw meshDraw)
+        {
+            var indices = ReadIndices(meshDraw);
+            fixed (uint* indicesPtr = indices)
+            {
+                return NativeInvoke.AnalyzeVertexCache(indicesPtr, indices.Length, meshDraw.VertexBuffers[0].Count);
+            }
+        }
+    }
+}
@@ -0,0 +1,280 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Extensions;
+using Stride.Graphics;
+using Stride.Graphics.Data;
+using Stride.Native;
+using Stride.Rendering;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Checks the target count, error bound, border and seam guarantees of the native quadric mesh simplifier.
+    /// </summary>
+    public class TestMeshSimplifier
+    {
+        private const float NormalWeight = 0.5f;
+        private const float TextureWeight = 1.0f;
+
+        private const int GridSize = 16;
+
+        [Fact]
+        public void TestReachesTargetIndexCount()
+        {
+            var (vertices, indices) = CreateSphere(4);
+            var targetIndexCount = indices.Length / 4 / 3 * 3;
+
+            var result = Simplify(vertices, indices, targetIndexCount, 1.0f, out var resultError);
+
+            // Every collapse removes two triangles of the closed sphere, so the last one can go one triangle below the target
+            Assert.True(result.Length <= targetIndexCount, $"{result.Length} indices for a target of {targetIndexCount}");
+            Assert.True(result.Length >= targetIndexCount - 3, $"{result.Length} indices for a target of {targetIndexCount}");
+            Assert.True(resultError > 0.0f);
+            CheckTriangles(result, vertices.Length);
+        }
+
+        [Fact]
+        public void TestErrorBound()
+        {
+            var (vertices, indices) = CreateSphere(4);
+
+            // Any collapse bends the sphere more than that
+            var exact = Simplify(vertices, indices, 0, 1.0e-4f, out var exactError);
+            Assert.Equal(indices, exact);
+            Assert.Equal(0.0f, exactError);
+
+            var previousIndexCount = indices.Length;
+            foreach (var targetError in new[] { 0.01f, 0.03f, 0.1f })
+            {
+                var result = Simplify(vertices, indices, 0, targetError, out var resultError);
+                // The error is rounded to float before its square root is taken
+                Assert.True(resultError <= targetError * 1.0001f, $"Error {resultError} above {targetError}");
+                Assert.True(result.Length < indices.Length);
+                Assert.True(result.Length <= previousIndexCount);
+                CheckTriangles(result, vertices.Length);
+                previousIndexCount = result.Length;
+            }
+
+            // A plane with linear attributes collapses without error
+            var (gridVertices, gridIndices) = CreateGrid(false);
+            var grid = Simplify(gridVertices, gridIndices, 0, 1.0e-4f, out var gridError);
+            Assert.True(grid.Length < gridIndices.Length / 2, $"{grid.Length} indices left out of {gridIndices.Length}");
+            Assert.True(gridError <= 1.0e-4f * 1.0001f);
+        }
+
+        [Theory]
+        [InlineData(false)]
+        [InlineData(true)]
+        public void TestKeepsBordersAndSeams(bool seam)
+        {
+            var (vertices, indices) = CreateGrid(seam);
+
+            var result = Simplify(vertices, indices, 0, 1.0f, out _);
+
+            Assert.True(result.Length < indices.Length / 2, $"{result.Length} indices left out of {indices.Length}");
+            CheckTriangles(result, vertices.Length);
+
+            // Border vertices stay, so the outline is made of the same edges
+            Assert.Equal(GetBorderEdges(vertices, indices), GetBorderEdges(vertices, result));
+
+            if (seam)
+            {
+                // No triangle spans the seam, and both sides still meet along the same edges
+                var leftSeamEdges = new HashSet<(int, int)>();
+                var rightSeamEdges = new HashSet<(int, int)>();
+                for (int i = 0; i < result.Length; i += 3)
+                {
+                    var right = vertices[result[i]].TextureCoordinate.X >= 1.0f;
+                    for (int k = 0; k < 3; k++)
+                    {
+                        var a = vertices[result[i + k]];
+                        var b = vertices[result[i + (k + 1) % 3]];
+                        Assert.Equal(right, a.TextureCoordinate.X >= 1.0f);
+                        if (a.Position.X == GridSize / 2 && b.Position.X == GridSize / 2)
+                        {
+                            var edge = ((int)Math.Min(a.Position.Z, b.Position.Z), (int)Math.Max(a.Position.Z, b.Position.Z));
+                            (right ? rightSeamEdges : leftSeamEdges).Add(edge);
+                        }
+                    }
+                }
+                Assert.NotEmpty(leftSeamEdges);
+                Assert.Equal(leftSeamEdges.OrderBy(x => x), rightSeamEdges.OrderBy(x => x));
+            }
+        }
+
+        [Fact]
+        public void TestTargetAboveIndexCount()
+        {
+            var (vertices, indices) = CreateSphere(2);
+
+            foreach (var targetIndexCount in new[] { indices.Length, indices.Length + 3, int.MaxValue })
+            {
+                var result = Simplify(vertices, indices, targetIndexCount, 1.0f, out var resultError);
+                Assert.Equal(indices, result);
+                Assert.Equal(0.0f, resultError);
+            }
+        }
+
+        [Fact]
+        public void TestMeshDrawKeepsVertexBuffer()
+        {
+            var (vertices, indices) = CreateGrid(false);
+            var vertexBuffer = new VertexBufferBinding(new BufferData(BufferFlags.VertexBuffer, MemoryMarshal.AsBytes(vertices.AsSpan()).ToArray()).ToSerializableVersion(), VertexPositionNormalTexture.Layout, vertices.Length);
+            var meshDraw = new MeshDraw
+            {
+                PrimitiveType = PrimitiveType.TriangleList,
+                DrawCount = indices.Length,
+                VertexBuffers = [vertexBuffer],
+                IndexBuffer = new IndexBufferBinding(new BufferData(BufferFlags.IndexBuffer, MemoryMarshal.AsBytes(indices.Select(x => (ushort)x).ToArray().AsSpan()).ToArray()).ToSerializableVersion(), false, indices.Length),
+            };
+
+            Assert.True(meshDraw.Simplify(0.5f, 0.01f, out var resultError));
+
+            Assert.Same(vertexBuffer.Buffer, meshDraw.VertexBuffers[0].Buffer);
+            Assert.False(meshDraw.IndexBuffer.Is32Bit);
+            Assert.Equal(meshDraw.IndexBuffer.Count, meshDraw.DrawCount);
+            Assert.True(meshDraw.DrawCount <= indices.Length / 2 / 3 * 3, $"{meshDraw.DrawCount} indices left out of {indices.Length}");
+            Assert.True(resultError <= 0.01f * 1.0001f);
+
+            var result = MemoryMarshal.Cast<byte, ushort>(meshDraw.IndexBuffer.Buffer.GetSerializationData().Content.AsSpan()).ToArray().Select(x => (uint)x).ToArray();
+            Assert.Equal(GetBorderEdges(vertices, indices), GetBorderEdges(vertices, result));
+        }
+
+        private static unsafe uint[] Simplify(VertexPositionNormalTexture[] vertices, uint[] indices, int targetIndexCount, float targetError, out float resultError)
+        {
+            var destination = new uint[indices.Length];
+            int indexCount;
+            resultError = 0.0f;
+            fixed (uint* destinationPtr = destination)
+            fixed (uint* indicesPtr = indices)
+            fixed (VertexPositionNormalTexture* verticesPtr = vertices)
+            fixed (float* resultErrorPtr = &resultError)
+            {
+                indexCount = NativeInvoke.SimplifyMesh(destinationPtr, indicesPtr, indices.Length, verticesPtr, vertices.Length, targetIndexCount, targetError, NormalWeight, TextureWeight, resultErrorPtr);
+            }
+            return destination.AsSpan(0, indexCount).ToArray();
+        }
+
+        private static void CheckTriangles(uint[] indices, int vertexCount)
+        {
+            Assert.Equal(0, indices.Length % 3);
+            for (int i = 0; i < indices.Length; i += 3)
+            {
+                Assert.All(indices.AsSpan(i, 3).ToArray(), x => Assert.True(x < vertexCount));
+                Assert.True(indices[i] != indices[i + 1] && indices[i + 1] != indices[i + 2] && indices[i + 2] != indices[i], $"Degenerate triangle {i / 3}");
+            }
+        }
+
+        /// <summary>
+        /// Returns the edges used by a single triangle, as sorted position pairs.
+        /// </summary>
+        private static List<(Vector3, Vector3)> GetBorderEdges(VertexPositionNormalTexture[] vertices, uint[] indices)
+        {
+            var edgeCounts = new Dictionary<(Vector3, Vector3), int>();
+            for (int i = 0; i < indices.Length; i++)
+            {
+                var a = vertices[indices[i]].Position;
+                var b = vertices[indices[i - i % 3 + (i + 1) % 3]].Position;
+                var edge = Compare(a, b) < 0 ? (a, b) : (b, a);
+                edgeCounts[edge] = edgeCounts.GetValueOrDefault(edge) + 1;
+            }
+            var edges = edgeCounts.Where(x => x.Value == 1).Select(x => x.Key).ToList();
+            edges.Sort((x, y) => Compare(x.Item1, y.Item1) != 0 ? Compare(x.Item1, y.Item1) : Compare(x.Item2, y.Item2));
+            return edges;
+        }
+
+        private static int Compare(Vector3 left, Vector3 right)
+        {
+            return left.X != right.X ? left.X.CompareTo(right.X) : left.Y != right.Y ? left.Y.CompareTo(right.Y) : left.Z.CompareTo(right.Z);
+        }
+
+        /// <summary>
+        /// A subdivided octahedron projected on the unit sphere, closed and without seams.
+        /// </summary>
+        private static (VertexPositionNormalTexture[], uint[]) CreateSphere(int subdivisions)
+        {
+            var positions = new List<Vector3> { Vector3.UnitX, -Vector3.UnitX, Vector3.UnitY, -Vector3.UnitY, Vector3.UnitZ, -Vector3.UnitZ };
+            var triangles = new List<uint>
+            {
+                0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+                2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5,
+            };
+
+            for (int s = 0; s < subdivisions; s++)
+            {
+                var midpoints = new Dictionary<(uint, uint), uint>();
+                uint Midpoint(uint a, uint b)
+                {
+                    var key = a < b ? (a, b) : (b, a);
+                    if (!midpoints.TryGetValue(key, out var index))
+                    {
+                        index = (uint)positions.Count;
+                        positions.Add(Vector3.Normalize(positions[(int)a] + positions[(int)b]));
+                        midpoints.Add(key, index);
+                    }
+                    return index;
+                }
+
+                var subdivided = new List<uint>();
+                for (int i = 0; i < triangles.Count; i += 3)
+                {
+                    uint a = triangles[i], b = triangles[i + 1], c = triangles[i + 2];
+                    uint ab = Midpoint(a, b), bc = Midpoint(b, c), ca = Midpoint(c, a);
+                    subdivided.AddRange([a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca]);
+                }
+                triangles = subdivided;
+            }
+
+            var vertices = positions.Select(x => new VertexPositionNormalTexture(x, x, Vector2.Zero)).ToArray();
+            return (vertices, triangles.ToArray());
+        }
+
+        /// <summary>
+        /// A flat grid with texture coordinates following the positions. With a seam, the right half uses its own vertices with shifted texture coordinates.
+        /// </summary>
+        private static (VertexPositionNormalTexture[], uint[]) CreateGrid(bool seam)
+        {
+            var vertices = new List<VertexPositionNormalTexture>();
+            var indices = new int[GridSize + 1, GridSize + 1];
+            var rightIndices = new int[GridSize + 1, GridSize + 1];
+            for (int z = 0; z <= GridSize; z++)
+            {
+                for (int x = 0; x <= GridSize; x++)
+                {
+                    var position = new Vector3(x, 0, z);
+                    var right = seam && x >= GridSize / 2;
+                    if (!right || x == GridSize / 2)
+                    {
+                        indices[x, z] = vertices.Count;
+                        vertices.Add(new VertexPositionNormalTexture(position, Vector3.UnitY, new Vector2(x, z) / GridSize));
+                    }
+                    if (right)
+                    {
+                        rightIndices[x, z] = vertices.Count;
+                        vertices.Add(new VertexPositionNormalTexture(position, Vector3.UnitY, new Vector2(x, z) / GridSize + new Vector2(1, 0)));
+                    }
+                }
+            }
+
+            var triangles = new List<uint>();
+            for (int z = 0; z < GridSize; z++)
+            {
+                for (int x = 0; x < GridSize; x++)
+                {
+                    var cell = seam && x >= GridSize / 2 ? rightIndices : indices;
+                    uint v00 = (uint)cell[x, z], v10 = (uint)cell[x + 1, z], v01 = (uint)cell[x, z + 1], v11 = (uint)cell[x + 1, z + 1];
+                    triangles.AddRange([v00, v01, v10, v10, v01, v11]);
+                }
+            }
+
+            return (vertices.ToArray(), triangles.ToArray());
+        }
+    }
+}
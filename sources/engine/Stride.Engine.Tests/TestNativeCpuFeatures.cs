@@ -0,0 +1,44 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System.Runtime.InteropServices;
+using Xunit;
+using Stride.Native;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Checks the CPU features reported by libstride.
+    /// </summary>
+    public class TestNativeCpuFeatures
+    {
+        [Fact]
+        public void TestReportsBaseline()
+        {
+            var features = NativeInvoke.CpuFeatures();
+
+            switch (RuntimeInformation.ProcessArchitecture)
+            {
+                case Architecture.X86:
+                case Architecture.X64:
+                    Assert.True(features.HasFlag(NativeCpuFeatures.Sse2), $"Got {features}");
+                    break;
+                case Architecture.Arm64:
+                    Assert.True(features.HasFlag(NativeCpuFeatures.Neon), $"Got {features}");
+                    break;
+            }
+        }
+
+        [Fact]
+        public void TestReportsImpliedFeatures()
+        {
+            var features = NativeInvoke.CpuFeatures();
+
+            // Variants are selected on these features, so a wider one must never be reported without the ones it builds on
+            if (features.HasFlag(NativeCpuFeatures.Avx512))
+                Assert.True(features.HasFlag(NativeCpuFeatures.Avx2), $"Got {features}");
+            if (features.HasFlag(NativeCpuFeatures.Avx2) || features.HasFlag(NativeCpuFeatures.Fma) || features.HasFlag(NativeCpuFeatures.F16c))
+                Assert.True(features.HasFlag(NativeCpuFeatures.Avx), $"Got {features}");
+        }
+    }
+}
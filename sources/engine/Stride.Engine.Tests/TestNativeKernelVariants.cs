@@ -0,0 +1,153 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Engine.Processors;
+using Stride.Graphics;
+using Stride.Native;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the variants of the dispatched native kernels picked for this CPU with their baseline variants.
+    /// </summary>
+    /// <remarks>
+    /// Wider variants can contract multiply-adds into FMA, so results are compared with a tolerance.
+    /// On a CPU without wider instruction sets, both runs use the baseline variants.
+    /// </remarks>
+    [Collection(NativeCpuFeaturesCollection.Name)]
+    public class TestNativeKernelVariants
+    {
+        private readonly NativeCpuFeaturesFixture fixture;
+
+        public TestNativeKernelVariants(NativeCpuFeaturesFixture fixture)
+        {
+            this.fixture = fixture;
+        }
+
+        [Fact]
+        public void TestBaselineDisablesWiderFeatures()
+        {
+            var features = NativeInvoke.CpuFeatures();
+            fixture.RunBaseline(() => Assert.Equal(NativeCpuFeatures.None, NativeInvoke.CpuFeatures() & ~NativeInvoke.BaselineCpuFeatures));
+
+            // Features are enabled again afterwards
+            Assert.Equal(features, NativeInvoke.CpuFeatures());
+        }
+
+        [Fact]
+        public unsafe void TestSpriteBatchBuildVertices()
+        {
+            const int Count = 37;
+            var random = new Random(2024);
+
+            var drawInfos = new SpriteBatch.SpriteDrawInfo[Count];
+            for (int i = 0; i < Count; i++)
+            {
+                var textureSize = new Vector2(random.Next(1, 1024), random.Next(1, 1024));
+                drawInfos[i] = new SpriteBatch.SpriteDrawInfo
+                {
+                    Source = new RectangleF(NextFloat(random, 0, textureSize.X), NextFloat(random, 0, textureSize.Y), NextFloat(random, 1, 256), NextFloat(random, 1, 256)),
+                    Destination = new RectangleF(NextFloat(random, -500, 500), NextFloat(random, -500, 500), NextFloat(random, 1, 300), NextFloat(random, 1, 300)),
+                    Origin = new Vector2(NextFloat(random, -50, 50), NextFloat(random, -50, 50)),
+                    Rotation = i % 2 == 0 ? 0.0f : NextFloat(random, -6.3f, 6.3f),
+                    Depth = NextFloat(random, 0, 1),
+                    SpriteEffects = (SpriteEffects)random.Next(4),
+                    ColorScale = new Color4(NextFloat(random, 0, 1), NextFloat(random, 0, 1), NextFloat(random, 0, 1), NextFloat(random, 0, 1)),
+                    ColorAdd = new Color4(NextFloat(random, 0, 1), NextFloat(random, 0, 1), NextFloat(random, 0, 1), 0),
+                    Swizzle = (SwizzleMode)random.Next(4),
+                    TextureSize = textureSize,
+                    Orientation = (ImageOrientation)random.Next(2),
+                };
+            }
+
+            var expected = new VertexPositionColorTextureSwizzle[4 * Count];
+            var actual = new VertexPositionColorTextureSwizzle[4 * Count];
+            fixed (SpriteBatch.SpriteDrawInfo* drawInfosPtr = drawInfos)
+            {
+                var drawInfosPointer = (IntPtr)drawInfosPtr;
+                fixture.RunBaseline(() => BuildVertices(drawInfosPointer, expected));
+                BuildVertices(drawInfosPointer, actual);
+            }
+
+            for (int i = 0; i < 4 * Count; i++)
+            {
+                AssertNearEqual(expected[i].Position, actual[i].Position);
+                AssertNearEqual(expected[i].ColorScale.ToVector4(), actual[i].ColorScale.ToVector4());
+                AssertNearEqual(expected[i].ColorAdd.ToVector4(), actual[i].ColorAdd.ToVector4());
+                AssertNearEqual(new Vector4(expected[i].TextureCoordinate, 0, 0), new Vector4(actual[i].TextureCoordinate, 0, 0));
+                Assert.Equal(expected[i].Swizzle, actual[i].Swizzle);
+            }
+
+            static void BuildVertices(IntPtr drawInfos, VertexPositionColorTextureSwizzle[] vertices)
+            {
+                fixed (VertexPositionColorTextureSwizzle* verticesPtr = vertices)
+                {
+                    NativeInvoke.SpriteBatchBuildVertices((void*)drawInfos, sizeof(SpriteBatch.SpriteDrawInfo), vertices.Length / 4, verticesPtr);
+                }
+            }
+        }
+
+        [Fact]
+        public void TestTransformPropagate()
+        {
+            const int Count = 1000;
+            var random = new Random(4096);
+
+            // Parents always come before their children, some transforms are roots
+            var parentIndex = new int[Count];
+            var local = new TransformPropagation.LocalTransform[Count];
+            for (int i = 0; i < Count; i++)
+            {
+                parentIndex[i] = i == 0 || random.Next(10) == 0 ? -1 : random.Next(i);
+                local[i] = new TransformPropagation.LocalTransform
+                {
+                    Scale = new Vector3(NextFloat(random, 0.8f, 1.25f), NextFloat(random, 0.8f, 1.25f), NextFloat(random, 0.8f, 1.25f)),
+                    Rotation = Quaternion.RotationYawPitchRoll(NextFloat(random, -3, 3), NextFloat(random, -3, 3), NextFloat(random, -3, 3)),
+                    Position = new Vector3(NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10)),
+                };
+            }
+
+            var expected = new Matrix[Count];
+            var actual = new Matrix[Count];
+            fixture.RunBaseline(() => Propagate(parentIndex, local, expected));
+            Propagate(parentIndex, local, actual);
+
+            for (int i = 0; i < Count; i++)
+            {
+                for (int j = 0; j < 16; j++)
+                {
+                    var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i][j]));
+                    Assert.True(Math.Abs(expected[i][j] - actual[i][j]) <= tolerance, $"Transform {i}, element {j}: expected {expected[i][j]}, got {actual[i][j]}");
+                }
+            }
+
+            // One range at a time, so that parents are computed before their children
+            static unsafe void Propagate(int[] parentIndex, TransformPropagation.LocalTransform[] local, Matrix[] world)
+            {
+                fixed (int* parentIndexPtr = parentIndex)
+                fixed (TransformPropagation.LocalTransform* localPtr = local)
+                fixed (Matrix* worldPtr = world)
+                {
+                    NativeInvoke.TransformPropagate(parentIndexPtr, localPtr, null, worldPtr, 0, world.Length);
+                }
+            }
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(Vector4 expected, Vector4 actual)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i]));
+                Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Component {i}: expected {expected}, got {actual}");
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.IO;
+using System.Linq;
+using System.Text.Json;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+using Stride.Core.Diagnostics;
+using Stride.Native;
+using Stride.Profiling;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Checks that zones traced by libstride reach offline captures through <see cref="NativeProfiling"/> and <see cref="ChromeTracingProfileWriter"/>.
+    /// </summary>
+    public class TestNativeProfiling
+    {
+        private static readonly ProfilingKey SentinelKey = new ProfilingKey("TestNativeProfiling");
+
+        // NP_TRACE_BUFFER_SIZE
+        private const int TraceBufferSize = 4096;
+
+        [Fact]
+        public async Task TestZonesAreWrittenToChromeTrace()
+        {
+            var outputPath = Path.GetTempFileName();
+            var minimumProfileDuration = Profiler.MinimumProfileDuration;
+            try
+            {
+                // Optimizing a single triangle is faster than the default minimum duration
+                Profiler.MinimumProfileDuration = TimeSpan.Zero;
+
+                var writer = new ChromeTracingProfileWriter();
+                writer.Start(outputPath);
+                var reader = Profiler.Subscribe();
+
+                using (var nativeProfiling = new NativeProfiling())
+                {
+                    nativeProfiling.Enable();
+                    OptimizeTriangle();
+                    nativeProfiling.Tick();
+                }
+
+                // Events of a thread reach subscribers in order, so once the sentinel is received the writer has the native zone too
+                Profiler.Enable(SentinelKey);
+                using (Profiler.Begin(SentinelKey))
+                {
+                }
+
+                using (var timeout = new CancellationTokenSource(TimeSpan.FromSeconds(10)))
+                {
+                    while ((await reader.ReadAsync(timeout.Token)).Key != SentinelKey)
+                    {
+                    }
+                }
+                Profiler.Unsubscribe(reader);
+                writer.Stop();
+
+                using var trace = JsonDocument.Parse(File.ReadAllBytes(outputPath));
+                var zones = trace.RootElement.GetProperty("traceEvents").EnumerateArray()
+                    .Where(x => x.GetProperty("name").GetString() == "xnOptimizeVertexCache")
+                    .ToList();
+
+                Assert.NotEmpty(zones);
+                foreach (var zone in zones)
+                {
+                    Assert.Equal(NativeProfiling.NativeKey.Name, zone.GetProperty("cat").GetString());
+                    Assert.Equal("X", zone.GetProperty("ph").GetString());
+                    Assert.True(zone.GetProperty("ts").GetDouble() >= 0.0);
+                    Assert.True(zone.GetProperty("dur").GetDouble() >= 0.0);
+                    // Native threads are kept apart from managed ones
+                    Assert.True(zone.GetProperty("tid").GetInt32() >= 1 << 16);
+                }
+            }
+            finally
+            {
+                Profiler.Disable(SentinelKey);
+                Profiler.MinimumProfileDuration = minimumProfileDuration;
+                File.Delete(outputPath);
+            }
+        }
+
+        [Fact]
+        public void TestDroppedZonesAreCounted()
+        {
+            using var nativeProfiling = new NativeProfiling();
+            nativeProfiling.Enable();
+
+            // Start from an empty buffer on this thread
+            nativeProfiling.Tick();
+            var droppedBefore = NativeInvoke.TraceDroppedCount();
+
+            const int extraZoneCount = 100;
+            for (int i = 0; i < TraceBufferSize + extraZoneCount; i++)
+                OptimizeTriangle();
+
+            Assert.True(NativeInvoke.TraceDroppedCount() - droppedBefore >= extraZoneCount);
+
+            nativeProfiling.Tick();
+            Assert.True(nativeProfiling.DroppedZoneCount >= droppedBefore + extraZoneCount);
+        }
+
+        private static unsafe void OptimizeTriangle()
+        {
+            var indices = stackalloc uint[] { 0, 1, 2 };
+            var destination = stackalloc uint[3];
+            Assert.True(NativeInvoke.OptimizeVertexCache(destination, indices, 3, 3));
+        }
+    }
+}
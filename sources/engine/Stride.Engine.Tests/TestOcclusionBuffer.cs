@@ -0,0 +1,281 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Collections.Generic;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Rendering;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the native masked occlusion culling of <see cref="OcclusionBuffer"/> with a managed per pixel depth buffer.
+    /// </summary>
+    /// <remarks>
+    /// The tile layers only keep conservative depths, so the native buffer may report a hidden box as visible, but never the opposite.
+    /// </remarks>
+    public class TestOcclusionBuffer
+    {
+        // Distance to an edge, in pixels, and depth difference under which the reference doesn't decide
+        private const double EdgeTolerance = 1e-3;
+        private const double DepthTolerance = 1e-4;
+
+        [Fact]
+        public void TestNeverHidesVisibleBoxes()
+        {
+            var random = new Random(4242);
+            var viewProjection = CreateViewProjection();
+
+            // Not multiples of the tile size
+            var buffer = new OcclusionBuffer(60, 30);
+            var reference = new ReferenceBuffer(buffer.Width, buffer.Height);
+            buffer.Begin(ref viewProjection);
+
+            // Random triangles, some of them crossing the near plane or behind the camera
+            var world = Matrix.Identity;
+            for (int occluder = 0; occluder < 6; occluder++)
+            {
+                var positions = new Vector3[12];
+                for (int i = 0; i < positions.Length; i++)
+                    positions[i] = new Vector3(NextFloat(random, -15, 15), NextFloat(random, -10, 10), NextFloat(random, -40, 3));
+                var indices = new int[3 * 8];
+                for (int i = 0; i < indices.Length; i++)
+                    indices[i] = random.Next(positions.Length);
+
+                buffer.AddOccluder(positions, indices, ref world);
+                reference.AddOccluder(positions, indices, viewProjection);
+            }
+
+            // A rotated quad, to get a large occluder in the middle of the view
+            var quadWorld = Matrix.RotationYawPitchRoll(0.3f, 0.2f, 0.1f) * Matrix.Translation(0, 0, -15);
+            var quadPositions = new[] { new Vector3(-6, -4, 0), new Vector3(6, -4, 0), new Vector3(6, 4, 0), new Vector3(-6, 4, 0) };
+            var quadIndices = new[] { 0, 1, 2, 0, 2, 3 };
+            buffer.AddOccluder(quadPositions, quadIndices, ref quadWorld);
+            var transformedQuad = Array.ConvertAll(quadPositions, position => Vector3.TransformCoordinate(position, quadWorld));
+            reference.AddOccluder(transformedQuad, quadIndices, viewProjection);
+
+            buffer.Rasterize();
+
+            var boxes = new BoundingBox[500];
+            for (int i = 0; i < boxes.Length; i++)
+            {
+                var center = new Vector3(NextFloat(random, -15, 15), NextFloat(random, -10, 10), NextFloat(random, -45, 1));
+                var extent = new Vector3(NextFloat(random, 0.05f, 2), NextFloat(random, 0.05f, 2), NextFloat(random, 0.05f, 2));
+                boxes[i] = new BoundingBox(center - extent, center + extent);
+            }
+
+            var visibility = new byte[boxes.Length];
+            buffer.TestBoxes(boxes, visibility);
+
+            var visibleCount = 0;
+            for (int i = 0; i < boxes.Length; i++)
+            {
+                var boxExt = new BoundingBoxExt(boxes[i]);
+                var visible = buffer.IsVisible(ref boxExt);
+                Assert.Equal(visible ? 1 : 0, visibility[i]);
+
+                if (reference.IsDefinitelyVisible(boxes[i], viewProjection))
+                {
+                    Assert.True(visible, $"Box {i} {boxes[i]} is visible but was culled");
+                    visibleCount++;
+                }
+            }
+
+            Assert.True(visibleCount > 0, "No box is visible");
+            Assert.True(visibleCount < boxes.Length, "No box is hidden");
+        }
+
+        [Fact]
+        public void TestHidesBoxesBehindWall()
+        {
+            var random = new Random(1212);
+            var viewProjection = CreateViewProjection();
+
+            var buffer = new OcclusionBuffer(64, 32);
+            buffer.Begin(ref viewProjection);
+
+            // Covers the whole view, with a constant depth
+            var world = Matrix.Identity;
+            var wallPositions = new[] { new Vector3(-100, -100, -10), new Vector3(100, -100, -10), new Vector3(100, 100, -10), new Vector3(-100, 100, -10) };
+            buffer.AddOccluder(wallPositions, new[] { 0, 1, 2, 0, 2, 3 }, ref world);
+            buffer.Rasterize();
+
+            for (int i = 0; i < 100; i++)
+            {
+                var center = new Vector3(NextFloat(random, -5, 5), NextFloat(random, -5, 5), NextFloat(random, -60, -13));
+                var extent = new Vector3(NextFloat(random, 0.1f, 2), NextFloat(random, 0.1f, 2), NextFloat(random, 0.1f, 2));
+                var behind = new BoundingBoxExt(center - extent, center + extent);
+                Assert.False(buffer.IsVisible(ref behind), $"Box {i} behind the wall is visible");
+
+                center.Z = NextFloat(random, -8, -3);
+                var inFront = new BoundingBoxExt(center - extent * 0.5f, center + extent * 0.5f);
+                Assert.True(buffer.IsVisible(ref inFront), $"Box {i} in front of the wall is hidden");
+            }
+        }
+
+        private static Matrix CreateViewProjection()
+        {
+            var view = Matrix.LookAtRH(new Vector3(0.5f, 1, 2), new Vector3(0, 0, -20), Vector3.UnitY);
+            var projection = Matrix.PerspectiveFovRH(MathUtil.PiOverTwo, 2.0f, 0.5f, 100.0f);
+            return view * projection;
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        /// <summary>
+        /// Per pixel depth buffer, where a pixel gets the nearest depth of the triangles that might cover its center.
+        /// </summary>
+        private class ReferenceBuffer
+        {
+            private readonly int width;
+            private readonly int height;
+            private readonly double[] depths;
+
+            public ReferenceBuffer(int width, int height)
+            {
+                this.width = width;
+                this.height = height;
+                depths = new double[width * height];
+                Array.Fill(depths, 1.0);
+            }
+
+            public void AddOccluder(Vector3[] positions, int[] indices, Matrix viewProjection)
+            {
+                for (int i = 0; i < indices.Length; i += 3)
+                {
+                    // Clip against the near plane (z >= 0), then rasterize the fan
+                    var polygon = new List<Double4>();
+                    for (int j = 0; j < 3; j++)
+                    {
+                        var current = Transform(positions[indices[i + j]], viewProjection);
+                        var next = Transform(positions[indices[i + (j + 1) % 3]], viewProjection);
+                        if (current.Z >= 0)
+                            polygon.Add(current);
+                        if ((current.Z >= 0) != (next.Z >= 0))
+                            polygon.Add(Double4.Lerp(current, next, current.Z / (current.Z - next.Z)));
+                    }
+
+                    for (int j = 2; j < polygon.Count; j++)
+                        RasterizeTriangle(Project(polygon[0]), Project(polygon[j - 1]), Project(polygon[j]));
+                }
+            }
+
+            /// <summary>
+            /// Whether a pixel the box surely touches is behind the box.
+            /// </summary>
+            public bool IsDefinitelyVisible(BoundingBox box, Matrix viewProjection)
+            {
+                double minX = double.MaxValue, minY = double.MaxValue, maxX = double.MinValue, maxY = double.MinValue;
+                var minDepth = double.MaxValue;
+                for (int corner = 0; corner < 8; corner++)
+                {
+                    var position = new Vector3(
+                        (corner & 1) != 0 ? box.Maximum.X : box.Minimum.X,
+                        (corner & 2) != 0 ? box.Maximum.Y : box.Minimum.Y,
+                        (corner & 4) != 0 ? box.Maximum.Z : box.Minimum.Z);
+                    var clipPosition = Transform(position, viewProjection);
+
+                    // Crossing the near plane
+                    if (clipPosition.Z <= DepthTolerance * clipPosition.W || clipPosition.W <= 0)
+                        return false;
+
+                    var vertex = Project(clipPosition);
+                    minX = Math.Min(minX, vertex.X);
+                    maxX = Math.Max(maxX, vertex.X);
+                    minY = Math.Min(minY, vertex.Y);
+                    maxY = Math.Max(maxY, vertex.Y);
+                    minDepth = Math.Min(minDepth, vertex.Z);
+                }
+
+                var startX = Math.Max((int)Math.Floor(minX + EdgeTolerance), 0);
+                var endX = Math.Min((int)Math.Floor(maxX - EdgeTolerance) + 1, width);
+                var startY = Math.Max((int)Math.Floor(minY + EdgeTolerance), 0);
+                var endY = Math.Min((int)Math.Floor(maxY - EdgeTolerance) + 1, height);
+
+                for (int y = startY; y < endY; y++)
+                {
+                    for (int x = startX; x < endX; x++)
+                    {
+                        if (depths[y * width + x] > minDepth + DepthTolerance)
+                            return true;
+                    }
+                }
+
+                return false;
+            }
+
+            private void RasterizeTriangle(Double4 v0, Double4 v1, Double4 v2)
+            {
+                var area = (v1.X - v0.X) * (v2.Y - v0.Y) - (v2.X - v0.X) * (v1.Y - v0.Y);
+                if (area == 0)
+                    return;
+
+                for (int y = 0; y < height; y++)
+                {
+                    for (int x = 0; x < width; x++)
+                    {
+                        var px = x + 0.5;
+                        var py = y + 0.5;
+
+                        // Barycentric coordinates, allowing centers within rounding distance of an edge
+                        var w0 = ((v1.X - px) * (v2.Y - py) - (v2.X - px) * (v1.Y - py)) / area;
+                        var w1 = ((v2.X - px) * (v0.Y - py) - (v0.X - px) * (v2.Y - py)) / area;
+                        var w2 = 1 - w0 - w1;
+                        if (!IsNearInside(w0, v1, v2) || !IsNearInside(w1, v2, v0) || !IsNearInside(w2, v0, v1))
+                            continue;
+
+                        var depth = w0 * v0.Z + w1 * v1.Z + w2 * v2.Z;
+                        var index = y * width + x;
+                        depths[index] = Math.Min(depths[index], depth - DepthTolerance);
+                    }
+                }
+
+                bool IsNearInside(double weight, Double4 edgeStart, Double4 edgeEnd)
+                {
+                    if (weight >= 0)
+                        return true;
+
+                    // Barycentric coordinate to pixel distance from the opposite edge
+                    var edgeLength = Math.Sqrt((edgeEnd.X - edgeStart.X) * (edgeEnd.X - edgeStart.X) + (edgeEnd.Y - edgeStart.Y) * (edgeEnd.Y - edgeStart.Y));
+                    return -weight * Math.Abs(area) / edgeLength <= EdgeTolerance;
+                }
+            }
+
+            private static Double4 Transform(Vector3 position, Matrix matrix)
+            {
+                double x = position.X, y = position.Y, z = position.Z;
+                return new Double4(
+                    x * matrix.M11 + y * matrix.M21 + z * matrix.M31 + matrix.M41,
+                    x * matrix.M12 + y * matrix.M22 + z * matrix.M32 + matrix.M42,
+                    x * matrix.M13 + y * matrix.M23 + z * matrix.M33 + matrix.M43,
+                    x * matrix.M14 + y * matrix.M24 + z * matrix.M34 + matrix.M44);
+            }
+
+            // Pixels, z / w
+            private Double4 Project(Double4 clipPosition)
+            {
+                return new Double4(
+                    (clipPosition.X / clipPosition.W * 0.5 + 0.5) * width,
+                    (0.5 - clipPosition.Y / clipPosition.W * 0.5) * height,
+                    clipPosition.Z / clipPosition.W,
+                    1);
+            }
+        }
+
+        private readonly record struct Double4(double X, double Y, double Z, double W)
+        {
+            public static Double4 Lerp(Double4 from, Double4 to, double amount)
+            {
+                return new Double4(
+                    from.X + (to.X - from.X) * amount,
+                    from.Y + (to.Y - from.Y) * amount,
+                    from.Z + (to.Z - from.Z) * amount,
+                    from.W + (to.W - from.W) * amount);
+            }
+        }
+    }
+}
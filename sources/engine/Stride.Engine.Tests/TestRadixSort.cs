@@ -0,0 +1,68 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Linq;
+using Xunit;
+using Stride.Native;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the native radix sort with a stable <see cref="Enumerable.OrderBy{TSource, TKey}(System.Collections.Generic.IEnumerable{TSource}, Func{TSource, TKey})"/>.
+    /// </summary>
+    public class TestRadixSort
+    {
+        [Theory]
+        [InlineData(0, 0)]
+        [InlineData(1000, 0)]
+        [InlineData(1000, 40)]
+        [InlineData(5000, 56)]
+        public unsafe void TestMatchesStableSort(int count, int shift)
+        {
+            var random = new Random(777 + count + shift);
+
+            // Few distinct values so that the stability is checked, shifted so that some passes have a single digit and get skipped
+            var keys = new ulong[count];
+            for (int i = 0; i < count; i++)
+                keys[i] = (ulong)random.Next(200) << shift;
+
+            var expected = Enumerable.Range(0, count).OrderBy(i => keys[i]).ToArray();
+
+            var sortedKeys = (ulong[])keys.Clone();
+            var indices = Enumerable.Range(0, count).ToArray();
+            fixed (ulong* keysPtr = sortedKeys)
+            fixed (int* indicesPtr = indices)
+            {
+                Assert.True(NativeInvoke.RadixSortKeys(keysPtr, (uint*)indicesPtr, count));
+            }
+
+            Assert.Equal(expected, indices);
+            Assert.Equal(expected.Select(i => keys[i]), sortedKeys);
+        }
+
+        [Fact]
+        public unsafe void TestMatchesStableSort32()
+        {
+            const int Count = 3000;
+            var random = new Random(4242);
+
+            var keys = new uint[Count];
+            for (int i = 0; i < Count; i++)
+                keys[i] = (uint)random.Next(1000) * 0x10001u;
+
+            var expected = Enumerable.Range(0, Count).OrderBy(i => keys[i]).ToArray();
+
+            var sortedKeys = (uint[])keys.Clone();
+            var indices = Enumerable.Range(0, Count).ToArray();
+            fixed (uint* keysPtr = sortedKeys)
+            fixed (int* indicesPtr = indices)
+            {
+                Assert.True(NativeInvoke.RadixSortKeys32(keysPtr, (uint*)indicesPtr, Count));
+            }
+
+            Assert.Equal(expected, indices);
+            Assert.Equal(expected.Select(i => keys[i]), sortedKeys);
+        }
+    }
+}
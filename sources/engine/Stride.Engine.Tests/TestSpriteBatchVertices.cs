@@ -0,0 +1,81 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Graphics;
+using Stride.Native;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares the native sprite vertex expansion with <see cref="SpriteBatch.BuildVertices"/>.
+    /// </summary>
+    public class TestSpriteBatchVertices
+    {
+        [Theory]
+        [InlineData(1)]
+        [InlineData(67)]
+        public unsafe void TestMatchesManagedVertices(int count)
+        {
+            var random = new Random(31 + count);
+
+            var drawInfos = new SpriteBatch.SpriteDrawInfo[count];
+            for (int i = 0; i < count; i++)
+            {
+                var textureSize = new Vector2(random.Next(1, 1024), random.Next(1, 1024));
+                drawInfos[i] = new SpriteBatch.SpriteDrawInfo
+                {
+                    Source = new RectangleF(NextFloat(random, 0, textureSize.X), NextFloat(random, 0, textureSize.Y), NextFloat(random, 1, 256), NextFloat(random, 1, 256)),
+                    Destination = new RectangleF(NextFloat(random, -500, 500), NextFloat(random, -500, 500), NextFloat(random, 1, 300), NextFloat(random, 1, 300)),
+                    Origin = new Vector2(NextFloat(random, -50, 50), NextFloat(random, -50, 50)),
+                    // Every other sprite is not rotated, which takes a different path in the managed code
+                    Rotation = i % 2 == 0 ? 0.0f : NextFloat(random, -6.3f, 6.3f),
+                    Depth = NextFloat(random, 0, 1),
+                    SpriteEffects = (SpriteEffects)random.Next(4),
+                    ColorScale = new Color4(NextFloat(random, 0, 1), NextFloat(random, 0, 1), NextFloat(random, 0, 1), NextFloat(random, 0, 1)),
+                    ColorAdd = new Color4(NextFloat(random, 0, 1), NextFloat(random, 0, 1), NextFloat(random, 0, 1), 0),
+                    Swizzle = (SwizzleMode)random.Next(4),
+                    TextureSize = textureSize,
+                    Orientation = (ImageOrientation)random.Next(2),
+                };
+            }
+
+            var expected = new VertexPositionColorTextureSwizzle[4 * count];
+            var actual = new VertexPositionColorTextureSwizzle[4 * count];
+            fixed (SpriteBatch.SpriteDrawInfo* drawInfosPtr = drawInfos)
+            fixed (VertexPositionColorTextureSwizzle* expectedPtr = expected)
+            fixed (VertexPositionColorTextureSwizzle* actualPtr = actual)
+            {
+                for (int i = 0; i < count; i++)
+                    SpriteBatch.BuildVertices(drawInfosPtr + i, expectedPtr + 4 * i);
+
+                NativeInvoke.SpriteBatchBuildVertices(drawInfosPtr, sizeof(SpriteBatch.SpriteDrawInfo), count, actualPtr);
+            }
+
+            for (int i = 0; i < 4 * count; i++)
+            {
+                AssertNearEqual(expected[i].Position, actual[i].Position);
+                AssertNearEqual(expected[i].ColorScale.ToVector4(), actual[i].ColorScale.ToVector4());
+                AssertNearEqual(expected[i].ColorAdd.ToVector4(), actual[i].ColorAdd.ToVector4());
+                AssertNearEqual(new Vector4(expected[i].TextureCoordinate, 0, 0), new Vector4(actual[i].TextureCoordinate, 0, 0));
+                Assert.Equal(expected[i].Swizzle, actual[i].Swizzle);
+            }
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(Vector4 expected, Vector4 actual)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i]));
+                Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Component {i}: expected {expected}, got {actual}");
+            }
+        }
+    }
+}
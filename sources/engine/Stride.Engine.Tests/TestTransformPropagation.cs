@@ -0,0 +1,151 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Collections.Generic;
+using Xunit;
+using Stride.Core;
+using Stride.Core.Mathematics;
+using Stride.Engine.Processors;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Compares <see cref="TransformPropagation"/> and the native path of <see cref="TransformProcessor"/> with <see cref="TransformComponent.UpdateWorldMatrix"/>.
+    /// </summary>
+    public class TestTransformPropagation
+    {
+        [Fact]
+        public unsafe void TestMatchesUpdateWorldMatrix()
+        {
+            var random = new Random(1234);
+
+            // 3 roots, each with 3 children, each with 2 children, each with 1 child
+            var levels = new List<List<TransformComponent>> { new List<TransformComponent>() };
+            for (int i = 0; i < 3; i++)
+                levels[0].Add(CreateTransform(random, null));
+            foreach (var childCount in new[] { 3, 2, 1 })
+            {
+                var level = new List<TransformComponent>();
+                foreach (var parent in levels[levels.Count - 1])
+                {
+                    for (int i = 0; i < childCount; i++)
+                        level.Add(CreateTransform(random, parent));
+                }
+                levels.Add(level);
+            }
+
+            // Depth-sorted arrays
+            var transforms = new List<TransformComponent>();
+            var levelStarts = new int[levels.Count + 1];
+            for (int level = 0; level < levels.Count; level++)
+            {
+                transforms.AddRange(levels[level]);
+                levelStarts[level + 1] = transforms.Count;
+            }
+
+            var parentIndex = new int[transforms.Count];
+            var local = new TransformPropagation.LocalTransform[transforms.Count];
+            for (int i = 0; i < transforms.Count; i++)
+            {
+                var transform = transforms[i];
+                parentIndex[i] = transform.Parent != null ? transforms.IndexOf(transform.Parent) : -1;
+                local[i] = new TransformPropagation.LocalTransform { Scale = transform.Scale, Rotation = transform.Rotation, Position = transform.Position };
+            }
+
+            var world = new Matrix[transforms.Count];
+            fixed (int* parentIndexPtr = parentIndex)
+            fixed (TransformPropagation.LocalTransform* localPtr = local)
+            fixed (Matrix* worldPtr = world)
+            fixed (int* levelStartsPtr = levelStarts)
+            {
+                TransformPropagation.Propagate(parentIndexPtr, localPtr, null, worldPtr, levelStartsPtr, levels.Count);
+            }
+
+            for (int i = 0; i < transforms.Count; i++)
+            {
+                transforms[i].UpdateWorldMatrix();
+                AssertNearEqual(transforms[i].WorldMatrix, world[i]);
+            }
+        }
+
+        [Fact]
+        public void TestProcessorMatchesManagedPath()
+        {
+            var random = new Random(5678);
+            var entityManager = new CustomEntityManager(new ServiceRegistry());
+            var scene = new Scene { Offset = new Vector3(1, 2, 3) };
+            scene.UpdateWorldMatrix();
+
+            // Roots inside and outside of a scene, and a transform with its own local matrix whose children are updated in managed code
+            var transforms = new List<TransformComponent>();
+            for (int i = 0; i < 4; i++)
+            {
+                var root = CreateTransform(random, null);
+                if (i < 3)
+                    root.Entity.Scene = scene;
+                transforms.Add(root);
+
+                var child = CreateTransform(random, root);
+                transforms.Add(child);
+                transforms.Add(CreateTransform(random, child));
+                transforms.Add(CreateTransform(random, CreateTransform(random, child)));
+            }
+            var customLocal = transforms[1];
+            customLocal.UseTRS = false;
+            customLocal.LocalMatrix = Matrix.RotationX(0.5f) * Matrix.Translation(4, 5, 6);
+
+            foreach (var transform in transforms)
+            {
+                if (transform.Parent == null)
+                    entityManager.Add(transform.Entity);
+            }
+            var processor = entityManager.GetProcessor<TransformProcessor>();
+
+            processor.UseNativePropagation = true;
+            processor.Draw(null);
+            var nativeLocal = new List<Matrix>();
+            var nativeWorld = new List<Matrix>();
+            foreach (var transform in transforms)
+            {
+                nativeLocal.Add(transform.LocalMatrix);
+                nativeWorld.Add(transform.WorldMatrix);
+                if (transform.UseTRS)
+                    transform.LocalMatrix = Matrix.Identity;
+                transform.WorldMatrix = Matrix.Identity;
+            }
+
+            processor.UseNativePropagation = false;
+            processor.Draw(null);
+            for (int i = 0; i < transforms.Count; i++)
+            {
+                AssertNearEqual(transforms[i].LocalMatrix, nativeLocal[i]);
+                AssertNearEqual(transforms[i].WorldMatrix, nativeWorld[i]);
+            }
+        }
+
+        private static TransformComponent CreateTransform(Random random, TransformComponent parent)
+        {
+            var transform = new Entity().Transform;
+            transform.Position = new Vector3(NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10));
+            transform.Rotation = Quaternion.RotationYawPitchRoll(NextFloat(random, -3, 3), NextFloat(random, -3, 3), NextFloat(random, -3, 3));
+            transform.Scale = new Vector3(NextFloat(random, 0.5f, 2), NextFloat(random, 0.5f, 2), NextFloat(random, 0.5f, 2));
+            transform.Parent = parent;
+            return transform;
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(Matrix expected, Matrix actual)
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i]));
+                Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Element {i}: expected {expected[i]}, got {actual[i]}");
+            }
+        }
+    }
+}
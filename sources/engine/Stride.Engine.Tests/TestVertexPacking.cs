@@ -0,0 +1,269 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Runtime.InteropServices;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Extensions;
+using Stride.Graphics;
+using Stride.Graphics.Data;
+using Stride.Native;
+
+namespace Stride.Engine.Tests
+{
+    /// <summary>
+    /// Packs vertex attributes natively and decodes them the way the input assembler and VertexQuantization.sdsl do, checking the error bounds.
+    /// </summary>
+    public class TestVertexPacking
+    {
+        // Rounding to 16-bit octahedral coordinates moves directions by up to about 4e-5 radians
+        private const double MaxOctahedralAngle = 1.0e-4;
+
+        [Fact]
+        public unsafe void TestHalf2MatchesHalfConversion()
+        {
+            var random = new Random(5);
+            var values = new float[2 * 1001];
+            for (int i = 0; i < values.Length; i++)
+                values[i] = (float)((random.NextDouble() * 2.0 - 1.0) * Math.Pow(2.0, random.Next(-26, 18)));
+
+            // Denormals, rounding ties, overflow and infinities
+            float[] special = [0.0f, -0.0f, 1.0f, 65504.0f, 65519.0f, 65520.0f, -1.0e9f, float.PositiveInfinity, float.NegativeInfinity, 5.96e-8f, 2.0e-8f, 1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f];
+            special.CopyTo(values, 0);
+
+            // Odd count, to cover the last unpaired element
+            var count = values.Length / 2 - 2;
+            var packed = new ushort[values.Length];
+            fixed (float* valuesPtr = values)
+            fixed (ushort* packedPtr = packed)
+            {
+                NativeInvoke.PackHalf2(valuesPtr, 2 * sizeof(float), packedPtr, 2 * sizeof(ushort), count);
+            }
+
+            for (int i = 0; i < count * 2; i++)
+                Assert.Equal(BitConverter.HalfToUInt16Bits((Half)values[i]), packed[i]);
+            Assert.Equal(0, packed[count * 2]);
+
+            var nan = new Vector2(float.NaN, -float.NaN);
+            var packedNan = new ushort[2];
+            fixed (ushort* packedPtr = packedNan)
+            {
+                NativeInvoke.PackHalf2(&nan, sizeof(Vector2), packedPtr, 2 * sizeof(ushort), 1);
+            }
+            Assert.True(Half.IsNaN(BitConverter.UInt16BitsToHalf(packedNan[0])));
+            Assert.True(Half.IsNaN(BitConverter.UInt16BitsToHalf(packedNan[1])));
+        }
+
+        [Fact]
+        public unsafe void TestNormalOctahedralRoundTrip()
+        {
+            var random = new Random(6);
+            var normals = new Vector3[4099];
+            for (int i = 0; i < normals.Length; i++)
+                normals[i] = RandomDirection(random);
+
+            var packed = PackNormals(normals);
+            for (int i = 0; i < normals.Length; i++)
+            {
+                var decoded = DecodeOctahedralNormal(packed[i * 2], packed[i * 2 + 1]);
+                Assert.True(Angle(normals[i], decoded) <= MaxOctahedralAngle, $"{normals[i]} decoded as {decoded}");
+            }
+        }
+
+        [Fact]
+        public void TestNormalOctahedralAxesAndZero()
+        {
+            // Poles and the fold of the lower hemisphere decode exactly, for both signs of zero
+            Vector3[] axes = [Vector3.UnitX, -Vector3.UnitX, Vector3.UnitY, -Vector3.UnitY, Vector3.UnitZ, -Vector3.UnitZ, new Vector3(-0.0f, -0.0f, -1.0f), new Vector3(-0.0f, 0.0f, 1.0f)];
+            var packed = PackNormals(axes);
+            for (int i = 0; i < axes.Length; i++)
+            {
+                var decoded = DecodeOctahedralNormal(packed[i * 2], packed[i * 2 + 1]);
+                Assert.Equal(axes[i], decoded);
+            }
+            Assert.Equal(new short[] { 0, 0 }, packed.AsSpan(4 * 2, 2).ToArray());
+            Assert.Equal(new short[] { 32767, 32767 }, packed.AsSpan(5 * 2, 2).ToArray());
+
+            // A zero vector has no direction, it is stored as +Z instead of producing NaNs
+            var zero = PackNormals([Vector3.Zero]);
+            Assert.Equal(new short[] { 0, 0 }, zero);
+            Assert.Equal(Vector3.UnitZ, DecodeOctahedralNormal(zero[0], zero[1]));
+        }
+
+        [Fact]
+        public unsafe void TestTangentOctahedralKeepsHandedness()
+        {
+            var random = new Random(7);
+            var tangents = new Vector4[1023];
+            for (int i = 0; i < tangents.Length; i++)
+                tangents[i] = new Vector4(RandomDirection(random), i % 3 == 0 ? -1.0f : 1.0f);
+            tangents[0] = new Vector4(0, 0, -1, -1);
+            tangents[1] = new Vector4(0, 0, 1, -0.0f);
+            tangents[2] = new Vector4(1, 0, 0, 0.0f);
+
+            var packed = new short[tangents.Length * 4];
+            fixed (Vector4* tangentsPtr = tangents)
+            fixed (short* packedPtr = packed)
+            {
+                NativeInvoke.PackTangentOctahedral(tangentsPtr, sizeof(Vector4), packedPtr, 4 * sizeof(short), tangents.Length);
+            }
+
+            var normals = new Vector3[tangents.Length];
+            for (int i = 0; i < tangents.Length; i++)
+                normals[i] = (Vector3)tangents[i];
+            var packedNormals = PackNormals(normals);
+
+            for (int i = 0; i < tangents.Length; i++)
+            {
+                // The direction uses the normal encoding, the handedness only keeps its sign (0 and -0 count as positive)
+                Assert.Equal(packedNormals[i * 2], packed[i * 4]);
+                Assert.Equal(packedNormals[i * 2 + 1], packed[i * 4 + 1]);
+                Assert.Equal(tangents[i].W < 0.0f ? -32767 : 32767, packed[i * 4 + 2]);
+                Assert.Equal(0, packed[i * 4 + 3]);
+
+                var decoded = DecodeOctahedralTangent(packed[i * 4], packed[i * 4 + 1], packed[i * 4 + 2]);
+                Assert.True(Angle((Vector3)tangents[i], (Vector3)decoded) <= MaxOctahedralAngle, $"{tangents[i]} decoded as {decoded}");
+                Assert.Equal(tangents[i].W < 0.0f ? -1.0f : 1.0f, decoded.W);
+            }
+        }
+
+        [Fact]
+        public unsafe void TestPositionUnorm16RoundTrip()
+        {
+            var random = new Random(8);
+            // Flat on Y, which decodes to the minimum
+            var bounds = new BoundingBox(new Vector3(-12.5f, 3.0f, 100.0f), new Vector3(40.0f, 3.0f, 100.25f));
+            var size = bounds.Maximum - bounds.Minimum;
+            var positions = new Vector3[1000];
+            for (int i = 0; i < positions.Length; i++)
+                positions[i] = bounds.Minimum + new Vector3(random.NextSingle(), random.NextSingle(), random.NextSingle()) * size;
+            positions[0] = bounds.Minimum;
+            positions[1] = bounds.Maximum;
+
+            var packed = PackPositions(positions, bounds);
+            for (int i = 0; i < positions.Length; i++)
+            {
+                var decoded = DecodePosition(packed, i, bounds);
+                Assert.Equal(0, packed[i * 4 + 3]);
+                Assert.Equal(bounds.Minimum.Y, decoded.Y);
+
+                // Half a quantization step, plus the float rounding of the encode and decode
+                Assert.True(Math.Abs(decoded.X - positions[i].X) <= size.X / 65535.0f * 0.5f + 1.0e-5f, $"{positions[i]} decoded as {decoded}");
+                Assert.True(Math.Abs(decoded.Z - positions[i].Z) <= size.Z / 65535.0f * 0.5f + 1.0e-5f, $"{positions[i]} decoded as {decoded}");
+            }
+            Assert.Equal(new ushort[] { 0, 0, 0 }, packed.AsSpan(0, 3).ToArray());
+            Assert.Equal(new ushort[] { 65535, 0, 65535 }, packed.AsSpan(4, 3).ToArray());
+
+            // Positions outside of the bounds are clamped
+            var outside = PackPositions([bounds.Minimum - Vector3.One, bounds.Maximum + Vector3.One], bounds);
+            Assert.Equal(new ushort[] { 0, 0, 0, 0, 65535, 0, 65535, 0 }, outside);
+        }
+
+        [Fact]
+        public void TestCompactHalfTextureCoordinates()
+        {
+            var vertices = new VertexPositionNormalTexture[37];
+            for (int i = 0; i < vertices.Length; i++)
+                vertices[i] = new VertexPositionNormalTexture(new Vector3(i, -i, 2 * i), Vector3.UnitY, new Vector2(i / 37.0f, 1.0f - i / 11.0f));
+
+            var vertexBufferBinding = new VertexBufferBinding(new BufferData(BufferFlags.VertexBuffer, MemoryMarshal.AsBytes(vertices.AsSpan()).ToArray()).ToSerializableVersion(), VertexPositionNormalTexture.Layout, vertices.Length);
+            Assert.True(HalfBufferExtensions.CompactHalfTextureCoordinates(ref vertexBufferBinding));
+
+            Assert.Equal(vertices.Length, vertexBufferBinding.Count);
+            Assert.Equal(VertexPositionNormalTexture.Size - 4, vertexBufferBinding.Stride);
+            var data = vertexBufferBinding.Buffer.GetSerializationData().Content;
+            var textureCoordinateOffset = -1;
+            foreach (var element in vertexBufferBinding.Declaration.EnumerateWithOffsets())
+            {
+                if (element.VertexElement.SemanticName == VertexElementUsage.TextureCoordinate)
+                {
+                    Assert.Equal(PixelFormat.R16G16_Float, element.VertexElement.Format);
+                    textureCoordinateOffset = element.Offset;
+                }
+            }
+            Assert.Equal(24, textureCoordinateOffset);
+
+            for (int i = 0; i < vertices.Length; i++)
+            {
+                var vertex = data.AsSpan(i * vertexBufferBinding.Stride, vertexBufferBinding.Stride);
+                Assert.Equal(vertices[i].Position, MemoryMarshal.Read<Vector3>(vertex));
+                Assert.Equal(vertices[i].Normal, MemoryMarshal.Read<Vector3>(vertex.Slice(12)));
+                Assert.Equal((Half)vertices[i].TextureCoordinate.X, MemoryMarshal.Read<Half>(vertex.Slice(24)));
+                Assert.Equal((Half)vertices[i].TextureCoordinate.Y, MemoryMarshal.Read<Half>(vertex.Slice(26)));
+            }
+
+            // Already compact
+            Assert.False(HalfBufferExtensions.CompactHalfTextureCoordinates(ref vertexBufferBinding));
+        }
+
+        private static unsafe short[] PackNormals(Vector3[] normals)
+        {
+            var packed = new short[normals.Length * 2];
+            fixed (Vector3* normalsPtr = normals)
+            fixed (short* packedPtr = packed)
+            {
+                NativeInvoke.PackNormalOctahedral(normalsPtr, sizeof(Vector3), packedPtr, 2 * sizeof(short), normals.Length);
+            }
+            return packed;
+        }
+
+        private static unsafe ushort[] PackPositions(Vector3[] positions, BoundingBox bounds)
+        {
+            var packed = new ushort[positions.Length * 4];
+            fixed (Vector3* positionsPtr = positions)
+            fixed (ushort* packedPtr = packed)
+            {
+                NativeInvoke.PackPositionUnorm16(positionsPtr, sizeof(Vector3), &bounds, packedPtr, 4 * sizeof(ushort), positions.Length);
+            }
+            return packed;
+        }
+
+        // Input assembler conversions
+        private static float Snorm16(short value) => Math.Max(value / 32767.0f, -1.0f);
+
+        private static float Unorm16(ushort value) => value / 65535.0f;
+
+        // Same as VertexQuantization.sdsl
+        private static Vector3 DecodeOctahedralNormal(short x, short y)
+        {
+            var n = new Vector3(Snorm16(x), Snorm16(y), 0.0f);
+            n.Z = 1.0f - Math.Abs(n.X) - Math.Abs(n.Y);
+            var t = Math.Clamp(-n.Z, 0.0f, 1.0f);
+            n.X += n.X >= 0.0f ? -t : t;
+            n.Y += n.Y >= 0.0f ? -t : t;
+            return Vector3.Normalize(n);
+        }
+
+        private static Vector4 DecodeOctahedralTangent(short x, short y, short z)
+        {
+            return new Vector4(DecodeOctahedralNormal(x, y), Snorm16(z) >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        private static Vector3 DecodePosition(ushort[] packed, int index, BoundingBox bounds)
+        {
+            var encoded = new Vector3(Unorm16(packed[index * 4]), Unorm16(packed[index * 4 + 1]), Unorm16(packed[index * 4 + 2]));
+            return bounds.Minimum + encoded * (bounds.Maximum - bounds.Minimum);
+        }
+
+        private static Vector3 RandomDirection(Random random)
+        {
+            while (true)
+            {
+                var direction = new Vector3(random.NextSingle() * 2.0f - 1.0f, random.NextSingle() * 2.0f - 1.0f, random.NextSingle() * 2.0f - 1.0f);
+                var lengthSquared = direction.LengthSquared();
+                if (lengthSquared > 1.0e-4f && lengthSquared <= 1.0f)
+                    return direction / MathF.Sqrt(lengthSquared);
+            }
+        }
+
+        private static double Angle(Vector3 expected, Vector3 actual)
+        {
+            double dot = (double)expected.X * actual.X + (double)expected.Y * actual.Y + (double)expected.Z * actual.Z;
+            double cross = Math.Sqrt(Math.Pow((double)expected.Y * actual.Z - (double)expected.Z * actual.Y, 2)
+                + Math.Pow((double)expected.Z * actual.X - (double)expected.X * actual.Z, 2)
+                + Math.Pow((double)expected.X * actual.Y - (double)expected.Y * actual.X, 2));
+            return Math.Atan2(cross, dot);
+        }
+    }
+}
@@ -4,9 +4,11 @@
 using System;
 using System.Collections.Generic;
 using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
 using Stride.Core;
 using Stride.Core.Collections;
 using Stride.Core.Mathematics;
+using Stride.Native;
 using Stride.Updater;
 
 namespace Stride.Animations
@@ -31,6 +33,20 @@ namespace Stride.Animations
         private int structureSize;
         private int objectsSize;
 
+        /// <summary>
+        /// Blends with at most this many channels describe them on the stack
+        /// </summary>
+        private const int MaxStackChannels = 256;
+
+        // Same layout as AnimationBlendChannel in the native code
+        [StructLayout(LayoutKind.Sequential)]
+        private struct NativeChannel
+        {
+            public int Offset;
+            public int Size;
+            public int BlendType;
+        }
+
         public AnimationClipEvaluator CreateEvaluator(AnimationClip clip)
         {
             // Check if this clip has already been used
@@ -154,138 +170,27 @@ namespace Stride.Animations
 
         public static unsafe void Blend(CoreAnimationOperation blendOperation, float blendFactor, AnimationClipResult sourceLeft, AnimationClipResult sourceRight, AnimationClipResult result)
         {
+            if (blendOperation > CoreAnimationOperation.Subtract)
+                throw new ArgumentOutOfRangeException(nameof(blendOperation));
+
+            // Channels are blended natively, quaternions with a normalized lerp
+            var channels = sourceLeft.Channels;
+            Span<NativeChannel> nativeChannels = channels.Count <= MaxStackChannels
+                ? stackalloc NativeChannel[channels.Count]
+                : new NativeChannel[channels.Count];
+            for (int i = 0; i < channels.Count; i++)
+            {
+                var channel = channels[i];
+                nativeChannels[i] = new NativeChannel { Offset = channel.Offset, Size = channel.Size, BlendType = (int)channel.BlendType };
+            }
+
             fixed (byte* sourceLeftDataStart = sourceLeft.Data)
             fixed (byte* sourceRightDataStart = sourceRight.Data)
             fixed (byte* resultDataStart = result.Data)
+            fixed (NativeChannel* nativeChannelsPtr = nativeChannels)
             {
-                foreach (var channel in sourceLeft.Channels)
-                {
-                    int offset = channel.Offset;
-                    var sourceLeftData = (float*)(sourceLeftDataStart + offset);
-                    var sourceRightData = (float*)(sourceRightDataStart + offset);
-                    var resultData = (float*)(resultDataStart + offset);
-
-                    float factorLeft = *sourceLeftData++;
-                    float factorRight = *sourceRightData++;
-
-                    // Ignore this channel
-                    if (factorLeft == 0.0f && factorRight == 0.0f)
-                    {
-                        *resultData++ = 0.0f;
-                        continue;
-                    }
-
-                    // Use left value
-                    if (factorLeft > 0.0f && factorRight == 0.0f)
-                    {
-                        *resultData++ = 1.0f;
-                        MemoryUtilities.CopyWithAlignmentFallback(resultData, sourceLeftData, (uint)channel.Size);
-                        continue;
-                    }
-
-                    // Use right value
-                    if (factorRight > 0.0f && factorLeft == 0.0f)
-                    {
-                        *resultData++ = 1.0f;
-                        MemoryUtilities.CopyWithAlignmentFallback(resultData, sourceRightData, (uint)channel.Size);
-                        continue;
-                    }
-
-                    // Blending
-                    *resultData++ = 1.0f;
-
-                    switch (blendOperation)
-                    {
-                        case CoreAnimationOperation.Blend:
-                            // Perform linear blending
-                            // It will blend between left (0.0) and right (1.0)
-                            switch (channel.BlendType)
-                            {
-                                case BlendType.Blit:
-                                    MemoryUtilities.CopyWithAlignmentFallback(
-                                        resultData,
-                                        blendFactor < 0.5f ? sourceLeftData : sourceRightData,
-                                        (uint)channel.Size);
-                                    break;
-                                case BlendType.Float1:
-                                    *resultData = MathUtil.Lerp(*sourceLeftData, *sourceRightData, blendFactor);
-                                    break;
-                                case BlendType.Float2:
-                                    Vector2.Lerp(ref *(Vector2*)sourceLeftData, ref *(Vector2*)sourceRightData, blendFactor, out *(Vector2*)resultData);
-                                    break;
-                                case BlendType.Float3:
-                                    Vector3.Lerp(ref *(Vector3*)sourceLeftData, ref *(Vector3*)sourceRightData, blendFactor, out *(Vector3*)resultData);
-                                    break;
-                                case BlendType.Quaternion:
-                                    Quaternion.Slerp(ref *(Quaternion*)sourceLeftData, ref *(Quaternion*)sourceRightData, blendFactor, out *(Quaternion*)resultData);
-                                    break;
-                                default:
-                                    throw new ArgumentOutOfRangeException();
-                            }
-                            break;
-                        case CoreAnimationOperation.Add:
-                            // Perform additive blending
-                            // It will blend between left (0.0) and left + right (1.0).
-                            switch (channel.BlendType)
-                            {
-                                case BlendType.Blit:
-                                    MemoryUtilities.CopyWithAlignmentFallback(resultData, sourceLeftData, (uint)channel.Size);
-                                    break;
-                                case BlendType.Float2:
-                                    Vector2 rightValue2;
-                                    Vector2.Add(ref *(Vector2*)sourceLeftData, ref *(Vector2*)sourceRightData, out rightValue2);
-                                    Vector2.Lerp(ref *(Vector2*)sourceLeftData, ref rightValue2, blendFactor, out *(Vector2*)resultData);
-                                    break;
-                                case BlendType.Float3:
-                                    Vector3 rightValue3;
-                                    Vector3.Add(ref *(Vector3*)sourceLeftData, ref *(Vector3*)sourceRightData, out rightValue3);
-                                    Vector3.Lerp(ref *(Vector3*)sourceLeftData, ref rightValue3, blendFactor, out *(Vector3*)resultData);
-                                    break;
-                                case BlendType.Quaternion:
-                                    Quaternion rightValueQ;
-                                    Quaternion.Multiply(ref *(Quaternion*)sourceLeftData, ref *(Quaternion*)sourceRightData, out rightValueQ);
-                                    Quaternion.Normalize(ref rightValueQ, out rightValueQ);
-                                    Quaternion.Slerp(ref *(Quaternion*)sourceLeftData, ref rightValueQ, blendFactor, out *(Quaternion*)resultData);
-                                    break;
-                                default:
-                                    throw new ArgumentOutOfRangeException();
-                            }
-                            break;
-                        case CoreAnimationOperation.Subtract:
-                            // Perform subtractive blending
-                            // It will blend between left (0.0) and left - right (1.0).
-                            switch (channel.BlendType)
-                            {
-                                case BlendType.Blit:
-                                    MemoryUtilities.CopyWithAlignmentFallback(resultData, sourceLeftData, (uint)channel.Size);
-                                    break;
-                                case BlendType.Float2:
-                                    Vector2 rightValue2;
-                                    Vector2.Subtract(ref *(Vector2*)sourceLeftData, ref *(Vector2*)sourceRightData, out rightValue2);
-                                    Vector2.Lerp(ref *(Vector2*)sourceLeftData, ref rightValue2, blendFactor, out *(Vector2*)resultData);
-                                    break;
-                                case BlendType.Float3:
-                                    Vector3 rightValue3;
-                                    Vector3.Subtract(ref *(Vector3*)sourceLeftData, ref *(Vector3*)sourceRightData, out rightValue3);
-                                    Vector3.Lerp(ref *(Vector3*)sourceLeftData, ref rightValue3, blendFactor, out *(Vector3*)resultData);
-                                    break;
-                                case BlendType.Quaternion:
-                                    Quaternion rightValueQ;
-                                    // blend between left (0.0) and left * conjugate(right) (1.0)
-                                    Quaternion.Invert(ref *(Quaternion*)sourceRightData, out rightValueQ);
-                                    Quaternion.Multiply(ref rightValueQ, ref *(Quaternion*)sourceLeftData, out rightValueQ);
-                                    Quaternion.Normalize(ref rightValueQ, out rightValueQ);
-                                    //throw new NotImplementedException();
-                                    Quaternion.Slerp(ref *(Quaternion*)sourceLeftData, ref rightValueQ, blendFactor, out *(Quaternion*)resultData);
-                                    break;
-                                default:
-                                    throw new ArgumentOutOfRangeException();
-                            }
-                            break;
-                        default:
-                            throw new ArgumentOutOfRangeException("blendOperation");
-                    }
-                }
+                if (NativeInvoke.AnimationBlend((int)blendOperation, blendFactor, sourceLeftDataStart, sourceRightDataStart, resultDataStart, nativeChannelsPtr, nativeChannels.Length) >= 0)
+                    throw new ArgumentOutOfRangeException();
             }
         }
 
@@ -17,24 +17,15 @@ namespace Stride.Animations
 
         public static AnimationCurveEvaluatorOptimizedGroup Create<T>()
         {
-            // Those types require interpolators
+            // Those types require interpolators (float based ones are sampled natively)
             // TODO: Simple enough for now, but at some point we might want a mechanism to register them externally?
-            if (typeof(T) == typeof(float))
-                return new AnimationCurveEvaluatorOptimizedFloatGroup();
+            if (typeof(T) == typeof(float) || typeof(T) == typeof(Quaternion) || typeof(T) == typeof(Vector3) || typeof(T) == typeof(Vector4))
+                return new AnimationCurveEvaluatorOptimizedNativeGroup<T>();
 
             // TODO: Reintroduces explicit int path for now, since generic path does not work on iOS
             if (typeof(T) == typeof(int))
                 return new AnimationCurveEvaluatorOptimizedIntGroup();
 
-            if (typeof(T) == typeof(Quaternion))
-                return new AnimationCurveEvaluatorOptimizedQuaternionGroup();
-
-            if (typeof(T) == typeof(Vector3))
-                return new AnimationCurveEvaluatorOptimizedVector3Group();
-
-            if (typeof(T) == typeof(Vector4))
-                return new AnimationCurveEvaluatorOptimizedVector4Group();
-
             // Blittable
             if (BlittableHelper.IsBlittable(typeof(T)))
                 return new AnimationCurveEvaluatorOptimizedBlittableGroup<T>();
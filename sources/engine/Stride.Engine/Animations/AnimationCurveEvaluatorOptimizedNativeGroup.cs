@@ -0,0 +1,153 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+#pragma warning disable SA1402 // File may only contain a single class
+using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Threading;
+using Stride.Core.Mathematics;
+using Stride.Native;
+using Stride.Updater;
+
+namespace Stride.Animations
+{
+    /// <summary>
+    /// Keys of an <see cref="AnimationData{T}"/> with float components, stored channel after channel for native sampling.
+    /// </summary>
+    internal sealed class AnimationNativeKeys
+    {
+        public int[] KeyTimes;
+        public float[] KeyValues;
+        public int[] ChannelKeyStarts;
+        public int[] InterpolationTypes;
+        public int Components;
+        public bool IsQuaternion;
+
+        public static AnimationNativeKeys Get<T>(AnimationData<T> animationData)
+        {
+            return LazyInitializer.EnsureInitialized(ref animationData.NativeKeys, () => Create(animationData));
+        }
+
+        private static AnimationNativeKeys Create<T>(AnimationData<T> animationData)
+        {
+            var initialValues = animationData.AnimationInitialValues;
+            var channelCount = initialValues.Length;
+            var components = Unsafe.SizeOf<T>() / sizeof(float);
+
+            // Each channel has its two initial keys followed by its sorted values, except the last one which repeats the last key
+            // (a channel with a single key gets it twice, which samples the same)
+            var sortedValueCounts = new int[channelCount];
+            ForEachSortedValue(animationData, (ref AnimationKeyValuePair<T> value) => sortedValueCounts[value.ChannelIndex]++);
+
+            var channelKeyStarts = new int[channelCount + 1];
+            for (int channel = 0; channel < channelCount; channel++)
+                channelKeyStarts[channel + 1] = channelKeyStarts[channel] + (sortedValueCounts[channel] > 0 ? sortedValueCounts[channel] + 1 : 1);
+
+            var keyCount = channelKeyStarts[channelCount];
+            var keys = new AnimationNativeKeys
+            {
+                KeyTimes = new int[keyCount],
+                KeyValues = new float[keyCount * components],
+                ChannelKeyStarts = channelKeyStarts,
+                InterpolationTypes = new int[channelCount],
+                Components = components,
+                IsQuaternion = typeof(T) == typeof(Quaternion),
+            };
+
+            var writtenSortedValues = new int[channelCount];
+            for (int channel = 0; channel < channelCount; channel++)
+            {
+                keys.InterpolationTypes[channel] = (int)initialValues[channel].InterpolationType;
+                keys.SetKey(channelKeyStarts[channel], ref initialValues[channel].Value1);
+                if (sortedValueCounts[channel] > 0)
+                    keys.SetKey(channelKeyStarts[channel] + 1, ref initialValues[channel].Value2);
+            }
+
+            ForEachSortedValue(animationData, (ref AnimationKeyValuePair<T> value) =>
+            {
+                var channel = value.ChannelIndex;
+                if (writtenSortedValues[channel] < sortedValueCounts[channel] - 1)
+                    keys.SetKey(channelKeyStarts[channel] + 2 + writtenSortedValues[channel]++, ref value.Value);
+            });
+
+            return keys;
+        }
+
+        private delegate void SortedValueAction<T>(ref AnimationKeyValuePair<T> value);
+
+        private static void ForEachSortedValue<T>(AnimationData<T> animationData, SortedValueAction<T> action)
+        {
+            for (int index = 0; index < animationData.AnimationSortedValueCount; index++)
+            {
+                action(ref animationData.AnimationSortedValues[index / AnimationData.AnimationSortedValueBlock][index % AnimationData.AnimationSortedValueBlock]);
+            }
+        }
+
+        private void SetKey<T>(int keyIndex, ref KeyFrameData<T> key)
+        {
+            KeyTimes[keyIndex] = key.Time.Ticks;
+            MemoryMarshal.CreateReadOnlySpan(ref Unsafe.As<T, float>(ref key.Value), Components).CopyTo(KeyValues.AsSpan(keyIndex * Components, Components));
+        }
+    }
+
+    /// <summary>
+    /// Evaluates optimized curves of float, <see cref="Vector3"/>, <see cref="Vector4"/> and <see cref="Quaternion"/> values natively.
+    /// </summary>
+    /// <remarks>
+    /// Linear interpolation of quaternions is a normalized lerp, and cubic interpolation of quaternions is normalized.
+    /// </remarks>
+    internal sealed class AnimationCurveEvaluatorOptimizedNativeGroup<T> : AnimationCurveEvaluatorOptimizedGroup
+    {
+        private AnimationData<T> animationData;
+        private AnimationNativeKeys keys;
+        private int[] offsets = [];
+        private int[] cursors = [];
+
+        public override Type ElementType => typeof(T);
+
+        public override void Initialize(AnimationData animationData)
+        {
+            this.animationData = (AnimationData<T>)animationData;
+            keys = AnimationNativeKeys.Get(this.animationData);
+
+            var channelCount = keys.InterpolationTypes.Length;
+            if (offsets.Length != channelCount)
+            {
+                offsets = new int[channelCount];
+                cursors = new int[channelCount];
+            }
+
+            Array.Fill(offsets, -1);
+            Array.Clear(cursors);
+        }
+
+        public override void Cleanup()
+        {
+            animationData = null;
+            keys = null;
+        }
+
+        public override void SetChannelOffset(string name, int offset)
+        {
+            var index = Array.IndexOf(animationData.TargetKeys, name);
+            if (index >= 0)
+                offsets[index] = offset;
+        }
+
+        public override unsafe void Evaluate(CompressedTimeSpan newTime, IntPtr data, UpdateObjectData[] objects)
+        {
+            if (animationData == null)
+                return;
+
+            fixed (int* keyTimes = keys.KeyTimes)
+            fixed (float* keyValues = keys.KeyValues)
+            fixed (int* channelKeyStarts = keys.ChannelKeyStarts)
+            fixed (int* interpolationTypes = keys.InterpolationTypes)
+            fixed (int* offsetsPtr = offsets)
+            fixed (int* cursorsPtr = cursors)
+            {
+                NativeInvoke.AnimationSampleChannels(keyTimes, keyValues, channelKeyStarts, interpolationTypes, offsetsPtr, cursorsPtr, offsets.Length, keys.Components, keys.IsQuaternion ? 1 : 0, newTime.Ticks, (byte*)data);
+            }
+        }
+    }
+}
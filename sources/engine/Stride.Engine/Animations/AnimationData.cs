@@ -22,6 +22,12 @@ namespace Stride.Animations
         public int AnimationSortedValueCount { get; set; }
         public string[] TargetKeys { get; set; }
 
+        /// <summary>
+        /// Keys of every channel laid out for native sampling, built on first use.
+        /// </summary>
+        [DataMemberIgnore]
+        internal AnimationNativeKeys NativeKeys;
+
         public abstract Type ElementType { get; }
         internal abstract AnimationCurveEvaluatorOptimizedGroup CreateEvaluator();
     }
@@ -74,6 +74,11 @@ namespace Stride.Animations
         [DataMemberIgnore]
         private T[] bakedArray;
 
+        /// <summary>
+        /// The values sampled at regular intervals over [0 .. 1] by <see cref="UpdateChanges"/>, for native code to sample the curve like <see cref="Evaluate"/>.
+        /// </summary>
+        internal ReadOnlySpan<T> BakedData => bakedArray;
+
         /// <summary>
         /// Bakes the sampled data in a fixed size array for faster access
         /// </summary>
@@ -10,6 +10,7 @@ using Stride.Core.Collections;
 using Stride.Core.Mathematics;
 using Stride.Engine.Design;
 using Stride.Engine.Processors;
+using Stride.Native;
 using Stride.Rendering;
 using Stride.Updater;
 
@@ -27,6 +28,17 @@ namespace Stride.Engine
     [ComponentCategory("Model")]
     public sealed class ModelComponent : ActivableEntityComponent, IModelInstance
     {
+        /// <summary>
+        /// Skinned meshes with at least this many bones get their bounding box from the native transform and merge kernel
+        /// </summary>
+        internal const int NativeBoundingBoxBoneCount = 16;
+
+        // Copies of the bounding box of the skinned mesh being updated, one per bone, and the group of each of them (always 0)
+        [ThreadStatic]
+        private static BoundingBox[] boneBoundingBoxes;
+        [ThreadStatic]
+        private static int[] boneBoundingBoxGroups;
+
         private readonly List<MeshInfo> meshInfos = new List<MeshInfo>();
         private Model model;
         private SkeletonUpdater skeleton;
@@ -269,6 +281,7 @@ namespace Stride.Engine
                 {
                     bool meshHasBoundingBox = false;
                     var bones = mesh.Skinning.Bones;
+                    var mergeNatively = bones.Length >= NativeBoundingBoxBoneCount;
 
                     // For skinned meshes, bounding box is union of the bounding boxes of the unskinned mesh, transformed by each affecting bone.
                     for (int boneIndex = 0; boneIndex < bones.Length; boneIndex++)
@@ -276,23 +289,31 @@ namespace Stride.Engine
                         var nodeIndex = bones[boneIndex].NodeIndex;
                         Matrix.Multiply(ref bones[boneIndex].LinkToMeshMatrix, ref skeleton.NodeTransformations[nodeIndex].WorldMatrix, out meshInfo.BlendMatrices[boneIndex]);
 
-                        BoundingBox skinnedBoundingBox;
-                        BoundingBox.Transform(ref mesh.BoundingBox, ref meshInfo.BlendMatrices[boneIndex], out skinnedBoundingBox);
                         BoundingSphere skinnedBoundingSphere;
                         BoundingSphere.Transform(ref mesh.BoundingSphere, ref meshInfo.BlendMatrices[boneIndex], out skinnedBoundingSphere);
 
+                        BoundingBox skinnedBoundingBox = default;
+                        if (!mergeNatively)
+                            BoundingBox.Transform(ref mesh.BoundingBox, ref meshInfo.BlendMatrices[boneIndex], out skinnedBoundingBox);
+
                         if (meshHasBoundingBox)
                         {
-                            BoundingBox.Merge(ref meshInfo.BoundingBox, ref skinnedBoundingBox, out meshInfo.BoundingBox);
+                            if (!mergeNatively)
+                                BoundingBox.Merge(ref meshInfo.BoundingBox, ref skinnedBoundingBox, out meshInfo.BoundingBox);
                             BoundingSphere.Merge(ref meshInfo.BoundingSphere, ref skinnedBoundingSphere, out meshInfo.BoundingSphere);
                         }
                         else
                         {
                             meshHasBoundingBox = true;
                             meshInfo.BoundingSphere = skinnedBoundingSphere;
-                            meshInfo.BoundingBox = skinnedBoundingBox;
+                            if (!mergeNatively)
+                                meshInfo.BoundingBox = skinnedBoundingBox;
                         }
                     }
+
+                    // Once all blend matrices are known, the boxes of all the bones are transformed and merged in a single call
+                    if (mergeNatively)
+                        TransformMergeBoundingBox(ref mesh.BoundingBox, meshInfo.BlendMatrices, bones.Length, out meshInfo.BoundingBox);
                 }
                 else
                 {
@@ -315,5 +336,25 @@ namespace Stride.Engine
                 }
             }
         }
+
+        private static unsafe void TransformMergeBoundingBox(ref BoundingBox box, Matrix[] worlds, int count, out BoundingBox result)
+        {
+            var boxes = boneBoundingBoxes;
+            if (boxes == null || boxes.Length < count)
+            {
+                boneBoundingBoxes = boxes = new BoundingBox[count];
+                boneBoundingBoxGroups = new int[count];
+            }
+            Array.Fill(boxes, box, 0, count);
+
+            result = BoundingBox.Empty;
+            fixed (BoundingBox* boxesPtr = boxes)
+            fixed (Matrix* worldsPtr = worlds)
+            fixed (int* groupsPtr = boneBoundingBoxGroups)
+            fixed (BoundingBox* resultPtr = &result)
+            {
+                NativeInvoke.BoundingBoxTransformMerge(boxesPtr, worldsPtr, null, groupsPtr, resultPtr, count);
+            }
+        }
     }
 }
@@ -1,9 +1,11 @@
 // Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 
+using System;
 using System.Collections.Generic;
 using System.Linq;
 using Stride.Core.Collections;
+using Stride.Core.Mathematics;
 using Stride.Core.Threading;
 using Stride.Rendering;
 
@@ -26,6 +28,17 @@ namespace Stride.Engine.Processors
         private readonly FastCollection<TransformComponent> notSpecialRootComponents = new FastCollection<TransformComponent>();
         private readonly FastCollection<TransformComponent> modelNodeLinkComponents = new FastCollection<TransformComponent>();
 
+        // Depth-sorted hierarchies given to TransformPropagation, rebuilt at each frame
+        private readonly FastCollection<TransformComponent> managedTransforms = new FastCollection<TransformComponent>();
+        private readonly Dictionary<Scene, int> sceneIndices = new Dictionary<Scene, int>();
+        private readonly FastList<int> levelStarts = new FastList<int>();
+        private TransformComponent[] propagatedTransforms = Array.Empty<TransformComponent>();
+        private int[] parentIndices = Array.Empty<int>();
+        private TransformPropagation.LocalTransform[] localTransforms = Array.Empty<TransformPropagation.LocalTransform>();
+        private Matrix[] localMatrices = Array.Empty<Matrix>();
+        private Matrix[] worldMatrices = Array.Empty<Matrix>();
+        private int propagatedCount;
+
         private ModelNodeLinkProcessor modelNodeLinkProcessor;
         private ModelNodeLinkProcessor ModelNodeLinkProcessor
         {
@@ -46,6 +59,16 @@ namespace Stride.Engine.Processors
             Order = -200;
         }
 
+        /// <summary>
+        /// Gets or sets a value indicating whether world matrices are computed by the native propagation kernel.
+        /// </summary>
+        /// <remarks>
+        /// Transforms using a <see cref="TransformComponent.TransformLink"/>, <see cref="TransformComponent.PostOperations"/> or a custom
+        /// <see cref="TransformComponent.LocalMatrix"/>, and their children, are still updated in managed code.
+        /// If false, every hierarchy is updated in managed code.
+        /// </remarks>
+        public bool UseNativePropagation { get; set; } = true;
+
         /// <inheritdoc/>
         protected internal override void OnSystemAdd()
         {
@@ -93,7 +116,18 @@ namespace Stride.Engine.Processors
 
         internal unsafe void UpdateTransformations(FastCollection<TransformComponent> transformationComponents)
         {
-            Dispatcher.ForBatched(transformationComponents.Count, transformationComponents, &UpdateTransformationsRecursive);
+            if (UseNativePropagation)
+            {
+                PropagateTransformations(transformationComponents);
+
+                // Their parents are up to date, so the remaining hierarchies can be updated like roots
+                Dispatcher.ForBatched(managedTransforms.Count, managedTransforms, &UpdateTransformationsRecursive);
+                managedTransforms.Clear();
+            }
+            else
+            {
+                Dispatcher.ForBatched(transformationComponents.Count, transformationComponents, &UpdateTransformationsRecursive);
+            }
 
             // Re-update model node links to avoid one frame delay compared reference model (ideally entity should be sorted to avoid this in future).
             if (ModelNodeLinkProcessor != null)
@@ -107,6 +141,100 @@ namespace Stride.Engine.Processors
             }
         }
 
+        private unsafe void PropagateTransformations(FastCollection<TransformComponent> roots)
+        {
+            propagatedCount = 0;
+            levelStarts.Clear();
+            sceneIndices.Clear();
+
+            // Scene world matrices are stored first, outside of any level, so that roots can use them as parents
+            foreach (var root in roots)
+            {
+                var scene = root.Entity?.Scene;
+                if (scene != null && CanPropagate(root) && !sceneIndices.ContainsKey(scene))
+                {
+                    EnsurePropagationCapacity(propagatedCount + 1);
+                    sceneIndices.Add(scene, propagatedCount);
+                    worldMatrices[propagatedCount++] = scene.WorldMatrix;
+                }
+            }
+
+            levelStarts.Add(propagatedCount);
+            foreach (var root in roots)
+            {
+                var scene = root.Entity?.Scene;
+                AddPropagatedTransform(root, scene != null && sceneIndices.TryGetValue(scene, out var sceneIndex) ? sceneIndex : -1);
+            }
+            levelStarts.Add(propagatedCount);
+
+            // The children of a level form the next one
+            for (int levelStart = levelStarts[0]; levelStart < propagatedCount;)
+            {
+                var levelEnd = propagatedCount;
+                for (int i = levelStart; i < levelEnd; i++)
+                {
+                    foreach (var child in propagatedTransforms[i].Children)
+                        AddPropagatedTransform(child, i);
+                }
+
+                if (propagatedCount > levelEnd)
+                    levelStarts.Add(propagatedCount);
+                levelStart = levelEnd;
+            }
+
+            fixed (int* parentIndicesPtr = parentIndices)
+            fixed (TransformPropagation.LocalTransform* localTransformsPtr = localTransforms)
+            fixed (Matrix* localMatricesPtr = localMatrices)
+            fixed (Matrix* worldMatricesPtr = worldMatrices)
+            fixed (int* levelStartsPtr = levelStarts.Items)
+            {
+                TransformPropagation.Propagate(parentIndicesPtr, localTransformsPtr, localMatricesPtr, worldMatricesPtr, levelStartsPtr, levelStarts.Count - 1);
+            }
+
+            for (int i = levelStarts[0]; i < propagatedCount; i++)
+            {
+                var transform = propagatedTransforms[i];
+                transform.LocalMatrix = localMatrices[i];
+                transform.WorldMatrix = worldMatrices[i];
+            }
+
+            // Don't keep removed entities alive until the next frame
+            Array.Clear(propagatedTransforms, 0, propagatedCount);
+        }
+
+        private void AddPropagatedTransform(TransformComponent transform, int parentIndex)
+        {
+            if (!CanPropagate(transform))
+            {
+                managedTransforms.Add(transform);
+                return;
+            }
+
+            EnsurePropagationCapacity(propagatedCount + 1);
+            propagatedTransforms[propagatedCount] = transform;
+            parentIndices[propagatedCount] = parentIndex;
+            localTransforms[propagatedCount] = new TransformPropagation.LocalTransform { Scale = transform.Scale, Rotation = transform.Rotation, Position = transform.Position };
+            propagatedCount++;
+        }
+
+        private void EnsurePropagationCapacity(int capacity)
+        {
+            if (capacity <= propagatedTransforms.Length)
+                return;
+
+            var newCapacity = Math.Max(capacity, propagatedTransforms.Length * 2);
+            Array.Resize(ref propagatedTransforms, newCapacity);
+            Array.Resize(ref parentIndices, newCapacity);
+            Array.Resize(ref localTransforms, newCapacity);
+            Array.Resize(ref localMatrices, newCapacity);
+            Array.Resize(ref worldMatrices, newCapacity);
+        }
+
+        private static bool CanPropagate(TransformComponent transform)
+        {
+            return transform.UseTRS && transform.TransformLink == null && transform.PostOperations.Count == 0;
+        }
+
         private static void UpdateTransformationsRecursive(FastCollection<TransformComponent> transforms, int from, int toExclusive)
         {
             for (int i = from; i < toExclusive; i++)
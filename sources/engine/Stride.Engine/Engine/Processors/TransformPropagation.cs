@@ -0,0 +1,70 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System.Runtime.InteropServices;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Native;
+
+namespace Stride.Engine.Processors
+{
+    /// <summary>
+    /// Computes the world matrices of a depth-sorted transform hierarchy with the native propagation kernel.
+    /// Depth levels are processed one after the other, and large levels are split across threads.
+    /// </summary>
+    internal static unsafe class TransformPropagation
+    {
+        /// <summary>
+        /// Levels with at least this many transforms are propagated on several threads
+        /// </summary>
+        public const int ParallelThreshold = 1024;
+
+        /// <summary>
+        /// Local scale, rotation and position of a transform, with the layout of the native TransformSRT.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential, Pack = 4)]
+        public struct LocalTransform
+        {
+            public Vector3 Scale;
+            public Quaternion Rotation;
+            public Vector3 Position;
+        }
+
+        private struct LevelJob
+        {
+            public int* ParentIndex;
+            public LocalTransform* Local;
+            public Matrix* LocalMatrix;
+            public Matrix* World;
+            public int Start;
+        }
+
+        /// <summary>
+        /// Computes <paramref name="world"/>[i] = Matrix.Transformation(<paramref name="local"/>[i]) * <paramref name="world"/>[<paramref name="parentIndex"/>[i]].
+        /// </summary>
+        /// <param name="parentIndex">The index of the parent of each transform, -1 for roots</param>
+        /// <param name="localMatrix">If not null, receives Matrix.Transformation(<paramref name="local"/>[i])</param>
+        /// <param name="levelStarts">
+        /// <paramref name="levelCount"/> + 1 offsets. Level i holds the transforms [levelStarts[i], levelStarts[i + 1]),
+        /// whose parents all belong to previous levels.
+        /// </param>
+        public static void Propagate(int* parentIndex, LocalTransform* local, Matrix* localMatrix, Matrix* world, int* levelStarts, int levelCount)
+        {
+            for (int level = 0; level < levelCount; level++)
+            {
+                var job = new LevelJob { ParentIndex = parentIndex, Local = local, LocalMatrix = localMatrix, World = world, Start = levelStarts[level] };
+                var count = levelStarts[level + 1] - job.Start;
+
+                if (count >= ParallelThreshold)
+                    Dispatcher.ForBatched(count, job, &PropagateBatch);
+                else if (count > 0)
+                    PropagateBatch(job, 0, count);
+            }
+        }
+
+        private static void PropagateBatch(LevelJob job, int start, int end)
+        {
+            NativeInvoke.TransformPropagate(job.ParentIndex, job.Local, job.LocalMatrix, job.World, job.Start + start, job.Start + end);
+        }
+    }
+}
@@ -1,7 +1,9 @@
 // Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 using System;
+using Stride.Audio;
 using Stride.Core.Diagnostics;
+using Stride.Native;
 
 namespace Stride.Profiling
 {
@@ -11,12 +13,14 @@ namespace Stride.Profiling
         private const string BeginMemoryMessage = "Allocated memory> Total: {0:0.00}MB";
         private const string EndMemoryMessage = "Allocated memory> Total: {0:0.00}MB Peak: {1:0.00}MB";
         private const string MarkMemoryMessage = "Allocated memory> Total: {0:0.00}MB Peak: {1:0.00}MB Allocations: {2:0.00}KB";
+        private const string NativeMemoryMessage = "Native memory> Total: {0:0.00}MB Peak: {1:0.00}MB Audio: {2:0.00}MB";
 
         private const float kB = 1 << 10;
         private const float MB = 1 << 20;
 
         public static ProfilingKey GcCollectionCountKey = new ProfilingKey("GC Collection Count");
         public static ProfilingKey GcMemoryKey = new ProfilingKey("GC Memory");
+        public static ProfilingKey NativeMemoryKey = new ProfilingKey("Native Memory");
 
         private ProfilingState collectionCountState;
         private int gen0Count;
@@ -27,6 +31,12 @@ namespace Stride.Profiling
         private long lastFrameMemory;
         private long memoryPeak;
 
+        // Native allocations are only counted by native libraries built with memory tracking
+        private ProfilingState nativeMemoryState;
+        private bool nativeMemoryTracked;
+        private bool audioMemoryAvailable = true;
+        private long lastNativeMemory;
+
         public GcProfiling()
         {
             collectionCountState = Profiler.New(GcCollectionCountKey);
@@ -38,6 +48,11 @@ namespace Stride.Profiling
             gcMemoryState = Profiler.New(GcMemoryKey);
             memoryPeak = lastFrameMemory = GC.GetTotalMemory(false);
             gcMemoryState.Begin(BeginMemoryMessage, lastFrameMemory / MB);
+
+            nativeMemoryState = Profiler.New(NativeMemoryKey);
+            nativeMemoryTracked = ReadNativeMemory(out lastNativeMemory, out var nativePeak, out var audioMemory);
+            if (nativeMemoryTracked)
+                nativeMemoryState.Begin(NativeMemoryMessage, lastNativeMemory / MB, nativePeak / MB, audioMemory / MB);
         }
 
         public void Tick()
@@ -52,6 +67,16 @@ namespace Stride.Profiling
                 lastFrameMemory = totalMem;
             }
 
+            if (nativeMemoryTracked)
+            {
+                ReadNativeMemory(out var nativeMemory, out var nativePeak, out var audioMemory);
+                if (nativeMemory != lastNativeMemory)
+                {
+                    nativeMemoryState.Mark(NativeMemoryMessage, nativeMemory / MB, nativePeak / MB, audioMemory / MB);
+                    lastNativeMemory = nativeMemory;
+                }
+            }
+
             //gens collections
             var gen0 = GC.CollectionCount(0);
             var gen1 = GC.CollectionCount(1);
@@ -72,6 +97,12 @@ namespace Stride.Profiling
             memoryPeak = Math.Max(totalMem, memoryPeak);
             gcMemoryState.End(EndMemoryMessage, totalMem / MB, memoryPeak / MB);
 
+            if (nativeMemoryTracked)
+            {
+                ReadNativeMemory(out var nativeMemory, out var nativePeak, out var audioMemory);
+                nativeMemoryState.End(NativeMemoryMessage, nativeMemory / MB, nativePeak / MB, audioMemory / MB);
+            }
+
             //gens count
             gen0Count = GC.CollectionCount(0);
             gen1Count = GC.CollectionCount(1);
@@ -83,7 +114,9 @@ namespace Stride.Profiling
         {
             Profiler.Enable(GcCollectionCountKey);
             Profiler.Enable(GcMemoryKey);
+            Profiler.Enable(NativeMemoryKey);
             gcMemoryState.CheckIfEnabled();
+            nativeMemoryState.CheckIfEnabled();
             collectionCountState.CheckIfEnabled();
         }
 
@@ -91,8 +124,43 @@ namespace Stride.Profiling
         {
             Profiler.Disable(GcCollectionCountKey);
             Profiler.Disable(GcMemoryKey);
+            Profiler.Disable(NativeMemoryKey);
             gcMemoryState.CheckIfEnabled();
+            nativeMemoryState.CheckIfEnabled();
             collectionCountState.CheckIfEnabled();
         }
+
+        /// <summary>
+        /// Sums the live and peak native allocations of libstride and libstrideaudio, returns <c>false</c> when they are not tracked.
+        /// </summary>
+        private unsafe bool ReadNativeMemory(out long liveBytes, out long peakBytes, out long audioBytes)
+        {
+            NativeMemoryStats stats;
+            NativeInvoke.MemoryGetStats(&stats);
+            liveBytes = stats.Total.LiveBytes;
+            peakBytes = stats.Total.PeakBytes;
+            audioBytes = 0;
+            if (stats.Enabled == 0)
+                return false;
+
+            if (audioMemoryAvailable)
+            {
+                try
+                {
+                    NativeMemoryStats audioStats;
+                    AudioLayer.MemoryGetStats(&audioStats);
+                    liveBytes += audioStats.Total.LiveBytes;
+                    peakBytes += audioStats.Total.PeakBytes;
+                    audioBytes = audioStats.GetSubsystem(NativeMemorySubsystem.Audio).LiveBytes + audioStats.GetSubsystem(NativeMemorySubsystem.Codec).LiveBytes;
+                }
+                catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+                {
+                    // Audio is not available on this platform
+                    audioMemoryAvailable = false;
+                }
+            }
+
+            return true;
+        }
     }
 }
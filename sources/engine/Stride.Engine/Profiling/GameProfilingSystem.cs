@@ -25,10 +25,14 @@ namespace Stride.Profiling
         private const int TopRowHeight = TextRowHeight + 2;
 
         private readonly GcProfiling gcProfiler;
+        private readonly NativeProfiling nativeProfiler;
 
         private readonly StringBuilder gcMemoryStringBuilder = new StringBuilder();
         private string gcMemoryString = string.Empty;
 
+        private readonly StringBuilder nativeMemoryStringBuilder = new StringBuilder();
+        private string nativeMemoryString = string.Empty;
+
         private readonly StringBuilder gcCollectionsStringBuilder = new StringBuilder();
         private string gcCollectionsString = string.Empty;
 
@@ -99,6 +103,7 @@ namespace Stride.Profiling
             DrawOrder = 0xfffffe;
 
             gcProfiler = new GcProfiling();
+            nativeProfiler = new NativeProfiling();
         }
 
         private readonly Stopwatch dumpTiming = Stopwatch.StartNew();
@@ -114,6 +119,7 @@ namespace Stride.Profiling
 
             //Advance any profiler that needs it
             gcProfiler.Tick();
+            nativeProfiler.Tick();
 
             // calculate elaspsed frames
             var newDraw = Game.DrawTime.FrameCount;
@@ -146,7 +152,7 @@ namespace Stride.Profiling
                 // ReSharper restore PossibleInvalidOperationException
             }
 
-            var availableDisplayHeight = viewportHeight - 2 * TextRowHeight - 3 * TopRowHeight;
+            var availableDisplayHeight = viewportHeight - 2 * TextRowHeight - (nativeMemoryStringBuilder.Length > 0 ? 4 : 3) * TopRowHeight;
             var elementsPerPage = (int)Math.Floor(availableDisplayHeight / TextRowHeight);
             numberOfPages = (uint)Math.Ceiling(profilingResults.Count / (float)elementsPerPage);
             CurrentResultPage = Math.Min(CurrentResultPage, numberOfPages);
@@ -184,6 +190,7 @@ namespace Stride.Profiling
             {
                 gcCollectionsString = gcCollectionsStringBuilder.ToString();
                 gcMemoryString = gcMemoryStringBuilder.ToString();
+                nativeMemoryString = nativeMemoryStringBuilder.ToString();
                 profilersString = profilersStringBuilder.ToString();
                 fpsStatString = fpsStatStringBuilder.ToString();
                 gpuInfoString = gpuInfoStringBuilder.ToString();
@@ -241,6 +248,13 @@ namespace Stride.Profiling
                         continue;
                     }
 
+                    if (e.Key == GcProfiling.NativeMemoryKey)
+                    {
+                        nativeMemoryStringBuilder.Clear();
+                        e.Message?.ToString(nativeMemoryStringBuilder);
+                        continue;
+                    }
+
                     if (e.Key == GcProfiling.GcCollectionCountKey)
                     {
                         gcCollectionsStringBuilder.Clear();
@@ -329,6 +343,7 @@ namespace Stride.Profiling
             }
 
             gcProfiler.Dispose();
+            nativeProfiler.Dispose();
         }
 
         /// <inheritdoc/>
@@ -367,6 +382,11 @@ namespace Stride.Profiling
                 {
                     fastTextRenderer.DrawString(graphicsContext, gcMemoryString, textDrawStartOffset.X, currentHeight);
                     currentHeight += TopRowHeight;
+                    if (nativeMemoryString.Length > 0)
+                    {
+                        fastTextRenderer.DrawString(graphicsContext, nativeMemoryString, textDrawStartOffset.X, currentHeight);
+                        currentHeight += TopRowHeight;
+                    }
                     fastTextRenderer.DrawString(graphicsContext, gcCollectionsString, textDrawStartOffset.X, currentHeight);
                     currentHeight += TopRowHeight;
                 }
@@ -431,6 +451,7 @@ namespace Stride.Profiling
             }
 
             gcProfiler.Enable();
+            nativeProfiler.Enable();
 
             if (stringBuilderTask == null || stringBuilderTask.IsCompleted)
             {
@@ -455,6 +476,7 @@ namespace Stride.Profiling
 
             Profiler.DisableAll();
             gcProfiler.Disable();
+            nativeProfiler.Disable();
 
             FilteringMode = GameProfilingResults.Fps;
         }
@@ -0,0 +1,159 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using Stride.Audio;
+using Stride.Core.Diagnostics;
+using Stride.Core.Extensions;
+using Stride.Native;
+
+namespace Stride.Profiling
+{
+    /// <summary>
+    /// Forwards the zones traced by the native libraries to the <see cref="Profiler"/>, as children of <see cref="NativeKey"/>.
+    /// </summary>
+    public class NativeProfiling : IDisposable
+    {
+        // Native threads are numbered by each library, keep them apart from managed thread ids (and from each other) in captures
+        private const int NativeThreadIdBase = 1 << 16;
+        private const int AudioThreadIdBase = 2 << 16;
+
+        private static readonly Logger Log = GlobalLogger.GetLogger("NativeProfiling");
+
+        public static ProfilingKey NativeKey = new ProfilingKey("Native");
+
+        private readonly Dictionary<IntPtr, ProfilingKey> zoneKeys = new Dictionary<IntPtr, ProfilingKey>();
+        private readonly NativeTraceEvent[] events = new NativeTraceEvent[1024];
+        private bool audioTraceAvailable = true;
+        private bool enabled;
+
+        /// <summary>
+        /// Gets the number of zones the native libraries dropped since they were loaded, because a thread traced more zones
+        /// than its buffer holds between two <see cref="Tick"/>. Updated by <see cref="Tick"/>.
+        /// </summary>
+        public long DroppedZoneCount { get; private set; }
+
+        public void Tick()
+        {
+            if (!enabled)
+                return;
+
+            // Zones are timed with the native clock, moved to the profiler time by sampling both clocks now
+            var nativeTime = NativeInvoke.TraceSeconds();
+            var profilerTime = TimeSpanExtensions.FromTimeStamp(Stopwatch.GetTimestamp()) - Profiler.StartTime;
+
+            Drain(false, nativeTime, profilerTime);
+
+            if (audioTraceAvailable)
+            {
+                try
+                {
+                    Drain(true, nativeTime, profilerTime);
+                }
+                catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+                {
+                    // Audio is not available on this platform
+                    audioTraceAvailable = false;
+                }
+            }
+
+            // Native counters only grow, report the zones missing from this capture once
+            var droppedZoneCount = GetDroppedZoneCount();
+            if (droppedZoneCount > DroppedZoneCount)
+            {
+                Log.Warning($"{droppedZoneCount - DroppedZoneCount} native zones were dropped since the last frame, the capture is incomplete.");
+                DroppedZoneCount = droppedZoneCount;
+            }
+        }
+
+        public void Dispose()
+        {
+            Disable();
+        }
+
+        public void Enable()
+        {
+            Profiler.Enable(NativeKey);
+            SetTraceEnabled(true);
+        }
+
+        public void Disable()
+        {
+            Profiler.Disable(NativeKey);
+            SetTraceEnabled(false);
+        }
+
+        private void SetTraceEnabled(bool value)
+        {
+            enabled = value;
+            NativeInvoke.TraceEnable(value);
+
+            if (audioTraceAvailable)
+            {
+                try
+                {
+                    AudioLayer.TraceEnable(value);
+                }
+                catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+                {
+                    audioTraceAvailable = false;
+                }
+            }
+        }
+
+        private long GetDroppedZoneCount()
+        {
+            var count = NativeInvoke.TraceDroppedCount();
+
+            if (audioTraceAvailable)
+            {
+                try
+                {
+                    count += AudioLayer.TraceDroppedCount();
+                }
+                catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+                {
+                    audioTraceAvailable = false;
+                }
+            }
+
+            return count;
+        }
+
+        private unsafe void Drain(bool audio, double nativeTime, TimeSpan profilerTime)
+        {
+            fixed (NativeTraceEvent* eventsPtr = events)
+            {
+                int count;
+                do
+                {
+                    count = audio ? AudioLayer.TraceDrain(eventsPtr, events.Length) : NativeInvoke.TraceDrain(eventsPtr, events.Length);
+                    for (int i = 0; i < count; i++)
+                    {
+                        ref var zone = ref events[i];
+                        var timeStamp = profilerTime - TimeSpan.FromSeconds(nativeTime - zone.Begin);
+                        var elapsedTime = TimeSpan.FromSeconds(zone.End - zone.Begin);
+                        var threadId = (audio ? AudioThreadIdBase : NativeThreadIdBase) + zone.ThreadIndex;
+
+                        var profilingEvent = new ProfilingEvent(0, GetZoneKey(zone.Name), ProfilingMessageType.End, timeStamp, elapsedTime, threadId, null, default);
+                        Profiler.ProcessEvent(ref profilingEvent, ProfilingEventType.CpuProfilingEvent);
+                    }
+                }
+                while (count == events.Length);
+            }
+        }
+
+        // Zone names are static native strings, so their address is enough to identify them
+        private ProfilingKey GetZoneKey(IntPtr name)
+        {
+            if (!zoneKeys.TryGetValue(name, out var key))
+            {
+                key = new ProfilingKey(NativeKey, Marshal.PtrToStringUTF8(name));
+                zoneKeys.Add(name, key);
+            }
+            return key;
+        }
+    }
+}
@@ -33,3 +33,4 @@ using System.Runtime.InteropServices;
 [assembly: InternalsVisibleTo("Stride.Graphics.Tests" + Stride.PublicKeys.Default)]
 [assembly: InternalsVisibleTo("Stride.Engine.Tests" + Stride.PublicKeys.Default)]
 [assembly: InternalsVisibleTo("Stride.VirtualReality" + Stride.PublicKeys.Default)]
+[assembly: InternalsVisibleTo("Stride.Particles" + Stride.PublicKeys.Default)]
@@ -26,6 +26,7 @@ using System.Collections.Generic;
 using System.Runtime.InteropServices;
 using System.Threading;
 using Stride.Core;
+using Stride.Native;
 using Stride.Rendering;
 using Stride.Shaders;
 
@@ -87,7 +88,9 @@ namespace Stride.Graphics
         private ObjectParameterAccessor<SamplerState>? samplerUpdater;
 
         private int[] sortIndices;
+        private ulong[] sortKeys;
         private ElementInfo[] sortedDraws;
+        private readonly Dictionary<Texture, int> sortTextureIds = new(ReferenceEqualityComparer.Instance);
         private ElementInfo[] drawsQueue;
         private int drawsQueueCount;
         private Texture[] drawTextures;
@@ -151,6 +154,19 @@ namespace Stride.Graphics
             lastFrameBuffers = new();
         }
 
+        /// <summary>
+        /// Creates a batch that only queues and sorts elements, without any device resource. It can't draw and is only used by tests.
+        /// </summary>
+        private protected BatchBase(int batchCapacity)
+        {
+            drawsQueue = new ElementInfo[batchCapacity];
+            drawTextures = new Texture[batchCapacity];
+
+            TextureComparer = new TextureIdComparer();
+            BackToFrontComparer = new SpriteBackToFrontComparer();
+            FrontToBackComparer = new SpriteFrontToBackComparer();
+        }
+
         protected override void Destroy()
         {
             base.Destroy();
@@ -310,8 +326,63 @@ namespace Stride.Graphics
             isBeginCalled = false;
         }
 
+        /// <summary>
+        /// Sorts elements of the given depths and textures like <see cref="End"/> does with <paramref name="elementSortMode"/>, without drawing them.
+        /// </summary>
+        /// <returns>The indices of the elements, in draw order.</returns>
+        internal int[] GetDrawOrder(SpriteSortMode elementSortMode, float[] depths, Texture[] textures)
+        {
+            var count = depths.Length;
+            if (drawsQueue.Length < count)
+            {
+                Array.Resize(ref drawsQueue, count);
+                Array.Resize(ref drawTextures, count);
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                drawsQueue[i] = new ElementInfo(0, 0, default, depths[i]);
+                drawTextures[i] = textures[i];
+            }
+            drawsQueueCount = count;
+            sortMode = elementSortMode;
+
+            SortSprites();
+
+            drawsQueueCount = 0;
+            Array.Clear(drawTextures, 0, count);
+            return sortIndices.AsSpan(0, count).ToArray();
+        }
+
         private void SortSprites()
         {
+            if ((sortIndices == null) || (sortIndices.Length < drawsQueueCount))
+            {
+                sortIndices = new int[drawsQueueCount];
+                sortKeys = new ulong[drawsQueueCount];
+                sortedDraws = new ElementInfo[drawsQueueCount];
+            }
+
+            // Reset all indices to the original order
+            for (int i = 0; i < drawsQueueCount; i++)
+            {
+                sortIndices[i] = i;
+            }
+
+            // Default orders are sorted natively with a stable radix sort, custom comparers (or a failed native sort) still go through Array.Sort
+            if (BuildSortKeys())
+            {
+                unsafe
+                {
+                    fixed (ulong* keys = sortKeys)
+                    fixed (int* indices = sortIndices)
+                    {
+                        if (NativeInvoke.RadixSortKeys(keys, (uint*)indices, drawsQueueCount))
+                            return;
+                    }
+                }
+            }
+
             IComparer<int> comparer;
 
             switch (sortMode)
@@ -334,19 +405,73 @@ namespace Stride.Graphics
                     throw new NotSupportedException();
             }
 
-            if ((sortIndices == null) || (sortIndices.Length < drawsQueueCount))
-            {
-                sortIndices = new int[drawsQueueCount];
-                sortedDraws = new ElementInfo[drawsQueueCount];
-            }
+            Array.Sort(sortIndices, 0, drawsQueueCount, comparer);
+        }
 
-            // Reset all indices to the original order
-            for (int i = 0; i < drawsQueueCount; i++)
+        /// <summary>
+        /// Fills <see cref="sortKeys"/> when the sort mode uses the default comparer: depth for <see cref="SpriteSortMode.BackToFront"/>
+        /// and <see cref="SpriteSortMode.FrontToBack"/>, order of first use of the texture for <see cref="SpriteSortMode.Texture"/>.
+        /// </summary>
+        /// <returns><c>true</c> if the keys were built; <c>false</c> if the comparer has been replaced.</returns>
+        private bool BuildSortKeys()
+        {
+            switch (sortMode)
             {
-                sortIndices[i] = i;
+                case SpriteSortMode.Texture:
+                    if (TextureComparer.GetType() != typeof(TextureIdComparer))
+                        return false;
+
+                    sortTextureIds.Clear();
+                    int nextTextureId = 0;
+                    int nullTextureId = -1;
+                    for (int i = 0; i < drawsQueueCount; i++)
+                    {
+                        var texture = drawTextures[i];
+                        int textureId;
+                        if (texture == null)
+                        {
+                            if (nullTextureId < 0)
+                                nullTextureId = nextTextureId++;
+                            textureId = nullTextureId;
+                        }
+                        else if (!sortTextureIds.TryGetValue(texture, out textureId))
+                        {
+                            textureId = nextTextureId++;
+                            sortTextureIds.Add(texture, textureId);
+                        }
+                        sortKeys[i] = (ulong)textureId;
+                    }
+                    return true;
+
+                case SpriteSortMode.BackToFront:
+                    if (BackToFrontComparer.GetType() != typeof(SpriteBackToFrontComparer))
+                        return false;
+
+                    for (int i = 0; i < drawsQueueCount; i++)
+                        sortKeys[i] = (ulong)DepthToSortKey(drawsQueue[i].Depth) << 32;
+                    return true;
+
+                case SpriteSortMode.FrontToBack:
+                    if (FrontToBackComparer.GetType() != typeof(SpriteFrontToBackComparer))
+                        return false;
+
+                    for (int i = 0; i < drawsQueueCount; i++)
+                        sortKeys[i] = (ulong)~DepthToSortKey(drawsQueue[i].Depth) << 32;
+                    return true;
+
+                default:
+                    return false;
             }
+        }
 
-            Array.Sort(sortIndices, 0, drawsQueueCount, comparer);
+        /// <summary>
+        /// Maps a depth to an unsigned integer with the same ordering.
+        /// </summary>
+        private static uint DepthToSortKey(float depth)
+        {
+            // Adding zero turns -0 into +0 so that both get the same key
+            var bits = BitConverter.SingleToUInt32Bits(depth + 0.0f);
+            return (bits & 0x80000000) != 0 ? ~bits : bits | 0x80000000;
         }
 
         private void FlushBatch()
@@ -474,16 +599,8 @@ namespace Stride.Graphics
                 var vertexPointer = mappedVertices.DataBox.DataPointer;
                 var indexPointer = mappedIndices.DataBox.DataPointer;
 
-                for (var i = batchStart; i < offset; i++)
-                {
-                    ref var spriteElementInfo = ref sprites[i];
-
-                    UpdateBufferValuesFromElementInfo(ref spriteElementInfo, vertexPointer, indexPointer, ResourceContext.VertexBufferPosition);
-
-                    ResourceContext.VertexBufferPosition += spriteElementInfo.VertexCount;
-                    vertexPointer += vertexStructSize * spriteElementInfo.VertexCount;
-                    indexPointer += indexStructSize * spriteElementInfo.IndexCount;
-                }
+                UpdateBufferValuesFromElementInfos(sprites, batchStart, offset - batchStart, vertexPointer, indexPointer, ResourceContext.VertexBufferPosition);
+                ResourceContext.VertexBufferPosition += vertexCount;
 
                 GraphicsContext.CommandList.UnmapSubResource(mappedVertices);
                 if (ResourceContext.IsIndexBufferDynamic)
@@ -536,6 +653,33 @@ namespace Stride.Graphics
         /// <param name="vexterStartOffset">The offset in the vertex buffer where the vertex of the element starts</param>
         protected abstract void UpdateBufferValuesFromElementInfo(ref ElementInfo elementInfo, IntPtr vertexPointer, IntPtr indexPointer, int vexterStartOffset);
 
+        /// <summary>
+        /// Update the mapped vertex and index buffer values using a contiguous range of element infos.
+        /// </summary>
+        /// <remarks>
+        /// The default implementation calls <see cref="UpdateBufferValuesFromElementInfo"/> for each element.
+        /// Override it to fill the whole range at once.
+        /// </remarks>
+        /// <param name="elementInfos">The array containing the elements to draw.</param>
+        /// <param name="offset">The index of the first element to draw.</param>
+        /// <param name="count">The number of elements to draw.</param>
+        /// <param name="vertexPointer">The pointer to the vertex array buffer to update.</param>
+        /// <param name="indexPointer">The pointer to the index array buffer to update. This value is null if the index buffer used is static.</param>
+        /// <param name="vexterStartOffset">The offset in the vertex buffer where the vertex of the first element starts</param>
+        protected virtual void UpdateBufferValuesFromElementInfos(ElementInfo[] elementInfos, int offset, int count, IntPtr vertexPointer, IntPtr indexPointer, int vexterStartOffset)
+        {
+            for (var i = offset; i < offset + count; i++)
+            {
+                ref var elementInfo = ref elementInfos[i];
+
+                UpdateBufferValuesFromElementInfo(ref elementInfo, vertexPointer, indexPointer, vexterStartOffset);
+
+                vexterStartOffset += elementInfo.VertexCount;
+                vertexPointer += vertexStructSize * elementInfo.VertexCount;
+                indexPointer += indexStructSize * elementInfo.IndexCount;
+            }
+        }
+
         #region Nested types
 
         protected struct DrawTextures
@@ -5,6 +5,7 @@ using System;
 using System.Runtime.InteropServices;
 using System.Text;
 using Stride.Core.Mathematics;
+using Stride.Native;
 using Stride.Rendering;
 
 namespace Stride.Graphics
@@ -589,45 +590,61 @@ namespace Stride.Graphics
 
         protected override unsafe void UpdateBufferValuesFromElementInfo(ref ElementInfo elementInfo, IntPtr vertexPtr, IntPtr indexPtr, int vertexOffset)
         {
-            var vertex = (VertexPositionColorTextureSwizzle*)vertexPtr;
             fixed (SpriteDrawInfo* drawInfo = &elementInfo.DrawInfo)
             {
-                float deltaX = 1.0f / drawInfo->TextureSize.X;
-                float deltaY = 1.0f / drawInfo->TextureSize.Y;
+                BuildVertices(drawInfo, (VertexPositionColorTextureSwizzle*)vertexPtr);
+            }
+        }
 
-                Vector2 rotation = new(1,0);
+        /// <summary>
+        /// Expands a sprite into its 4 vertices with managed math. <see cref="NativeInvoke.SpriteBatchBuildVertices"/> does the same for a whole batch.
+        /// </summary>
+        internal static unsafe void BuildVertices(SpriteDrawInfo* drawInfo, VertexPositionColorTextureSwizzle* vertex)
+        {
+            float deltaX = 1.0f / drawInfo->TextureSize.X;
+            float deltaY = 1.0f / drawInfo->TextureSize.Y;
 
-                if (Math.Abs(drawInfo->Rotation) > float.Epsilon)
-                {
-                    (rotation.Y, rotation.X) = MathF.SinCos(drawInfo->Rotation);
-                }
+            Vector2 rotation = new(1,0);
+
+            if (Math.Abs(drawInfo->Rotation) > float.Epsilon)
+            {
+                (rotation.Y, rotation.X) = MathF.SinCos(drawInfo->Rotation);
+            }
 
-                Vector2 origin = drawInfo->Origin;
-                origin.X /= Math.Max(float.Epsilon, drawInfo->Source.Width);
-                origin.Y /= Math.Max(float.Epsilon, drawInfo->Source.Height);
+            Vector2 origin = drawInfo->Origin;
+            origin.X /= Math.Max(float.Epsilon, drawInfo->Source.Width);
+            origin.Y /= Math.Max(float.Epsilon, drawInfo->Source.Height);
 
-                for (int j = 0; j < 4; j++)
-                {
-                    Vector2 corner = CornerOffsets[j];
-                    Vector2 position;
-                    position.X = (corner.X - origin.X) * drawInfo->Destination.Width;
-                    position.Y = (corner.Y - origin.Y) * drawInfo->Destination.Height;
-
-                    vertex->Position.X = drawInfo->Destination.X + (position.X * rotation.X) - (position.Y * rotation.Y);
-                    vertex->Position.Y = drawInfo->Destination.Y + (position.X * rotation.Y) + (position.Y * rotation.X);
-                    vertex->Position.Z = drawInfo->Depth;
-                    vertex->Position.W = 1.0f;
-                    vertex->ColorScale = drawInfo->ColorScale;
-                    vertex->ColorAdd = drawInfo->ColorAdd;
-
-                    corner = CornerOffsets[((j ^ (int)drawInfo->SpriteEffects) + (int)drawInfo->Orientation) % 4];
-                    vertex->TextureCoordinate.X = (drawInfo->Source.X + corner.X * drawInfo->Source.Width) * deltaX;
-                    vertex->TextureCoordinate.Y = (drawInfo->Source.Y + corner.Y * drawInfo->Source.Height) * deltaY;
-
-                    vertex->Swizzle = (int)drawInfo->Swizzle;
-                    
-                    vertex++;
-                }
+            for (int j = 0; j < 4; j++)
+            {
+                Vector2 corner = CornerOffsets[j];
+                Vector2 position;
+                position.X = (corner.X - origin.X) * drawInfo->Destination.Width;
+                position.Y = (corner.Y - origin.Y) * drawInfo->Destination.Height;
+
+                vertex->Position.X = drawInfo->Destination.X + (position.X * rotation.X) - (position.Y * rotation.Y);
+                vertex->Position.Y = drawInfo->Destination.Y + (position.X * rotation.Y) + (position.Y * rotation.X);
+                vertex->Position.Z = drawInfo->Depth;
+                vertex->Position.W = 1.0f;
+                vertex->ColorScale = drawInfo->ColorScale;
+                vertex->ColorAdd = drawInfo->ColorAdd;
+
+                corner = CornerOffsets[((j ^ (int)drawInfo->SpriteEffects) + (int)drawInfo->Orientation) % 4];
+                vertex->TextureCoordinate.X = (drawInfo->Source.X + corner.X * drawInfo->Source.Width) * deltaX;
+                vertex->TextureCoordinate.Y = (drawInfo->Source.Y + corner.Y * drawInfo->Source.Height) * deltaY;
+
+                vertex->Swizzle = (int)drawInfo->Swizzle;
+                
+                vertex++;
+            }
+        }
+
+        protected override unsafe void UpdateBufferValuesFromElementInfos(ElementInfo[] elementInfos, int offset, int count, IntPtr vertexPtr, IntPtr indexPtr, int vertexOffset)
+        {
+            // Sprites always use 4 vertices and the static quad index buffer, so the whole range can be expanded natively in one call
+            fixed (ElementInfo* elementInfo = &elementInfos[offset])
+            {
+                NativeInvoke.SpriteBatchBuildVertices(&elementInfo->DrawInfo, sizeof(ElementInfo), count, (void*)vertexPtr);
             }
         }
 
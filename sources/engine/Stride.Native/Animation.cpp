@@ -0,0 +1,295 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "StrideNative.h"
+
+/*
+* Animation curve sampling and blending.
+* The keys of a clip are stored in SoA form per value type: keyTimes (CompressedTimeSpan ticks) and keyValues (components floats
+* per key) hold the keys of every channel one after the other, channel c owning keys [channelKeyStarts[c], channelKeyStarts[c + 1]).
+* Values are processed as float4, one channel per vector.
+*/
+
+extern "C" {
+	// AnimationCurveInterpolationType
+	#define ANIMATION_INTERPOLATION_CONSTANT 0
+	#define ANIMATION_INTERPOLATION_LINEAR 1
+	#define ANIMATION_INTERPOLATION_CUBIC 2
+
+	// AnimationBlender.BlendType
+	#define ANIMATION_BLEND_BLIT 0
+	#define ANIMATION_BLEND_OBJECT 1
+	#define ANIMATION_BLEND_FLOAT1 2
+	#define ANIMATION_BLEND_FLOAT2 3
+	#define ANIMATION_BLEND_FLOAT3 4
+	#define ANIMATION_BLEND_FLOAT4 5
+	#define ANIMATION_BLEND_QUATERNION 6
+
+	// CoreAnimationOperation
+	#define ANIMATION_OPERATION_BLEND 0
+	#define ANIMATION_OPERATION_ADD 1
+	#define ANIMATION_OPERATION_SUBTRACT 2
+
+	static inline float4 LoadValue(const void* source, int components)
+	{
+		float4 value = { 0.0f, 0.0f, 0.0f, 0.0f };
+		memcpy(&value, source, sizeof(float) * components);
+		return value;
+	}
+
+	static inline void StoreValue(void* destination, const float4& value, int components)
+	{
+		memcpy(destination, &value, sizeof(float) * components);
+	}
+
+	static inline float Dot4(const float4& left, const float4& right)
+	{
+		float4 product = left * right;
+		return product.x + product.y + product.z + product.w;
+	}
+
+	// Linear interpolation along the shortest arc, normalized
+	static inline float4 Nlerp(const float4& start, const float4& end, float amount)
+	{
+		float4 target = Dot4(start, end) < 0.0f ? -end : end;
+		float4 result = start + (target - start) * amount;
+		float lengthSquared = Dot4(result, result);
+		return lengthSquared > 0.0f ? result * (1.0f / sqrtf(lengthSquared)) : start;
+	}
+
+	static inline float4 NormalizeQuaternion(const float4& value)
+	{
+		float lengthSquared = Dot4(value, value);
+		return lengthSquared > 0.0f ? value * (1.0f / sqrtf(lengthSquared)) : value;
+	}
+
+	// Same as Quaternion.Multiply(left, right)
+	static inline float4 MultiplyQuaternion(const float4& left, const float4& right)
+	{
+		float4 result;
+		result.x = (right.x * left.w + left.x * right.w + right.y * left.z) - (right.z * left.y);
+		result.y = (right.y * left.w + left.y * right.w + right.z * left.x) - (right.x * left.z);
+		result.z = (right.z * left.w + left.z * right.w + right.x * left.y) - (right.y * left.x);
+		result.w = (right.w * left.w) - (right.x * left.x + right.y * left.y + right.z * left.z);
+		return result;
+	}
+
+	// Same as Quaternion.Invert
+	static inline float4 InvertQuaternion(const float4& value)
+	{
+		float lengthSquared = Dot4(value, value);
+		if (lengthSquared <= 1e-6f)
+			return value;
+		float4 conjugate = { -value.x, -value.y, -value.z, value.w };
+		return conjugate * (1.0f / lengthSquared);
+	}
+
+	// Last segment [k, k + 1] starting at or before time, searched forward from the previous segment first
+	static inline int FindSegment(const int32_t* times, int count, int cursor, int32_t time)
+	{
+		int last = count - 2;
+		if (last <= 0)
+			return 0;
+
+		if (cursor >= 0 && cursor <= last && times[cursor] <= time)
+		{
+			for (int step = 0; step < 4 && cursor < last && times[cursor + 1] <= time; step++)
+				cursor++;
+			if (cursor == last || times[cursor + 1] > time)
+				return cursor;
+		}
+
+		int low = 0, high = last;
+		while (low < high)
+		{
+			int middle = (low + high + 1) >> 1;
+			if (times[middle] <= time)
+				low = middle;
+			else
+				high = middle - 1;
+		}
+		return low;
+	}
+
+	/*
+	* Samples every channel of a clip at time, like AnimationCurveEvaluatorOptimizedGroup: the value is the first key before the
+	* first key time, the last one after the last key time, and is interpolated between the surrounding keys otherwise
+	* (linear interpolation of quaternions is a normalized lerp).
+	* Channel c is written at output + outputOffsets[c], channels with a negative offset are skipped.
+	* cursors holds the last segment of each channel (initialize to 0), so that sampling forward in time doesn't search the keys.
+	*/
+	DLL_EXPORT_API void xnAnimationSampleChannels(const int32_t* keyTimes, const float* keyValues, const int32_t* channelKeyStarts, const int32_t* interpolationTypes, const int32_t* outputOffsets, int32_t* cursors, int channelCount, int components, int quaternion, int32_t time, uint8_t* output)
+	{
+		for (int channel = 0; channel < channelCount; channel++)
+		{
+			int offset = outputOffsets[channel];
+			int firstKey = channelKeyStarts[channel];
+			int keyCount = channelKeyStarts[channel + 1] - firstKey;
+			if (offset < 0 || keyCount == 0)
+				continue;
+
+			const int32_t* times = keyTimes + firstKey;
+			const float* values = keyValues + (size_t)firstKey * components;
+
+			int start = FindSegment(times, keyCount, cursors[channel], time);
+			int end = keyCount > 1 ? start + 1 : start;
+			cursors[channel] = start;
+
+			float4 value;
+			if (time <= times[start])
+			{
+				value = LoadValue(values + start * components, components);
+			}
+			else if (time >= times[end])
+			{
+				value = LoadValue(values + end * components, components);
+			}
+			else
+			{
+				float factor = (float)(time - times[start]) / (float)(times[end] - times[start]);
+				float4 startValue = LoadValue(values + start * components, components);
+				float4 endValue = LoadValue(values + end * components, components);
+
+				switch (interpolationTypes[channel])
+				{
+				case ANIMATION_INTERPOLATION_LINEAR:
+					if (quaternion)
+						value = Nlerp(startValue, endValue, factor);
+					else if (components == 1)
+						value = (1.0f - factor) * startValue + factor * endValue;
+					else
+						value = startValue + (endValue - startValue) * factor;
+					break;
+
+				case ANIMATION_INTERPOLATION_CUBIC:
+				{
+					// Same as Interpolator.Cubic, the tangents are implied by the previous and next keys
+					float4 previousValue = LoadValue(values + (start > 0 ? start - 1 : 0) * components, components);
+					float4 nextValue = LoadValue(values + (end + 1 < keyCount ? end + 1 : end) * components, components);
+					if (quaternion)
+					{
+						// q and -q are the same rotation: bring the keys into the hemisphere of startValue, each one relative to its
+						// neighbour, otherwise the spline goes through the origin and flips when normalized
+						previousValue = Dot4(previousValue, startValue) < 0.0f ? -previousValue : previousValue;
+						endValue = Dot4(endValue, startValue) < 0.0f ? -endValue : endValue;
+						nextValue = Dot4(nextValue, endValue) < 0.0f ? -nextValue : nextValue;
+					}
+					float t2 = factor * factor;
+					float t3 = t2 * factor;
+					float factor0 = -t3 + 2.0f * t2 - factor;
+					float factor1 = 3.0f * t3 - 5.0f * t2 + 2.0f;
+					float factor2 = -3.0f * t3 + 4.0f * t2 + factor;
+					float factor3 = t3 - t2;
+					value = 0.5f * (previousValue * factor0 + startValue * factor1 + endValue * factor2 + nextValue * factor3);
+					if (quaternion)
+						value = NormalizeQuaternion(value);
+					break;
+				}
+
+				default:
+					value = startValue;
+					break;
+				}
+			}
+
+			StoreValue(output + offset, value, components);
+		}
+	}
+
+	/*
+	* Same as AnimationBlender.Blend: blends each channel of left and right into result, where every channel starts with a float
+	* factor (0 when the channel is missing) followed by its value. Quaternions are blended with a normalized lerp.
+	* Returns -1, or the index of the first channel whose blend type isn't supported by the operation.
+	*/
+	DLL_EXPORT_API int xnAnimationBlend(int operation, float blendFactor, const uint8_t* left, const uint8_t* right, uint8_t* result, const AnimationBlendChannel* channels, int channelCount)
+	{
+		for (int i = 0; i < channelCount; i++)
+		{
+			const AnimationBlendChannel& channel = channels[i];
+			const uint8_t* leftData = left + channel.Offset;
+			const uint8_t* rightData = right + channel.Offset;
+			uint8_t* resultData = result + channel.Offset;
+
+			float factorLeft, factorRight;
+			memcpy(&factorLeft, leftData, sizeof(float));
+			memcpy(&factorRight, rightData, sizeof(float));
+			leftData += sizeof(float);
+			rightData += sizeof(float);
+
+			// Ignore the channel, or use the only value present
+			float resultFactor = (factorLeft == 0.0f && factorRight == 0.0f) ? 0.0f : 1.0f;
+			memcpy(resultData, &resultFactor, sizeof(float));
+			resultData += sizeof(float);
+
+			if (factorLeft == 0.0f && factorRight == 0.0f)
+				continue;
+
+			if (factorLeft > 0.0f && factorRight == 0.0f)
+			{
+				memmove(resultData, leftData, channel.Size);
+				continue;
+			}
+
+			if (factorRight > 0.0f && factorLeft == 0.0f)
+			{
+				memmove(resultData, rightData, channel.Size);
+				continue;
+			}
+
+			int components;
+			switch (channel.BlendType)
+			{
+			case ANIMATION_BLEND_FLOAT1: components = 1; break;
+			case ANIMATION_BLEND_FLOAT2: components = 2; break;
+			case ANIMATION_BLEND_FLOAT3: components = 3; break;
+			case ANIMATION_BLEND_FLOAT4: components = 4; break;
+			case ANIMATION_BLEND_QUATERNION: components = 4; break;
+			default: components = 0; break;
+			}
+
+			if (channel.BlendType == ANIMATION_BLEND_BLIT)
+			{
+				// Blend picks the closest value, Add and Subtract keep the left one
+				const uint8_t* source = operation == ANIMATION_OPERATION_BLEND && blendFactor >= 0.5f ? rightData : leftData;
+				memmove(resultData, source, channel.Size);
+				continue;
+			}
+
+			// Float1 can only be blended, Float4 is not supported (as in the managed version)
+			if (components == 0 || channel.BlendType == ANIMATION_BLEND_FLOAT4 || (channel.BlendType == ANIMATION_BLEND_FLOAT1 && operation != ANIMATION_OPERATION_BLEND))
+				return i;
+
+			float4 leftValue = LoadValue(leftData, components);
+			float4 rightValue = LoadValue(rightData, components);
+			float4 value;
+
+			if (channel.BlendType == ANIMATION_BLEND_QUATERNION)
+			{
+				float4 target = rightValue;
+				if (operation == ANIMATION_OPERATION_ADD)
+					target = NormalizeQuaternion(MultiplyQuaternion(leftValue, rightValue));
+				else if (operation == ANIMATION_OPERATION_SUBTRACT)
+					target = NormalizeQuaternion(MultiplyQuaternion(InvertQuaternion(rightValue), leftValue));
+				value = Nlerp(leftValue, target, blendFactor);
+			}
+			else if (channel.BlendType == ANIMATION_BLEND_FLOAT1)
+			{
+				value = (1.0f - blendFactor) * leftValue + blendFactor * rightValue;
+			}
+			else
+			{
+				float4 target = rightValue;
+				if (operation == ANIMATION_OPERATION_ADD)
+					target = leftValue + rightValue;
+				else if (operation == ANIMATION_OPERATION_SUBTRACT)
+					target = leftValue - rightValue;
+				value = leftValue + (target - leftValue) * blendFactor;
+			}
+
+			StoreValue(resultData, value, components);
+		}
+
+		return -1;
+	}
+}
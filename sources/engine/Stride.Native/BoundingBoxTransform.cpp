@@ -0,0 +1,91 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeFloat4.h"
+#include "StrideNative.h"
+
+extern "C" {
+	static inline float4 LoadVector3(const Vector3* value)
+	{
+		return float4{ value->X, value->Y, value->Z, 0.0f };
+	}
+
+	static inline void StoreVector3(Vector3* value, float4 v)
+	{
+		value->X = v.x;
+		value->Y = v.y;
+		value->Z = v.z;
+	}
+
+	// Same as BoundingBoxExt.Transform: http://zeuxcg.org/2010/10/17/aabb-from-obb-with-component-wise-abs/
+	static inline void TransformBox(const BoundingBox* box, const Matrix* world, float4* minimum, float4* maximum)
+	{
+		// Matrix stores its columns contiguously, transpose them to get the rows (M11, M12, M13, M14), ...
+		float4 rows[4];
+		for (int i = 0; i < 4; i++)
+		{
+			rows[i] = npLoadF4(&world->Array[4 * i]);
+		}
+		npTransposeF4(rows);
+		float4 row0 = rows[0], row1 = rows[1], row2 = rows[2], row3 = rows[3];
+
+		float4 boxMinimum = LoadVector3(&box->minimum);
+		float4 boxMaximum = LoadVector3(&box->maximum);
+		float4 center = (boxMinimum + boxMaximum) * 0.5f;
+		float4 extent = (boxMaximum - boxMinimum) * 0.5f;
+
+		// Vector3.TransformCoordinate
+		float4 worldCenter = center.x * row0 + center.y * row1 + center.z * row2 + row3;
+		worldCenter /= worldCenter.w;
+
+		// Vector3.TransformNormal by the absolute matrix
+		float4 worldExtent = extent.x * (float4)((int4)row0 & 0x7fffffff)
+			+ extent.y * (float4)((int4)row1 & 0x7fffffff)
+			+ extent.z * (float4)((int4)row2 & 0x7fffffff);
+
+		*minimum = worldCenter - worldExtent;
+		*maximum = worldCenter + worldExtent;
+	}
+
+	/*
+	* Transforms boxes[i] by worlds[i] into result[i], for count boxes.
+	*/
+	DLL_EXPORT_API void xnBoundingBoxTransform(const BoundingBox* boxes, const Matrix* worlds, BoundingBox* result, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			float4 minimum, maximum;
+			TransformBox(&boxes[i], &worlds[i], &minimum, &maximum);
+			StoreVector3(&result[i].minimum, minimum);
+			StoreVector3(&result[i].maximum, maximum);
+		}
+	}
+
+	/*
+	* Transforms boxes[i] by worlds[i] and merges it into groupBounds[groupIndex[i]] (skipped when groupIndex[i] is negative).
+	* groupBounds must be initialized by the caller (e.g. to BoundingBox.Empty). result is optional and receives every transformed box.
+	*/
+	DLL_EXPORT_API void xnBoundingBoxTransformMerge(const BoundingBox* boxes, const Matrix* worlds, BoundingBox* result, const int* groupIndex, BoundingBox* groupBounds, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			float4 minimum, maximum;
+			TransformBox(&boxes[i], &worlds[i], &minimum, &maximum);
+
+			if (result)
+			{
+				StoreVector3(&result[i].minimum, minimum);
+				StoreVector3(&result[i].maximum, maximum);
+			}
+
+			int group = groupIndex[i];
+			if (group >= 0)
+			{
+				BoundingBox* bounds = &groupBounds[group];
+				StoreVector3(&bounds->minimum, npMinF4(LoadVector3(&bounds->minimum), minimum));
+				StoreVector3(&bounds->maximum, npMaxF4(LoadVector3(&bounds->maximum), maximum));
+			}
+		}
+	}
+}
@@ -0,0 +1,664 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeFloat4.h"
+#include "../../../deps/NativePath/NativeCpu.h"
+#include "../../../deps/NativePath/NativeTrace.h"
+#include "StrideNative.h"
+
+/*
+* Bounding volume hierarchy over primitive bounding boxes (triangles or arbitrary BoundingBox leaves), built with binned SAH.
+* A node over n primitives owns the 2n - 1 node slots following it, which gives every subtree a fixed place in the node
+* array: subtrees can be built independently (see xnBvhBuildTopLevel) and nodes always needs 2 * count - 1 entries.
+* Rays are traced in packets of 8 lanes on AVX2 CPUs and 4 lanes otherwise, picked at runtime (see NativeCpu.h).
+*/
+
+// Leaves hold at most this many primitives, larger ranges are always split
+#define BVH_MAX_LEAF_SIZE 8
+#define BVH_BIN_COUNT 16
+// Past this depth, ranges are split in two halves to bound the tree depth
+#define BVH_MEDIAN_SPLIT_DEPTH 32
+// Top level and subtree tasks can each go 32 levels deep before median splits, which add at most 32 levels
+#define BVH_STACK_SIZE 160
+
+typedef float float8 __attribute__((ext_vector_type(8)));
+typedef int32_t int8 __attribute__((ext_vector_type(8)));
+
+// Vectors are passed by reference: 8 lane vectors passed by value change the ABI depending on AVX support
+template<typename TFloat, typename TInt>
+NP_CPU_INLINE void SelectLanes(TFloat& result, const TInt& mask, const TFloat& a, const TFloat& b)
+{
+	result = (TFloat)(((TInt)a & mask) | ((TInt)b & ~mask));
+}
+
+template<typename TFloat, typename TInt>
+NP_CPU_INLINE void MinLanes(TFloat& result, const TFloat& a, const TFloat& b)
+{
+	TInt mask = a < b;
+	SelectLanes(result, mask, a, b);
+}
+
+template<typename TFloat, typename TInt>
+NP_CPU_INLINE void MaxLanes(TFloat& result, const TFloat& a, const TFloat& b)
+{
+	TInt mask = a > b;
+	SelectLanes(result, mask, a, b);
+}
+
+template<typename TInt>
+NP_CPU_INLINE int AnyLane(const TInt& mask)
+{
+	for (int i = 0; i < (int)(sizeof(TInt) / sizeof(int32_t)); i++)
+	{
+		if (mask[i])
+			return 1;
+	}
+	return 0;
+}
+
+// Index of the first set lane, mask must have one
+template<typename TInt>
+NP_CPU_INLINE int FirstLane(const TInt& mask)
+{
+	int i = 0;
+	while (!mask[i])
+		i++;
+	return i;
+}
+
+template<typename TFloat, typename TInt>
+struct RayPacket
+{
+	TFloat OriginX, OriginY, OriginZ;
+	TFloat DirectionX, DirectionY, DirectionZ;
+	TFloat InverseX, InverseY, InverseZ;
+	// Closest hit so far, negative for inactive lanes
+	TFloat MaxDistance;
+	TFloat U, V;
+	TInt Primitive;
+};
+
+// Slab test, entry is clamped to the ray origin
+template<typename TFloat, typename TInt>
+NP_CPU_INLINE void IntersectBoxLanes(const RayPacket<TFloat, TInt>& ray, const Vector3& minimum, const Vector3& maximum, TInt& mask, TFloat& entry)
+{
+	TFloat t0, t1, exit, near, far;
+
+	t0 = (minimum.X - ray.OriginX) * ray.InverseX;
+	t1 = (maximum.X - ray.OriginX) * ray.InverseX;
+	MinLanes<TFloat, TInt>(entry, t0, t1);
+	MaxLanes<TFloat, TInt>(exit, t0, t1);
+
+	t0 = (minimum.Y - ray.OriginY) * ray.InverseY;
+	t1 = (maximum.Y - ray.OriginY) * ray.InverseY;
+	MinLanes<TFloat, TInt>(near, t0, t1);
+	MaxLanes<TFloat, TInt>(far, t0, t1);
+	MaxLanes<TFloat, TInt>(entry, entry, near);
+	MinLanes<TFloat, TInt>(exit, exit, far);
+
+	t0 = (minimum.Z - ray.OriginZ) * ray.InverseZ;
+	t1 = (maximum.Z - ray.OriginZ) * ray.InverseZ;
+	MinLanes<TFloat, TInt>(near, t0, t1);
+	MaxLanes<TFloat, TInt>(far, t0, t1);
+	MaxLanes<TFloat, TInt>(entry, entry, near);
+	MinLanes<TFloat, TInt>(exit, exit, far);
+
+	TFloat zero = 0.0f;
+	MaxLanes<TFloat, TInt>(entry, entry, zero);
+	MinLanes<TFloat, TInt>(exit, exit, ray.MaxDistance);
+	mask = entry <= exit;
+}
+
+template<typename TFloat, typename TInt>
+NP_CPU_INLINE void RecordHits(RayPacket<TFloat, TInt>& ray, const TInt& mask, const TFloat& distance, const TFloat& u, const TFloat& v, uint32_t primitive)
+{
+	SelectLanes<TFloat, TInt>(ray.MaxDistance, mask, distance, ray.MaxDistance);
+	SelectLanes<TFloat, TInt>(ray.U, mask, u, ray.U);
+	SelectLanes<TFloat, TInt>(ray.V, mask, v, ray.V);
+	ray.Primitive = (mask & (int32_t)primitive) | (~mask & ray.Primitive);
+}
+
+// Triangles are 3 indices into a strided position buffer, tested on both sides [Moller and Trumbore 1997]
+struct TriangleLeaves
+{
+	const uint8_t* Positions;
+	int PositionStride;
+	const uint32_t* Indices;
+
+	template<typename TFloat, typename TInt>
+	inline __attribute__((always_inline)) void Intersect(RayPacket<TFloat, TInt>& ray, uint32_t primitive, TInt& mask) const
+	{
+		const Vector3* p0 = (const Vector3*)(Positions + (size_t)Indices[primitive * 3 + 0] * PositionStride);
+		const Vector3* p1 = (const Vector3*)(Positions + (size_t)Indices[primitive * 3 + 1] * PositionStride);
+		const Vector3* p2 = (const Vector3*)(Positions + (size_t)Indices[primitive * 3 + 2] * PositionStride);
+		float e1x = p1->X - p0->X, e1y = p1->Y - p0->Y, e1z = p1->Z - p0->Z;
+		float e2x = p2->X - p0->X, e2y = p2->Y - p0->Y, e2z = p2->Z - p0->Z;
+
+		TFloat px = ray.DirectionY * e2z - ray.DirectionZ * e2y;
+		TFloat py = ray.DirectionZ * e2x - ray.DirectionX * e2z;
+		TFloat pz = ray.DirectionX * e2y - ray.DirectionY * e2x;
+		TFloat determinant = e1x * px + e1y * py + e1z * pz;
+		TFloat inverseDeterminant = 1.0f / determinant;
+
+		TFloat tx = ray.OriginX - p0->X;
+		TFloat ty = ray.OriginY - p0->Y;
+		TFloat tz = ray.OriginZ - p0->Z;
+		TFloat u = (tx * px + ty * py + tz * pz) * inverseDeterminant;
+
+		TFloat qx = ty * e1z - tz * e1y;
+		TFloat qy = tz * e1x - tx * e1z;
+		TFloat qz = tx * e1y - ty * e1x;
+		TFloat v = (ray.DirectionX * qx + ray.DirectionY * qy + ray.DirectionZ * qz) * inverseDeterminant;
+		TFloat distance = (e2x * qx + e2y * qy + e2z * qz) * inverseDeterminant;
+
+		mask = (determinant != 0.0f) & (u >= 0.0f) & (v >= 0.0f) & (u + v <= 1.0f) & (distance > 0.0f) & (distance < ray.MaxDistance);
+		RecordHits(ray, mask, distance, u, v, primitive);
+	}
+};
+
+// Primitives are the boxes themselves, hit at their entry distance (0 when the ray starts inside)
+struct BoxLeaves
+{
+	const BoundingBox* Bounds;
+
+	template<typename TFloat, typename TInt>
+	inline __attribute__((always_inline)) void Intersect(RayPacket<TFloat, TInt>& ray, uint32_t primitive, TInt& mask) const
+	{
+		TFloat entry;
+		IntersectBoxLanes(ray, Bounds[primitive].minimum, Bounds[primitive].maximum, mask, entry);
+		mask &= entry < ray.MaxDistance;
+
+		TFloat zero = 0.0f;
+		RecordHits(ray, mask, entry, zero, zero, primitive);
+	}
+};
+
+template<typename TFloat, typename TInt, typename TLeaves>
+NP_CPU_INLINE void IntersectPacket(const BvhNode* nodes, const uint32_t* primitiveIndices, const TLeaves& leaves, const Ray* rays, const float* maxDistances, int count, int anyHit, BvhHit* hits, uint8_t* occluded)
+{
+	const int Width = sizeof(TFloat) / sizeof(float);
+
+	// Unused lanes replicate the first ray but stay inactive
+	RayPacket<TFloat, TInt> ray;
+	for (int i = 0; i < Width; i++)
+	{
+		const Ray* source = &rays[i < count ? i : 0];
+		ray.OriginX[i] = source->Position.X;
+		ray.OriginY[i] = source->Position.Y;
+		ray.OriginZ[i] = source->Position.Z;
+		ray.DirectionX[i] = source->Direction.X;
+		ray.DirectionY[i] = source->Direction.Y;
+		ray.DirectionZ[i] = source->Direction.Z;
+		ray.MaxDistance[i] = i < count ? (maxDistances ? maxDistances[i] : __builtin_inff()) : -1.0f;
+	}
+	ray.InverseX = 1.0f / ray.DirectionX;
+	ray.InverseY = 1.0f / ray.DirectionY;
+	ray.InverseZ = 1.0f / ray.DirectionZ;
+	ray.U = 0.0f;
+	ray.V = 0.0f;
+	ray.Primitive = -1;
+
+	TInt occludedLanes = 0;
+	uint32_t stack[BVH_STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BvhNode* node = &nodes[stack[--stackSize]];
+
+		TInt mask;
+		TFloat entry;
+		IntersectBoxLanes(ray, node->Minimum, node->Maximum, mask, entry);
+		if (!AnyLane(mask))
+			continue;
+
+		if (node->Count == 0)
+		{
+			// Visit the child on the side the packet comes from first (rays of a packet are expected to be coherent).
+			// The direction is taken from a lane that hit the node, inactive lanes only replicate the first ray.
+			int lane = FirstLane(mask);
+			const BvhNode* left = &nodes[node->LeftOrFirst];
+			const BvhNode* right = left + 1;
+			float separationX = (right->Minimum.X + right->Maximum.X) - (left->Minimum.X + left->Maximum.X);
+			float separationY = (right->Minimum.Y + right->Maximum.Y) - (left->Minimum.Y + left->Maximum.Y);
+			float separationZ = (right->Minimum.Z + right->Maximum.Z) - (left->Minimum.Z + left->Maximum.Z);
+			float direction = ray.DirectionX[lane] * separationX;
+			if (fabsf(separationY) > fabsf(separationX) && fabsf(separationY) >= fabsf(separationZ))
+				direction = ray.DirectionY[lane] * separationY;
+			else if (fabsf(separationZ) > fabsf(separationX))
+				direction = ray.DirectionZ[lane] * separationZ;
+
+			int leftFirst = direction >= 0.0f;
+			stack[stackSize++] = node->LeftOrFirst + leftFirst;
+			stack[stackSize++] = node->LeftOrFirst + 1 - leftFirst;
+			continue;
+		}
+
+		for (uint32_t i = 0; i < node->Count; i++)
+		{
+			leaves.Intersect(ray, primitiveIndices[node->LeftOrFirst + i], mask);
+			if (anyHit && AnyLane(mask))
+			{
+				// Occluded lanes are done
+				occludedLanes |= mask;
+				TFloat done = -1.0f;
+				SelectLanes<TFloat, TInt>(ray.MaxDistance, mask, done, ray.MaxDistance);
+				if (!AnyLane(ray.MaxDistance >= 0.0f))
+				{
+					stackSize = 0;
+					break;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (anyHit)
+		{
+			occluded[i] = occludedLanes[i] ? 1 : 0;
+			continue;
+		}
+
+		hits[i].PrimitiveIndex = (uint32_t)ray.Primitive[i];
+		hits[i].Distance = ray.Primitive[i] >= 0 ? ray.MaxDistance[i] : __builtin_inff();
+		hits[i].U = ray.U[i];
+		hits[i].V = ray.V[i];
+	}
+}
+
+template<typename TFloat, typename TInt, typename TLeaves>
+NP_CPU_INLINE void IntersectPackets(const BvhNode* nodes, const uint32_t* primitiveIndices, const TLeaves* leaves, const Ray* rays, const float* maxDistances, int anyHit, BvhHit* hits, uint8_t* occluded, int start, int end)
+{
+	const int Width = sizeof(TFloat) / sizeof(float);
+	for (int i = start; i < end; i += Width)
+	{
+		int count = end - i < Width ? end - i : Width;
+		IntersectPacket<TFloat, TInt>(nodes, primitiveIndices, *leaves, &rays[i], maxDistances ? &maxDistances[i] : NULL, count, anyHit,
+			hits ? &hits[i] : NULL, occluded ? &occluded[i] : NULL);
+	}
+}
+
+template<typename TLeaves>
+static void IntersectPacketsDefault(const BvhNode* nodes, const uint32_t* primitiveIndices, const TLeaves* leaves, const Ray* rays, const float* maxDistances, int anyHit, BvhHit* hits, uint8_t* occluded, int start, int end)
+{
+	IntersectPackets<float4, int4>(nodes, primitiveIndices, leaves, rays, maxDistances, anyHit, hits, occluded, start, end);
+}
+
+#ifdef NP_CPU_X86
+template<typename TLeaves>
+NP_TARGET_AVX2 static void IntersectPacketsAvx2(const BvhNode* nodes, const uint32_t* primitiveIndices, const TLeaves* leaves, const Ray* rays, const float* maxDistances, int anyHit, BvhHit* hits, uint8_t* occluded, int start, int end)
+{
+	IntersectPackets<float8, int8>(nodes, primitiveIndices, leaves, rays, maxDistances, anyHit, hits, occluded, start, end);
+}
+#endif
+
+static const npCpuVariant IntersectTrianglePacketsVariants[] =
+{
+#ifdef NP_CPU_X86
+	{ NP_CPU_TARGET_AVX2, (void*)IntersectPacketsAvx2<TriangleLeaves> },
+#endif
+	{ 0, (void*)IntersectPacketsDefault<TriangleLeaves> },
+};
+
+static const npCpuVariant IntersectBoxPacketsVariants[] =
+{
+#ifdef NP_CPU_X86
+	{ NP_CPU_TARGET_AVX2, (void*)IntersectPacketsAvx2<BoxLeaves> },
+#endif
+	{ 0, (void*)IntersectPacketsDefault<BoxLeaves> },
+};
+
+static npCpuSlot IntersectTrianglePacketsSlot;
+static npCpuSlot IntersectBoxPacketsSlot;
+
+template<typename TLeaves>
+static void DispatchIntersectPackets(npCpuSlot* slot, const npCpuVariant* variants, int variantCount, const BvhNode* nodes, const uint32_t* primitiveIndices, const TLeaves* leaves, const Ray* rays, const float* maxDistances, int anyHit, BvhHit* hits, uint8_t* occluded, int start, int end)
+{
+	typedef void (*IntersectPacketsDelegate)(const BvhNode* nodes, const uint32_t* primitiveIndices, const TLeaves* leaves, const Ray* rays, const float* maxDistances, int anyHit, BvhHit* hits, uint8_t* occluded, int start, int end);
+	IntersectPacketsDelegate intersectPackets = (IntersectPacketsDelegate)npCpuDispatch(slot, variants, variantCount);
+	intersectPackets(nodes, primitiveIndices, leaves, rays, maxDistances, anyHit, hits, occluded, start, end);
+}
+
+#define BVH_VARIANT_COUNT(variants) ((int)(sizeof(variants) / sizeof(variants[0])))
+
+extern "C" {
+	typedef struct BvhBin
+	{
+		float4 Minimum;
+		float4 Maximum;
+		int Count;
+	} BvhBin;
+
+	typedef struct BvhBuildContext
+	{
+		const BoundingBox* Bounds;
+		BvhNode* Nodes;
+		uint32_t* PrimitiveIndices;
+		BvhBuildTask* Tasks;
+		int TaskCount;
+		int MaxTasks;
+		uint32_t TaskThreshold;
+	} BvhBuildContext;
+
+	static inline float HalfArea(float4 minimum, float4 maximum)
+	{
+		float4 size = maximum - minimum;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	static inline float4 LoadMinimum(const BoundingBox* box)
+	{
+		return float4{ box->minimum.X, box->minimum.Y, box->minimum.Z, 0.0f };
+	}
+
+	static inline float4 LoadMaximum(const BoundingBox* box)
+	{
+		return float4{ box->maximum.X, box->maximum.Y, box->maximum.Z, 0.0f };
+	}
+
+	static inline int BinIndex(float centroid, float minimum, float scale)
+	{
+		int bin = (int)((centroid - minimum) * scale);
+		return bin < 0 ? 0 : (bin >= BVH_BIN_COUNT ? BVH_BIN_COUNT - 1 : bin);
+	}
+
+	static void BuildNode(BvhBuildContext* context, BvhBuildTask task, int depth)
+	{
+		// Large enough subtrees are left to xnBvhBuildTasks
+		if (context->Tasks && task.Count <= context->TaskThreshold && context->TaskCount < context->MaxTasks)
+		{
+			context->Tasks[context->TaskCount++] = task;
+			return;
+		}
+
+		BvhNode* node = &context->Nodes[task.NodeIndex];
+		uint32_t* primitives = &context->PrimitiveIndices[task.First];
+
+		float4 minimum = __builtin_inff();
+		float4 maximum = -__builtin_inff();
+		float4 centroidMinimum = __builtin_inff();
+		float4 centroidMaximum = -__builtin_inff();
+		for (uint32_t i = 0; i < task.Count; i++)
+		{
+			const BoundingBox* box = &context->Bounds[primitives[i]];
+			float4 boxMinimum = LoadMinimum(box);
+			float4 boxMaximum = LoadMaximum(box);
+			float4 centroid = boxMinimum + boxMaximum;
+			minimum = npMinF4(minimum, boxMinimum);
+			maximum = npMaxF4(maximum, boxMaximum);
+			centroidMinimum = npMinF4(centroidMinimum, centroid);
+			centroidMaximum = npMaxF4(centroidMaximum, centroid);
+		}
+		node->Minimum.X = minimum.x;
+		node->Minimum.Y = minimum.y;
+		node->Minimum.Z = minimum.z;
+		node->Maximum.X = maximum.x;
+		node->Maximum.Y = maximum.y;
+		node->Maximum.Z = maximum.z;
+
+		float4 centroidExtent = centroidMaximum - centroidMinimum;
+		int bestAxis = -1;
+		int bestBin = 0;
+		float bestCost = __builtin_inff();
+
+		if (task.Count > 1 && depth < BVH_MEDIAN_SPLIT_DEPTH)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (!(centroidExtent[axis] > 0.0f))
+					continue;
+
+				BvhBin bins[BVH_BIN_COUNT];
+				for (int b = 0; b < BVH_BIN_COUNT; b++)
+				{
+					bins[b].Minimum = __builtin_inff();
+					bins[b].Maximum = -__builtin_inff();
+					bins[b].Count = 0;
+				}
+
+				float scale = BVH_BIN_COUNT / centroidExtent[axis];
+				for (uint32_t i = 0; i < task.Count; i++)
+				{
+					const BoundingBox* box = &context->Bounds[primitives[i]];
+					float4 boxMinimum = LoadMinimum(box);
+					float4 boxMaximum = LoadMaximum(box);
+					BvhBin* bin = &bins[BinIndex(boxMinimum[axis] + boxMaximum[axis], centroidMinimum[axis], scale)];
+					bin->Minimum = npMinF4(bin->Minimum, boxMinimum);
+					bin->Maximum = npMaxF4(bin->Maximum, boxMaximum);
+					bin->Count++;
+				}
+
+				// Sweep from the right to get the cost of every right side, then from the left
+				float rightCosts[BVH_BIN_COUNT];
+				float4 sweepMinimum = __builtin_inff();
+				float4 sweepMaximum = -__builtin_inff();
+				int sweepCount = 0;
+				for (int b = BVH_BIN_COUNT - 1; b > 0; b--)
+				{
+					sweepMinimum = npMinF4(sweepMinimum, bins[b].Minimum);
+					sweepMaximum = npMaxF4(sweepMaximum, bins[b].Maximum);
+					sweepCount += bins[b].Count;
+					rightCosts[b] = sweepCount > 0 ? HalfArea(sweepMinimum, sweepMaximum) * sweepCount : __builtin_inff();
+				}
+
+				sweepMinimum = __builtin_inff();
+				sweepMaximum = -__builtin_inff();
+				sweepCount = 0;
+				for (int b = 0; b < BVH_BIN_COUNT - 1; b++)
+				{
+					sweepMinimum = npMinF4(sweepMinimum, bins[b].Minimum);
+					sweepMaximum = npMaxF4(sweepMaximum, bins[b].Maximum);
+					sweepCount += bins[b].Count;
+					if (sweepCount == 0)
+						continue;
+
+					float cost = HalfArea(sweepMinimum, sweepMaximum) * sweepCount + rightCosts[b + 1];
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestBin = b;
+					}
+				}
+			}
+		}
+
+		// Same costs for traversal and primitive tests, relative to the node area
+		float area = HalfArea(minimum, maximum);
+		int makeLeaf = task.Count == 1;
+		if (task.Count <= BVH_MAX_LEAF_SIZE)
+			makeLeaf |= bestAxis < 0 || (float)task.Count * area <= area + bestCost;
+
+		if (makeLeaf)
+		{
+			node->LeftOrFirst = task.First;
+			node->Count = task.Count;
+			return;
+		}
+
+		uint32_t leftCount = task.Count / 2;
+		if (bestAxis >= 0)
+		{
+			float scale = BVH_BIN_COUNT / centroidExtent[bestAxis];
+			int i = 0;
+			int j = (int)task.Count - 1;
+			while (i <= j)
+			{
+				const BoundingBox* box = &context->Bounds[primitives[i]];
+				float centroid = LoadMinimum(box)[bestAxis] + LoadMaximum(box)[bestAxis];
+				if (BinIndex(centroid, centroidMinimum[bestAxis], scale) <= bestBin)
+				{
+					i++;
+				}
+				else
+				{
+					uint32_t swap = primitives[i];
+					primitives[i] = primitives[j];
+					primitives[j--] = swap;
+				}
+			}
+
+			if (i > 0 && i < (int)task.Count)
+				leftCount = (uint32_t)i;
+		}
+
+		// Children take the first two owned slots, then each one owns 2n - 2 slots for its own descendants
+		node->LeftOrFirst = task.DescendantStart;
+		node->Count = 0;
+
+		BvhBuildTask left;
+		left.NodeIndex = task.DescendantStart;
+		left.DescendantStart = task.DescendantStart + 2;
+		left.First = task.First;
+		left.Count = leftCount;
+
+		BvhBuildTask right;
+		right.NodeIndex = task.DescendantStart + 1;
+		right.DescendantStart = left.DescendantStart + 2 * leftCount - 2;
+		right.First = task.First + leftCount;
+		right.Count = task.Count - leftCount;
+
+		BuildNode(context, left, depth + 1);
+		BuildNode(context, right, depth + 1);
+	}
+
+	/*
+	* Computes the bounds of triangleCount triangles, to build a BVH over them.
+	*/
+	DLL_EXPORT_API void xnBvhComputeTriangleBounds(const void* positions, int positionStride, const uint32_t* indices, int triangleCount, BoundingBox* bounds)
+	{
+		const uint8_t* positionData = (const uint8_t*)positions;
+		for (int t = 0; t < triangleCount; t++)
+		{
+			const Vector3* p0 = (const Vector3*)(positionData + (size_t)indices[t * 3 + 0] * positionStride);
+			const Vector3* p1 = (const Vector3*)(positionData + (size_t)indices[t * 3 + 1] * positionStride);
+			const Vector3* p2 = (const Vector3*)(positionData + (size_t)indices[t * 3 + 2] * positionStride);
+			bounds[t].minimum.X = fminf(p0->X, fminf(p1->X, p2->X));
+			bounds[t].minimum.Y = fminf(p0->Y, fminf(p1->Y, p2->Y));
+			bounds[t].minimum.Z = fminf(p0->Z, fminf(p1->Z, p2->Z));
+			bounds[t].maximum.X = fmaxf(p0->X, fmaxf(p1->X, p2->X));
+			bounds[t].maximum.Y = fmaxf(p0->Y, fmaxf(p1->Y, p2->Y));
+			bounds[t].maximum.Z = fmaxf(p0->Z, fmaxf(p1->Z, p2->Z));
+		}
+	}
+
+	/*
+	* Builds the top of the hierarchy and returns up to maxTasks independent subtrees, to be built in parallel with xnBvhBuildTasks.
+	* nodes needs 2 * count - 1 entries, primitiveIndices count entries.
+	*/
+	DLL_EXPORT_API int xnBvhBuildTopLevel(const BoundingBox* bounds, int count, BvhNode* nodes, uint32_t* primitiveIndices, BvhBuildTask* tasks, int maxTasks)
+	{
+		NP_TRACE_SCOPE("xnBvhBuildTopLevel");
+
+		if (count <= 0)
+			return 0;
+
+		for (int i = 0; i < count; i++)
+			primitiveIndices[i] = i;
+
+		BvhBuildContext context;
+		context.Bounds = bounds;
+		context.Nodes = nodes;
+		context.PrimitiveIndices = primitiveIndices;
+		context.Tasks = maxTasks > 0 ? tasks : NULL;
+		context.TaskCount = 0;
+		context.MaxTasks = maxTasks;
+		context.TaskThreshold = maxTasks > 0 ? (uint32_t)(count / maxTasks) : 0;
+		// Not worth a task below that
+		if (context.TaskThreshold < 1024)
+			context.TaskThreshold = 1024;
+
+		BvhBuildTask root;
+		root.NodeIndex = 0;
+		root.DescendantStart = 1;
+		root.First = 0;
+		root.Count = count;
+		BuildNode(&context, root, 0);
+
+		return context.TaskCount;
+	}
+
+	/*
+	* Builds the subtrees returned by xnBvhBuildTopLevel. Tasks don't overlap and can run concurrently.
+	*/
+	DLL_EXPORT_API void xnBvhBuildTasks(const BoundingBox* bounds, BvhNode* nodes, uint32_t* primitiveIndices, const BvhBuildTask* tasks, int start, int end)
+	{
+		NP_TRACE_SCOPE("xnBvhBuildTasks");
+
+		BvhBuildContext context;
+		context.Bounds = bounds;
+		context.Nodes = nodes;
+		context.PrimitiveIndices = primitiveIndices;
+		context.Tasks = NULL;
+		context.TaskCount = 0;
+		context.MaxTasks = 0;
+		context.TaskThreshold = 0;
+
+		// Depth only matters for the median split fallback, the top level is a few levels deep at most
+		for (int i = start; i < end; i++)
+			BuildNode(&context, tasks[i], 0);
+	}
+
+	/*
+	* Builds the whole hierarchy on the calling thread. Returns the number of node slots used (2 * count - 1).
+	*/
+	DLL_EXPORT_API int xnBvhBuild(const BoundingBox* bounds, int count, BvhNode* nodes, uint32_t* primitiveIndices)
+	{
+		xnBvhBuildTopLevel(bounds, count, nodes, primitiveIndices, NULL, 0);
+		return count > 0 ? 2 * count - 1 : 0;
+	}
+
+	/*
+	* Finds the closest triangle hit by each ray, within maxDistances (optional, infinite by default).
+	* Misses get PrimitiveIndex 0xffffffff. U and V are the barycentric coordinates of the hit relative to the second and third vertices.
+	*/
+	DLL_EXPORT_API void xnBvhIntersectRaysRange(const BvhNode* nodes, const uint32_t* primitiveIndices, const void* positions, int positionStride, const uint32_t* indices, const Ray* rays, const float* maxDistances, BvhHit* hits, int start, int end)
+	{
+		TriangleLeaves leaves;
+		leaves.Positions = (const uint8_t*)positions;
+		leaves.PositionStride = positionStride;
+		leaves.Indices = indices;
+		DispatchIntersectPackets(&IntersectTrianglePacketsSlot, IntersectTrianglePacketsVariants, BVH_VARIANT_COUNT(IntersectTrianglePacketsVariants),
+			nodes, primitiveIndices, &leaves, rays, maxDistances, 0, hits, NULL, start, end);
+	}
+
+	/*
+	* Single ray version of xnBvhIntersectRaysRange, for picking. Returns whether a triangle was hit.
+	*/
+	DLL_EXPORT_API int xnBvhIntersectRay(const BvhNode* nodes, const uint32_t* primitiveIndices, const void* positions, int positionStride, const uint32_t* indices, const Ray* ray, float maxDistance, BvhHit* hit)
+	{
+		TriangleLeaves leaves;
+		leaves.Positions = (const uint8_t*)positions;
+		leaves.PositionStride = positionStride;
+		leaves.Indices = indices;
+		IntersectPacket<float4, int4>(nodes, primitiveIndices, leaves, ray, &maxDistance, 1, 0, hit, NULL);
+		return hit->PrimitiveIndex != 0xffffffff;
+	}
+
+	/*
+	* Sets occluded[i] to 1 when any triangle is hit within maxDistances (optional, infinite by default), for line of sight tests.
+	*/
+	DLL_EXPORT_API void xnBvhOccludedRaysRange(const BvhNode* nodes, const uint32_t* primitiveIndices, const void* positions, int positionStride, const uint32_t* indices, const Ray* rays, const float* maxDistances, uint8_t* occluded, int start, int end)
+	{
+		TriangleLeaves leaves;
+		leaves.Positions = (const uint8_t*)positions;
+		leaves.PositionStride = positionStride;
+		leaves.Indices = indices;
+		DispatchIntersectPackets(&IntersectTrianglePacketsSlot, IntersectTrianglePacketsVariants, BVH_VARIANT_COUNT(IntersectTrianglePacketsVariants),
+			nodes, primitiveIndices, &leaves, rays, maxDistances, 1, NULL, occluded, start, end);
+	}
+
+	/*
+	* Finds the closest BoundingBox leaf hit by each ray, for hierarchies built directly over object bounds.
+	*/
+	DLL_EXPORT_API void xnBvhIntersectBoxesRange(const BvhNode* nodes, const uint32_t* primitiveIndices, const BoundingBox* bounds, const Ray* rays, const float* maxDistances, BvhHit* hits, int start, int end)
+	{
+		BoxLeaves leaves;
+		leaves.Bounds = bounds;
+		DispatchIntersectPackets(&IntersectBoxPacketsSlot, IntersectBoxPacketsVariants, BVH_VARIANT_COUNT(IntersectBoxPacketsVariants),
+			nodes, primitiveIndices, &leaves, rays, maxDistances, 0, hits, NULL, start, end);
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#define NATIVEPATH_CPU_IMPLEMENTATION
+#include "../../../deps/NativePath/NativeCpu.h"
+#include "StrideNative.h"
+
+/*
+* CPU features used by libstride to pick the instruction set of its kernels.
+*/
+
+extern "C" {
+	/*
+	* NP_CPU_* flags supported by the CPU and the OS.
+	*/
+	DLL_EXPORT_API uint32_t xnCpuFeatures()
+	{
+		return npCpuFeatures();
+	}
+
+	/*
+	* Makes kernels ignore the given features (replacing the previous ones, 0 enables everything again) from their next call.
+	*/
+	DLL_EXPORT_API void xnCpuDisableFeatures(uint32_t features)
+	{
+		npCpuDisableFeatures(features);
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeCpu.h"
+#include "StrideNative.h"
+
+extern "C" {
+	// 8 boxes per iteration: a single AVX register in the AVX2 variant, two SSE/NEON registers otherwise
+	typedef float float8 __attribute__((ext_vector_type(8)));
+	typedef int32_t int8 __attribute__((ext_vector_type(8)));
+
+	// Returned through a pointer since passing 8-wide vectors by value changes the ABI depending on AVX support
+	NP_CPU_INLINE void LoadFloat8(float8* result, const float* values, int count)
+	{
+		if (count == 8)
+		{
+			memcpy(result, values, sizeof(float8));
+		}
+		else
+		{
+			*result = 0.0f;
+			for (int i = 0; i < count; i++)
+				(*result)[i] = values[i];
+		}
+	}
+
+	// Returns one bit per box, set when the box is at least partially inside all the planes
+	NP_CPU_INLINE uint8_t CullBoxes8(const Plane* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, int count)
+	{
+		float8 cx, cy, cz, ex, ey, ez;
+		LoadFloat8(&cx, centerX, count);
+		LoadFloat8(&cy, centerY, count);
+		LoadFloat8(&cz, centerZ, count);
+		LoadFloat8(&ex, extentX, count);
+		LoadFloat8(&ey, extentY, count);
+		LoadFloat8(&ez, extentZ, count);
+
+		int8 visible = -1;
+		for (int i = 0; i < planeCount; i++)
+		{
+			// Same test as VisibilityGroup.FrustumContainsBox: culled when dot(center, n) + dot(extent, |n|) <= -d
+			const Plane* plane = &planes[i];
+			float8 distance = cx * plane->Normal.X + cy * plane->Normal.Y + cz * plane->Normal.Z
+				+ ex * fabsf(plane->Normal.X) + ey * fabsf(plane->Normal.Y) + ez * fabsf(plane->Normal.Z);
+			visible &= distance > -plane->D;
+		}
+
+		int8 bits = visible & int8{ 1, 2, 4, 8, 16, 32, 64, 128 };
+		int4 bits4 = bits.lo | bits.hi;
+		int2 bits2 = bits4.lo | bits4.hi;
+		return (uint8_t)((bits2.x | bits2.y) & ((1 << count) - 1));
+	}
+
+	NP_CPU_INLINE void CullBoxesRange(const Plane* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, uint8_t* visibilityMask, int start, int end)
+	{
+		for (int i = start; i < end; i += 8)
+		{
+			visibilityMask[i >> 3] = CullBoxes8(planes, planeCount, centerX + i, centerY + i, centerZ + i, extentX + i, extentY + i, extentZ + i, end - i < 8 ? end - i : 8);
+		}
+	}
+
+	typedef void (*CullBoxesRangeDelegate)(const Plane* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, uint8_t* visibilityMask, int start, int end);
+
+	static void CullBoxesRangeDefault(const Plane* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, uint8_t* visibilityMask, int start, int end)
+	{
+		CullBoxesRange(planes, planeCount, centerX, centerY, centerZ, extentX, extentY, extentZ, visibilityMask, start, end);
+	}
+
+#ifdef NP_CPU_X86
+	NP_TARGET_AVX2 static void CullBoxesRangeAvx2(const Plane* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, uint8_t* visibilityMask, int start, int end)
+	{
+		CullBoxesRange(planes, planeCount, centerX, centerY, centerZ, extentX, extentY, extentZ, visibilityMask, start, end);
+	}
+#endif
+
+	static const npCpuVariant CullBoxesRangeVariants[] =
+	{
+#ifdef NP_CPU_X86
+		{ NP_CPU_TARGET_AVX2, (void*)CullBoxesRangeAvx2 },
+#endif
+		{ 0, (void*)CullBoxesRangeDefault },
+	};
+
+	static npCpuSlot CullBoxesRangeSlot;
+
+	/*
+	* Tests boxes [start, end) against planeCount planes (6 for a full frustum, 4 to ignore near/far planes).
+	* Boxes are given as SoA center/extent arrays. Bit (i & 7) of visibilityMask[i >> 3] is set when box i is visible.
+	* start must be a multiple of 8 so that concurrent ranges never write to the same mask byte.
+	*/
+	DLL_EXPORT_API void xnFrustumCullBoxesRange(const Plane* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, uint8_t* visibilityMask, int start, int end)
+	{
+		CullBoxesRangeDelegate cullBoxesRange = (CullBoxesRangeDelegate)npCpuDispatch(&CullBoxesRangeSlot, CullBoxesRangeVariants, sizeof(CullBoxesRangeVariants) / sizeof(CullBoxesRangeVariants[0]));
+		cullBoxesRange(planes, planeCount, centerX, centerY, centerZ, extentX, extentY, extentZ, visibilityMask, start, end);
+	}
+}
@@ -0,0 +1,487 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeFloat4.h"
+#include "StrideNative.h"
+
+/*
+* Heightfield queries. Heights are a width * length grid of floats (row major, heights[z * width + x]), and the grid has
+* (width - 1) * (length - 1) cells. Each cell is the bilinear patch between its 4 height sticks.
+* The min/max pyramid stores the height range (X = min, Y = max) of every cell at level 0, then of every 2x2 block of the
+* previous level, up to a single node. Queries take positions in the heightfield local space: origin is the local position
+* of the first height stick at a height of 0 (for Bullet heightfields: -(width - 1) / 2, -(minHeight + maxHeight) / 2, -(length - 1) / 2).
+*/
+
+extern "C" {
+	#define HEIGHTFIELD_MAX_LEVELS 32
+
+	// HeightfieldTypes
+	#define HEIGHTFIELD_TYPE_BYTE 1
+	#define HEIGHTFIELD_TYPE_SHORT 2
+	#define HEIGHTFIELD_TYPE_FLOAT 4
+
+	typedef struct HeightfieldLevels
+	{
+		int Count;
+		int Width[HEIGHTFIELD_MAX_LEVELS];
+		int Length[HEIGHTFIELD_MAX_LEVELS];
+		int Offset[HEIGHTFIELD_MAX_LEVELS];
+		int Size;
+	} HeightfieldLevels;
+
+	static void GetHeightfieldLevels(int width, int length, HeightfieldLevels* levels)
+	{
+		int levelWidth = width - 1 > 1 ? width - 1 : 1;
+		int levelLength = length - 1 > 1 ? length - 1 : 1;
+		int offset = 0;
+		int level = 0;
+		for (;;)
+		{
+			levels->Width[level] = levelWidth;
+			levels->Length[level] = levelLength;
+			levels->Offset[level] = offset;
+			offset += levelWidth * levelLength;
+			level++;
+			if ((levelWidth == 1 && levelLength == 1) || level == HEIGHTFIELD_MAX_LEVELS)
+				break;
+			levelWidth = (levelWidth + 1) >> 1;
+			levelLength = (levelLength + 1) >> 1;
+		}
+		levels->Count = level;
+		levels->Size = offset;
+	}
+
+	static inline float Clamp(float value, float minimum, float maximum)
+	{
+		return value < minimum ? minimum : (value > maximum ? maximum : value);
+	}
+
+	// Slopes of the bilinear patch at (u, v), and the matching unit normal
+	static inline Vector3 PatchNormal(float h00, float h10, float h01, float h11, float u, float v)
+	{
+		float slopeX = (h10 - h00) * (1.0f - v) + (h11 - h01) * v;
+		float slopeZ = (h01 - h00) * (1.0f - u) + (h11 - h10) * u;
+		float inverseLength = 1.0f / sqrtf(slopeX * slopeX + 1.0f + slopeZ * slopeZ);
+		Vector3 normal = { -slopeX * inverseLength, inverseLength, -slopeZ * inverseLength };
+		return normal;
+	}
+
+	/*
+	* Converts height sticks to float heights (bytes and shorts are multiplied by heightScale, like Bullet does).
+	*/
+	DLL_EXPORT_API void xnHeightfieldConvertHeights(const void* source, int heightType, float heightScale, float* heights, int count)
+	{
+		switch (heightType)
+		{
+		case HEIGHTFIELD_TYPE_BYTE:
+			for (int i = 0; i < count; i++)
+				heights[i] = ((const uint8_t*)source)[i] * heightScale;
+			break;
+		case HEIGHTFIELD_TYPE_SHORT:
+			for (int i = 0; i < count; i++)
+				heights[i] = ((const int16_t*)source)[i] * heightScale;
+			break;
+		default:
+			memcpy(heights, source, sizeof(float) * count);
+			break;
+		}
+	}
+
+	/*
+	* Returns the number of Vector2 entries of the min/max pyramid of a width * length heightfield.
+	*/
+	DLL_EXPORT_API int xnHeightfieldPyramidSize(int width, int length)
+	{
+		HeightfieldLevels levels;
+		GetHeightfieldLevels(width, length, &levels);
+		return levels.Size;
+	}
+
+	/*
+	* Recomputes the pyramid nodes covering the cells in [startX, endX) * [startZ, endZ), after heights were modified.
+	* The cells touching a modified height stick (x, z) are [x - 1, x + 1) * [z - 1, z + 1).
+	*/
+	DLL_EXPORT_API void xnHeightfieldUpdatePyramid(const float* heights, int width, int length, Vector2* pyramid, int startX, int startZ, int endX, int endZ)
+	{
+		HeightfieldLevels levels;
+		GetHeightfieldLevels(width, length, &levels);
+
+		startX = startX > 0 ? startX : 0;
+		startZ = startZ > 0 ? startZ : 0;
+		endX = endX < levels.Width[0] ? endX : levels.Width[0];
+		endZ = endZ < levels.Length[0] ? endZ : levels.Length[0];
+
+		for (int z = startZ; z < endZ; z++)
+		{
+			const float* row = heights + (size_t)z * width;
+			Vector2* node = pyramid + z * levels.Width[0];
+			for (int x = startX; x < endX; x++)
+			{
+				float h00 = row[x], h10 = row[x + 1], h01 = row[x + width], h11 = row[x + width + 1];
+				node[x].X = fminf(fminf(h00, h10), fminf(h01, h11));
+				node[x].Y = fmaxf(fmaxf(h00, h10), fmaxf(h01, h11));
+			}
+		}
+
+		for (int level = 1; level < levels.Count; level++)
+		{
+			startX >>= 1;
+			startZ >>= 1;
+			endX = (endX + 1) >> 1;
+			endZ = (endZ + 1) >> 1;
+
+			const Vector2* children = pyramid + levels.Offset[level - 1];
+			int childWidth = levels.Width[level - 1];
+			int childLength = levels.Length[level - 1];
+			Vector2* nodes = pyramid + levels.Offset[level];
+			for (int z = startZ; z < endZ; z++)
+			{
+				for (int x = startX; x < endX; x++)
+				{
+					Vector2 range = children[(2 * z) * childWidth + 2 * x];
+					for (int child = 1; child < 4; child++)
+					{
+						int childX = 2 * x + (child & 1);
+						int childZ = 2 * z + (child >> 1);
+						if (childX >= childWidth || childZ >= childLength)
+							continue;
+						Vector2 childRange = children[childZ * childWidth + childX];
+						range.X = fminf(range.X, childRange.X);
+						range.Y = fmaxf(range.Y, childRange.Y);
+					}
+					nodes[z * levels.Width[level] + x] = range;
+				}
+			}
+		}
+	}
+
+	DLL_EXPORT_API void xnHeightfieldBuildPyramid(const float* heights, int width, int length, Vector2* pyramid)
+	{
+		xnHeightfieldUpdatePyramid(heights, width, length, pyramid, 0, 0, width - 1, length - 1);
+	}
+
+	/*
+	* Gets the min/max height of the cells in [startX, endX) * [startZ, endZ) from the pyramid, e.g. to place objects on a footprint.
+	* An empty region gives a range of (FLT_MAX, -FLT_MAX).
+	*/
+	DLL_EXPORT_API void xnHeightfieldGetRegionRange(const Vector2* pyramid, int width, int length, int startX, int startZ, int endX, int endZ, Vector2* result)
+	{
+		HeightfieldLevels levels;
+		GetHeightfieldLevels(width, length, &levels);
+
+		startX = startX > 0 ? startX : 0;
+		startZ = startZ > 0 ? startZ : 0;
+		endX = endX < levels.Width[0] ? endX : levels.Width[0];
+		endZ = endZ < levels.Length[0] ? endZ : levels.Length[0];
+
+		Vector2 range = { __FLT_MAX__, -__FLT_MAX__ };
+		*result = range;
+		if (startX >= endX || startZ >= endZ)
+			return;
+
+		// Finest level where the region spans at most 2x2 nodes, nodes only partly inside are refined at finer levels
+		int level = 0;
+		while (level + 1 < levels.Count && (((endX - 1) >> level) - (startX >> level) > 1 || ((endZ - 1) >> level) - (startZ >> level) > 1))
+			level++;
+
+		struct Node { int Level, X, Z; } stack[4 * HEIGHTFIELD_MAX_LEVELS + 4];
+		int stackSize = 0;
+		for (int z = startZ >> level; z <= (endZ - 1) >> level; z++)
+		{
+			for (int x = startX >> level; x <= (endX - 1) >> level; x++)
+			{
+				stack[stackSize].Level = level;
+				stack[stackSize].X = x;
+				stack[stackSize].Z = z;
+				stackSize++;
+			}
+		}
+
+		while (stackSize > 0)
+		{
+			Node node = stack[--stackSize];
+			int cellStartX = node.X << node.Level, cellEndX = (node.X + 1) << node.Level;
+			int cellStartZ = node.Z << node.Level, cellEndZ = (node.Z + 1) << node.Level;
+			if (cellStartX >= endX || cellEndX <= startX || cellStartZ >= endZ || cellEndZ <= startZ)
+				continue;
+
+			if (node.Level == 0 || (cellStartX >= startX && cellEndX <= endX && cellStartZ >= startZ && cellEndZ <= endZ))
+			{
+				Vector2 nodeRange = pyramid[levels.Offset[node.Level] + node.Z * levels.Width[node.Level] + node.X];
+				range.X = fminf(range.X, nodeRange.X);
+				range.Y = fmaxf(range.Y, nodeRange.Y);
+				continue;
+			}
+
+			for (int child = 0; child < 4; child++)
+			{
+				int childX = 2 * node.X + (child & 1);
+				int childZ = 2 * node.Z + (child >> 1);
+				if (childX < levels.Width[node.Level - 1] && childZ < levels.Length[node.Level - 1])
+				{
+					stack[stackSize].Level = node.Level - 1;
+					stack[stackSize].X = childX;
+					stack[stackSize].Z = childZ;
+					stackSize++;
+				}
+			}
+		}
+
+		*result = range;
+	}
+
+	/*
+	* Samples the bilinear height (and optionally the normal) at local XZ positions, 4 positions at a time.
+	* Positions outside of the heightfield are clamped to its border.
+	*/
+	DLL_EXPORT_API void xnHeightfieldGetHeightsRange(const float* heights, int width, int length, const Vector3* origin, const Vector2* positions, float* outHeights, Vector3* outNormals, int start, int end)
+	{
+		const float maximumX = (float)(width - 1), maximumZ = (float)(length - 1);
+		const int lastCellX = width - 2, lastCellZ = length - 2;
+
+		for (int i = start; i < end; i += 4)
+		{
+			int count = end - i < 4 ? end - i : 4;
+
+			// Unused lanes replicate the first position
+			float4 x, z;
+			for (int lane = 0; lane < 4; lane++)
+			{
+				const Vector2* position = positions + i + (lane < count ? lane : 0);
+				x[lane] = position->X;
+				z[lane] = position->Y;
+			}
+
+			x = npClampF4(x - origin->X, 0.0f, maximumX);
+			z = npClampF4(z - origin->Z, 0.0f, maximumZ);
+
+			int4 cellX = __builtin_convertvector(x, int4);
+			int4 cellZ = __builtin_convertvector(z, int4);
+			cellX = cellX > lastCellX ? lastCellX : cellX;
+			cellZ = cellZ > lastCellZ ? lastCellZ : cellZ;
+			float4 u = x - __builtin_convertvector(cellX, float4);
+			float4 v = z - __builtin_convertvector(cellZ, float4);
+
+			float4 h00, h10, h01, h11;
+			for (int lane = 0; lane < 4; lane++)
+			{
+				const float* corner = heights + (size_t)cellZ[lane] * width + cellX[lane];
+				h00[lane] = corner[0];
+				h10[lane] = corner[1];
+				h01[lane] = corner[width];
+				h11[lane] = corner[width + 1];
+			}
+
+			float4 bottom = h00 + (h10 - h00) * u;
+			float4 top = h01 + (h11 - h01) * u;
+			float4 height = bottom + (top - bottom) * v + origin->Y;
+
+			for (int lane = 0; lane < count; lane++)
+				outHeights[i + lane] = height[lane];
+
+			if (outNormals)
+			{
+				float4 slopeX = (h10 - h00) * (1.0f - v) + (h11 - h01) * v;
+				float4 slopeZ = top - bottom;
+				float4 squaredLength = slopeX * slopeX + 1.0f + slopeZ * slopeZ;
+				for (int lane = 0; lane < count; lane++)
+				{
+					float inverseLength = 1.0f / sqrtf(squaredLength[lane]);
+					outNormals[i + lane].X = -slopeX[lane] * inverseLength;
+					outNormals[i + lane].Y = inverseLength;
+					outNormals[i + lane].Z = -slopeZ[lane] * inverseLength;
+				}
+			}
+		}
+	}
+
+	DLL_EXPORT_API void xnHeightfieldGetHeights(const float* heights, int width, int length, const Vector3* origin, const Vector2* positions, float* outHeights, Vector3* outNormals, int count)
+	{
+		xnHeightfieldGetHeightsRange(heights, width, length, origin, positions, outHeights, outNormals, 0, count);
+	}
+
+	// Smallest t in [0, length] where the ray crosses the cell patch, starting from the point where it enters the cell
+	static inline int IntersectPatch(float h00, float h10, float h01, float h11, float u0, float y0, float v0, const Vector3& direction, float length, float* t)
+	{
+		float a = h10 - h00;
+		float b = h01 - h00;
+		float c = h00 - h10 - h01 + h11;
+
+		// height(u0 + t * dx, v0 + t * dz) - (y0 + t * dy) = qa * t^2 + qb * t + qc
+		float qa = c * direction.X * direction.Z;
+		float qb = a * direction.X + b * direction.Z + c * (u0 * direction.Z + v0 * direction.X) - direction.Y;
+		float qc = h00 + a * u0 + b * v0 + c * u0 * v0 - y0;
+
+		if (qc == 0.0f)
+		{
+			*t = 0.0f;
+			return 1;
+		}
+
+		float root;
+		if (fabsf(qa) < 1e-7f)
+		{
+			if (qb == 0.0f)
+				return 0;
+			root = -qc / qb;
+			if (root < 0.0f || root > length)
+				return 0;
+		}
+		else
+		{
+			float discriminant = qb * qb - 4.0f * qa * qc;
+			if (discriminant < 0.0f)
+				return 0;
+
+			// Numerically stable roots
+			float q = -0.5f * (qb + (qb >= 0.0f ? sqrtf(discriminant) : -sqrtf(discriminant)));
+			float root0 = q / qa;
+			float root1 = q != 0.0f ? qc / q : root0;
+			if (root0 > root1)
+			{
+				float swap = root0; root0 = root1; root1 = swap;
+			}
+
+			if (root0 >= 0.0f && root0 <= length)
+				root = root0;
+			else if (root1 >= 0.0f && root1 <= length)
+				root = root1;
+			else
+				return 0;
+		}
+
+		*t = root;
+		return 1;
+	}
+
+	// Ray entry and exit distances for a box, on the XZ slabs only and with the height range
+	static inline int IntersectNode(const Vector3& position, const Vector3& inverseDirection, float minX, float minY, float minZ, float maxX, float maxY, float maxZ, float maxDistance, float* enterXZ, float* exitXZ)
+	{
+		float tx0 = (minX - position.X) * inverseDirection.X, tx1 = (maxX - position.X) * inverseDirection.X;
+		float ty0 = (minY - position.Y) * inverseDirection.Y, ty1 = (maxY - position.Y) * inverseDirection.Y;
+		float tz0 = (minZ - position.Z) * inverseDirection.Z, tz1 = (maxZ - position.Z) * inverseDirection.Z;
+
+		// fminf/fmaxf drop the NaNs of rays lying in a slab plane
+		float enter = fmaxf(fminf(tx0, tx1), fminf(tz0, tz1));
+		float exit = fminf(fmaxf(tx0, tx1), fmaxf(tz0, tz1));
+		*enterXZ = enter;
+		*exitXZ = exit;
+
+		enter = fmaxf(fmaxf(enter, fminf(ty0, ty1)), 0.0f);
+		exit = fminf(fminf(exit, fmaxf(ty0, ty1)), maxDistance);
+		return enter <= exit;
+	}
+
+	static void RaycastHeightfield(const float* heights, int width, const Vector2* pyramid, const HeightfieldLevels& levels, const Vector3& origin, const Ray& ray, float maxDistance, HeightfieldHit* hit)
+	{
+		Vector3 position = { ray.Position.X - origin.X, ray.Position.Y - origin.Y, ray.Position.Z - origin.Z };
+		Vector3 inverseDirection = { 1.0f / ray.Direction.X, 1.0f / ray.Direction.Y, 1.0f / ray.Direction.Z };
+
+		hit->Distance = -1.0f;
+		hit->Cell = -1;
+
+		struct Node { int Level, X, Z; } stack[3 * HEIGHTFIELD_MAX_LEVELS + 4];
+		int stackSize = 0;
+		int top = levels.Count - 1;
+		stack[stackSize].Level = top;
+		stack[stackSize].X = 0;
+		stack[stackSize].Z = 0;
+		stackSize++;
+
+		// Children are visited in the order the ray enters their XZ footprint. Footprints don't overlap, so the first cell hit is the closest.
+		while (stackSize > 0)
+		{
+			Node node = stack[--stackSize];
+			Vector2 range = pyramid[levels.Offset[node.Level] + node.Z * levels.Width[node.Level] + node.X];
+			int cellStartX = node.X << node.Level, cellStartZ = node.Z << node.Level;
+			int cellEndX = (node.X + 1) << node.Level, cellEndZ = (node.Z + 1) << node.Level;
+			cellEndX = cellEndX < levels.Width[0] ? cellEndX : levels.Width[0];
+			cellEndZ = cellEndZ < levels.Length[0] ? cellEndZ : levels.Length[0];
+
+			float enterXZ, exitXZ;
+			if (!IntersectNode(position, inverseDirection, (float)cellStartX, range.X, (float)cellStartZ, (float)cellEndX, range.Y, (float)cellEndZ, maxDistance, &enterXZ, &exitXZ))
+				continue;
+
+			if (node.Level == 0)
+			{
+				float enter = fmaxf(enterXZ, 0.0f);
+				float exit = fminf(exitXZ, maxDistance);
+				float u0 = position.X + ray.Direction.X * enter - (float)node.X;
+				float y0 = position.Y + ray.Direction.Y * enter;
+				float v0 = position.Z + ray.Direction.Z * enter - (float)node.Z;
+
+				const float* corner = heights + (size_t)node.Z * width + node.X;
+				float h00 = corner[0], h10 = corner[1], h01 = corner[width], h11 = corner[width + 1];
+
+				float t;
+				if (IntersectPatch(h00, h10, h01, h11, u0, y0, v0, ray.Direction, exit - enter, &t))
+				{
+					float u = Clamp(u0 + ray.Direction.X * t, 0.0f, 1.0f);
+					float v = Clamp(v0 + ray.Direction.Z * t, 0.0f, 1.0f);
+					hit->Distance = enter + t;
+					hit->Position.X = ray.Position.X + ray.Direction.X * hit->Distance;
+					hit->Position.Y = ray.Position.Y + ray.Direction.Y * hit->Distance;
+					hit->Position.Z = ray.Position.Z + ray.Direction.Z * hit->Distance;
+					hit->Normal = PatchNormal(h00, h10, h01, h11, u, v);
+					hit->Cell = node.Z * levels.Width[0] + node.X;
+					return;
+				}
+				continue;
+			}
+
+			// Sort the children by XZ entry distance, then push the farthest first
+			Node children[4];
+			float childEnter[4];
+			int childCount = 0;
+			int childLevel = node.Level - 1;
+			for (int child = 0; child < 4; child++)
+			{
+				int childX = 2 * node.X + (child & 1);
+				int childZ = 2 * node.Z + (child >> 1);
+				if (childX >= levels.Width[childLevel] || childZ >= levels.Length[childLevel])
+					continue;
+
+				float minX = (float)(childX << childLevel), minZ = (float)(childZ << childLevel);
+				float maxX = (float)((childX + 1) << childLevel), maxZ = (float)((childZ + 1) << childLevel);
+				float tx0 = (minX - position.X) * inverseDirection.X, tx1 = (maxX - position.X) * inverseDirection.X;
+				float tz0 = (minZ - position.Z) * inverseDirection.Z, tz1 = (maxZ - position.Z) * inverseDirection.Z;
+				float enter = fmaxf(fminf(tx0, tx1), fminf(tz0, tz1));
+
+				int slot = childCount++;
+				while (slot > 0 && childEnter[slot - 1] < enter)
+				{
+					children[slot] = children[slot - 1];
+					childEnter[slot] = childEnter[slot - 1];
+					slot--;
+				}
+				children[slot].Level = childLevel;
+				children[slot].X = childX;
+				children[slot].Z = childZ;
+				childEnter[slot] = enter;
+			}
+
+			for (int child = 0; child < childCount; child++)
+				stack[stackSize++] = children[child];
+		}
+	}
+
+	/*
+	* Finds the closest point where each ray hits the heightfield surface within maxDistances (optional, infinite by default).
+	* Rays and hits are in local space; the ray direction doesn't need to be normalized (distances are then in direction units).
+	* Misses get a negative Distance and a Cell of -1.
+	*/
+	DLL_EXPORT_API void xnHeightfieldRaycastRange(const float* heights, int width, int length, const Vector2* pyramid, const Vector3* origin, const Ray* rays, const float* maxDistances, HeightfieldHit* hits, int start, int end)
+	{
+		HeightfieldLevels levels;
+		GetHeightfieldLevels(width, length, &levels);
+
+		for (int i = start; i < end; i++)
+			RaycastHeightfield(heights, width, pyramid, levels, *origin, rays[i], maxDistances ? maxDistances[i] : __FLT_MAX__, hits + i);
+	}
+
+	DLL_EXPORT_API void xnHeightfieldRaycast(const float* heights, int width, int length, const Vector2* pyramid, const Vector3* origin, const Ray* rays, const float* maxDistances, HeightfieldHit* hits, int count)
+	{
+		xnHeightfieldRaycastRange(heights, width, length, pyramid, origin, rays, maxDistances, hits, 0, count);
+	}
+}
@@ -0,0 +1,423 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeMemory.h"
+#include "../../../deps/NativePath/NativeFloat4.h"
+#include "StrideNative.h"
+
+/*
+* Clustered light assignment, same layout as LightClusteredPointSpotGroupRenderer: the view is split in ClusterSize pixels
+* tiles and ClusterSlices depth slices, slice z covering depths where log2(depth * DepthScale + DepthBias) is in [z, z + 1)
+* (slice 0 starting at the camera). Cluster (x, y, z) has index x + (y + z * ClusterCountY) * ClusterCountX.
+* Each cluster gets the indices of the point lights, then of the spot lights, touching it, stored as (start, pointCount | spotCount << 16).
+* Lights are view space spheres (and cones for spot lights), tested against the view space bounding box of each cluster.
+* The bounding box of a cluster is the product of per column, per row and per slice ranges, so the distance to a light is
+* computed once per slice and row, and each column is tested against 4 lights at a time.
+*/
+
+extern "C" {
+	typedef struct LightClusterSlice
+	{
+		int Slice;
+		float Near;
+		float Far;
+		float* ColumnMin;
+		float* ColumnMax;
+		float* RowMin;
+		float* RowMax;
+	} LightClusterSlice;
+
+	// Tiles covered by the screen space bounds of a light, the same for every slice
+	typedef struct LightClusterTiles
+	{
+		int StartX;
+		int EndX;
+		int StartY;
+		int EndY;
+	} LightClusterTiles;
+
+	// Lights touching a slice, as SoA arrays
+	typedef struct LightClusterSliceLights
+	{
+		int Count;
+		int PointCount;
+		int* Light;
+		float* CenterX;
+		float* CenterY;
+		float* Budget; // Squared radius minus the squared distance to the slice along Z
+		int* TileStartX;
+		int* TileEndX;
+		int* TileStartY;
+		int* TileEndY;
+	} LightClusterSliceLights;
+
+	// Lights touching a row of a slice, padded to a multiple of 4
+	typedef struct LightClusterRowLights
+	{
+		int Count;
+		int PointCount;
+		int* Light; // Index in the slice lights
+		float* CenterX;
+		float* Budget; // Squared radius minus the squared distance to the row along Y and Z
+		int* TileStartX;
+		int* TileEndX;
+	} LightClusterRowLights;
+
+	static inline float Max(float left, float right)
+	{
+		return left > right ? left : right;
+	}
+
+	static inline float Min(float left, float right)
+	{
+		return left < right ? left : right;
+	}
+
+	static inline int ClampInt(int value, int minimum, int maximum)
+	{
+		return value < minimum ? minimum : (value > maximum ? maximum : value);
+	}
+
+	// Distance from value to [minimum, maximum], 0 inside
+	static inline float RangeDistance(float value, float minimum, float maximum)
+	{
+		return Max(Max(minimum - value, value - maximum), 0.0f);
+	}
+
+	// Same as LightClusteredPointSpotGroupRenderer.UpdateClipRegionRoot
+	static inline void UpdateClipRegionRoot(float nc, float lc, float lz, float lightRadius, float cameraScale, float cameraOffset, float* clipMin, float* clipMax)
+	{
+		float nz = (lightRadius - nc * lc) / lz;
+		float pz = (lc * lc + lz * lz - lightRadius * lightRadius) / (lz - (nz / nc) * lc);
+		if (pz > 0.0f)
+		{
+			float c = -nz * cameraScale / nc - cameraOffset;
+			if (nc > 0.0f)
+				*clipMin = Max(*clipMin, c);
+			else
+				*clipMax = Min(*clipMax, c);
+		}
+	}
+
+	// Same as LightClusteredPointSpotGroupRenderer.UpdateClipRegion
+	static inline void UpdateClipRegion(float lc, float lz, float lightRadius, float cameraScale, float cameraOffset, float* clipMin, float* clipMax)
+	{
+		float rSq = lightRadius * lightRadius;
+		float lcSqPluslzSq = lc * lc + lz * lz;
+		float d = rSq * lc * lc - lcSqPluslzSq * (rSq - lz * lz);
+		if (d > 0.0f)
+		{
+			float a = lightRadius * lc;
+			float b = sqrtf(d);
+			UpdateClipRegionRoot((a + b) / lcSqPluslzSq, lc, lz, lightRadius, cameraScale, cameraOffset, clipMin, clipMax);
+			UpdateClipRegionRoot((a - b) / lcSqPluslzSq, lc, lz, lightRadius, cameraScale, cameraOffset, clipMin, clipMax);
+		}
+	}
+
+	// View space bounds of the columns and rows of a slice
+	static void ComputeSliceBounds(const LightClusterGrid* grid, LightClusterSlice* slice)
+	{
+		const FlatMatrix* projection = &grid->Projection.Flat;
+
+		// Slice 0 also covers the depths before the special near plane
+		slice->Near = slice->Slice == 0 ? 0.0f : ((float)(1 << slice->Slice) - grid->DepthBias) / grid->DepthScale;
+		slice->Far = ((float)(1 << (slice->Slice + 1)) - grid->DepthBias) / grid->DepthScale;
+
+		// Inverse of ndc = position * scale / depth - offset, over the depth range of the slice
+		float tileSizeX = 2.0f * grid->ClusterSize / grid->ViewSize.X;
+		for (int x = 0; x < grid->ClusterCountX; x++)
+		{
+			float left = (-1.0f + x * tileSizeX + projection->M31) / projection->M11;
+			float right = (-1.0f + (x + 1) * tileSizeX + projection->M31) / projection->M11;
+			slice->ColumnMin[x] = Min(left * slice->Near, left * slice->Far);
+			slice->ColumnMax[x] = Max(right * slice->Near, right * slice->Far);
+		}
+
+		float tileSizeY = 2.0f * grid->ClusterSize / grid->ViewSize.Y;
+		for (int y = 0; y < grid->ClusterCountY; y++)
+		{
+			float top = (1.0f - y * tileSizeY + projection->M32) / projection->M22;
+			float bottom = (1.0f - (y + 1) * tileSizeY + projection->M32) / projection->M22;
+			slice->RowMin[y] = Min(bottom * slice->Near, bottom * slice->Far);
+			slice->RowMax[y] = Max(top * slice->Near, top * slice->Far);
+		}
+	}
+
+	// Screen space bounds of the lights, in tiles; empty when a light is outside of the view
+	static void ComputeLightTiles(const LightClusterGrid* grid, const LightClusterLight* lights, int lightCount, LightClusterTiles* tiles)
+	{
+		const FlatMatrix* projection = &grid->Projection.Flat;
+
+		for (int i = 0; i < lightCount; i++)
+		{
+			const LightClusterLight* light = &lights[i];
+			float depth = -light->Position.Z;
+
+			float clipMinX = -1.0f, clipMaxX = 1.0f, clipMinY = -1.0f, clipMaxY = 1.0f;
+			UpdateClipRegion(light->Position.X, depth, light->Radius, projection->M11, projection->M31, &clipMinX, &clipMaxX);
+			UpdateClipRegion(light->Position.Y, depth, light->Radius, projection->M22, projection->M32, &clipMinY, &clipMaxY);
+
+			tiles[i].StartX = ClampInt((int)((clipMinX * 0.5f + 0.5f) * grid->ViewSize.X / grid->ClusterSize), 0, grid->ClusterCountX);
+			tiles[i].EndX = ClampInt((int)((clipMaxX * 0.5f + 0.5f) * grid->ViewSize.X / grid->ClusterSize) + 1, 0, grid->ClusterCountX);
+			tiles[i].StartY = ClampInt((int)((-clipMaxY * 0.5f + 0.5f) * grid->ViewSize.Y / grid->ClusterSize), 0, grid->ClusterCountY);
+			tiles[i].EndY = ClampInt((int)((-clipMinY * 0.5f + 0.5f) * grid->ViewSize.Y / grid->ClusterSize) + 1, 0, grid->ClusterCountY);
+		}
+	}
+
+	// Adds the lights touching the depth range of the slice, restricted to the tiles of their screen space bounds
+	static void GatherSliceLights(const LightClusterSlice* slice, const LightClusterLight* lights, const LightClusterTiles* tiles, int lightCount, LightClusterSliceLights* sliceLights)
+	{
+		for (int i = 0; i < lightCount; i++)
+		{
+			const LightClusterTiles* lightTiles = &tiles[i];
+			if (lightTiles->StartX >= lightTiles->EndX || lightTiles->StartY >= lightTiles->EndY)
+				continue;
+
+			const LightClusterLight* light = &lights[i];
+			float distanceZ = RangeDistance(-light->Position.Z, slice->Near, slice->Far);
+			float budget = light->Radius * light->Radius - distanceZ * distanceZ;
+			if (budget < 0.0f)
+				continue;
+
+			int index = sliceLights->Count++;
+			sliceLights->Light[index] = i;
+			sliceLights->CenterX[index] = light->Position.X;
+			sliceLights->CenterY[index] = light->Position.Y;
+			sliceLights->Budget[index] = budget;
+			sliceLights->TileStartX[index] = lightTiles->StartX;
+			sliceLights->TileEndX[index] = lightTiles->EndX;
+			sliceLights->TileStartY[index] = lightTiles->StartY;
+			sliceLights->TileEndY[index] = lightTiles->EndY;
+		}
+	}
+
+	static void GatherRowLights(const LightClusterSlice* slice, const LightClusterSliceLights* sliceLights, int y, LightClusterRowLights* rowLights)
+	{
+		rowLights->Count = 0;
+		rowLights->PointCount = 0;
+		for (int i = 0; i < sliceLights->Count; i++)
+		{
+			if (i == sliceLights->PointCount)
+				rowLights->PointCount = rowLights->Count;
+
+			if (y < sliceLights->TileStartY[i] || y >= sliceLights->TileEndY[i])
+				continue;
+
+			float distanceY = RangeDistance(sliceLights->CenterY[i], slice->RowMin[y], slice->RowMax[y]);
+			float budget = sliceLights->Budget[i] - distanceY * distanceY;
+			if (budget < 0.0f)
+				continue;
+
+			int index = rowLights->Count++;
+			rowLights->Light[index] = i;
+			rowLights->CenterX[index] = sliceLights->CenterX[i];
+			rowLights->Budget[index] = budget;
+			rowLights->TileStartX[index] = sliceLights->TileStartX[i];
+			rowLights->TileEndX[index] = sliceLights->TileEndX[i];
+		}
+		if (sliceLights->PointCount == sliceLights->Count)
+			rowLights->PointCount = rowLights->Count;
+
+		// Padding lanes never pass the test
+		for (int i = rowLights->Count; (i & 3) != 0; i++)
+		{
+			rowLights->Light[i] = 0;
+			rowLights->CenterX[i] = 0.0f;
+			rowLights->Budget[i] = -1.0f;
+			rowLights->TileStartX[i] = 0;
+			rowLights->TileEndX[i] = 0;
+		}
+	}
+
+	// Cone against the bounding sphere of a cluster, culled when the sphere is entirely outside of the cone angle or range
+	static inline bool SpotTouchesCluster(const LightClusterLight* light, const Vector3& center, float radius)
+	{
+		float vx = center.X - light->Position.X;
+		float vy = center.Y - light->Position.Y;
+		float vz = center.Z - light->Position.Z;
+		float lengthSquared = vx * vx + vy * vy + vz * vz;
+		float alongAxis = vx * light->Direction.X + vy * light->Direction.Y + vz * light->Direction.Z;
+		float sinAngle = sqrtf(Max(1.0f - light->CosAngle * light->CosAngle, 0.0f));
+		float distanceToCone = light->CosAngle * sqrtf(Max(lengthSquared - alongAxis * alongAxis, 0.0f)) - alongAxis * sinAngle;
+		return !(distanceToCone > radius || alongAxis > radius + light->Radius || alongAxis < -radius);
+	}
+
+	static void AssignSlice(const LightClusterGrid* grid, const LightClusterLight* pointLights, const LightClusterLight* spotLights, const LightClusterSlice* slice, const LightClusterSliceLights* sliceLights,
+		LightClusterRowLights* rowLights, int32_t* clusterInfos, int32_t* indices, int capacity, int32_t* indexCount)
+	{
+		int count = 0;
+		float centerZ = -0.5f * (slice->Near + slice->Far);
+		float extentZ = 0.5f * (slice->Far - slice->Near);
+
+		for (int y = 0; y < grid->ClusterCountY; y++)
+		{
+			GatherRowLights(slice, sliceLights, y, rowLights);
+
+			float centerY = 0.5f * (slice->RowMin[y] + slice->RowMax[y]);
+			float extentY = 0.5f * (slice->RowMax[y] - slice->RowMin[y]);
+			int previousStart = 0, previousCounts = 0;
+
+			for (int x = 0; x < grid->ClusterCountX; x++)
+			{
+				int start = count;
+				int pointCount = 0, spotCount = 0;
+
+				if (rowLights->Count > 0)
+				{
+					float4 columnMin = slice->ColumnMin[x];
+					float4 columnMax = slice->ColumnMax[x];
+					int4 column = x;
+
+					float extentX = 0.5f * (slice->ColumnMax[x] - slice->ColumnMin[x]);
+					Vector3 clusterCenter = { 0.5f * (slice->ColumnMin[x] + slice->ColumnMax[x]), centerY, centerZ };
+					float clusterRadius = sqrtf(extentX * extentX + extentY * extentY + extentZ * extentZ);
+
+					for (int i = 0; i < rowLights->Count; i += 4)
+					{
+						float4 centerX, budget;
+						int4 tileStartX, tileEndX;
+						memcpy(&centerX, rowLights->CenterX + i, sizeof(float4));
+						memcpy(&budget, rowLights->Budget + i, sizeof(float4));
+						memcpy(&tileStartX, rowLights->TileStartX + i, sizeof(int4));
+						memcpy(&tileEndX, rowLights->TileEndX + i, sizeof(int4));
+
+						float4 distanceX = npMaxF4(npMaxF4(columnMin - centerX, centerX - columnMax), (float4)0.0f);
+						int4 touches = (distanceX * distanceX <= budget) & (column >= tileStartX) & (column < tileEndX);
+						if (!(touches.x | touches.y | touches.z | touches.w))
+							continue;
+
+						for (int lane = 0; lane < 4; lane++)
+						{
+							if (!touches[lane])
+								continue;
+
+							int rowLight = i + lane;
+							int sliceLight = rowLights->Light[rowLight];
+							int lightIndex = sliceLights->Light[sliceLight];
+							if (rowLight < rowLights->PointCount)
+							{
+								pointCount++;
+							}
+							else
+							{
+								if (!SpotTouchesCluster(&spotLights[lightIndex], clusterCenter, clusterRadius))
+									continue;
+								spotCount++;
+							}
+
+							if (count < capacity)
+								indices[count] = lightIndex;
+							count++;
+						}
+					}
+				}
+
+				int counts = pointCount | (spotCount << 16);
+				int32_t* clusterInfo = clusterInfos + 2 * (x + (y + slice->Slice * grid->ClusterCountY) * grid->ClusterCountX);
+
+				// Share the list of the previous cluster when it is the same
+				int size = pointCount + spotCount;
+				if (size > 0 && counts == previousCounts && count <= capacity && memcmp(indices + previousStart, indices + start, sizeof(int32_t) * size) == 0)
+				{
+					count = start;
+					start = previousStart;
+				}
+
+				clusterInfo[0] = size > 0 ? start : 0;
+				clusterInfo[1] = counts;
+				previousStart = start;
+				previousCounts = counts;
+			}
+		}
+
+		*indexCount = count;
+	}
+
+	/*
+	* Assigns the point and spot lights to the clusters of slices [start, end).
+	* The light indices of slice z are written to sliceIndices + z * sliceCapacity, and their count to sliceIndexCounts[z];
+	* when the count is larger than sliceCapacity, the indices are incomplete and the slice must be assigned again with a larger capacity.
+	* The cluster infos (2 ints per cluster) of slice z have their start relative to the slice indices, see xnLightClusterMerge.
+	* Slices can be assigned concurrently.
+	*/
+	DLL_EXPORT_API void xnLightClusterAssignRange(const LightClusterGrid* grid, const LightClusterLight* pointLights, int pointLightCount, const LightClusterLight* spotLights, int spotLightCount,
+		int32_t* clusterInfos, int32_t* sliceIndices, int sliceCapacity, int32_t* sliceIndexCounts, int start, int end)
+	{
+		int lightCount = pointLightCount + spotLightCount;
+		int paddedLightCount = (lightCount + 3) & ~3;
+
+		npArena* arena = npFrameArena();
+		npArenaMarker marker = npArenaGetMarker(arena);
+		float* bounds = (float*)npArenaAlloc(arena, sizeof(float) * 2 * (grid->ClusterCountX + grid->ClusterCountY));
+		int* sliceLightData = (int*)npArenaAlloc(arena, sizeof(int) * 8 * lightCount + 1);
+		int* rowLightData = (int*)npArenaAlloc(arena, sizeof(int) * 5 * paddedLightCount + 1);
+		LightClusterTiles* tiles = (LightClusterTiles*)npArenaAlloc(arena, sizeof(LightClusterTiles) * lightCount + 1);
+
+		// The screen space bounds of a light don't depend on the slice
+		LightClusterTiles* pointTiles = tiles;
+		LightClusterTiles* spotTiles = tiles + pointLightCount;
+		ComputeLightTiles(grid, pointLights, pointLightCount, pointTiles);
+		ComputeLightTiles(grid, spotLights, spotLightCount, spotTiles);
+
+		LightClusterSlice slice;
+		slice.ColumnMin = bounds;
+		slice.ColumnMax = slice.ColumnMin + grid->ClusterCountX;
+		slice.RowMin = slice.ColumnMax + grid->ClusterCountX;
+		slice.RowMax = slice.RowMin + grid->ClusterCountY;
+
+		LightClusterSliceLights sliceLights;
+		sliceLights.Light = sliceLightData;
+		sliceLights.CenterX = (float*)(sliceLights.Light + lightCount);
+		sliceLights.CenterY = sliceLights.CenterX + lightCount;
+		sliceLights.Budget = sliceLights.CenterY + lightCount;
+		sliceLights.TileStartX = (int*)(sliceLights.Budget + lightCount);
+		sliceLights.TileEndX = sliceLights.TileStartX + lightCount;
+		sliceLights.TileStartY = sliceLights.TileEndX + lightCount;
+		sliceLights.TileEndY = sliceLights.TileStartY + lightCount;
+
+		LightClusterRowLights rowLights;
+		rowLights.Light = rowLightData;
+		rowLights.CenterX = (float*)(rowLights.Light + paddedLightCount);
+		rowLights.Budget = rowLights.CenterX + paddedLightCount;
+		rowLights.TileStartX = (int*)(rowLights.Budget + paddedLightCount);
+		rowLights.TileEndX = rowLights.TileStartX + paddedLightCount;
+
+		for (int z = start; z < end; z++)
+		{
+			slice.Slice = z;
+			ComputeSliceBounds(grid, &slice);
+
+			sliceLights.Count = 0;
+			GatherSliceLights(&slice, pointLights, pointTiles, pointLightCount, &sliceLights);
+			sliceLights.PointCount = sliceLights.Count;
+			GatherSliceLights(&slice, spotLights, spotTiles, spotLightCount, &sliceLights);
+
+			AssignSlice(grid, pointLights, spotLights, &slice, &sliceLights, &rowLights, clusterInfos, sliceIndices + (size_t)z * sliceCapacity, sliceCapacity, &sliceIndexCounts[z]);
+		}
+
+		npArenaRewind(arena, marker);
+	}
+
+	/*
+	* Concatenates the light indices of every slice into indices (the sum of sliceIndexCounts) and makes the cluster infos start absolute.
+	*/
+	DLL_EXPORT_API void xnLightClusterMerge(const LightClusterGrid* grid, int32_t* clusterInfos, const int32_t* sliceIndices, int sliceCapacity, const int32_t* sliceIndexCounts, int32_t* indices)
+	{
+		int clustersPerSlice = grid->ClusterCountX * grid->ClusterCountY;
+		int offset = 0;
+		for (int z = 0; z < grid->ClusterSlices; z++)
+		{
+			memcpy(indices + offset, sliceIndices + (size_t)z * sliceCapacity, sizeof(int32_t) * sliceIndexCounts[z]);
+
+			int32_t* clusterInfo = clusterInfos + 2 * z * clustersPerSlice;
+			for (int i = 0; i < clustersPerSlice; i++)
+			{
+				if (clusterInfo[2 * i + 1] != 0)
+					clusterInfo[2 * i] += offset;
+			}
+
+			offset += sliceIndexCounts[z];
+		}
+	}
+}
@@ -0,0 +1,22 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#define NATIVEPATH_MEMORY_IMPLEMENTATION
+#include "../../../deps/NativePath/NativeMemory.h"
+#include "StrideNative.h"
+
+/*
+* Arenas and allocation tracking of libstride. Kernels called every frame take their temporary buffers from npFrameArena and rewind it on return,
+* instead of going through the heap on each call.
+*/
+
+extern "C" {
+	/*
+	* Fills stats with the native allocations of libstride, see npMemoryGetStats (only counted when built with NP_MEMORY_TRACKING).
+	*/
+	DLL_EXPORT_API void xnMemoryGetStats(npMemoryStats* stats)
+	{
+		npMemoryGetStats(stats);
+	}
+}
@@ -0,0 +1,538 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#define NP_MEMORY_SUBSYSTEM NP_MEMORY_SUBSYSTEM_GEOMETRY
+#include "../../../deps/NativePath/NativeMemory.h"
+#include "../../../deps/NativePath/NativeMath.h"
+#include "../../../deps/NativePath/NativeTrace.h"
+#include "StrideNative.h"
+
+/*
+* Index and vertex buffer optimizations for the asset pipeline. Functions only touch the buffers they are given,
+* so different meshes can be optimized concurrently. Indices are 32-bit, 16-bit buffers need to be widened first.
+* Triangle lists ignore trailing indices that don't form a whole triangle. Functions that allocate scratch memory report
+* allocation failures through their return value.
+*/
+
+extern "C" {
+	void xnRadixSortKeys32(uint32_t* keys, uint32_t* indices, int count);
+
+	// Post transform cache size that index orders are optimized and measured for
+	static const int VertexCacheSize = 16;
+
+	static const uint32_t InvalidIndex = 0xffffffff;
+
+	typedef struct TriangleAdjacency
+	{
+		int* Offsets; // vertexCount + 1 entries, triangles of vertex v are Triangles[Offsets[v]..Offsets[v + 1]]
+		int* Triangles;
+		int* LiveCounts;
+	} TriangleAdjacency;
+
+	static void FreeAdjacency(TriangleAdjacency* adjacency)
+	{
+		free(adjacency->Offsets);
+		free(adjacency->Triangles);
+		free(adjacency->LiveCounts);
+	}
+
+	// indexCount must be a multiple of 3
+	static npBool BuildAdjacency(TriangleAdjacency* adjacency, const uint32_t* indices, int indexCount, int vertexCount)
+	{
+		adjacency->Offsets = (int*)malloc(sizeof(int) * (vertexCount + 1));
+		adjacency->Triangles = (int*)malloc(sizeof(int) * indexCount);
+		adjacency->LiveCounts = (int*)malloc(sizeof(int) * vertexCount);
+		if (!adjacency->Offsets || !adjacency->Triangles || !adjacency->LiveCounts)
+		{
+			FreeAdjacency(adjacency);
+			return false;
+		}
+
+		memset(adjacency->LiveCounts, 0, sizeof(int) * vertexCount);
+		for (int i = 0; i < indexCount; i++)
+			adjacency->LiveCounts[indices[i]]++;
+
+		int offset = 0;
+		for (int v = 0; v < vertexCount; v++)
+		{
+			adjacency->Offsets[v] = offset;
+			offset += adjacency->LiveCounts[v];
+		}
+		adjacency->Offsets[vertexCount] = offset;
+
+		// Fill using Offsets as cursors, then shift them back
+		for (int i = 0; i < indexCount; i++)
+			adjacency->Triangles[adjacency->Offsets[indices[i]]++] = i / 3;
+		for (int v = vertexCount; v > 0; v--)
+			adjacency->Offsets[v] = adjacency->Offsets[v - 1];
+		adjacency->Offsets[0] = 0;
+		return true;
+	}
+
+	/*
+	* Reorders triangles for the post transform vertex cache.
+	* Tipsify [Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"]
+	* destination must not alias indices. Returns false when out of memory, destination is then left unchanged.
+	*/
+	DLL_EXPORT_API npBool xnOptimizeVertexCache(uint32_t* destination, const uint32_t* indices, int indexCount, int vertexCount)
+	{
+		NP_TRACE_SCOPE("xnOptimizeVertexCache");
+
+		int triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+			return true;
+		indexCount = triangleCount * 3;
+
+		TriangleAdjacency adjacency;
+		if (!BuildAdjacency(&adjacency, indices, indexCount, vertexCount))
+			return false;
+
+		int* timestamps = (int*)malloc(sizeof(int) * vertexCount);
+		uint8_t* emitted = (uint8_t*)malloc(triangleCount);
+		// Every emitted index is pushed once at most
+		uint32_t* deadEnds = (uint32_t*)malloc(sizeof(uint32_t) * indexCount);
+		// Candidates are the vertices of the triangles just emitted around the fanning vertex
+		uint32_t* candidates = (uint32_t*)malloc(sizeof(uint32_t) * indexCount);
+		if (!timestamps || !emitted || !deadEnds || !candidates)
+		{
+			free(candidates);
+			free(deadEnds);
+			free(emitted);
+			free(timestamps);
+			FreeAdjacency(&adjacency);
+			return false;
+		}
+
+		memset(timestamps, 0, sizeof(int) * vertexCount);
+		memset(emitted, 0, triangleCount);
+
+		int deadEndCount = 0;
+		int time = VertexCacheSize + 1;
+		int cursor = 0;
+		int outputCount = 0;
+
+		int fanning = 0;
+		while (cursor < vertexCount && adjacency.LiveCounts[cursor] == 0)
+			cursor++;
+		fanning = cursor < vertexCount ? cursor : -1;
+
+		while (fanning >= 0)
+		{
+			int candidateCount = 0;
+			for (int j = adjacency.Offsets[fanning]; j < adjacency.Offsets[fanning + 1]; j++)
+			{
+				int triangle = adjacency.Triangles[j];
+				if (emitted[triangle])
+					continue;
+
+				for (int k = 0; k < 3; k++)
+				{
+					uint32_t v = indices[triangle * 3 + k];
+					destination[outputCount++] = v;
+					deadEnds[deadEndCount++] = v;
+					candidates[candidateCount++] = v;
+					adjacency.LiveCounts[v]--;
+
+					// Not in cache anymore: loading it again makes it the most recent entry
+					if (time - timestamps[v] > VertexCacheSize)
+						timestamps[v] = time++;
+				}
+				emitted[triangle] = 1;
+			}
+
+			// Pick the candidate still in cache after its remaining triangles are emitted, preferring the oldest one
+			int next = -1;
+			int bestPriority = -1;
+			for (int j = 0; j < candidateCount; j++)
+			{
+				uint32_t v = candidates[j];
+				if (adjacency.LiveCounts[v] <= 0)
+					continue;
+
+				int priority = 0;
+				if (time - timestamps[v] + 2 * adjacency.LiveCounts[v] <= VertexCacheSize)
+					priority = time - timestamps[v];
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = (int)v;
+				}
+			}
+
+			// Dead end: go back to a recently used vertex, or to the next vertex with triangles left
+			while (next < 0 && deadEndCount > 0)
+			{
+				uint32_t v = deadEnds[--deadEndCount];
+				if (adjacency.LiveCounts[v] > 0)
+					next = (int)v;
+			}
+			while (next < 0 && cursor < vertexCount)
+			{
+				if (adjacency.LiveCounts[cursor] > 0)
+					next = cursor;
+				cursor++;
+			}
+
+			fanning = next;
+		}
+
+		free(candidates);
+		free(deadEnds);
+		free(emitted);
+		free(timestamps);
+		FreeAdjacency(&adjacency);
+		return true;
+	}
+
+	/*
+	* Returns the number of post transform cache misses per triangle (ACMR) of an index buffer, for a FIFO cache, or -1 when out of memory.
+	*/
+	DLL_EXPORT_API float xnAnalyzeVertexCache(const uint32_t* indices, int indexCount, int vertexCount)
+	{
+		int triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+			return 0.0f;
+
+		int* timestamps = (int*)malloc(sizeof(int) * vertexCount);
+		if (!timestamps)
+			return -1.0f;
+		memset(timestamps, 0, sizeof(int) * vertexCount);
+
+		int time = VertexCacheSize + 1;
+		int misses = 0;
+		for (int i = 0; i < triangleCount * 3; i++)
+		{
+			uint32_t v = indices[i];
+			if (time - timestamps[v] > VertexCacheSize)
+			{
+				timestamps[v] = time++;
+				misses++;
+			}
+		}
+
+		free(timestamps);
+		return (float)misses / (float)triangleCount;
+	}
+
+	static inline Vector3 GetPosition(const uint8_t* positions, int positionStride, uint32_t index)
+	{
+		return *(const Vector3*)(positions + (size_t)index * positionStride);
+	}
+
+	/*
+	* Reorders clusters of triangles of a vertex cache optimized index buffer so that outward facing clusters are drawn first.
+	* Clusters are split where the cache is fully flushed, and further where their local ACMR stays within threshold times the
+	* cluster ACMR (e.g. 1.05 allows a 5% cache efficiency loss for finer sorting).
+	* [Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"]
+	* destination must not alias indices. Returns false when out of memory, destination is then left unchanged.
+	*/
+	DLL_EXPORT_API npBool xnOptimizeOverdraw(uint32_t* destination, const uint32_t* indices, int indexCount, const void* positions, int positionStride, int vertexCount, float threshold)
+	{
+		NP_TRACE_SCOPE("xnOptimizeOverdraw");
+
+		int triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+			return true;
+
+		const uint8_t* positionData = (const uint8_t*)positions;
+		int* timestamps = (int*)malloc(sizeof(int) * vertexCount);
+		// Cluster start triangles, plus the end of the last cluster
+		int* clusters = (int*)malloc(sizeof(int) * (triangleCount + 1));
+		// Clusters after the soft splits
+		int* splitClusters = (int*)malloc(sizeof(int) * (triangleCount + 1));
+		if (!timestamps || !clusters || !splitClusters)
+		{
+			free(splitClusters);
+			free(clusters);
+			free(timestamps);
+			return false;
+		}
+		int clusterCount = 0;
+
+		// Hard boundaries: triangles missing the cache for all their vertices
+		memset(timestamps, 0, sizeof(int) * vertexCount);
+		int time = VertexCacheSize + 1;
+		for (int t = 0; t < triangleCount; t++)
+		{
+			int misses = 0;
+			for (int k = 0; k < 3; k++)
+			{
+				uint32_t v = indices[t * 3 + k];
+				if (time - timestamps[v] > VertexCacheSize)
+				{
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+			if (t == 0 || misses == 3)
+				clusters[clusterCount++] = t;
+		}
+		clusters[clusterCount] = triangleCount;
+
+		// Soft boundaries: split hard clusters further as long as it does not degrade their ACMR by more than threshold
+		int splitClusterCount = 0;
+		for (int c = 0; c < clusterCount; c++)
+		{
+			int start = clusters[c];
+			int end = clusters[c + 1];
+
+			time += VertexCacheSize + 1;
+			int clusterMisses = 0;
+			for (int i = start * 3; i < end * 3; i++)
+			{
+				uint32_t v = indices[i];
+				if (time - timestamps[v] > VertexCacheSize)
+				{
+					timestamps[v] = time++;
+					clusterMisses++;
+				}
+			}
+			float maximumAcmr = (float)clusterMisses / (float)(end - start) * threshold;
+
+			splitClusters[splitClusterCount++] = start;
+			time += VertexCacheSize + 1;
+			int misses = 0;
+			int currentStart = start;
+			for (int t = start; t < end; t++)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					uint32_t v = indices[t * 3 + k];
+					if (time - timestamps[v] > VertexCacheSize)
+					{
+						timestamps[v] = time++;
+						misses++;
+					}
+				}
+
+				if (t + 1 < end && (float)misses <= maximumAcmr * (float)(t + 1 - currentStart))
+				{
+					splitClusters[splitClusterCount++] = t + 1;
+					currentStart = t + 1;
+					misses = 0;
+					time += VertexCacheSize + 1;
+				}
+			}
+		}
+		splitClusters[splitClusterCount] = triangleCount;
+		free(clusters);
+		free(timestamps);
+
+		// Mesh centroid, area weighted
+		float4 meshCentroid = 0.0f;
+		float meshArea = 0.0f;
+		float4* clusterCentroids = (float4*)malloc(sizeof(float4) * splitClusterCount);
+		float4* clusterNormals = (float4*)malloc(sizeof(float4) * splitClusterCount);
+		uint32_t* keys = (uint32_t*)malloc(sizeof(uint32_t) * splitClusterCount);
+		uint32_t* order = (uint32_t*)malloc(sizeof(uint32_t) * splitClusterCount);
+		if (!clusterCentroids || !clusterNormals || !keys || !order)
+		{
+			free(order);
+			free(keys);
+			free(clusterNormals);
+			free(clusterCentroids);
+			free(splitClusters);
+			return false;
+		}
+
+		for (int c = 0; c < splitClusterCount; c++)
+		{
+			float4 centroid = 0.0f;
+			float4 normal = 0.0f;
+			float area = 0.0f;
+			for (int t = splitClusters[c]; t < splitClusters[c + 1]; t++)
+			{
+				Vector3 p0 = GetPosition(positionData, positionStride, indices[t * 3 + 0]);
+				Vector3 p1 = GetPosition(positionData, positionStride, indices[t * 3 + 1]);
+				Vector3 p2 = GetPosition(positionData, positionStride, indices[t * 3 + 2]);
+				float4 a = { p0.X, p0.Y, p0.Z, 0.0f };
+				float4 b = { p1.X, p1.Y, p1.Z, 0.0f };
+				float4 d = { p2.X, p2.Y, p2.Z, 0.0f };
+
+				float4 e0 = b - a;
+				float4 e1 = d - a;
+				float4 cross = npCrossProductF4(e0, e1);
+				float triangleArea = sqrtf(cross.x * cross.x + cross.y * cross.y + cross.z * cross.z);
+
+				centroid += (a + b + d) * (triangleArea / 3.0f);
+				normal += cross;
+				area += triangleArea;
+			}
+
+			meshCentroid += centroid;
+			meshArea += area;
+			clusterCentroids[c] = area > 0.0f ? centroid / area : centroid;
+			float normalLength = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			clusterNormals[c] = normalLength > 0.0f ? normal / normalLength : normal;
+		}
+		if (meshArea > 0.0f)
+			meshCentroid /= meshArea;
+
+		// Outward facing clusters (largest dot product) first: sort by descending key with the stable radix sort
+		for (int c = 0; c < splitClusterCount; c++)
+		{
+			float4 offset = clusterCentroids[c] - meshCentroid;
+			float4 normal = clusterNormals[c];
+			float sortKey = offset.x * normal.x + offset.y * normal.y + offset.z * normal.z + 0.0f;
+
+			uint32_t bits;
+			memcpy(&bits, &sortKey, sizeof(uint32_t));
+			bits = (bits & 0x80000000) ? ~bits : bits | 0x80000000;
+			keys[c] = ~bits;
+			order[c] = c;
+		}
+		xnRadixSortKeys32(keys, order, splitClusterCount);
+
+		int outputCount = 0;
+		for (int c = 0; c < splitClusterCount; c++)
+		{
+			int cluster = order[c];
+			int start = splitClusters[cluster] * 3;
+			int end = splitClusters[cluster + 1] * 3;
+			memcpy(&destination[outputCount], &indices[start], sizeof(uint32_t) * (end - start));
+			outputCount += end - start;
+		}
+
+		free(keys);
+		free(order);
+		free(clusterNormals);
+		free(clusterCentroids);
+		free(splitClusters);
+		return true;
+	}
+
+	/*
+	* Computes remap[oldVertex] = newVertex so that vertices are stored in the order the index buffer first uses them.
+	* Unused vertices are mapped to 0xffffffff. Returns the number of used vertices.
+	*/
+	DLL_EXPORT_API int xnOptimizeVertexFetchRemap(uint32_t* remap, const uint32_t* indices, int indexCount, int vertexCount)
+	{
+		memset(remap, 0xff, sizeof(uint32_t) * vertexCount);
+
+		uint32_t nextVertex = 0;
+		for (int i = 0; i < indexCount; i++)
+		{
+			uint32_t v = indices[i];
+			if (remap[v] == InvalidIndex)
+				remap[v] = nextVertex++;
+		}
+
+		return (int)nextVertex;
+	}
+
+	/*
+	* destination[i] = remap[indices[i]]. destination may alias indices.
+	*/
+	DLL_EXPORT_API void xnRemapIndexBuffer(uint32_t* destination, const uint32_t* indices, int indexCount, const uint32_t* remap)
+	{
+		for (int i = 0; i < indexCount; i++)
+			destination[i] = remap[indices[i]];
+	}
+
+	/*
+	* Moves vertex v to remap[v] in destination (skipped when 0xffffffff). destination must not alias vertices.
+	*/
+	DLL_EXPORT_API void xnRemapVertexBuffer(void* destination, const void* vertices, int vertexCount, int vertexSize, const uint32_t* remap)
+	{
+		uint8_t* destinationData = (uint8_t*)destination;
+		const uint8_t* sourceData = (const uint8_t*)vertices;
+		for (int v = 0; v < vertexCount; v++)
+		{
+			if (remap[v] != InvalidIndex)
+				memcpy(destinationData + (size_t)remap[v] * vertexSize, sourceData + (size_t)v * vertexSize, vertexSize);
+		}
+	}
+
+	static inline uint32_t HashCell(int x, int y, int z)
+	{
+		return ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u);
+	}
+
+	static inline int CellCoordinate(float value, float inverseCellSize)
+	{
+		float cell = value * inverseCellSize;
+		// Clamp so that huge or invalid values still give a valid integer
+		cell = cell > 1.0e9f ? 1.0e9f : (cell < -1.0e9f ? -1.0e9f : (cell == cell ? cell : 0.0f));
+		return (int)floorf(cell);
+	}
+
+	/*
+	* Finds duplicate vertices: identical bytes apart from the position, and positions closer than epsilon on every axis.
+	* Positions are 3 floats at positionOffset. A hash grid with epsilon sized cells limits comparisons to neighboring cells.
+	* Computes remap[vertex] = welded vertex (numbered in order of first occurrence, to use with xnRemapVertexBuffer and
+	* xnRemapIndexBuffer) and returns the number of welded vertices, or -1 when out of memory.
+	*/
+	DLL_EXPORT_API int xnWeldVertices(uint32_t* remap, const void* vertices, int vertexCount, int vertexStride, int positionOffset, float epsilon)
+	{
+		NP_TRACE_SCOPE("xnWeldVertices");
+
+		const uint8_t* data = (const uint8_t*)vertices;
+		int positionEnd = positionOffset + (int)sizeof(Vector3);
+		int neighborRange = epsilon > 0.0f ? 1 : 0;
+		float inverseCellSize = epsilon > 0.0f ? 1.0f / epsilon : 1.0f;
+
+		uint32_t bucketCount = 1;
+		while (bucketCount < (uint32_t)vertexCount * 2)
+			bucketCount <<= 1;
+
+		// Buckets chain the representative vertices (first occurrence) of their cells
+		uint32_t* buckets = (uint32_t*)malloc(sizeof(uint32_t) * bucketCount);
+		uint32_t* next = (uint32_t*)malloc(sizeof(uint32_t) * (vertexCount > 0 ? vertexCount : 1));
+		if (!buckets || !next)
+		{
+			free(next);
+			free(buckets);
+			return -1;
+		}
+		memset(buckets, 0xff, sizeof(uint32_t) * bucketCount);
+
+		uint32_t weldedCount = 0;
+		for (int v = 0; v < vertexCount; v++)
+		{
+			const uint8_t* vertex = data + (size_t)v * vertexStride;
+			Vector3 position = *(const Vector3*)(vertex + positionOffset);
+			int cellX = CellCoordinate(position.X, inverseCellSize);
+			int cellY = CellCoordinate(position.Y, inverseCellSize);
+			int cellZ = CellCoordinate(position.Z, inverseCellSize);
+
+			uint32_t match = InvalidIndex;
+			for (int dz = -neighborRange; dz <= neighborRange && match == InvalidIndex; dz++)
+			for (int dy = -neighborRange; dy <= neighborRange && match == InvalidIndex; dy++)
+			for (int dx = -neighborRange; dx <= neighborRange && match == InvalidIndex; dx++)
+			{
+				uint32_t bucket = HashCell(cellX + dx, cellY + dy, cellZ + dz) & (bucketCount - 1);
+				for (uint32_t other = buckets[bucket]; other != InvalidIndex; other = next[other])
+				{
+					const uint8_t* otherVertex = data + (size_t)other * vertexStride;
+					Vector3 otherPosition = *(const Vector3*)(otherVertex + positionOffset);
+					if (fabsf(otherPosition.X - position.X) <= epsilon
+						&& fabsf(otherPosition.Y - position.Y) <= epsilon
+						&& fabsf(otherPosition.Z - position.Z) <= epsilon
+						&& memcmp(otherVertex, vertex, positionOffset) == 0
+						&& memcmp(otherVertex + positionEnd, vertex + positionEnd, vertexStride - positionEnd) == 0)
+					{
+						match = other;
+						break;
+					}
+				}
+			}
+
+			if (match != InvalidIndex)
+			{
+				remap[v] = remap[match];
+			}
+			else
+			{
+				remap[v] = weldedCount++;
+				uint32_t bucket = HashCell(cellX, cellY, cellZ) & (bucketCount - 1);
+				next[v] = buckets[bucket];
+				buckets[bucket] = (uint32_t)v;
+			}
+		}
+
+		free(next);
+		free(buckets);
+		return (int)weldedCount;
+	}
+}
@@ -0,0 +1,507 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#define NP_MEMORY_SUBSYSTEM NP_MEMORY_SUBSYSTEM_GEOMETRY
+#include "../../../deps/NativePath/NativeMemory.h"
+#include "../../../deps/NativePath/NativeTrace.h"
+#include "StrideNative.h"
+
+/*
+* Edge collapse simplification driven by quadric error metrics over position, normal and texture coordinate
+* [Garland and Heckbert 1998, "Simplifying Surfaces with Color and Texture using Quadric Error Metrics"].
+* Vertices only collapse onto one of their neighbors, so every level of detail can share the original vertex buffer.
+*/
+
+extern "C" {
+	void xnRadixSortKeys(uint64_t* keys, uint32_t* indices, int count);
+	void xnRadixSortKeys32(uint32_t* keys, uint32_t* indices, int count);
+
+	// Position (3), normal (3) and texture coordinate (2)
+	#define QUADRIC_SIZE 8
+	#define QUADRIC_MATRIX_SIZE (QUADRIC_SIZE * (QUADRIC_SIZE + 1) / 2)
+
+	static const uint32_t InvalidIndex = 0xffffffff;
+
+	// Symmetric matrix stored as its upper triangle, row by row
+	typedef struct Quadric
+	{
+		double A[QUADRIC_MATRIX_SIZE];
+		double B[QUADRIC_SIZE];
+		double C;
+		double Weight; // Total area of the triangles summed in, to get an area-averaged error
+	} Quadric;
+
+	enum VertexKind
+	{
+		VertexKindManifold = 0,
+		VertexKindSeam = 1, // Shares its position with exactly one other vertex (its twin) across an attribute discontinuity
+		VertexKindLocked = 2, // Open border, or position shared by more than two vertices
+	};
+
+	typedef struct SimplifierAttributes
+	{
+		Vector3 Origin;
+		double PositionScale;
+		double NormalWeight;
+		double TextureWeight;
+	} SimplifierAttributes;
+
+	static inline void GetAttributeVector(const SimplifierAttributes* attributes, const VertexPositionNormalTexture* vertex, double* result)
+	{
+		result[0] = (vertex->Position.X - attributes->Origin.X) * attributes->PositionScale;
+		result[1] = (vertex->Position.Y - attributes->Origin.Y) * attributes->PositionScale;
+		result[2] = (vertex->Position.Z - attributes->Origin.Z) * attributes->PositionScale;
+		result[3] = vertex->Normal.X * attributes->NormalWeight;
+		result[4] = vertex->Normal.Y * attributes->NormalWeight;
+		result[5] = vertex->Normal.Z * attributes->NormalWeight;
+		result[6] = vertex->TextureCoordinate.X * attributes->TextureWeight;
+		result[7] = vertex->TextureCoordinate.Y * attributes->TextureWeight;
+	}
+
+	static inline double Dot(const double* left, const double* right)
+	{
+		double result = 0.0;
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+			result += left[i] * right[i];
+		return result;
+	}
+
+	// Squared distance to the plane of the triangle in attribute space, weighted by the triangle area
+	static void AddTriangleQuadric(Quadric* quadric, const double* p0, const double* p1, const double* p2, double weight)
+	{
+		double e1[QUADRIC_SIZE], e2[QUADRIC_SIZE];
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+		{
+			e1[i] = p1[i] - p0[i];
+			e2[i] = p2[i] - p0[i];
+		}
+
+		double length1 = sqrt(Dot(e1, e1));
+		if (length1 <= 0.0)
+			return;
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+			e1[i] /= length1;
+
+		double projection = Dot(e1, e2);
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+			e2[i] -= projection * e1[i];
+		double length2 = sqrt(Dot(e2, e2));
+		if (length2 <= 0.0)
+			return;
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+			e2[i] /= length2;
+
+		double p0e1 = Dot(p0, e1);
+		double p0e2 = Dot(p0, e2);
+
+		int k = 0;
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+		{
+			for (int j = i; j < QUADRIC_SIZE; j++, k++)
+				quadric->A[k] += weight * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+			quadric->B[i] += weight * (p0e1 * e1[i] + p0e2 * e2[i] - p0[i]);
+		}
+		quadric->C += weight * (Dot(p0, p0) - p0e1 * p0e1 - p0e2 * p0e2);
+		quadric->Weight += weight;
+	}
+
+	static inline void AddQuadric(Quadric* quadric, const Quadric* other)
+	{
+		for (int k = 0; k < QUADRIC_MATRIX_SIZE; k++)
+			quadric->A[k] += other->A[k];
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+			quadric->B[i] += other->B[i];
+		quadric->C += other->C;
+		quadric->Weight += other->Weight;
+	}
+
+	// (v^T A v + 2 b.v + c) / weight for the sum of two quadrics, so that the error doesn't depend on the triangle sizes
+	static inline double EvaluateQuadrics(const Quadric* first, const Quadric* second, const double* v)
+	{
+		double result = first->C + second->C;
+		int k = 0;
+		for (int i = 0; i < QUADRIC_SIZE; i++)
+		{
+			result += 2.0 * (first->B[i] + second->B[i]) * v[i];
+			result += (first->A[k] + second->A[k]) * v[i] * v[i];
+			k++;
+			for (int j = i + 1; j < QUADRIC_SIZE; j++, k++)
+				result += 2.0 * (first->A[k] + second->A[k]) * v[i] * v[j];
+		}
+		double weight = first->Weight + second->Weight;
+		if (weight > 0.0)
+			result /= weight;
+		return result > 0.0 ? result : 0.0;
+	}
+
+	static inline uint32_t HashPosition(const Vector3* position)
+	{
+		uint32_t bits[3];
+		memcpy(bits, position, sizeof(bits));
+		return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+	}
+
+	// Finds the VertexKind of every vertex, and the twin of seam vertices (InvalidIndex for other kinds)
+	static void ClassifyVertices(uint8_t* kinds, uint32_t* twins, const uint32_t* indices, int indexCount, const VertexPositionNormalTexture* vertices, int vertexCount)
+	{
+		// Map each vertex to the first vertex with the same position, and count the vertices of every position
+		uint32_t* positionIds = (uint32_t*)malloc(sizeof(uint32_t) * vertexCount);
+		uint32_t* positionCounts = (uint32_t*)malloc(sizeof(uint32_t) * vertexCount);
+		uint32_t bucketCount = 1;
+		while (bucketCount < (uint32_t)vertexCount * 2)
+			bucketCount <<= 1;
+		uint32_t* buckets = (uint32_t*)malloc(sizeof(uint32_t) * bucketCount);
+		memset(buckets, 0xff, sizeof(uint32_t) * bucketCount);
+		memset(positionCounts, 0, sizeof(uint32_t) * vertexCount);
+		memset(twins, 0xff, sizeof(uint32_t) * vertexCount);
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			uint32_t bucket = HashPosition(&vertices[v].Position) & (bucketCount - 1);
+			for (;;)
+			{
+				uint32_t other = buckets[bucket];
+				if (other == InvalidIndex)
+				{
+					buckets[bucket] = v;
+					positionIds[v] = v;
+					break;
+				}
+				if (memcmp(&vertices[other].Position, &vertices[v].Position, sizeof(Vector3)) == 0)
+				{
+					positionIds[v] = other;
+					twins[v] = other;
+					twins[other] = v;
+					break;
+				}
+				bucket = (bucket + 1) & (bucketCount - 1);
+			}
+			positionCounts[positionIds[v]]++;
+		}
+		free(buckets);
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			uint32_t count = positionCounts[positionIds[v]];
+			kinds[v] = count == 1 ? VertexKindManifold : (count == 2 ? VertexKindSeam : VertexKindLocked);
+			if (kinds[v] != VertexKindSeam)
+				twins[v] = InvalidIndex;
+		}
+		free(positionCounts);
+
+		// Border edges are used by a single triangle: sort undirected edges and look for unique ones
+		uint64_t* edges = (uint64_t*)malloc(sizeof(uint64_t) * indexCount);
+		uint32_t* edgeOrder = (uint32_t*)malloc(sizeof(uint32_t) * indexCount);
+		for (int i = 0; i < indexCount; i++)
+		{
+			uint32_t a = positionIds[indices[i]];
+			uint32_t b = positionIds[indices[i - i % 3 + (i + 1) % 3]];
+			edges[i] = a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+			edgeOrder[i] = i;
+		}
+		xnRadixSortKeys(edges, edgeOrder, indexCount);
+
+		uint8_t* borderPositions = (uint8_t*)malloc(vertexCount);
+		memset(borderPositions, 0, vertexCount);
+		for (int i = 0; i < indexCount;)
+		{
+			int j = i + 1;
+			while (j < indexCount && edges[j] == edges[i])
+				j++;
+			if (j - i == 1)
+			{
+				borderPositions[edges[i] >> 32] = 1;
+				borderPositions[edges[i] & 0xffffffff] = 1;
+			}
+			i = j;
+		}
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			if (borderPositions[positionIds[v]])
+			{
+				kinds[v] = VertexKindLocked;
+				twins[v] = InvalidIndex;
+			}
+		}
+
+		free(borderPositions);
+		free(edgeOrder);
+		free(edges);
+		free(positionIds);
+	}
+
+	static inline float4 LoadPosition(const VertexPositionNormalTexture* vertices, uint32_t index)
+	{
+		const Vector3* position = &vertices[index].Position;
+		return float4{ position->X, position->Y, position->Z, 0.0f };
+	}
+
+	static inline float4 TriangleNormal(float4 p0, float4 p1, float4 p2)
+	{
+		float4 e0 = p1 - p0;
+		float4 e1 = p2 - p0;
+		return e0.yzxw * e1.zxyw - e0.zxyw * e1.yzxw;
+	}
+
+	// Collapsing from onto to must not flip the triangles that stay around from
+	static int CollapseFlipsTriangles(const uint32_t* indices, const int* offsets, const int* triangles, const VertexPositionNormalTexture* vertices, uint32_t from, uint32_t to)
+	{
+		float4 target = LoadPosition(vertices, to);
+		for (int j = offsets[from]; j < offsets[from + 1]; j++)
+		{
+			const uint32_t* triangle = &indices[triangles[j] * 3];
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+				continue;
+
+			float4 p[3], moved[3];
+			for (int k = 0; k < 3; k++)
+			{
+				p[k] = LoadPosition(vertices, triangle[k]);
+				moved[k] = triangle[k] == from ? target : p[k];
+			}
+
+			float4 before = TriangleNormal(p[0], p[1], p[2]);
+			float4 after = TriangleNormal(moved[0], moved[1], moved[2]);
+			float4 product = before * after;
+			if (product.x + product.y + product.z <= 0.0f)
+				return 1;
+		}
+		return 0;
+	}
+
+	static int HasEdge(const uint32_t* indices, const int* offsets, const int* triangles, uint32_t a, uint32_t b)
+	{
+		for (int j = offsets[a]; j < offsets[a + 1]; j++)
+		{
+			const uint32_t* triangle = &indices[triangles[j] * 3];
+			if (triangle[0] == b || triangle[1] == b || triangle[2] == b)
+				return 1;
+		}
+		return 0;
+	}
+
+	/*
+	* Simplifies a triangle list down to targetIndexCount indices, without exceeding targetError (relative to the mesh extent).
+	* normalWeight and textureWeight scale how much attribute discontinuities cost compared to geometric error.
+	* Border vertices are kept in place. Attribute seam vertices only collapse along their seam, together with their twin on the
+	* other side of it, so the seam stays closed. Returns the new index count; destination (indexCount entries) can alias indices.
+	* resultError is optional and receives the largest error introduced.
+	*/
+	DLL_EXPORT_API int xnSimplifyMesh(uint32_t* destination, const uint32_t* indices, int indexCount, const VertexPositionNormalTexture* vertices, int vertexCount, int targetIndexCount, float targetError, float normalWeight, float textureWeight, float* resultError)
+	{
+		NP_TRACE_SCOPE("xnSimplifyMesh");
+
+		int triangleCount = indexCount / 3;
+		int targetTriangleCount = targetIndexCount / 3;
+		float maximumError = 0.0f;
+
+		if (destination != indices)
+			memcpy(destination, indices, sizeof(uint32_t) * triangleCount * 3);
+		if (triangleCount <= targetTriangleCount || vertexCount == 0)
+		{
+			if (resultError)
+				*resultError = 0.0f;
+			return triangleCount * 3;
+		}
+
+		// Errors are measured in a space where the mesh spans a unit box
+		BoundingBox bounds;
+		bounds.minimum = vertices[0].Position;
+		bounds.maximum = vertices[0].Position;
+		for (int v = 1; v < vertexCount; v++)
+		{
+			const Vector3* position = &vertices[v].Position;
+			bounds.minimum.X = fminf(bounds.minimum.X, position->X);
+			bounds.minimum.Y = fminf(bounds.minimum.Y, position->Y);
+			bounds.minimum.Z = fminf(bounds.minimum.Z, position->Z);
+			bounds.maximum.X = fmaxf(bounds.maximum.X, position->X);
+			bounds.maximum.Y = fmaxf(bounds.maximum.Y, position->Y);
+			bounds.maximum.Z = fmaxf(bounds.maximum.Z, position->Z);
+		}
+		float extent = fmaxf(bounds.maximum.X - bounds.minimum.X, fmaxf(bounds.maximum.Y - bounds.minimum.Y, bounds.maximum.Z - bounds.minimum.Z));
+
+		SimplifierAttributes attributes;
+		attributes.Origin = bounds.minimum;
+		attributes.PositionScale = extent > 0.0f ? 1.0 / extent : 1.0;
+		attributes.NormalWeight = normalWeight;
+		attributes.TextureWeight = textureWeight;
+
+		double* attributeVectors = (double*)malloc(sizeof(double) * QUADRIC_SIZE * vertexCount);
+		for (int v = 0; v < vertexCount; v++)
+			GetAttributeVector(&attributes, &vertices[v], &attributeVectors[v * QUADRIC_SIZE]);
+
+		Quadric* quadrics = (Quadric*)malloc(sizeof(Quadric) * vertexCount);
+		memset(quadrics, 0, sizeof(Quadric) * vertexCount);
+		for (int t = 0; t < triangleCount; t++)
+		{
+			const double* p0 = &attributeVectors[destination[t * 3 + 0] * QUADRIC_SIZE];
+			const double* p1 = &attributeVectors[destination[t * 3 + 1] * QUADRIC_SIZE];
+			const double* p2 = &attributeVectors[destination[t * 3 + 2] * QUADRIC_SIZE];
+
+			float4 normal = TriangleNormal(LoadPosition(vertices, destination[t * 3 + 0]), LoadPosition(vertices, destination[t * 3 + 1]), LoadPosition(vertices, destination[t * 3 + 2]));
+			double area = 0.5 * sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z) * attributes.PositionScale * attributes.PositionScale;
+
+			for (int k = 0; k < 3; k++)
+				AddTriangleQuadric(&quadrics[destination[t * 3 + k]], p0, p1, p2, area);
+		}
+
+		uint8_t* kinds = (uint8_t*)malloc(vertexCount);
+		uint32_t* twins = (uint32_t*)malloc(sizeof(uint32_t) * vertexCount);
+		ClassifyVertices(kinds, twins, destination, triangleCount * 3, vertices, vertexCount);
+
+		int* offsets = (int*)malloc(sizeof(int) * (vertexCount + 1));
+		int* triangles = (int*)malloc(sizeof(int) * indexCount);
+		uint32_t* remap = (uint32_t*)malloc(sizeof(uint32_t) * vertexCount);
+		uint8_t* touched = (uint8_t*)malloc(vertexCount);
+		// Both directions of every triangle edge
+		uint32_t* collapseFrom = (uint32_t*)malloc(sizeof(uint32_t) * indexCount * 2);
+		uint32_t* collapseTo = (uint32_t*)malloc(sizeof(uint32_t) * indexCount * 2);
+		uint32_t* collapseKeys = (uint32_t*)malloc(sizeof(uint32_t) * indexCount * 2);
+		uint32_t* collapseOrder = (uint32_t*)malloc(sizeof(uint32_t) * indexCount * 2);
+		// Quadrics are area-averaged squared distances in the unit box space, as targetError
+		double maximumQuadricError = (double)targetError * targetError;
+
+		while (triangleCount > targetTriangleCount)
+		{
+			// Vertex to triangle adjacency of the current index buffer
+			memset(offsets, 0, sizeof(int) * (vertexCount + 1));
+			for (int i = 0; i < triangleCount * 3; i++)
+				offsets[destination[i] + 1]++;
+			for (int v = 0; v < vertexCount; v++)
+				offsets[v + 1] += offsets[v];
+			for (int i = 0; i < triangleCount * 3; i++)
+				triangles[offsets[destination[i]]++] = i / 3;
+			for (int v = vertexCount; v > 0; v--)
+				offsets[v] = offsets[v - 1];
+			offsets[0] = 0;
+
+			// Evaluate every allowed collapse, errors are positive so their float bits sort in order
+			int collapseCount = 0;
+			for (int i = 0; i < triangleCount * 3; i++)
+			{
+				uint32_t a = destination[i];
+				uint32_t b = destination[i - i % 3 + (i + 1) % 3];
+				for (int direction = 0; direction < 2; direction++)
+				{
+					uint32_t from = direction ? b : a;
+					uint32_t to = direction ? a : b;
+					if (kinds[from] == VertexKindLocked)
+						continue;
+
+					double error = EvaluateQuadrics(&quadrics[from], &quadrics[to], &attributeVectors[to * QUADRIC_SIZE]);
+
+					// A seam vertex slides along a seam edge, whose other side is the edge between the twins
+					if (kinds[from] == VertexKindSeam)
+					{
+						uint32_t twinFrom = twins[from];
+						uint32_t twinTo = twins[to];
+						if (kinds[to] != VertexKindSeam || twinFrom == to || !HasEdge(destination, offsets, triangles, twinFrom, twinTo))
+							continue;
+
+						double twinError = EvaluateQuadrics(&quadrics[twinFrom], &quadrics[twinTo], &attributeVectors[twinTo * QUADRIC_SIZE]);
+						error = error > twinError ? error : twinError;
+					}
+
+					if (error > maximumQuadricError)
+						continue;
+
+					float sortError = (float)error;
+					memcpy(&collapseKeys[collapseCount], &sortError, sizeof(uint32_t));
+					collapseFrom[collapseCount] = from;
+					collapseTo[collapseCount] = to;
+					collapseOrder[collapseCount] = collapseCount;
+					collapseCount++;
+				}
+			}
+			if (collapseCount == 0)
+				break;
+			xnRadixSortKeys32(collapseKeys, collapseOrder, collapseCount);
+
+			// Apply the cheapest independent collapses, each one removes two triangles of a closed surface
+			for (int v = 0; v < vertexCount; v++)
+				remap[v] = v;
+			memset(touched, 0, vertexCount);
+
+			int collapseBudget = (triangleCount - targetTriangleCount + 1) / 2;
+			int collapsed = 0;
+			for (int c = 0; c < collapseCount && collapsed < collapseBudget; c++)
+			{
+				// Seam collapses move the twins as well
+				uint32_t from[2], to[2];
+				from[0] = collapseFrom[collapseOrder[c]];
+				to[0] = collapseTo[collapseOrder[c]];
+				int pairCount = kinds[from[0]] == VertexKindSeam ? 2 : 1;
+				if (pairCount == 2)
+				{
+					from[1] = twins[from[0]];
+					to[1] = twins[to[0]];
+				}
+
+				int valid = 1;
+				for (int k = 0; k < pairCount && valid; k++)
+				{
+					if (touched[from[k]] || touched[to[k]] || CollapseFlipsTriangles(destination, offsets, triangles, vertices, from[k], to[k]))
+						valid = 0;
+				}
+				if (!valid)
+					continue;
+
+				for (int k = 0; k < pairCount; k++)
+				{
+					// Neighbors keep their current triangles for the rest of the pass so the checks above stay valid
+					for (int j = offsets[from[k]]; j < offsets[from[k] + 1]; j++)
+					{
+						const uint32_t* triangle = &destination[triangles[j] * 3];
+						touched[triangle[0]] = 1;
+						touched[triangle[1]] = 1;
+						touched[triangle[2]] = 1;
+					}
+
+					AddQuadric(&quadrics[to[k]], &quadrics[from[k]]);
+					remap[from[k]] = to[k];
+				}
+
+				float error;
+				memcpy(&error, &collapseKeys[c], sizeof(float));
+				maximumError = fmaxf(maximumError, error);
+				collapsed++;
+			}
+			if (collapsed == 0)
+				break;
+
+			// Remap and drop the triangles that became degenerate
+			int outputCount = 0;
+			for (int t = 0; t < triangleCount; t++)
+			{
+				uint32_t v0 = remap[destination[t * 3 + 0]];
+				uint32_t v1 = remap[destination[t * 3 + 1]];
+				uint32_t v2 = remap[destination[t * 3 + 2]];
+				if (v0 == v1 || v1 == v2 || v2 == v0)
+					continue;
+				destination[outputCount++] = v0;
+				destination[outputCount++] = v1;
+				destination[outputCount++] = v2;
+			}
+			triangleCount = outputCount / 3;
+		}
+
+		free(collapseOrder);
+		free(collapseKeys);
+		free(collapseTo);
+		free(collapseFrom);
+		free(touched);
+		free(remap);
+		free(triangles);
+		free(offsets);
+		free(twins);
+		free(kinds);
+		free(quadrics);
+		free(attributeVectors);
+
+		if (resultError)
+			*resultError = sqrtf(maximumError);
+		return triangleCount * 3;
+	}
+}
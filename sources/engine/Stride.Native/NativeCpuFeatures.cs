@@ -0,0 +1,33 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+
+namespace Stride.Native
+{
+    /// <summary>
+    /// Instruction sets the native kernels pick their implementation from, same values as the NP_CPU constants of the native code.
+    /// </summary>
+    [Flags]
+    internal enum NativeCpuFeatures : uint
+    {
+        None = 0,
+        Sse2 = 0x0001,
+        Sse3 = 0x0002,
+        Ssse3 = 0x0004,
+        Sse41 = 0x0008,
+        Sse42 = 0x0010,
+        Popcnt = 0x0020,
+        Avx = 0x0040,
+        F16c = 0x0080,
+        Fma = 0x0100,
+        Avx2 = 0x0200,
+        Bmi1 = 0x0400,
+        Bmi2 = 0x0800,
+        /// <summary>
+        /// AVX-512 F, CD, BW, DQ and VL.
+        /// </summary>
+        Avx512 = 0x1000,
+        Neon = 0x10000,
+    }
+}
@@ -0,0 +1,460 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Runtime.InteropServices;
+using System.Security;
+using Stride.Core;
+
+namespace Stride.Native
+{
+    internal static class NativeInvoke
+    {
+#if STRIDE_PLATFORM_IOS
+        internal const string Library = "__Internal";
+#else
+        internal const string Library = "libstride";
+#endif
+
+        internal static void PreLoad()
+        {
+            NativeLibraryHelper.PreloadLibrary("libstride", typeof(NativeInvoke));
+        }
+
+        static NativeInvoke()
+        {
+            PreLoad();
+        }
+
+        /// <summary>
+        /// The features the baseline variants of the kernels are compiled for, on x64 and ARM respectively.
+        /// </summary>
+        internal const NativeCpuFeatures BaselineCpuFeatures = NativeCpuFeatures.Sse2 | NativeCpuFeatures.Neon;
+
+        /// <summary>
+        /// Expands <paramref name="count"/> sprite draw infos, read every <paramref name="stride"/> bytes, into 4 vertices each.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnSpriteBatchBuildVerticesStrided", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void SpriteBatchBuildVertices(void* drawInfos, int stride, int count, void* vertices);
+
+        /// <summary>
+        /// Computes the world matrices of transforms [<paramref name="start"/>, <paramref name="end"/>) from their scale/rotation/position.
+        /// Parents (-1 for roots) must be stored before their children, so that disjoint ranges of a same depth level can run concurrently.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnTransformPropagateRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void TransformPropagate(int* parentIndex, void* localSRT, void* localOut, void* worldOut, int start, int end);
+
+        /// <summary>
+        /// Tests boxes [<paramref name="start"/>, <paramref name="end"/>), given as SoA center/extent arrays, against <paramref name="planeCount"/> planes
+        /// and sets bit (i &amp; 7) of <paramref name="visibilityMask"/>[i &gt;&gt; 3] for every visible box i. <paramref name="start"/> must be a multiple of 8.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnFrustumCullBoxesRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void FrustumCullBoxes(void* planes, int planeCount, float* centerX, float* centerY, float* centerZ, float* extentX, float* extentY, float* extentZ, byte* visibilityMask, int start, int end);
+
+        /// <summary>
+        /// Transforms <paramref name="count"/> boxes by their world matrix into <paramref name="result"/> (optional) and merges them into
+        /// <paramref name="groupBounds"/>[<paramref name="groupIndex"/>[i]] when the group index is not negative.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBoundingBoxTransformMerge", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void BoundingBoxTransformMerge(void* boxes, void* worlds, void* result, int* groupIndex, void* groupBounds, int count);
+
+        /// <summary>
+        /// Skins vertices [<paramref name="start"/>, <paramref name="end"/>) of a VertexPositionNormalTexture stream with up to 4 bones per vertex.
+        /// Disjoint ranges can be processed concurrently.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnSkinVerticesRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void SkinVertices(void* bonePalette, ushort* blendIndices, float* blendWeights, void* input, void* output, int start, int end);
+
+        /// <summary>
+        /// Sorts <paramref name="keys"/> in ascending order with a stable radix sort, applying the same permutation to <paramref name="indices"/>.
+        /// Returns false when out of memory, both arrays are then left unchanged.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnRadixSortKeys", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static extern unsafe bool RadixSortKeys(ulong* keys, uint* indices, int count);
+
+        /// <summary>
+        /// Same as <see cref="RadixSortKeys"/> with 32-bit keys.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnRadixSortKeys32", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static extern unsafe bool RadixSortKeys32(uint* keys, uint* indices, int count);
+
+        /// <summary>
+        /// Packs <paramref name="count"/> Vector2 into 2 half floats (R16G16_Float).
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnPackHalf2", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void PackHalf2(void* input, int inputStride, void* output, int outputStride, int count);
+
+        /// <summary>
+        /// Packs <paramref name="count"/> unit Vector3 normals into 2 octahedral encoded snorm16 (R16G16_SNorm).
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnPackNormalOctahedral", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void PackNormalOctahedral(void* input, int inputStride, void* output, int outputStride, int count);
+
+        /// <summary>
+        /// Packs <paramref name="count"/> Vector4 tangents into 4 snorm16 (R16G16B16A16_SNorm): octahedral direction and handedness.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnPackTangentOctahedral", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void PackTangentOctahedral(void* input, int inputStride, void* output, int outputStride, int count);
+
+        /// <summary>
+        /// Packs <paramref name="count"/> Vector3 positions into 4 unorm16 (R16G16B16A16_UNorm) relative to <paramref name="bounds"/>.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnPackPositionUnorm16", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void PackPositionUnorm16(void* input, int inputStride, void* bounds, void* output, int outputStride, int count);
+
+        /// <summary>
+        /// Reorders the triangles of a 32-bit index buffer for the post transform vertex cache (Tipsify). Returns false when out of memory.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOptimizeVertexCache", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static extern unsafe bool OptimizeVertexCache(uint* destination, uint* indices, int indexCount, int vertexCount);
+
+        /// <summary>
+        /// Returns the average number of vertex cache misses per triangle of a 32-bit index buffer, or -1 when out of memory.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnAnalyzeVertexCache", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe float AnalyzeVertexCache(uint* indices, int indexCount, int vertexCount);
+
+        /// <summary>
+        /// Reorders triangle clusters of a vertex cache optimized index buffer so that outward facing clusters are drawn first.
+        /// Returns false when out of memory.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOptimizeOverdraw", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static extern unsafe bool OptimizeOverdraw(uint* destination, uint* indices, int indexCount, void* positions, int positionStride, int vertexCount, float threshold);
+
+        /// <summary>
+        /// Computes a vertex remap table ordering vertices by first use in the index buffer. Returns the number of used vertices.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOptimizeVertexFetchRemap", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int OptimizeVertexFetchRemap(uint* remap, uint* indices, int indexCount, int vertexCount);
+
+        /// <summary>
+        /// Applies a vertex remap table to a 32-bit index buffer.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnRemapIndexBuffer", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void RemapIndexBuffer(uint* destination, uint* indices, int indexCount, uint* remap);
+
+        /// <summary>
+        /// Applies a vertex remap table to a vertex buffer.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnRemapVertexBuffer", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void RemapVertexBuffer(void* destination, void* vertices, int vertexCount, int vertexSize, uint* remap);
+
+        /// <summary>
+        /// Computes a vertex remap table merging duplicate vertices, with positions compared within <paramref name="epsilon"/>. Returns the number of welded vertices,
+        /// or -1 when out of memory.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnWeldVertices", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int WeldVertices(uint* remap, void* vertices, int vertexCount, int vertexStride, int positionOffset, float epsilon);
+
+        /// <summary>
+        /// Simplifies a triangle list of VertexPositionNormalTexture with quadric error metrics. Returns the new index count.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnSimplifyMesh", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int SimplifyMesh(uint* destination, uint* indices, int indexCount, void* vertices, int vertexCount, int targetIndexCount, float targetError, float normalWeight, float textureWeight, float* resultError);
+
+        /// <summary>
+        /// Computes the bounds of each triangle of a 32-bit index buffer, to build a BVH over them.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhComputeTriangleBounds", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void BvhComputeTriangleBounds(void* positions, int positionStride, uint* indices, int triangleCount, void* bounds);
+
+        /// <summary>
+        /// Builds a BVH over <paramref name="count"/> bounding boxes. <paramref name="nodes"/> needs 2 * count - 1 entries.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhBuild", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int BvhBuild(void* bounds, int count, void* nodes, uint* primitiveIndices);
+
+        /// <summary>
+        /// Builds the top of a BVH and returns independent subtree tasks, to be built in parallel with <see cref="BvhBuildTasks"/>.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhBuildTopLevel", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int BvhBuildTopLevel(void* bounds, int count, void* nodes, uint* primitiveIndices, void* tasks, int maxTasks);
+
+        /// <summary>
+        /// Builds the BVH subtree tasks in [<paramref name="start"/>, <paramref name="end"/>).
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhBuildTasks", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void BvhBuildTasks(void* bounds, void* nodes, uint* primitiveIndices, void* tasks, int start, int end);
+
+        /// <summary>
+        /// Finds the closest triangle hit by a ray. Returns true on hit.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhIntersectRay", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.Bool)]
+        internal static extern unsafe bool BvhIntersectRay(void* nodes, uint* primitiveIndices, void* positions, int positionStride, uint* indices, void* ray, float maxDistance, void* hit);
+
+        /// <summary>
+        /// Finds the closest triangle hit by the rays in [<paramref name="start"/>, <paramref name="end"/>), traced in packets.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhIntersectRaysRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void BvhIntersectRaysRange(void* nodes, uint* primitiveIndices, void* positions, int positionStride, uint* indices, void* rays, float* maxDistances, void* hits, int start, int end);
+
+        /// <summary>
+        /// Tests whether the rays in [<paramref name="start"/>, <paramref name="end"/>) hit any triangle within their max distance.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhOccludedRaysRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void BvhOccludedRaysRange(void* nodes, uint* primitiveIndices, void* positions, int positionStride, uint* indices, void* rays, float* maxDistances, byte* occluded, int start, int end);
+
+        /// <summary>
+        /// Finds the closest bounding box hit by the rays in [<paramref name="start"/>, <paramref name="end"/>).
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnBvhIntersectBoxesRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void BvhIntersectBoxesRange(void* nodes, uint* primitiveIndices, void* bounds, void* rays, float* maxDistances, void* hits, int start, int end);
+
+        /// <summary>
+        /// Ages the particles in [<paramref name="start"/>, <paramref name="end"/>) and flags in <paramref name="dead"/> those which should be removed.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnParticleUpdateLifetimeRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void ParticleUpdateLifetimeRange(void* life, int lifeStride, void* randomSeeds, int seedStride, float minimumLifetime, float maximumLifetime, float dt, int delayDeath, byte* dead, int start, int end);
+
+        /// <summary>
+        /// Removes the flagged particles by moving the last living particle in their place. Returns the new particle count.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnParticleRemoveDead", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int ParticleRemoveDead(byte* dead, int count, IntPtr* streams, int* elementSizes, int streamCount);
+
+        /// <summary>
+        /// Copies the particle positions to the old positions and moves them by their velocity. Old positions and velocities are optional.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnParticleIntegrateRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void ParticleIntegrateRange(void* positions, int positionStride, void* oldPositions, int oldPositionStride, void* velocities, int velocityStride, float dt, int start, int end);
+
+        /// <summary>
+        /// Applies a constant acceleration to the particle velocities and positions.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnParticleApplyGravityRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void ParticleApplyGravityRange(void* positions, int positionStride, void* velocities, int velocityStride, void* acceleration, float dt, int start, int end);
+
+        /// <summary>
+        /// Applies a force field to the particle velocities and positions.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnParticleApplyForceFieldRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void ParticleApplyForceFieldRange(void* positions, int positionStride, void* velocities, int velocityStride, void* field, float dt, int start, int end);
+
+        /// <summary>
+        /// Samples a baked curve at the particle normalized age, optionally blending with a second curve by the particle random seed.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnParticleSampleCurveRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void ParticleSampleCurveRange(void* life, int lifeStride, float* curve, float* optionalCurve, int components, void* randomSeeds, int seedStride, uint seedOffset, float scale, int premultiplyAlpha, void* output, int outputStride, int start, int end);
+
+        /// <summary>
+        /// Sorts particles in ascending order of the dot product of a float field with weights and writes the sorted particle indices.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnParticleSortByKey", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void ParticleSortByKey(void* values, int valueStride, int components, float* weights, uint* keys, uint* indices, int count);
+
+        /// <summary>
+        /// Converts height sticks to float heights, multiplying byte and short heights by <paramref name="heightScale"/>.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnHeightfieldConvertHeights", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void HeightfieldConvertHeights(void* source, int heightType, float heightScale, float* heights, int count);
+
+        /// <summary>
+        /// Returns the number of min/max entries in the height pyramid of a heightfield.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnHeightfieldPyramidSize", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int HeightfieldPyramidSize(int width, int length);
+
+        /// <summary>
+        /// Recomputes the height pyramid nodes covering the cells in the given region.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnHeightfieldUpdatePyramid", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void HeightfieldUpdatePyramid(float* heights, int width, int length, void* pyramid, int startX, int startZ, int endX, int endZ);
+
+        /// <summary>
+        /// Builds the whole height pyramid of a heightfield.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnHeightfieldBuildPyramid", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void HeightfieldBuildPyramid(float* heights, int width, int length, void* pyramid);
+
+        /// <summary>
+        /// Gets the min/max height of the cells in the given region.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnHeightfieldGetRegionRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void HeightfieldGetRegionRange(void* pyramid, int width, int length, int startX, int startZ, int endX, int endZ, void* result);
+
+        /// <summary>
+        /// Samples the bilinear height and normal (optional) of a heightfield at the positions in [<paramref name="start"/>, <paramref name="end"/>).
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnHeightfieldGetHeightsRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void HeightfieldGetHeightsRange(float* heights, int width, int length, void* origin, void* positions, float* outHeights, void* outNormals, int start, int end);
+
+        /// <summary>
+        /// Finds the closest heightfield hit of the rays in [<paramref name="start"/>, <paramref name="end"/>), skipping empty space with the height pyramid.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnHeightfieldRaycastRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void HeightfieldRaycastRange(float* heights, int width, int length, void* pyramid, void* origin, void* rays, float* maxDistances, void* hits, int start, int end);
+
+        /// <summary>
+        /// Samples every channel of an animation clip at a time, writing channels with a non negative output offset.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnAnimationSampleChannels", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void AnimationSampleChannels(int* keyTimes, float* keyValues, int* channelKeyStarts, int* interpolationTypes, int* outputOffsets, int* cursors, int channelCount, int components, int quaternion, int time, byte* output);
+
+        /// <summary>
+        /// Blends two animation results, returns -1 or the index of the first channel whose blend type isn't supported.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnAnimationBlend", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int AnimationBlend(int operation, float blendFactor, byte* left, byte* right, byte* result, void* channels, int channelCount);
+
+        /// <summary>
+        /// Assigns point and spot lights to the clusters of the depth slices in [<paramref name="start"/>, <paramref name="end"/>), each slice writing its light indices in its own range of <paramref name="sliceIndices"/>.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnLightClusterAssignRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void LightClusterAssignRange(void* grid, void* pointLights, int pointLightCount, void* spotLights, int spotLightCount, void* clusterInfos, int* sliceIndices, int sliceCapacity, int* sliceIndexCounts, int start, int end);
+
+        /// <summary>
+        /// Concatenates the light indices of every depth slice and makes the cluster starts absolute.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnLightClusterMerge", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void LightClusterMerge(void* grid, void* clusterInfos, int* sliceIndices, int sliceCapacity, int* sliceIndexCounts, int* indices);
+
+        /// <summary>
+        /// Resets the occlusion buffer tiles in [<paramref name="start"/>, <paramref name="end"/>).
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOcclusionClearRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void OcclusionClearRange(void* tiles, int start, int end);
+
+        /// <summary>
+        /// Transforms the occluder positions in [<paramref name="start"/>, <paramref name="end"/>) to clip space.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOcclusionTransformVerticesRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void OcclusionTransformVerticesRange(void* worldViewProjection, void* positions, void* clipPositions, int start, int end);
+
+        /// <summary>
+        /// Clips and projects the occluder triangles in [<paramref name="start"/>, <paramref name="end"/>), writing 2 screen triangles per occluder triangle.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOcclusionSetupTrianglesRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void OcclusionSetupTrianglesRange(int width, int height, void* clipPositions, int* indices, void* triangles, int start, int end);
+
+        /// <summary>
+        /// Sorts screen triangles into bands of <paramref name="bandRows"/> tile rows. Returns the number of entries, which were only written if it is at most <paramref name="capacity"/>.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOcclusionBinTriangles", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int OcclusionBinTriangles(void* triangles, int triangleCount, int bandRows, int bandCount, int* binStarts, int* binTriangles, int capacity);
+
+        /// <summary>
+        /// Rasterizes the binned screen triangles of the bands in [<paramref name="start"/>, <paramref name="end"/>) into the occlusion buffer.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOcclusionRasterizeBinsRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void OcclusionRasterizeBinsRange(void* tiles, int width, int height, void* triangles, int* binStarts, int* binTriangles, int bandRows, int start, int end);
+
+        /// <summary>
+        /// Tests a bounding box against the occlusion buffer, returns 0 when it is hidden.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOcclusionTestBox", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int OcclusionTestBox(void* tiles, int width, int height, void* viewProjection, void* box);
+
+        /// <summary>
+        /// Tests the bounding boxes in [<paramref name="start"/>, <paramref name="end"/>) against the occlusion buffer, writing 1 for visible boxes and 0 for hidden ones.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnOcclusionTestBoxesRange", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void OcclusionTestBoxesRange(void* tiles, int width, int height, void* viewProjection, void* boxes, byte* visibility, int start, int end);
+
+        /// <summary>
+        /// Fills <paramref name="stats"/> with the native allocations of libstride, which are only counted when it was built with native memory tracking.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnMemoryGetStats", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe void MemoryGetStats(NativeMemoryStats* stats);
+
+        /// <summary>
+        /// Enables or disables the tracing of the native zones of libstride.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnTraceEnable", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void TraceEnable(bool enabled);
+
+        /// <summary>
+        /// Gets the current time of the clock used by native zones, in seconds.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnTraceSeconds", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern double TraceSeconds();
+
+        /// <summary>
+        /// Moves up to <paramref name="capacity"/> zones traced by libstride to <paramref name="events"/>, and returns their count.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnTraceDrain", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern unsafe int TraceDrain(NativeTraceEvent* events, int capacity);
+
+        /// <summary>
+        /// Gets the number of zones of libstride dropped because a thread traced more zones than its buffer holds between two drains.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnTraceDroppedCount", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern long TraceDroppedCount();
+
+        /// <summary>
+        /// Gets the CPU features the native kernels can use.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnCpuFeatures", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern NativeCpuFeatures CpuFeatures();
+
+        /// <summary>
+        /// Makes the native kernels ignore <paramref name="features"/>, replacing the previously disabled ones, so that tests can compare them with
+        /// their baseline versions. Kernels select their variant again on their next call; <see cref="NativeCpuFeatures.None"/> enables everything again.
+        /// </summary>
+        [SuppressUnmanagedCodeSecurity]
+        [DllImport(Library, EntryPoint = "xnCpuDisableFeatures", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void CpuDisableFeatures(NativeCpuFeatures features);
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System.Runtime.InteropServices;
+
+namespace Stride.Native
+{
+    /// <summary>
+    /// Subsystems native allocations are tagged with, same values as the NP_MEMORY_SUBSYSTEM constants of the native code.
+    /// </summary>
+    internal enum NativeMemorySubsystem
+    {
+        General = 0,
+        Arena = 1,
+        Audio = 2,
+        Codec = 3,
+        Geometry = 4,
+    }
+
+    // Same layout as npMemorySubsystemStats in the native code
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct NativeMemorySubsystemStats
+    {
+        public long LiveBytes;
+        public long PeakBytes;
+        public long AllocationCount;
+        public long FreeCount;
+    }
+
+    /// <summary>
+    /// Allocation counters of a native library, only filled when it was built with native memory tracking.
+    /// </summary>
+    // Same layout as npMemoryStats in the native code
+    [StructLayout(LayoutKind.Sequential)]
+    internal unsafe struct NativeMemoryStats
+    {
+        public const int SubsystemCount = 8;
+        public const int SizeClassCount = 32;
+
+        public int Enabled;
+        private int padding;
+        public NativeMemorySubsystemStats Total;
+        private fixed long subsystems[SubsystemCount * 4];
+
+        /// <summary>
+        /// Number of allocations of [2^(c - 1), 2^c) bytes for each size class c.
+        /// </summary>
+        public fixed long SizeClassCounts[SizeClassCount];
+
+        public NativeMemorySubsystemStats GetSubsystem(NativeMemorySubsystem subsystem)
+        {
+            var index = (int)subsystem * 4;
+            return new NativeMemorySubsystemStats
+            {
+                LiveBytes = subsystems[index],
+                PeakBytes = subsystems[index + 1],
+                AllocationCount = subsystems[index + 2],
+                FreeCount = subsystems[index + 3],
+            };
+        }
+    }
+}
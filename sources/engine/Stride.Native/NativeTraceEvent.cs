@@ -0,0 +1,25 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace Stride.Native
+{
+    /// <summary>
+    /// A zone traced by a native library, times being in seconds of the native clock (see <see cref="NativeInvoke.TraceSeconds"/>).
+    /// </summary>
+    // Same layout as npTraceEvent in the native code
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct NativeTraceEvent
+    {
+        /// <summary>
+        /// The static null terminated name of the zone, which also identifies it.
+        /// </summary>
+        public IntPtr Name;
+        public double Begin;
+        public double End;
+        public int ThreadIndex;
+        private int padding;
+    }
+}
@@ -0,0 +1,435 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "StrideNative.h"
+
+/*
+* Software occlusion culling, following Masked Software Occlusion Culling (Hasselgren, Andersson, Akenine-Moller 2016).
+* The depth buffer is split in 8x4 pixel tiles (width must be a multiple of 8 and height a multiple of 4), and each tile
+* stores two depth layers instead of per pixel depths: every pixel of the tile is at or in front of FarDepth, and the pixels
+* of Mask are at or in front of LayerDepth. Depth is z / w after projection (0 at the near plane), larger is farther.
+* Occluders are rasterized with pixel center coverage, double sided: triangles are first clipped and projected once, then binned
+* by bands of tile rows, so that each band only walks the triangles overlapping it. Occludees are tested conservatively: they are reported
+* visible unless every pixel of their screen rectangle is behind the buffer.
+*/
+
+extern "C" {
+	#define OCCLUSION_TILE_WIDTH 8
+	#define OCCLUSION_TILE_HEIGHT 4
+	#define OCCLUSION_FULL_MASK 0xFFFFFFFFu
+
+	typedef float float8 __attribute__((ext_vector_type(8)));
+	typedef int32_t int8 __attribute__((ext_vector_type(8)));
+
+	typedef struct OcclusionVertex
+	{
+		float X; // Pixels
+		float Y;
+		float Z; // z / w
+	} OcclusionVertex;
+
+	static inline float Min(float left, float right)
+	{
+		return left < right ? left : right;
+	}
+
+	static inline float Max(float left, float right)
+	{
+		return left > right ? left : right;
+	}
+
+	static inline int ClampInt(int value, int minimum, int maximum)
+	{
+		return value < minimum ? minimum : (value > maximum ? maximum : value);
+	}
+
+	// Same as Vector3.Transform(Vector3, Matrix) into a Vector4
+	static inline Vector4 TransformPosition(const FlatMatrix* matrix, float x, float y, float z)
+	{
+		Vector4 result;
+		result.X = x * matrix->M11 + y * matrix->M21 + z * matrix->M31 + matrix->M41;
+		result.Y = x * matrix->M12 + y * matrix->M22 + z * matrix->M32 + matrix->M42;
+		result.Z = x * matrix->M13 + y * matrix->M23 + z * matrix->M33 + matrix->M43;
+		result.W = x * matrix->M14 + y * matrix->M24 + z * matrix->M34 + matrix->M44;
+		return result;
+	}
+
+	static inline OcclusionVertex ProjectVertex(const Vector4& clipPosition, int width, int height)
+	{
+		float inverseW = 1.0f / clipPosition.W;
+		OcclusionVertex vertex;
+		vertex.X = (clipPosition.X * inverseW * 0.5f + 0.5f) * width;
+		vertex.Y = (0.5f - clipPosition.Y * inverseW * 0.5f) * height;
+		vertex.Z = clipPosition.Z * inverseW;
+		return vertex;
+	}
+
+	// Clips a triangle against the near plane (z >= 0 in clip space), returns the vertex count of the resulting polygon
+	static inline int ClipNearPlane(const Vector4* triangle, Vector4* polygon)
+	{
+		int count = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			const Vector4& current = triangle[i];
+			const Vector4& next = triangle[i == 2 ? 0 : i + 1];
+			if (current.Z >= 0.0f)
+				polygon[count++] = current;
+
+			if ((current.Z >= 0.0f) != (next.Z >= 0.0f))
+			{
+				float t = current.Z / (current.Z - next.Z);
+				Vector4 intersection = { current.X + (next.X - current.X) * t, current.Y + (next.Y - current.Y) * t, 0.0f, current.W + (next.W - current.W) * t };
+				polygon[count++] = intersection;
+			}
+		}
+		return count;
+	}
+
+	// Coverage of the 8 pixel centers of a tile row, one bit per pixel
+	static inline uint32_t RowCoverage(const float* edges, float x, float y)
+	{
+		const float8 offsets = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+		int8 inside = -1;
+		for (int edge = 0; edge < 3; edge++)
+		{
+			const float* e = edges + 3 * edge;
+			float8 value = e[0] * (offsets + x) + (e[1] * y + e[2]);
+			inside &= value >= 0.0f;
+		}
+
+		int8 bits = inside & int8{ 1, 2, 4, 8, 16, 32, 64, 128 };
+		int4 bits4 = bits.lo | bits.hi;
+		int2 bits2 = bits4.lo | bits4.hi;
+		return (uint32_t)(bits2.x | bits2.y);
+	}
+
+	// Merges a triangle covering mask with a conservative farthest depth of depth into a tile
+	static inline void UpdateTile(OcclusionTile* tile, uint32_t coverage, float depth)
+	{
+		if (depth >= tile->FarDepth)
+			return;
+
+		if (tile->Mask == 0)
+		{
+			tile->LayerDepth = depth;
+			tile->Mask = coverage;
+		}
+		else if (tile->LayerDepth - depth > tile->FarDepth - tile->LayerDepth)
+		{
+			// Much closer than the working layer: start a new layer with this triangle only
+			tile->LayerDepth = depth;
+			tile->Mask = coverage;
+		}
+		else
+		{
+			tile->LayerDepth = Max(tile->LayerDepth, depth);
+			tile->Mask |= coverage;
+		}
+
+		// Layer covers the whole tile: it becomes the far depth
+		if (tile->Mask == OCCLUSION_FULL_MASK)
+		{
+			tile->FarDepth = tile->LayerDepth;
+			tile->LayerDepth = 0.0f;
+			tile->Mask = 0;
+		}
+	}
+
+	static void RasterizeTriangle(OcclusionTile* tiles, int width, int height, const OcclusionVertex* v, int tileRowStart, int tileRowEnd)
+	{
+		float area = (v[1].X - v[0].X) * (v[2].Y - v[0].Y) - (v[2].X - v[0].X) * (v[1].Y - v[0].Y);
+		if (area == 0.0f)
+			return;
+
+		float minX = Min(Min(v[0].X, v[1].X), v[2].X);
+		float maxX = Max(Max(v[0].X, v[1].X), v[2].X);
+		float minY = Min(Min(v[0].Y, v[1].Y), v[2].Y);
+		float maxY = Max(Max(v[0].Y, v[1].Y), v[2].Y);
+
+		if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+			return;
+
+		int tileCountX = width / OCCLUSION_TILE_WIDTH;
+		int tileStartX = ClampInt((int)Max(minX, 0.0f) / OCCLUSION_TILE_WIDTH, 0, tileCountX);
+		int tileEndX = ClampInt((int)Min(maxX, (float)width) / OCCLUSION_TILE_WIDTH + 1, 0, tileCountX);
+		int tileStartY = ClampInt((int)Max(minY, 0.0f) / OCCLUSION_TILE_HEIGHT, tileRowStart, tileRowEnd);
+		int tileEndY = ClampInt((int)Min(maxY, (float)height) / OCCLUSION_TILE_HEIGHT + 1, tileRowStart, tileRowEnd);
+		if (tileStartX >= tileEndX || tileStartY >= tileEndY)
+			return;
+
+		// Edge functions a * x + b * y + c, positive inside whatever the winding
+		float sign = area > 0.0f ? 1.0f : -1.0f;
+		float edges[9];
+		for (int i = 0; i < 3; i++)
+		{
+			const OcclusionVertex& from = v[i];
+			const OcclusionVertex& to = v[i == 2 ? 0 : i + 1];
+			edges[3 * i + 0] = sign * (from.Y - to.Y);
+			edges[3 * i + 1] = sign * (to.X - from.X);
+			edges[3 * i + 2] = sign * (from.X * to.Y - from.Y * to.X);
+		}
+
+		// Depth plane z = depthX * x + depthY * y + depthC
+		float inverseArea = 1.0f / area;
+		float depthX = ((v[1].Z - v[0].Z) * (v[2].Y - v[0].Y) - (v[2].Z - v[0].Z) * (v[1].Y - v[0].Y)) * inverseArea;
+		float depthY = ((v[2].Z - v[0].Z) * (v[1].X - v[0].X) - (v[1].Z - v[0].Z) * (v[2].X - v[0].X)) * inverseArea;
+		float depthC = v[0].Z - depthX * v[0].X - depthY * v[0].Y;
+		float maxDepth = Max(Max(v[0].Z, v[1].Z), v[2].Z);
+
+		for (int tileY = tileStartY; tileY < tileEndY; tileY++)
+		{
+			float y = (float)(tileY * OCCLUSION_TILE_HEIGHT);
+			for (int tileX = tileStartX; tileX < tileEndX; tileX++)
+			{
+				float x = (float)(tileX * OCCLUSION_TILE_WIDTH);
+
+				uint32_t coverage = 0;
+				for (int row = 0; row < OCCLUSION_TILE_HEIGHT; row++)
+					coverage |= RowCoverage(edges, x, y + row + 0.5f) << (row * OCCLUSION_TILE_WIDTH);
+				if (coverage == 0)
+					continue;
+
+				// Farthest depth of the plane over the tile, bounded by the farthest vertex
+				float cornerX = depthX > 0.0f ? x + OCCLUSION_TILE_WIDTH : x;
+				float cornerY = depthY > 0.0f ? y + OCCLUSION_TILE_HEIGHT : y;
+				float depth = Min(depthX * cornerX + depthY * cornerY + depthC, maxDepth);
+
+				UpdateTile(&tiles[tileY * tileCountX + tileX], coverage, depth);
+			}
+		}
+	}
+
+	/*
+	* Resets tiles [start, end) to an empty depth buffer.
+	*/
+	DLL_EXPORT_API void xnOcclusionClearRange(OcclusionTile* tiles, int start, int end)
+	{
+		for (int i = start; i < end; i++)
+		{
+			tiles[i].Mask = 0;
+			tiles[i].FarDepth = 1.0f;
+			tiles[i].LayerDepth = 0.0f;
+		}
+	}
+
+	/*
+	* Transforms occluder positions [start, end) to clip space.
+	*/
+	DLL_EXPORT_API void xnOcclusionTransformVerticesRange(const Matrix* worldViewProjection, const Vector3* positions, Vector4* clipPositions, int start, int end)
+	{
+		const FlatMatrix* matrix = &worldViewProjection->Flat;
+		for (int i = start; i < end; i++)
+			clipPositions[i] = TransformPosition(matrix, positions[i].X, positions[i].Y, positions[i].Z);
+	}
+
+	/*
+	* Clips and projects occluder triangles [start, end) (3 indices each in clip space positions). Triangle i gives screen
+	* triangles 2 * i and 2 * i + 1 (the second one only when clipping by the near plane makes a quad); culled or unused
+	* screen triangles get an empty tile row range.
+	*/
+	DLL_EXPORT_API void xnOcclusionSetupTrianglesRange(int width, int height, const Vector4* clipPositions, const int32_t* indices, OcclusionTriangle* triangles, int start, int end)
+	{
+		int tileCountY = height / OCCLUSION_TILE_HEIGHT;
+		for (int triangle = start; triangle < end; triangle++)
+		{
+			OcclusionTriangle* output = &triangles[2 * triangle];
+			output[0].TileRowStart = output[0].TileRowEnd = 0;
+			output[1].TileRowStart = output[1].TileRowEnd = 0;
+
+			Vector4 clipTriangle[3] = { clipPositions[indices[3 * triangle]], clipPositions[indices[3 * triangle + 1]], clipPositions[indices[3 * triangle + 2]] };
+
+			// Quick reject when entirely behind the near plane or outside of a side plane
+			int outside = 0x1F;
+			for (int i = 0; i < 3; i++)
+			{
+				const Vector4& p = clipTriangle[i];
+				outside &= (p.Z < 0.0f ? 1 : 0) | (p.X < -p.W ? 2 : 0) | (p.X > p.W ? 4 : 0) | (p.Y < -p.W ? 8 : 0) | (p.Y > p.W ? 16 : 0);
+			}
+			if (outside != 0)
+				continue;
+
+			Vector4 polygon[4];
+			int polygonCount = ClipNearPlane(clipTriangle, polygon);
+
+			OcclusionVertex vertices[4];
+			for (int i = 0; i < polygonCount; i++)
+				vertices[i] = ProjectVertex(polygon[i], width, height);
+
+			for (int i = 2; i < polygonCount; i++)
+			{
+				const OcclusionVertex* fan[3] = { &vertices[0], &vertices[i - 1], &vertices[i] };
+				OcclusionTriangle* screenTriangle = &output[i - 2];
+				for (int j = 0; j < 3; j++)
+				{
+					screenTriangle->Vertices[j].X = fan[j]->X;
+					screenTriangle->Vertices[j].Y = fan[j]->Y;
+					screenTriangle->Vertices[j].Z = fan[j]->Z;
+				}
+
+				float minX = Min(Min(fan[0]->X, fan[1]->X), fan[2]->X);
+				float maxX = Max(Max(fan[0]->X, fan[1]->X), fan[2]->X);
+				float minY = Min(Min(fan[0]->Y, fan[1]->Y), fan[2]->Y);
+				float maxY = Max(Max(fan[0]->Y, fan[1]->Y), fan[2]->Y);
+				if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+					continue;
+
+				// Same rows as RasterizeTriangle
+				screenTriangle->TileRowStart = ClampInt((int)Max(minY, 0.0f) / OCCLUSION_TILE_HEIGHT, 0, tileCountY);
+				screenTriangle->TileRowEnd = ClampInt((int)Min(maxY, (float)height) / OCCLUSION_TILE_HEIGHT + 1, 0, tileCountY);
+			}
+		}
+	}
+
+	/*
+	* Sorts the screen triangles into bands of bandRows tile rows, keeping their order within each band. The triangles of band b
+	* are binTriangles[binStarts[b]] to binTriangles[binStarts[b + 1] - 1] (binStarts holds bandCount + 1 entries).
+	* Returns the number of entries; when it is larger than capacity, binTriangles is left unchanged and must be grown.
+	*/
+	DLL_EXPORT_API int xnOcclusionBinTriangles(const OcclusionTriangle* triangles, int triangleCount, int bandRows, int bandCount, int32_t* binStarts, int32_t* binTriangles, int capacity)
+	{
+		memset(binStarts, 0, sizeof(int32_t) * (bandCount + 1));
+		for (int i = 0; i < triangleCount; i++)
+		{
+			const OcclusionTriangle* triangle = &triangles[i];
+			if (triangle->TileRowStart >= triangle->TileRowEnd)
+				continue;
+			for (int band = triangle->TileRowStart / bandRows; band <= (triangle->TileRowEnd - 1) / bandRows; band++)
+				binStarts[band + 1]++;
+		}
+
+		for (int band = 0; band < bandCount; band++)
+			binStarts[band + 1] += binStarts[band];
+
+		int total = binStarts[bandCount];
+		if (total > capacity)
+			return total;
+
+		// Fill with binStarts as cursors, which leaves binStarts[b] at the start of band b + 1, then shift them back
+		for (int i = 0; i < triangleCount; i++)
+		{
+			const OcclusionTriangle* triangle = &triangles[i];
+			if (triangle->TileRowStart >= triangle->TileRowEnd)
+				continue;
+			for (int band = triangle->TileRowStart / bandRows; band <= (triangle->TileRowEnd - 1) / bandRows; band++)
+				binTriangles[binStarts[band]++] = i;
+		}
+
+		for (int band = bandCount; band > 0; band--)
+			binStarts[band] = binStarts[band - 1];
+		binStarts[0] = 0;
+
+		return total;
+	}
+
+	/*
+	* Rasterizes the binned screen triangles of bands [start, end), see xnOcclusionBinTriangles.
+	* Bands are written independently, so that disjoint ranges can be rasterized concurrently.
+	*/
+	DLL_EXPORT_API void xnOcclusionRasterizeBinsRange(OcclusionTile* tiles, int width, int height, const OcclusionTriangle* triangles, const int32_t* binStarts, const int32_t* binTriangles, int bandRows, int start, int end)
+	{
+		int tileCountY = height / OCCLUSION_TILE_HEIGHT;
+		for (int band = start; band < end; band++)
+		{
+			int tileRowStart = band * bandRows;
+			int tileRowEnd = tileRowStart + bandRows < tileCountY ? tileRowStart + bandRows : tileCountY;
+
+			for (int i = binStarts[band]; i < binStarts[band + 1]; i++)
+			{
+				const OcclusionTriangle* triangle = &triangles[binTriangles[i]];
+				OcclusionVertex vertices[3];
+				for (int j = 0; j < 3; j++)
+				{
+					vertices[j].X = triangle->Vertices[j].X;
+					vertices[j].Y = triangle->Vertices[j].Y;
+					vertices[j].Z = triangle->Vertices[j].Z;
+				}
+				RasterizeTriangle(tiles, width, height, vertices, tileRowStart, tileRowEnd);
+			}
+		}
+	}
+
+	/*
+	* Tests a box against the depth buffer, returns 0 when it is hidden by the occluders and 1 otherwise.
+	* Boxes crossing the near plane or outside of the screen are reported visible.
+	*/
+	DLL_EXPORT_API int xnOcclusionTestBox(const OcclusionTile* tiles, int width, int height, const Matrix* viewProjection, const BoundingBox* box)
+	{
+		const FlatMatrix* matrix = &viewProjection->Flat;
+		float minX = 3.402823466e+38f, minY = 3.402823466e+38f, maxX = -3.402823466e+38f, maxY = -3.402823466e+38f;
+		float minDepth = 3.402823466e+38f;
+
+		for (int corner = 0; corner < 8; corner++)
+		{
+			Vector4 clipPosition = TransformPosition(matrix,
+				(corner & 1) ? box->maximum.X : box->minimum.X,
+				(corner & 2) ? box->maximum.Y : box->minimum.Y,
+				(corner & 4) ? box->maximum.Z : box->minimum.Z);
+			if (clipPosition.Z < 0.0f || clipPosition.W <= 0.0f)
+				return 1;
+
+			OcclusionVertex vertex = ProjectVertex(clipPosition, width, height);
+			minX = Min(minX, vertex.X);
+			maxX = Max(maxX, vertex.X);
+			minY = Min(minY, vertex.Y);
+			maxY = Max(maxY, vertex.Y);
+			minDepth = Min(minDepth, vertex.Z);
+		}
+
+		if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+			return 1;
+
+		// Pixels touched by the box
+		int pixelStartX = ClampInt((int)Max(minX, 0.0f), 0, width);
+		int pixelEndX = ClampInt((int)Min(maxX, (float)width) + 1, 0, width);
+		int pixelStartY = ClampInt((int)Max(minY, 0.0f), 0, height);
+		int pixelEndY = ClampInt((int)Min(maxY, (float)height) + 1, 0, height);
+
+		int tileCountX = width / OCCLUSION_TILE_WIDTH;
+		for (int tileY = pixelStartY / OCCLUSION_TILE_HEIGHT; tileY <= (pixelEndY - 1) / OCCLUSION_TILE_HEIGHT; tileY++)
+		{
+			// Rows of the tile inside the box
+			int rowStart = pixelStartY - tileY * OCCLUSION_TILE_HEIGHT;
+			int rowEnd = pixelEndY - tileY * OCCLUSION_TILE_HEIGHT;
+			rowStart = rowStart > 0 ? rowStart : 0;
+			rowEnd = rowEnd < OCCLUSION_TILE_HEIGHT ? rowEnd : OCCLUSION_TILE_HEIGHT;
+
+			for (int tileX = pixelStartX / OCCLUSION_TILE_WIDTH; tileX <= (pixelEndX - 1) / OCCLUSION_TILE_WIDTH; tileX++)
+			{
+				const OcclusionTile& tile = tiles[tileY * tileCountX + tileX];
+
+				// Use the layer depth when the box only touches pixels of the layer
+				float depth = tile.FarDepth;
+				if (tile.Mask != 0)
+				{
+					int columnStart = pixelStartX - tileX * OCCLUSION_TILE_WIDTH;
+					int columnEnd = pixelEndX - tileX * OCCLUSION_TILE_WIDTH;
+					columnStart = columnStart > 0 ? columnStart : 0;
+					columnEnd = columnEnd < OCCLUSION_TILE_WIDTH ? columnEnd : OCCLUSION_TILE_WIDTH;
+
+					uint32_t rowMask = ((1u << columnEnd) - 1) & ~((1u << columnStart) - 1);
+					uint32_t boxMask = 0;
+					for (int row = rowStart; row < rowEnd; row++)
+						boxMask |= rowMask << (row * OCCLUSION_TILE_WIDTH);
+
+					if ((boxMask & ~tile.Mask) == 0)
+						depth = tile.LayerDepth;
+				}
+
+				if (minDepth < depth)
+					return 1;
+			}
+		}
+
+		return 0;
+	}
+
+	/*
+	* Tests boxes [start, end) against the depth buffer, visibility[i] is set to 1 when box i is visible and 0 otherwise.
+	*/
+	DLL_EXPORT_API void xnOcclusionTestBoxesRange(const OcclusionTile* tiles, int width, int height, const Matrix* viewProjection, const BoundingBox* boxes, uint8_t* visibility, int start, int end)
+	{
+		for (int i = start; i < end; i++)
+			visibility[i] = (uint8_t)xnOcclusionTestBox(tiles, width, height, viewProjection, &boxes[i]);
+	}
+}
@@ -0,0 +1,413 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "StrideNative.h"
+
+/*
+* Particle update kernels. Every particle field is a stream: a pointer to the field of the first particle and a byte stride,
+* which is the particle size for interleaved pools and the field size for SoA pools (contiguous streams take a vectorized path).
+* Range functions only touch particles in [start, end) and can run concurrently on disjoint ranges.
+*/
+
+extern "C" {
+	void xnRadixSortKeys32(uint32_t* keys, uint32_t* indices, int count);
+
+	// MathUtil.ZeroTolerance
+	static const float ParticleZeroTolerance = 1e-6f;
+
+	// ComputeCurveSampler.BakedArraySize
+	#define PARTICLE_CURVE_SIZE 32
+
+	// Same as RandomSeed.GetFloat
+	static inline float RandomSeedGetFloat(uint32_t seed, uint32_t offset)
+	{
+		double random = (double)(uint32_t)(seed + offset);
+		double dotProduct = cos(random) * 23.1406926327792690 + sin(random) * 2.6651441426902251;
+		double denominator = 1e-7 + 256 * dotProduct;
+		double remainder = fmod(123456789.0, denominator);
+		return (float)(remainder - floor(remainder));
+	}
+
+	static inline float* FloatAt(void* stream, int stride, int index)
+	{
+		return (float*)((uint8_t*)stream + (size_t)index * stride);
+	}
+
+	static inline Vector3* Vector3At(void* stream, int stride, int index)
+	{
+		return (Vector3*)((uint8_t*)stream + (size_t)index * stride);
+	}
+
+	static inline uint32_t SeedAt(const void* stream, int stride, int index)
+	{
+		return *(const uint32_t*)((const uint8_t*)stream + (size_t)index * stride);
+	}
+
+	static void AddVector3Range(void* stream, int stride, Vector3 value, int start, int end)
+	{
+		if (stride != sizeof(Vector3))
+		{
+			for (int i = start; i < end; i++)
+			{
+				Vector3* element = Vector3At(stream, stride, i);
+				element->X += value.X;
+				element->Y += value.Y;
+				element->Z += value.Z;
+			}
+			return;
+		}
+
+		// Contiguous: the xyz pattern repeats every 4 particles (3 vectors)
+		float* data = (float*)stream + (size_t)start * 3;
+		int floatCount = (end - start) * 3;
+		float4 pattern0 = { value.X, value.Y, value.Z, value.X };
+		float4 pattern1 = { value.Y, value.Z, value.X, value.Y };
+		float4 pattern2 = { value.Z, value.X, value.Y, value.Z };
+		int i = 0;
+		for (; i + 12 <= floatCount; i += 12)
+		{
+			float4 v0, v1, v2;
+			memcpy(&v0, data + i, sizeof(float4));
+			memcpy(&v1, data + i + 4, sizeof(float4));
+			memcpy(&v2, data + i + 8, sizeof(float4));
+			v0 += pattern0;
+			v1 += pattern1;
+			v2 += pattern2;
+			memcpy(data + i, &v0, sizeof(float4));
+			memcpy(data + i + 4, &v1, sizeof(float4));
+			memcpy(data + i + 8, &v2, sizeof(float4));
+		}
+
+		const float components[3] = { value.X, value.Y, value.Z };
+		for (; i < floatCount; i++)
+			data[i] += components[i % 3];
+	}
+
+	/*
+	* Ages particles like ParticleEmitter: remaining life decreases by dt over a lifetime picked between minimumLifetime and
+	* maximumLifetime by the particle's random seed. dead[i] is set for particles to remove (see xnParticleRemoveDead).
+	* With delayDeath, particles reaching the end of their life are kept one more update at a life of ZeroTolerance.
+	*/
+	DLL_EXPORT_API void xnParticleUpdateLifetimeRange(void* life, int lifeStride, const void* randomSeeds, int seedStride, float minimumLifetime, float maximumLifetime, float dt, int delayDeath, uint8_t* dead, int start, int end)
+	{
+		float lifeStep = maximumLifetime - minimumLifetime;
+		for (int i = start; i < end; i++)
+		{
+			float* remainingLife = FloatAt(life, lifeStride, i);
+			if (*remainingLife > 1)
+				*remainingLife = 1;
+
+			float startingLife = minimumLifetime + lifeStep * RandomSeedGetFloat(SeedAt(randomSeeds, seedStride, i), 0);
+
+			uint8_t isDead = 0;
+			if (*remainingLife <= ParticleZeroTolerance)
+			{
+				isDead = 1;
+			}
+			else if ((*remainingLife -= (dt / startingLife)) <= ParticleZeroTolerance)
+			{
+				if (delayDeath)
+					*remainingLife = ParticleZeroTolerance;
+				else
+					isDead = 1;
+			}
+			dead[i] = isDead;
+		}
+	}
+
+	/*
+	* Removes dead particles by moving the last living particle in their place, in the same order as ParticlePool's enumerator.
+	* A particle is made of streamCount streams of elementSizes[s] bytes (one stream for interleaved pools).
+	* dead is updated along with the particles. Returns the new particle count.
+	*/
+	DLL_EXPORT_API int xnParticleRemoveDead(uint8_t* dead, int count, void* const* streams, const int* elementSizes, int streamCount)
+	{
+		int i = 0;
+		while (i < count)
+		{
+			if (!dead[i])
+			{
+				i++;
+				continue;
+			}
+
+			// Check the moved particle at the same index next
+			count--;
+			if (i != count)
+			{
+				for (int s = 0; s < streamCount; s++)
+				{
+					uint8_t* data = (uint8_t*)streams[s];
+					memcpy(data + (size_t)i * elementSizes[s], data + (size_t)count * elementSizes[s], elementSizes[s]);
+				}
+				dead[i] = dead[count];
+			}
+		}
+
+		return count;
+	}
+
+	/*
+	* Copies positions to oldPositions (optional) then moves them by velocities * dt (optional).
+	*/
+	DLL_EXPORT_API void xnParticleIntegrateRange(void* positions, int positionStride, void* oldPositions, int oldPositionStride, const void* velocities, int velocityStride, float dt, int start, int end)
+	{
+		if (oldPositions)
+		{
+			if (positionStride == sizeof(Vector3) && oldPositionStride == sizeof(Vector3))
+			{
+				memcpy(Vector3At(oldPositions, oldPositionStride, start), Vector3At(positions, positionStride, start), (size_t)(end - start) * sizeof(Vector3));
+			}
+			else
+			{
+				for (int i = start; i < end; i++)
+					*Vector3At(oldPositions, oldPositionStride, i) = *Vector3At(positions, positionStride, i);
+			}
+		}
+
+		if (!velocities)
+			return;
+
+		int i = start;
+		if (positionStride == sizeof(Vector3) && velocityStride == sizeof(Vector3))
+		{
+			// Contiguous: same operation on every component
+			float* position = (float*)positions + (size_t)start * 3;
+			const float* velocity = (const float*)velocities + (size_t)start * 3;
+			int floatCount = (end - start) * 3;
+			int j = 0;
+			for (; j + 4 <= floatCount; j += 4)
+			{
+				float4 p, v;
+				memcpy(&p, position + j, sizeof(float4));
+				memcpy(&v, velocity + j, sizeof(float4));
+				p += v * dt;
+				memcpy(position + j, &p, sizeof(float4));
+			}
+			for (; j < floatCount; j++)
+				position[j] += velocity[j] * dt;
+			return;
+		}
+
+		for (; i < end; i++)
+		{
+			Vector3* position = Vector3At(positions, positionStride, i);
+			const Vector3* velocity = Vector3At((void*)velocities, velocityStride, i);
+			position->X += velocity->X * dt;
+			position->Y += velocity->Y * dt;
+			position->Z += velocity->Z * dt;
+		}
+	}
+
+	/*
+	* Constant acceleration, like UpdaterGravity: velocities change by acceleration * dt and positions by its integral over dt.
+	*/
+	DLL_EXPORT_API void xnParticleApplyGravityRange(void* positions, int positionStride, void* velocities, int velocityStride, const Vector3* acceleration, float dt, int start, int end)
+	{
+		Vector3 deltaVelocity = { acceleration->X * dt, acceleration->Y * dt, acceleration->Z * dt };
+		float halfDt = dt * 0.5f;
+		Vector3 deltaPosition = { deltaVelocity.X * halfDt, deltaVelocity.Y * halfDt, deltaVelocity.Z * halfDt };
+
+		AddVector3Range(positions, positionStride, deltaPosition, start, end);
+		AddVector3Range(velocities, velocityStride, deltaVelocity, start, end);
+	}
+
+	static inline Vector3 RotateVector3(const Vector4* rotation, Vector3 v)
+	{
+		// v + 2 * cross(q, cross(q, v) + w * v)
+		float cx = rotation->Y * v.Z - rotation->Z * v.Y + rotation->W * v.X;
+		float cy = rotation->Z * v.X - rotation->X * v.Z + rotation->W * v.Y;
+		float cz = rotation->X * v.Y - rotation->Y * v.X + rotation->W * v.Z;
+		Vector3 result;
+		result.X = v.X + 2.0f * (rotation->Y * cz - rotation->Z * cy);
+		result.Y = v.Y + 2.0f * (rotation->Z * cx - rotation->X * cz);
+		result.Z = v.Z + 2.0f * (rotation->X * cy - rotation->Y * cx);
+		return result;
+	}
+
+	// Same as FieldFalloff.GetStrength
+	static inline float FalloffStrength(const ParticleForceField* field, float distance)
+	{
+		if (distance <= field->FalloffStart)
+			return field->StrengthInside;
+
+		if (distance >= field->FalloffEnd)
+			return field->StrengthOutside;
+
+		float lerp = (distance - field->FalloffStart) / (field->FalloffEnd / field->FalloffStart);
+		return field->StrengthInside + (field->StrengthOutside - field->StrengthInside) * lerp;
+	}
+
+	/*
+	* Force field, like UpdaterForceField without a shape (Shape = 0) or with a sphere shape (Shape = 1).
+	*/
+	DLL_EXPORT_API void xnParticleApplyForceFieldRange(void* positions, int positionStride, void* velocities, int velocityStride, const ParticleForceField* field, float dt, int start, int end)
+	{
+		float directToPosition = 1.0f - field->EnergyConservation;
+		float halfDt = dt * 0.5f;
+
+		for (int i = start; i < end; i++)
+		{
+			Vector3* position = Vector3At(positions, positionStride, i);
+			Vector3* velocity = Vector3At(velocities, velocityStride, i);
+
+			Vector3 alongAxis = { 0.0f, 1.0f, 0.0f };
+			Vector3 awayAxis = { 0.0f, 0.0f, 1.0f };
+			Vector3 aroundAxis = { 1.0f, 0.0f, 0.0f };
+			float forceMagnitude = 1.0f;
+
+			if (field->Shape == 1)
+			{
+				alongAxis = field->MainAxis;
+
+				Vector3 offset = { position->X - field->Position.X, position->Y - field->Position.Y, position->Z - field->Position.Z };
+				float length = sqrtf(offset.X * offset.X + offset.Y * offset.Y + offset.Z * offset.Z);
+				awayAxis = offset;
+				// Same as Vector3.Normalize
+				if (length > ParticleZeroTolerance)
+				{
+					float inverseLength = 1.0f / length;
+					awayAxis.X *= inverseLength;
+					awayAxis.Y *= inverseLength;
+					awayAxis.Z *= inverseLength;
+				}
+
+				aroundAxis.X = alongAxis.Y * awayAxis.Z - alongAxis.Z * awayAxis.Y;
+				aroundAxis.Y = alongAxis.Z * awayAxis.X - alongAxis.X * awayAxis.Z;
+				aroundAxis.Z = alongAxis.X * awayAxis.Y - alongAxis.Y * awayAxis.X;
+
+				Vector3 local = RotateVector3(&field->InverseRotation, offset);
+				local.X /= field->Size.X;
+				local.Y /= field->Size.Y;
+				local.Z /= field->Size.Z;
+				float distance = sqrtf(local.X * local.X + local.Y * local.Y + local.Z * local.Z) / field->Radius;
+
+				forceMagnitude = FalloffStrength(field, distance);
+			}
+			forceMagnitude *= dt * field->ParentScale;
+
+			Vector3 force;
+			force.X = (field->ForceFixed.X + alongAxis.X * field->ForceDirected + aroundAxis.X * field->ForceVortex + awayAxis.X * field->ForceRepulsive) * forceMagnitude;
+			force.Y = (field->ForceFixed.Y + alongAxis.Y * field->ForceDirected + aroundAxis.Y * field->ForceVortex + awayAxis.Y * field->ForceRepulsive) * forceMagnitude;
+			force.Z = (field->ForceFixed.Z + alongAxis.Z * field->ForceDirected + aroundAxis.Z * field->ForceVortex + awayAxis.Z * field->ForceRepulsive) * forceMagnitude;
+
+			// Conserved energy goes to the velocity, the rest directly to the position
+			Vector3 conserved = { force.X * field->EnergyConservation, force.Y * field->EnergyConservation, force.Z * field->EnergyConservation };
+			velocity->X += conserved.X;
+			velocity->Y += conserved.Y;
+			velocity->Z += conserved.Z;
+
+			position->X += conserved.X * halfDt + force.X * directToPosition;
+			position->Y += conserved.Y * halfDt + force.Y * directToPosition;
+			position->Z += conserved.Z * halfDt + force.Z * directToPosition;
+		}
+	}
+
+	// Same as ComputeCurveSampler.Evaluate over a baked curve of PARTICLE_CURVE_SIZE values
+	static inline void SampleCurve(const float* curve, int components, float t, float* result)
+	{
+		float indexLocation = t * (PARTICLE_CURVE_SIZE - 1);
+		int index = (int)indexLocation;
+		float lerp = indexLocation - index;
+
+		int thisIndex = index < 0 ? 0 : (index > PARTICLE_CURVE_SIZE - 1 ? PARTICLE_CURVE_SIZE - 1 : index);
+		int nextIndex = index + 1 > PARTICLE_CURVE_SIZE - 1 ? PARTICLE_CURVE_SIZE - 1 : (index + 1 < 0 ? 0 : index + 1);
+
+		// ComputeCurveSamplerFloat.Linear and MathUtil.Lerp round differently
+		if (components == 1)
+		{
+			result[0] = curve[thisIndex] + (curve[nextIndex] - curve[thisIndex]) * lerp;
+			return;
+		}
+
+		for (int c = 0; c < components; c++)
+			result[c] = (1.0f - lerp) * curve[thisIndex * components + c] + lerp * curve[nextIndex * components + c];
+	}
+
+	/*
+	* Writes curve values (components floats each) sampled at 1 - remaining life, like UpdaterSizeOverTime (scale = world scale)
+	* and UpdaterColorOverTime (4 components, premultiplyAlpha). With optionalCurve, the result is interpolated between both
+	* curves by the particle's random seed at seedOffset.
+	*/
+	DLL_EXPORT_API void xnParticleSampleCurveRange(const void* life, int lifeStride, const float* curve, const float* optionalCurve, int components, const void* randomSeeds, int seedStride, uint32_t seedOffset, float scale, int premultiplyAlpha, void* output, int outputStride, int start, int end)
+	{
+		float value[4], optionalValue[4];
+		if (components > 4)
+			components = 4;
+
+		for (int i = start; i < end; i++)
+		{
+			float t = 1.0f - *FloatAt((void*)life, lifeStride, i);
+			SampleCurve(curve, components, t, value);
+
+			if (optionalCurve)
+			{
+				SampleCurve(optionalCurve, components, t, optionalValue);
+				float lerp = RandomSeedGetFloat(SeedAt(randomSeeds, seedStride, i), seedOffset);
+				if (components == 1)
+				{
+					value[0] = value[0] + (optionalValue[0] - value[0]) * lerp;
+				}
+				else
+				{
+					for (int c = 0; c < components; c++)
+						value[c] = (1.0f - lerp) * value[c] + lerp * optionalValue[c];
+				}
+			}
+
+			if (premultiplyAlpha && components == 4)
+			{
+				value[0] *= value[3];
+				value[1] *= value[3];
+				value[2] *= value[3];
+			}
+
+			float* result = FloatAt(output, outputStride, i);
+			for (int c = 0; c < components; c++)
+				result[c] = value[c] * scale;
+		}
+	}
+
+	// Maps a float to an unsigned key with the same ordering: negative floats have all their bits flipped, positive ones only the sign
+	static inline uint32_t FloatToSortableKey(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		uint32_t mask = (uint32_t)((int32_t)bits >> 31) | 0x80000000u;
+		return bits ^ mask;
+	}
+
+	/*
+	* Sorts the particles in ascending order of the dot product of a field (components floats) with weights, like
+	* ParticleSorterDepth (position and depth axis) and ParticleSorterAge (life and -1). The sort is stable.
+	* indices receives the sorted particle indices; keys is scratch memory for count keys.
+	*/
+	DLL_EXPORT_API void xnParticleSortByKey(const void* values, int valueStride, int components, const float* weights, uint32_t* keys, uint32_t* indices, int count)
+	{
+		const uint8_t* value = (const uint8_t*)values;
+		if (components == 3)
+		{
+			for (int i = 0; i < count; i++, value += valueStride)
+			{
+				const Vector3* v = (const Vector3*)value;
+				keys[i] = FloatToSortableKey(v->X * weights[0] + v->Y * weights[1] + v->Z * weights[2]);
+				indices[i] = i;
+			}
+		}
+		else
+		{
+			for (int i = 0; i < count; i++, value += valueStride)
+			{
+				const float* v = (const float*)value;
+				float key = 0.0f;
+				for (int c = 0; c < components; c++)
+					key += v[c] * weights[c];
+				keys[i] = FloatToSortableKey(key);
+				indices[i] = i;
+			}
+		}
+
+		xnRadixSortKeys32(keys, indices, count);
+	}
+}
@@ -14,3 +14,6 @@ using System.Runtime.CompilerServices;
 [assembly: InternalsVisibleTo("Stride.Audio")]
 [assembly: InternalsVisibleTo("Stride.Engine")]
 [assembly: InternalsVisibleTo("Stride.Assets")]
+[assembly: InternalsVisibleTo("Stride.Particles")]
+[assembly: InternalsVisibleTo("Stride.Physics")]
+[assembly: InternalsVisibleTo("Stride.Engine.Tests")]
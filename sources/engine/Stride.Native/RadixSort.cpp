@@ -0,0 +1,121 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeMemory.h"
+#include "StrideNative.h"
+
+// Stable LSD radix sort, one byte per pass. Histograms of all the passes are built in a single pass over the keys,
+// and passes where every key has the same digit are skipped (e.g. unused high bytes).
+template<typename TKey>
+static npBool RadixSort(TKey* keys, uint32_t* indices, int count)
+{
+	const int passCount = sizeof(TKey);
+	if (count <= 1)
+		return true;
+
+	uint32_t histograms[passCount][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (int i = 0; i < count; i++)
+	{
+		TKey key = keys[i];
+		for (int pass = 0; pass < passCount; pass++)
+		{
+			histograms[pass][(key >> (8 * pass)) & 0xff]++;
+		}
+	}
+
+	// The frame arena may fail to be created or to grow, the heap is tried before giving up
+	npArena* arena = npFrameArena();
+	npArenaMarker marker = {};
+	TKey* tempKeys = NULL;
+	uint32_t* tempIndices = NULL;
+	if (arena)
+	{
+		marker = npArenaGetMarker(arena);
+		tempKeys = (TKey*)npArenaAlloc(arena, sizeof(TKey) * count);
+		tempIndices = (uint32_t*)npArenaAlloc(arena, sizeof(uint32_t) * count);
+		if (!tempKeys || !tempIndices)
+			npArenaRewind(arena, marker);
+	}
+
+	npBool onHeap = !tempKeys || !tempIndices;
+	if (onHeap)
+	{
+		tempKeys = (TKey*)malloc(sizeof(TKey) * count);
+		tempIndices = (uint32_t*)malloc(sizeof(uint32_t) * count);
+		if (!tempKeys || !tempIndices)
+		{
+			free(tempKeys);
+			free(tempIndices);
+			return false;
+		}
+	}
+
+	TKey* sourceKeys = keys;
+	uint32_t* sourceIndices = indices;
+	TKey* destinationKeys = tempKeys;
+	uint32_t* destinationIndices = tempIndices;
+
+	for (int pass = 0; pass < passCount; pass++)
+	{
+		uint32_t* histogram = histograms[pass];
+		int shift = 8 * pass;
+		if (histogram[(keys[0] >> shift) & 0xff] == (uint32_t)count)
+			continue;
+
+		// Turn counts into start offsets
+		uint32_t offset = 0;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			uint32_t digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			TKey key = sourceKeys[i];
+			uint32_t position = histogram[(key >> shift) & 0xff]++;
+			destinationKeys[position] = key;
+			destinationIndices[position] = sourceIndices[i];
+		}
+
+		TKey* swapKeys = sourceKeys; sourceKeys = destinationKeys; destinationKeys = swapKeys;
+		uint32_t* swapIndices = sourceIndices; sourceIndices = destinationIndices; destinationIndices = swapIndices;
+	}
+
+	if (sourceKeys != keys)
+	{
+		memcpy(keys, sourceKeys, sizeof(TKey) * count);
+		memcpy(indices, sourceIndices, sizeof(uint32_t) * count);
+	}
+
+	if (onHeap)
+	{
+		free(tempKeys);
+		free(tempIndices);
+	}
+	else
+	{
+		npArenaRewind(arena, marker);
+	}
+	return true;
+}
+
+extern "C" {
+	/*
+	* Sorts keys in ascending order and applies the same permutation to indices.
+	* The sort is stable: elements with equal keys keep their relative order.
+	* Returns false when out of memory, keys and indices are then left unchanged.
+	*/
+	DLL_EXPORT_API npBool xnRadixSortKeys(uint64_t* keys, uint32_t* indices, int count)
+	{
+		return RadixSort(keys, indices, count);
+	}
+
+	DLL_EXPORT_API npBool xnRadixSortKeys32(uint32_t* keys, uint32_t* indices, int count)
+	{
+		return RadixSort(keys, indices, count);
+	}
+}
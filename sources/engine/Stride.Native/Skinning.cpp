@@ -0,0 +1,66 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeFloat4.h"
+#include "StrideNative.h"
+
+extern "C" {
+	// Matrix stores its columns contiguously, so this accumulates columns
+	static inline void AddWeightedBone(const Matrix* bone, float weight, float4* columns)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			columns[i] += weight * npLoadF4(&bone->Array[4 * i]);
+		}
+	}
+
+	/*
+	* Skins vertices [start, end) on the CPU, the same way as TransformationSkinning and NormalMeshSkinning do on the GPU.
+	* blendIndices and blendWeights hold 4 entries per vertex, indexing bonePalette. Normals are renormalized.
+	* Vertices are independent, so disjoint ranges can be processed concurrently.
+	*/
+	DLL_EXPORT_API void xnSkinVerticesRange(const Matrix* bonePalette, const uint16_t* blendIndices, const float* blendWeights, const VertexPositionNormalTexture* in, VertexPositionNormalTexture* out, int start, int end)
+	{
+		for (int i = start; i < end; i++)
+		{
+			const uint16_t* indices = &blendIndices[4 * i];
+			const float* weights = &blendWeights[4 * i];
+
+			// Blend matrix = sum of the bone matrices weighted by the blend weights, accumulated by columns then transposed to rows
+			float4 rows[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			AddWeightedBone(&bonePalette[indices[0]], weights[0], rows);
+			AddWeightedBone(&bonePalette[indices[1]], weights[1], rows);
+			AddWeightedBone(&bonePalette[indices[2]], weights[2], rows);
+			AddWeightedBone(&bonePalette[indices[3]], weights[3], rows);
+			npTransposeF4(rows);
+
+			const VertexPositionNormalTexture* source = &in[i];
+			VertexPositionNormalTexture* destination = &out[i];
+
+			float4 position = source->Position.X * rows[0] + source->Position.Y * rows[1] + source->Position.Z * rows[2] + rows[3];
+			position /= position.w;
+
+			float4 normal = source->Normal.X * rows[0] + source->Normal.Y * rows[1] + source->Normal.Z * rows[2];
+			normal.w = 0.0f;
+			float lengthSquared = normal.x * normal.x + normal.y * normal.y + normal.z * normal.z;
+			if (lengthSquared > 0.0f)
+				normal /= sqrtf(lengthSquared);
+
+			// Write after reading so that in and out may be the same buffer
+			Vector2 textureCoordinate = source->TextureCoordinate;
+			destination->Position.X = position.x;
+			destination->Position.Y = position.y;
+			destination->Position.Z = position.z;
+			destination->Normal.X = normal.x;
+			destination->Normal.Y = normal.y;
+			destination->Normal.Z = normal.z;
+			destination->TextureCoordinate = textureCoordinate;
+		}
+	}
+
+	DLL_EXPORT_API void xnSkinVertices(const Matrix* bonePalette, const uint16_t* blendIndices, const float* blendWeights, const VertexPositionNormalTexture* in, VertexPositionNormalTexture* out, int count)
+	{
+		xnSkinVerticesRange(bonePalette, blendIndices, blendWeights, in, out, 0, count);
+	}
+}
@@ -0,0 +1,139 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeMath.h"
+#include "../../../deps/NativePath/NativeFloat4.h"
+#include "../../../deps/NativePath/NativeCpu.h"
+#include "StrideNative.h"
+
+extern "C" {
+	// Same corners as SpriteBatch.CornerOffsets: (0,0) (1,0) (1,1) (0,1)
+	static const float SpriteCornerX[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+	static const float SpriteCornerY[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	// Expands up to 4 sprites into 16 vertices, one sprite per vector lane
+	NP_CPU_INLINE void BuildSpriteVertices4(const uint8_t* drawInfos, int stride, int count, VertexPositionColorTextureSwizzle* vertices)
+	{
+		// Unused lanes replicate the first sprite so every lane holds valid values
+		const SpriteDrawInfo* s0 = (const SpriteDrawInfo*)drawInfos;
+		const SpriteDrawInfo* s1 = count > 1 ? (const SpriteDrawInfo*)(drawInfos + stride) : s0;
+		const SpriteDrawInfo* s2 = count > 2 ? (const SpriteDrawInfo*)(drawInfos + 2 * stride) : s0;
+		const SpriteDrawInfo* s3 = count > 3 ? (const SpriteDrawInfo*)(drawInfos + 3 * stride) : s0;
+
+#define GATHER_F4(field) float4{ s0->field, s1->field, s2->field, s3->field }
+#define GATHER_I4(field) int4{ s0->field, s1->field, s2->field, s3->field }
+		float4 sourceX = GATHER_F4(Source.x);
+		float4 sourceY = GATHER_F4(Source.y);
+		float4 sourceWidth = GATHER_F4(Source.width);
+		float4 sourceHeight = GATHER_F4(Source.height);
+		float4 destinationX = GATHER_F4(Destination.x);
+		float4 destinationY = GATHER_F4(Destination.y);
+		float4 destinationWidth = GATHER_F4(Destination.width);
+		float4 destinationHeight = GATHER_F4(Destination.height);
+		float4 originX = GATHER_F4(Origin.X);
+		float4 originY = GATHER_F4(Origin.Y);
+		float4 rotation = GATHER_F4(Rotation);
+		float4 textureWidth = GATHER_F4(TextureSize.X);
+		float4 textureHeight = GATHER_F4(TextureSize.Y);
+		int4 effects = GATHER_I4(SpriteEffects);
+		int4 orientation = GATHER_I4(Orientation);
+#undef GATHER_F4
+#undef GATHER_I4
+
+		float4 deltaX = 1.0f / textureWidth;
+		float4 deltaY = 1.0f / textureHeight;
+
+		// Rotations below float.Epsilon are ignored, as in the managed version
+		float4 sinRotation, cosRotation;
+		npSinCosF4(rotation, &sinRotation, &cosRotation);
+		int4 rotated = (float4)((int4)rotation & 0x7fffffff) > __FLT_DENORM_MIN__;
+		sinRotation = npSelectF4(rotated, sinRotation, 0.0f);
+		cosRotation = npSelectF4(rotated, cosRotation, 1.0f);
+
+		originX /= npSelectF4(sourceWidth > __FLT_DENORM_MIN__, sourceWidth, __FLT_DENORM_MIN__);
+		originY /= npSelectF4(sourceHeight > __FLT_DENORM_MIN__, sourceHeight, __FLT_DENORM_MIN__);
+
+		float4 positionX[4], positionY[4], textureU[4], textureV[4];
+		for (int j = 0; j < 4; j++)
+		{
+			float4 cornerX = (SpriteCornerX[j] - originX) * destinationWidth;
+			float4 cornerY = (SpriteCornerY[j] - originY) * destinationHeight;
+			positionX[j] = destinationX + cornerX * cosRotation - cornerY * sinRotation;
+			positionY[j] = destinationY + cornerX * sinRotation + cornerY * cosRotation;
+
+			// Flips and 90 degrees orientation only permute the texture corners: index = ((j ^ effects) + orientation) % 4
+			int4 corner = ((j ^ effects) + orientation) & 3;
+			float4 textureCornerX = __builtin_convertvector((corner ^ (corner >> 1)) & 1, float4);
+			float4 textureCornerY = __builtin_convertvector(corner >> 1, float4);
+			textureU[j] = (sourceX + textureCornerX * sourceWidth) * deltaX;
+			textureV[j] = (sourceY + textureCornerY * sourceHeight) * deltaY;
+		}
+
+		for (int k = 0; k < count; k++)
+		{
+			const SpriteDrawInfo* drawInfo = (const SpriteDrawInfo*)(drawInfos + k * stride);
+			float swizzle = (float)drawInfo->Swizzle;
+
+			for (int j = 0; j < 4; j++, vertices++)
+			{
+				vertices->Position.X = positionX[j][k];
+				vertices->Position.Y = positionY[j][k];
+				vertices->Position.Z = drawInfo->Depth;
+				vertices->Position.W = 1.0f;
+				vertices->ColorScale = drawInfo->ColorScale;
+				vertices->ColorAdd = drawInfo->ColorAdd;
+				vertices->TextureCoordinate.X = textureU[j][k];
+				vertices->TextureCoordinate.Y = textureV[j][k];
+				vertices->Swizzle = swizzle;
+			}
+		}
+	}
+
+	NP_CPU_INLINE void BuildSpriteVertices(const uint8_t* drawInfos, int stride, int count, VertexPositionColorTextureSwizzle* vertices)
+	{
+		for (int i = 0; i < count; i += 4)
+		{
+			BuildSpriteVertices4(drawInfos, stride, count - i < 4 ? count - i : 4, vertices);
+			drawInfos += 4 * stride;
+			vertices += 16;
+		}
+	}
+
+	typedef void (*BuildSpriteVerticesDelegate)(const uint8_t* drawInfos, int stride, int count, VertexPositionColorTextureSwizzle* vertices);
+
+	static void BuildSpriteVerticesDefault(const uint8_t* drawInfos, int stride, int count, VertexPositionColorTextureSwizzle* vertices)
+	{
+		BuildSpriteVertices(drawInfos, stride, count, vertices);
+	}
+
+#ifdef NP_CPU_X86
+	// Same 4-wide code, compiled with VEX encoding and FMA contraction of the corner and texture coordinate math
+	NP_TARGET_AVX2 static void BuildSpriteVerticesAvx2(const uint8_t* drawInfos, int stride, int count, VertexPositionColorTextureSwizzle* vertices)
+	{
+		BuildSpriteVertices(drawInfos, stride, count, vertices);
+	}
+#endif
+
+	static const npCpuVariant BuildSpriteVerticesVariants[] =
+	{
+#ifdef NP_CPU_X86
+		{ NP_CPU_TARGET_AVX2, (void*)BuildSpriteVerticesAvx2 },
+#endif
+		{ 0, (void*)BuildSpriteVerticesDefault },
+	};
+
+	static npCpuSlot BuildSpriteVerticesSlot;
+
+	// drawInfos is walked with the given byte stride so that SpriteDrawInfo embedded in larger records can be read in place
+	DLL_EXPORT_API void xnSpriteBatchBuildVerticesStrided(const SpriteDrawInfo* drawInfos, int stride, int count, VertexPositionColorTextureSwizzle* vertices)
+	{
+		BuildSpriteVerticesDelegate buildSpriteVertices = (BuildSpriteVerticesDelegate)npCpuDispatch(&BuildSpriteVerticesSlot, BuildSpriteVerticesVariants, sizeof(BuildSpriteVerticesVariants) / sizeof(BuildSpriteVerticesVariants[0]));
+		buildSpriteVertices((const uint8_t*)drawInfos, stride, count, vertices);
+	}
+
+	DLL_EXPORT_API void xnSpriteBatchBuildVertices(const SpriteDrawInfo* drawInfos, int count, VertexPositionColorTextureSwizzle* vertices)
+	{
+		xnSpriteBatchBuildVerticesStrided(drawInfos, sizeof(SpriteDrawInfo), count, vertices);
+	}
+}
@@ -18,8 +18,23 @@
 #define DLL_EXPORT_API
 #endif
 
+/*
+* Kernels never start threads of their own. The ones worth splitting export a *Range entry point
+* working on [start, end), which managed code spreads over the engine threads with Dispatcher.ForBatched.
+*/
+
 #include "../../deps/NativePath/standard/math.h"
 
+#if !defined(__clang__)
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XN_MATRIX_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define XN_MATRIX_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -58,144 +73,205 @@ typedef struct Matrix
 
 
 
-inline void xnMatrixInvert(Matrix* m)
+/*
+* 4-wide float helpers shared by the matrix kernels below.
+* Clang vector extensions are preferred since they lower to SSE/AVX or NEON depending on the target and need no
+* intrinsic headers (we build with -nobuiltininc on Windows). Other compilers use SSE or NEON intrinsics directly,
+* with a scalar fallback for anything else.
+*/
+#if defined(__clang__)
+
+typedef float4 xnFloat4;
+
+inline xnFloat4 xnFloat4Load(const float* p) { xnFloat4 v; memcpy(&v, p, sizeof(xnFloat4)); return v; }
+inline void xnFloat4Store(float* p, xnFloat4 v) { memcpy(p, &v, sizeof(xnFloat4)); }
+inline xnFloat4 xnFloat4Splat(float s) { return (xnFloat4)s; }
+inline float xnFloat4GetX(xnFloat4 v) { return v.x; }
+inline xnFloat4 xnFloat4Add(xnFloat4 a, xnFloat4 b) { return a + b; }
+inline xnFloat4 xnFloat4Sub(xnFloat4 a, xnFloat4 b) { return a - b; }
+inline xnFloat4 xnFloat4Mul(xnFloat4 a, xnFloat4 b) { return a * b; }
+inline xnFloat4 xnFloat4UnpackLo(xnFloat4 a, xnFloat4 b) { return __builtin_shufflevector(a, b, 0, 4, 1, 5); }
+inline xnFloat4 xnFloat4UnpackHi(xnFloat4 a, xnFloat4 b) { return __builtin_shufflevector(a, b, 2, 6, 3, 7); }
+inline xnFloat4 xnFloat4SwapHalves(xnFloat4 a) { return __builtin_shufflevector(a, a, 2, 3, 0, 1); }
+inline xnFloat4 xnFloat4SwapPairs(xnFloat4 a) { return __builtin_shufflevector(a, a, 1, 0, 3, 2); }
+
+#elif defined(XN_MATRIX_SSE)
+
+typedef __m128 xnFloat4;
+
+inline xnFloat4 xnFloat4Load(const float* p) { return _mm_loadu_ps(p); }
+inline void xnFloat4Store(float* p, xnFloat4 v) { _mm_storeu_ps(p, v); }
+inline xnFloat4 xnFloat4Splat(float s) { return _mm_set1_ps(s); }
+inline float xnFloat4GetX(xnFloat4 v) { return _mm_cvtss_f32(v); }
+inline xnFloat4 xnFloat4Add(xnFloat4 a, xnFloat4 b) { return _mm_add_ps(a, b); }
+inline xnFloat4 xnFloat4Sub(xnFloat4 a, xnFloat4 b) { return _mm_sub_ps(a, b); }
+inline xnFloat4 xnFloat4Mul(xnFloat4 a, xnFloat4 b) { return _mm_mul_ps(a, b); }
+inline xnFloat4 xnFloat4UnpackLo(xnFloat4 a, xnFloat4 b) { return _mm_unpacklo_ps(a, b); }
+inline xnFloat4 xnFloat4UnpackHi(xnFloat4 a, xnFloat4 b) { return _mm_unpackhi_ps(a, b); }
+inline xnFloat4 xnFloat4SwapHalves(xnFloat4 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)); }
+inline xnFloat4 xnFloat4SwapPairs(xnFloat4 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+#elif defined(XN_MATRIX_NEON)
+
+typedef float32x4_t xnFloat4;
+
+inline xnFloat4 xnFloat4Load(const float* p) { return vld1q_f32(p); }
+inline void xnFloat4Store(float* p, xnFloat4 v) { vst1q_f32(p, v); }
+inline xnFloat4 xnFloat4Splat(float s) { return vdupq_n_f32(s); }
+inline float xnFloat4GetX(xnFloat4 v) { return vgetq_lane_f32(v, 0); }
+inline xnFloat4 xnFloat4Add(xnFloat4 a, xnFloat4 b) { return vaddq_f32(a, b); }
+inline xnFloat4 xnFloat4Sub(xnFloat4 a, xnFloat4 b) { return vsubq_f32(a, b); }
+inline xnFloat4 xnFloat4Mul(xnFloat4 a, xnFloat4 b) { return vmulq_f32(a, b); }
+inline xnFloat4 xnFloat4UnpackLo(xnFloat4 a, xnFloat4 b) { return vzipq_f32(a, b).val[0]; }
+inline xnFloat4 xnFloat4UnpackHi(xnFloat4 a, xnFloat4 b) { return vzipq_f32(a, b).val[1]; }
+inline xnFloat4 xnFloat4SwapHalves(xnFloat4 a) { return vextq_f32(a, a, 2); }
+inline xnFloat4 xnFloat4SwapPairs(xnFloat4 a) { return vrev64q_f32(a); }
+
+#else
+
+typedef struct xnFloat4
 {
-#ifdef __clang__
-	typedef float float16 __attribute__((ext_vector_type(16)));
-	//https://github.com/niswegmann/small-matrix-inverse/blob/master/invert4x4_llvm.h
+	float V[4];
+} xnFloat4;
+
+inline xnFloat4 xnFloat4Make(float x, float y, float z, float w) { xnFloat4 r; r.V[0] = x; r.V[1] = y; r.V[2] = z; r.V[3] = w; return r; }
+inline xnFloat4 xnFloat4Load(const float* p) { return xnFloat4Make(p[0], p[1], p[2], p[3]); }
+inline void xnFloat4Store(float* p, xnFloat4 v) { p[0] = v.V[0]; p[1] = v.V[1]; p[2] = v.V[2]; p[3] = v.V[3]; }
+inline xnFloat4 xnFloat4Splat(float s) { return xnFloat4Make(s, s, s, s); }
+inline float xnFloat4GetX(xnFloat4 v) { return v.V[0]; }
+inline xnFloat4 xnFloat4Add(xnFloat4 a, xnFloat4 b) { return xnFloat4Make(a.V[0] + b.V[0], a.V[1] + b.V[1], a.V[2] + b.V[2], a.V[3] + b.V[3]); }
+inline xnFloat4 xnFloat4Sub(xnFloat4 a, xnFloat4 b) { return xnFloat4Make(a.V[0] - b.V[0], a.V[1] - b.V[1], a.V[2] - b.V[2], a.V[3] - b.V[3]); }
+inline xnFloat4 xnFloat4Mul(xnFloat4 a, xnFloat4 b) { return xnFloat4Make(a.V[0] * b.V[0], a.V[1] * b.V[1], a.V[2] * b.V[2], a.V[3] * b.V[3]); }
+inline xnFloat4 xnFloat4UnpackLo(xnFloat4 a, xnFloat4 b) { return xnFloat4Make(a.V[0], b.V[0], a.V[1], b.V[1]); }
+inline xnFloat4 xnFloat4UnpackHi(xnFloat4 a, xnFloat4 b) { return xnFloat4Make(a.V[2], b.V[2], a.V[3], b.V[3]); }
+inline xnFloat4 xnFloat4SwapHalves(xnFloat4 a) { return xnFloat4Make(a.V[2], a.V[3], a.V[0], a.V[1]); }
+inline xnFloat4 xnFloat4SwapPairs(xnFloat4 a) { return xnFloat4Make(a.V[1], a.V[0], a.V[3], a.V[2]); }
 
-	float16 rsrc, rdst;
-	float16* src = &rsrc;
-	float16* dst = &rdst;
+#endif
 
-	memcpy(src, m, sizeof(float16));
+/*
+* Inverts matrix into out. out may point to matrix.
+*/
+inline void xnMatrixInvert(const Matrix* matrix, Matrix* out)
+{
+	//https://github.com/niswegmann/small-matrix-inverse/blob/master/invert4x4_llvm.h
 
-	float4 row0, row1, row2, row3;
-	float4 col0, col1, col2, col3;
-	float4 det, tmp1;
+	xnFloat4 row0, row1, row2, row3;
+	xnFloat4 col0, col1, col2, col3;
+	xnFloat4 det, tmp1;
 
 	/* Load matrix: */
 
-	col0 = ((float4 *)src)[0];
-	col1 = ((float4 *)src)[1];
-	col2 = ((float4 *)src)[2];
-	col3 = ((float4 *)src)[3];
+	col0 = xnFloat4Load(&matrix->Array[0]);
+	col1 = xnFloat4Load(&matrix->Array[4]);
+	col2 = xnFloat4Load(&matrix->Array[8]);
+	col3 = xnFloat4Load(&matrix->Array[12]);
 
 	/* Transpose: */
 
-	tmp1 = shufflevector(col0, col2, 0, 4, 1, 5);
-	row1 = shufflevector(col1, col3, 0, 4, 1, 5);
+	tmp1 = xnFloat4UnpackLo(col0, col2);
+	row1 = xnFloat4UnpackLo(col1, col3);
 
-	row0 = shufflevector(tmp1, row1, 0, 4, 1, 5);
-	row1 = shufflevector(tmp1, row1, 2, 6, 3, 7);
+	row0 = xnFloat4UnpackLo(tmp1, row1);
+	row1 = xnFloat4UnpackHi(tmp1, row1);
 
-	tmp1 = shufflevector(col0, col2, 2, 6, 3, 7);
-	row3 = shufflevector(col1, col3, 2, 6, 3, 7);
+	tmp1 = xnFloat4UnpackHi(col0, col2);
+	row3 = xnFloat4UnpackHi(col1, col3);
 
-	row2 = shufflevector(tmp1, row3, 0, 4, 1, 5);
-	row3 = shufflevector(tmp1, row3, 2, 6, 3, 7);
+	row2 = xnFloat4UnpackLo(tmp1, row3);
+	row3 = xnFloat4UnpackHi(tmp1, row3);
 
 	/* Compute adjoint: */
 
-	row1 = shufflevector(row1, row1, 2, 3, 0, 1);
-	row3 = shufflevector(row3, row3, 2, 3, 0, 1);
+	row1 = xnFloat4SwapHalves(row1);
+	row3 = xnFloat4SwapHalves(row3);
 
-	tmp1 = row2 * row3;
-	tmp1 = shufflevector(tmp1, tmp1, 1, 0, 7, 6);
+	tmp1 = xnFloat4Mul(row2, row3);
+	tmp1 = xnFloat4SwapPairs(tmp1);
 
-	col0 = row1 * tmp1;
-	col1 = row0 * tmp1;
+	col0 = xnFloat4Mul(row1, tmp1);
+	col1 = xnFloat4Mul(row0, tmp1);
 
-	tmp1 = shufflevector(tmp1, tmp1, 2, 3, 4, 5);
+	tmp1 = xnFloat4SwapHalves(tmp1);
 
-	col0 = row1 * tmp1 - col0;
-	col1 = row0 * tmp1 - col1;
-	col1 = shufflevector(col1, col1, 2, 3, 4, 5);
+	col0 = xnFloat4Sub(xnFloat4Mul(row1, tmp1), col0);
+	col1 = xnFloat4Sub(xnFloat4Mul(row0, tmp1), col1);
+	col1 = xnFloat4SwapHalves(col1);
 
-	tmp1 = row1 * row2;
-	tmp1 = shufflevector(tmp1, tmp1, 1, 0, 7, 6);
+	tmp1 = xnFloat4Mul(row1, row2);
+	tmp1 = xnFloat4SwapPairs(tmp1);
 
-	col0 = row3 * tmp1 + col0;
-	col3 = row0 * tmp1;
+	col0 = xnFloat4Add(xnFloat4Mul(row3, tmp1), col0);
+	col3 = xnFloat4Mul(row0, tmp1);
 
-	tmp1 = shufflevector(tmp1, tmp1, 2, 3, 4, 5);
+	tmp1 = xnFloat4SwapHalves(tmp1);
 
-	col0 = col0 - row3 * tmp1;
-	col3 = row0 * tmp1 - col3;
-	col3 = shufflevector(col3, col3, 2, 3, 4, 5);
+	col0 = xnFloat4Sub(col0, xnFloat4Mul(row3, tmp1));
+	col3 = xnFloat4Sub(xnFloat4Mul(row0, tmp1), col3);
+	col3 = xnFloat4SwapHalves(col3);
 
-	tmp1 = shufflevector(row1, row1, 2, 3, 4, 5) * row3;
-	tmp1 = shufflevector(tmp1, tmp1, 1, 0, 7, 6);
-	row2 = shufflevector(row2, row2, 2, 3, 4, 5);
+	tmp1 = xnFloat4Mul(xnFloat4SwapHalves(row1), row3);
+	tmp1 = xnFloat4SwapPairs(tmp1);
+	row2 = xnFloat4SwapHalves(row2);
 
-	col0 = row2 * tmp1 + col0;
-	col2 = row0 * tmp1;
+	col0 = xnFloat4Add(xnFloat4Mul(row2, tmp1), col0);
+	col2 = xnFloat4Mul(row0, tmp1);
 
-	tmp1 = shufflevector(tmp1, tmp1, 2, 3, 4, 5);
+	tmp1 = xnFloat4SwapHalves(tmp1);
 
-	col0 = col0 - row2 * tmp1;
-	col2 = row0 * tmp1 - col2;
-	col2 = shufflevector(col2, col2, 2, 3, 4, 5);
+	col0 = xnFloat4Sub(col0, xnFloat4Mul(row2, tmp1));
+	col2 = xnFloat4Sub(xnFloat4Mul(row0, tmp1), col2);
+	col2 = xnFloat4SwapHalves(col2);
 
-	tmp1 = row0 * row1;
-	tmp1 = shufflevector(tmp1, tmp1, 1, 0, 7, 6);
+	tmp1 = xnFloat4Mul(row0, row1);
+	tmp1 = xnFloat4SwapPairs(tmp1);
 
-	col2 = row3 * tmp1 + col2;
-	col3 = row2 * tmp1 - col3;
+	col2 = xnFloat4Add(xnFloat4Mul(row3, tmp1), col2);
+	col3 = xnFloat4Sub(xnFloat4Mul(row2, tmp1), col3);
 
-	tmp1 = shufflevector(tmp1, tmp1, 2, 3, 4, 5);
+	tmp1 = xnFloat4SwapHalves(tmp1);
 
-	col2 = row3 * tmp1 - col2;
-	col3 = col3 - row2 * tmp1;
+	col2 = xnFloat4Sub(xnFloat4Mul(row3, tmp1), col2);
+	col3 = xnFloat4Sub(col3, xnFloat4Mul(row2, tmp1));
 
-	tmp1 = row0 * row3;
-	tmp1 = shufflevector(tmp1, tmp1, 1, 0, 7, 6);
+	tmp1 = xnFloat4Mul(row0, row3);
+	tmp1 = xnFloat4SwapPairs(tmp1);
 
-	col1 = col1 - row2 * tmp1;
-	col2 = row1 * tmp1 + col2;
+	col1 = xnFloat4Sub(col1, xnFloat4Mul(row2, tmp1));
+	col2 = xnFloat4Add(xnFloat4Mul(row1, tmp1), col2);
 
-	tmp1 = shufflevector(tmp1, tmp1, 2, 3, 4, 5);
+	tmp1 = xnFloat4SwapHalves(tmp1);
 
-	col1 = row2 * tmp1 + col1;
-	col2 = col2 - row1 * tmp1;
+	col1 = xnFloat4Add(xnFloat4Mul(row2, tmp1), col1);
+	col2 = xnFloat4Sub(col2, xnFloat4Mul(row1, tmp1));
 
-	tmp1 = row0 * row2;
-	tmp1 = shufflevector(tmp1, tmp1, 1, 0, 7, 6);
+	tmp1 = xnFloat4Mul(row0, row2);
+	tmp1 = xnFloat4SwapPairs(tmp1);
 
-	col1 = row3 * tmp1 + col1;
-	col3 = col3 - row1 * tmp1;
+	col1 = xnFloat4Add(xnFloat4Mul(row3, tmp1), col1);
+	col3 = xnFloat4Sub(col3, xnFloat4Mul(row1, tmp1));
 
-	tmp1 = shufflevector(tmp1, tmp1, 2, 3, 4, 5);
+	tmp1 = xnFloat4SwapHalves(tmp1);
 
-	col1 = col1 - row3 * tmp1;
-	col3 = row1 * tmp1 + col3;
+	col1 = xnFloat4Sub(col1, xnFloat4Mul(row3, tmp1));
+	col3 = xnFloat4Add(xnFloat4Mul(row1, tmp1), col3);
 
 	/* Compute determinant: */
 
-	det = row0 * col0;
-	det = shufflevector(det, det, 2, 3, 4, 5) + det;
-	det = shufflevector(det, det, 1, 0, 7, 6) + det;
-
-	/* Compute reciprocal of determinant: */
+	det = xnFloat4Mul(row0, col0);
+	det = xnFloat4Add(xnFloat4SwapHalves(det), det);
+	det = xnFloat4Add(xnFloat4SwapPairs(det), det);
 
-	det = 1.0f / det;
+	/* Compute reciprocal of determinant (all lanes hold the same value): */
 
-	/* Multiply matrix of cofactors with reciprocal of determinant: */
+	det = xnFloat4Splat(1.0f / xnFloat4GetX(det));
 
-	col0 = col0 * det;
-	col1 = col1 * det;
-	col2 = col2 * det;
-	col3 = col3 * det;
+	/* Multiply matrix of cofactors with reciprocal of determinant and store: */
 
-	/* Store inverted matrix: */
-
-	((float4 *)dst)[0] = col0;
-	((float4 *)dst)[1] = col1;
-	((float4 *)dst)[2] = col2;
-	((float4 *)dst)[3] = col3;
-
-	memcpy(m, dst, sizeof(float16));
-#endif
+	xnFloat4Store(&out->Array[0], xnFloat4Mul(col0, det));
+	xnFloat4Store(&out->Array[4], xnFloat4Mul(col1, det));
+	xnFloat4Store(&out->Array[8], xnFloat4Mul(col2, det));
+	xnFloat4Store(&out->Array[12], xnFloat4Mul(col3, det));
 }
 
 inline void xnMatrixTranspose(Matrix* m)
@@ -211,38 +287,52 @@ inline void xnMatrixTranspose(Matrix* m)
 	temp = m->Flat.M43; m->Flat.M43 = m->Flat.M34; m->Flat.M34 = temp;
 }
 
-inline void xnMatrixMultiply(Matrix* left, Matrix* right, Matrix* out)
+/*
+* Computes out = left * right, using the FlatMatrix element naming. out may point to left or right.
+*/
+inline void xnMatrixMultiply(const Matrix* left, const Matrix* right, Matrix* out)
 {
-	xnMatrixTranspose(left);
-	xnMatrixTranspose(right);
-#ifdef __clang__
-	float4 row1, row2, row3, row4;
-	memcpy(&row1, &right->Array[0], sizeof(float4));
-	memcpy(&row2, &right->Array[4], sizeof(float4));
-	memcpy(&row3, &right->Array[8], sizeof(float4));
-	memcpy(&row4, &right->Array[12], sizeof(float4));
+	// Every column of the result is a linear combination of the columns of left (4 contiguous floats each)
+	xnFloat4 col0 = xnFloat4Load(&left->Array[0]);
+	xnFloat4 col1 = xnFloat4Load(&left->Array[4]);
+	xnFloat4 col2 = xnFloat4Load(&left->Array[8]);
+	xnFloat4 col3 = xnFloat4Load(&left->Array[12]);
+
+	xnFloat4 result[4];
 	for (int i = 0; i < 4; i++)
 	{
-		float4 brod1, brod2, brod3, brod4;
-		brod1.xyzw = left->Array[4 * i + 0];
-		brod2.xyzw = left->Array[4 * i + 1];
-		brod3.xyzw = left->Array[4 * i + 2];
-		brod4.xyzw = left->Array[4 * i + 3];
-
-		float4 b1xr1 = brod1 * row1;
-		float4 b2xr2 = brod2 * row2;
-		float4 b3xr3 = brod3 * row3;
-		float4 b4xr4 = brod4 * row4;
-		float4 b12pr12 = b1xr1 + b2xr2;
-		float4 b34pr34 = b3xr3 + b4xr4;
-		float4 row = b12pr12 + b34pr34;
-
-		memcpy(&out->Array[4 * i], &row, sizeof(float4));
-	}	
-#endif
-	xnMatrixTranspose(left);
-	xnMatrixTranspose(right);
-	xnMatrixTranspose(out);
+		const float* weights = &right->Array[4 * i];
+		xnFloat4 c01 = xnFloat4Add(xnFloat4Mul(col0, xnFloat4Splat(weights[0])), xnFloat4Mul(col1, xnFloat4Splat(weights[1])));
+		xnFloat4 c23 = xnFloat4Add(xnFloat4Mul(col2, xnFloat4Splat(weights[2])), xnFloat4Mul(col3, xnFloat4Splat(weights[3])));
+		result[i] = xnFloat4Add(c01, c23);
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		xnFloat4Store(&out->Array[4 * i], result[i]);
+	}
+}
+
+/*
+* Computes out[i] = left[i] * right[i] for count matrices.
+*/
+inline void xnMatrixMultiplyArray(const Matrix* left, const Matrix* right, Matrix* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		xnMatrixMultiply(&left[i], &right[i], &out[i]);
+	}
+}
+
+/*
+* Computes out[i] = inverse(matrices[i]) for count matrices.
+*/
+inline void xnMatrixInvertArray(const Matrix* matrices, Matrix* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		xnMatrixInvert(&matrices[i], &out[i]);
+	}
 }
 
 
@@ -289,6 +379,118 @@ typedef struct BoundingBox
 	Vector3 maximum;
 } BoundingBox;
 
+typedef struct Plane
+{
+	Vector3 Normal;
+	float D;
+} Plane;
+
+typedef struct Ray
+{
+	Vector3 Position;
+	Vector3 Direction;
+} Ray;
+
+typedef struct BvhNode
+{
+	Vector3 Minimum;
+	uint32_t LeftOrFirst; // Interior nodes: first child, the second one follows. Leaves: first primitive.
+	Vector3 Maximum;
+	uint32_t Count; // Primitive count, 0 for interior nodes
+} BvhNode;
+
+typedef struct BvhBuildTask
+{
+	uint32_t NodeIndex;
+	uint32_t DescendantStart;
+	uint32_t First;
+	uint32_t Count;
+} BvhBuildTask;
+
+typedef struct BvhHit
+{
+	float Distance;
+	uint32_t PrimitiveIndex;
+	float U;
+	float V;
+} BvhHit;
+
+typedef struct HeightfieldHit
+{
+	Vector3 Position;
+	float Distance; // Negative on miss
+	Vector3 Normal;
+	int32_t Cell; // z * (width - 1) + x, -1 on miss
+} HeightfieldHit;
+
+typedef struct AnimationBlendChannel
+{
+	int32_t Offset;
+	int32_t Size;
+	int32_t BlendType;
+} AnimationBlendChannel;
+
+typedef struct LightClusterGrid
+{
+	Matrix Projection;
+	int32_t ClusterCountX;
+	int32_t ClusterCountY;
+	int32_t ClusterSlices;
+	int32_t ClusterSize; // In pixels
+	Vector2 ViewSize;
+	float DepthScale;
+	float DepthBias;
+} LightClusterGrid;
+
+typedef struct LightClusterLight
+{
+	Vector3 Position; // View space
+	float Radius;
+	Vector3 Direction; // View space, spot lights only
+	float CosAngle; // Cosine of the half cone angle, spot lights only
+} LightClusterLight;
+
+typedef struct OcclusionTile
+{
+	uint32_t Mask; // Pixels of the layer, bit row * 8 + column
+	float FarDepth; // Farthest depth of the whole tile
+	float LayerDepth; // Farthest depth of the pixels of the layer
+} OcclusionTile;
+
+typedef struct OcclusionTriangle
+{
+	Vector3 Vertices[3]; // Pixels, z / w
+	int32_t TileRowStart; // Tile rows covered by the screen bounds, empty when the triangle is culled
+	int32_t TileRowEnd;
+} OcclusionTriangle;
+
+typedef struct TransformSRT
+{
+	Vector3 Scale;
+	Vector4 Rotation;
+	Vector3 Position;
+} TransformSRT;
+
+typedef struct ParticleForceField
+{
+	Vector3 Position;
+	Vector4 InverseRotation;
+	Vector3 Size;
+	Vector3 MainAxis;
+	float Radius;
+	int32_t Shape; // 0: no shape, 1: sphere
+	float StrengthInside;
+	float FalloffStart;
+	float StrengthOutside;
+	float FalloffEnd;
+	float EnergyConservation;
+	float ForceDirected;
+	float ForceVortex;
+	float ForceRepulsive;
+	Vector3 ForceFixed;
+	float ParentScale;
+} ParticleForceField;
+
 typedef struct VertexPositionColorTextureSwizzle
 {
 	Vector4 Position;
@@ -0,0 +1,45 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#define NATIVEPATH_TRACE_IMPLEMENTATION
+#include "../../../deps/NativePath/NativeTrace.h"
+#include "StrideNative.h"
+
+/*
+* Zones traced by libstride with NP_TRACE_SCOPE, drained every frame by the managed profiler.
+*/
+
+extern "C" {
+	/*
+	* Enables or disables the tracing of native zones.
+	*/
+	DLL_EXPORT_API void xnTraceEnable(npBool enabled)
+	{
+		npTraceEnable(enabled);
+	}
+
+	/*
+	* Current time of the clock used by the zones, in seconds.
+	*/
+	DLL_EXPORT_API double xnTraceSeconds()
+	{
+		return npSeconds();
+	}
+
+	/*
+	* Moves up to capacity traced zones to events, returns their count.
+	*/
+	DLL_EXPORT_API int xnTraceDrain(npTraceEvent* events, int capacity)
+	{
+		return npTraceDrain(events, capacity);
+	}
+
+	/*
+	* Number of zones dropped because a thread traced more than NP_TRACE_BUFFER_SIZE zones between two drains.
+	*/
+	DLL_EXPORT_API int64_t xnTraceDroppedCount()
+	{
+		return npTraceDroppedCount();
+	}
+}
@@ -0,0 +1,134 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "../../../deps/NativePath/NativeCpu.h"
+#include "StrideNative.h"
+
+extern "C" {
+	// Matrix stores its columns contiguously: Array[4 * column + row] holds M(row + 1)(column + 1)
+	NP_CPU_INLINE void StoreColumn(Matrix* matrix, int column, float4 value)
+	{
+		memcpy(&matrix->Array[4 * column], &value, sizeof(float4));
+	}
+
+	// Builds the local matrices of up to 4 consecutive transforms (one per vector lane) and multiplies each of them by its parent world matrix
+	NP_CPU_INLINE void PropagateTransforms4(const int* parentIndex, const TransformSRT* localSRT, Matrix* localOut, Matrix* worldOut, int start, int count)
+	{
+		// Unused lanes replicate the first transform so every lane holds valid values
+		const TransformSRT* t0 = &localSRT[start];
+		const TransformSRT* t1 = count > 1 ? &localSRT[start + 1] : t0;
+		const TransformSRT* t2 = count > 2 ? &localSRT[start + 2] : t0;
+		const TransformSRT* t3 = count > 3 ? &localSRT[start + 3] : t0;
+
+#define GATHER_F4(field) float4{ t0->field, t1->field, t2->field, t3->field }
+		float4 scaleX = GATHER_F4(Scale.X);
+		float4 scaleY = GATHER_F4(Scale.Y);
+		float4 scaleZ = GATHER_F4(Scale.Z);
+		float4 rotationX = GATHER_F4(Rotation.X);
+		float4 rotationY = GATHER_F4(Rotation.Y);
+		float4 rotationZ = GATHER_F4(Rotation.Z);
+		float4 rotationW = GATHER_F4(Rotation.W);
+		float4 positionX = GATHER_F4(Position.X);
+		float4 positionY = GATHER_F4(Position.Y);
+		float4 positionZ = GATHER_F4(Position.Z);
+#undef GATHER_F4
+
+		// Same as Matrix.Transformation(scaling, rotation, translation)
+		float4 xx = rotationX * rotationX;
+		float4 yy = rotationY * rotationY;
+		float4 zz = rotationZ * rotationZ;
+		float4 xy = rotationX * rotationY;
+		float4 zw = rotationZ * rotationW;
+		float4 zx = rotationZ * rotationX;
+		float4 yw = rotationY * rotationW;
+		float4 yz = rotationY * rotationZ;
+		float4 xw = rotationX * rotationW;
+
+		float4 m11 = (1.0f - (2.0f * (yy + zz))) * scaleX;
+		float4 m12 = (2.0f * (xy + zw)) * scaleX;
+		float4 m13 = (2.0f * (zx - yw)) * scaleX;
+		float4 m21 = (2.0f * (xy - zw)) * scaleY;
+		float4 m22 = (1.0f - (2.0f * (zz + xx))) * scaleY;
+		float4 m23 = (2.0f * (yz + xw)) * scaleY;
+		float4 m31 = (2.0f * (zx + yw)) * scaleZ;
+		float4 m32 = (2.0f * (yz - xw)) * scaleZ;
+		float4 m33 = (1.0f - (2.0f * (yy + xx))) * scaleZ;
+
+		// Lanes are resolved in order, so a parent may also be one of the previous transforms of this group
+		for (int k = 0; k < count; k++)
+		{
+			Matrix* world = &worldOut[start + k];
+			int parent = parentIndex[start + k];
+
+			// Rows are (m11, m12, m13, 0), (m21, m22, m23, 0), (m31, m32, m33, 0) and (position, 1)
+			Matrix local;
+			StoreColumn(&local, 0, float4{ m11[k], m21[k], m31[k], positionX[k] });
+			StoreColumn(&local, 1, float4{ m12[k], m22[k], m32[k], positionY[k] });
+			StoreColumn(&local, 2, float4{ m13[k], m23[k], m33[k], positionZ[k] });
+			StoreColumn(&local, 3, float4{ 0.0f, 0.0f, 0.0f, 1.0f });
+
+			if (localOut)
+				localOut[start + k] = local;
+
+			if (parent < 0)
+			{
+				*world = local;
+				continue;
+			}
+
+			// world = local * parentWorld
+			xnMatrixMultiply(&local, &worldOut[parent], world);
+		}
+	}
+
+	NP_CPU_INLINE void PropagateTransformsRange(const int* parentIndex, const TransformSRT* localSRT, Matrix* localOut, Matrix* worldOut, int start, int end)
+	{
+		for (int i = start; i < end; i += 4)
+		{
+			PropagateTransforms4(parentIndex, localSRT, localOut, worldOut, i, end - i < 4 ? end - i : 4);
+		}
+	}
+
+	typedef void (*PropagateTransformsRangeDelegate)(const int* parentIndex, const TransformSRT* localSRT, Matrix* localOut, Matrix* worldOut, int start, int end);
+
+	static void PropagateTransformsRangeDefault(const int* parentIndex, const TransformSRT* localSRT, Matrix* localOut, Matrix* worldOut, int start, int end)
+	{
+		PropagateTransformsRange(parentIndex, localSRT, localOut, worldOut, start, end);
+	}
+
+#ifdef NP_CPU_X86
+	// Same 4-wide code, with the local matrix math and the xnMatrixMultiply products inlined as VEX encoded instructions
+	NP_TARGET_AVX2 static void PropagateTransformsRangeAvx2(const int* parentIndex, const TransformSRT* localSRT, Matrix* localOut, Matrix* worldOut, int start, int end)
+	{
+		PropagateTransformsRange(parentIndex, localSRT, localOut, worldOut, start, end);
+	}
+#endif
+
+	static const npCpuVariant PropagateTransformsRangeVariants[] =
+	{
+#ifdef NP_CPU_X86
+		{ NP_CPU_TARGET_AVX2, (void*)PropagateTransformsRangeAvx2 },
+#endif
+		{ 0, (void*)PropagateTransformsRangeDefault },
+	};
+
+	static npCpuSlot PropagateTransformsRangeSlot;
+
+	/*
+	* Computes the world matrices of transforms [start, end), and their local matrices if localOut is not null.
+	* parentIndex[i] is the index of the parent of transform i, or -1 for a root, and parents must be stored before their children
+	* (e.g. sorted by depth). Transforms of a same depth level only depend on previous levels, so disjoint ranges of one level
+	* can be processed concurrently once the previous levels are done.
+	*/
+	DLL_EXPORT_API void xnTransformPropagateRange(const int* parentIndex, const TransformSRT* localSRT, Matrix* localOut, Matrix* worldOut, int start, int end)
+	{
+		PropagateTransformsRangeDelegate propagateTransformsRange = (PropagateTransformsRangeDelegate)npCpuDispatch(&PropagateTransformsRangeSlot, PropagateTransformsRangeVariants, sizeof(PropagateTransformsRangeVariants) / sizeof(PropagateTransformsRangeVariants[0]));
+		propagateTransformsRange(parentIndex, localSRT, localOut, worldOut, start, end);
+	}
+
+	DLL_EXPORT_API void xnTransformPropagate(const int* parentIndex, const TransformSRT* localSRT, Matrix* localOut, Matrix* worldOut, int count)
+	{
+		xnTransformPropagateRange(parentIndex, localSRT, localOut, worldOut, 0, count);
+	}
+}
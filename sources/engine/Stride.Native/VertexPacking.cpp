@@ -0,0 +1,202 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+#include "../../../deps/NativePath/NativePath.h"
+#include "StrideNative.h"
+
+/*
+* Converts float vertex streams to compact encodings. Every entry point reads count elements every inputStride bytes
+* and writes them every outputStride bytes, so interleaved vertex buffers can be packed in place of a new layout.
+* The matching shader decode is in VertexQuantization.sdsl.
+*/
+
+extern "C" {
+	static inline float4 SelectF4(int4 mask, float4 a, float4 b)
+	{
+		return (float4)(((int4)a & mask) | ((int4)b & ~mask));
+	}
+
+	static inline int4 SelectI4(int4 mask, int4 a, int4 b)
+	{
+		return (a & mask) | (b & ~mask);
+	}
+
+	static inline float4 SignNotZero(float4 v)
+	{
+		return (float4)(((int4)v & (int)0x80000000) | (int4)(float4)1.0f);
+	}
+
+	// Round to nearest, ties away from zero (inputs are already clamped to the output range)
+	static inline int4 RoundToInt(float4 v)
+	{
+		return __builtin_convertvector(v + (float4)(((int4)v & (int)0x80000000) | (int4)(float4)0.5f), int4);
+	}
+
+	// IEEE half conversion with round to nearest even, overflow to infinity and NaN preserved
+	// Based on https://gist.github.com/rygorous/2156668 (float_to_half_fast3_rtne)
+	static inline int4 FloatToHalf4(float4 value)
+	{
+		const int f32Infinity = 255 << 23;
+		const int f16Max = (127 + 16) << 23;
+		const int denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+		int4 bits = (int4)value;
+		int4 sign = bits & (int)0x80000000;
+		bits ^= sign;
+
+		// Overflow: infinity, or quiet NaN when the input was a NaN
+		int4 overflowResult = SelectI4(bits > f32Infinity, (int4)0x7e00, (int4)0x7c00);
+
+		// Denormals: let the FPU align and round the mantissa
+		int4 denormalResult = (int4)((float4)bits + (float4)((int4)denormMagic)) - denormMagic;
+
+		// Normals: rebias the exponent and round the mantissa to nearest even
+		int4 mantissaOdd = (bits >> 13) & 1;
+		int4 normalResult = (bits + (0xfff - ((127 - 15) << 23)) + mantissaOdd) >> 13;
+
+		int4 result = SelectI4(bits < (113 << 23), denormalResult, normalResult);
+		result = SelectI4(bits >= f16Max, overflowResult, result);
+		return result | (int4)((uint4)sign >> 16);
+	}
+
+	// Octahedral mapping of unit vectors to [-1;1]^2 [Cigolle et al. 2014, "A Survey of Efficient Representations for Independent Unit Vectors"]
+	static inline void OctahedralEncode4(float4 x, float4 y, float4 z, float4* u, float4* v)
+	{
+		float4 absX = (float4)((int4)x & 0x7fffffff);
+		float4 absY = (float4)((int4)y & 0x7fffffff);
+		float4 absZ = (float4)((int4)z & 0x7fffffff);
+		float4 norm = absX + absY + absZ;
+		norm = SelectF4(norm > 0.0f, norm, 1.0f);
+
+		float4 px = x / norm;
+		float4 py = y / norm;
+
+		// Fold the lower hemisphere over the diagonals
+		int4 lower = z < 0.0f;
+		float4 foldedX = (1.0f - (float4)((int4)py & 0x7fffffff)) * SignNotZero(px);
+		float4 foldedY = (1.0f - (float4)((int4)px & 0x7fffffff)) * SignNotZero(py);
+		*u = SelectF4(lower, foldedX, px);
+		*v = SelectF4(lower, foldedY, py);
+	}
+
+	static inline int4 ToSnorm16(float4 v)
+	{
+		v = SelectF4(v > 1.0f, 1.0f, SelectF4(v < -1.0f, -1.0f, v));
+		return RoundToInt(v * 32767.0f);
+	}
+
+	/*
+	* Vector2 -> 2 x half (R16G16_Float), typically texture coordinates.
+	*/
+	DLL_EXPORT_API void xnPackHalf2(const void* input, int inputStride, void* output, int outputStride, int count)
+	{
+		const uint8_t* source = (const uint8_t*)input;
+		uint8_t* destination = (uint8_t*)output;
+		for (int i = 0; i < count; i += 2)
+		{
+			const Vector2* a = (const Vector2*)(source + i * inputStride);
+			const Vector2* b = i + 1 < count ? (const Vector2*)(source + (i + 1) * inputStride) : a;
+
+			int4 halves = FloatToHalf4(float4{ a->X, a->Y, b->X, b->Y });
+
+			uint16_t* packedA = (uint16_t*)(destination + i * outputStride);
+			packedA[0] = (uint16_t)halves.x;
+			packedA[1] = (uint16_t)halves.y;
+			if (i + 1 < count)
+			{
+				uint16_t* packedB = (uint16_t*)(destination + (i + 1) * outputStride);
+				packedB[0] = (uint16_t)halves.z;
+				packedB[1] = (uint16_t)halves.w;
+			}
+		}
+	}
+
+	/*
+	* Vector3 unit normal -> 2 x snorm16 (R16G16_SNorm), octahedral encoded.
+	*/
+	DLL_EXPORT_API void xnPackNormalOctahedral(const void* input, int inputStride, void* output, int outputStride, int count)
+	{
+		const uint8_t* source = (const uint8_t*)input;
+		uint8_t* destination = (uint8_t*)output;
+		for (int i = 0; i < count; i += 4)
+		{
+			int groupCount = count - i < 4 ? count - i : 4;
+			const Vector3* n0 = (const Vector3*)(source + i * inputStride);
+			const Vector3* n1 = groupCount > 1 ? (const Vector3*)(source + (i + 1) * inputStride) : n0;
+			const Vector3* n2 = groupCount > 2 ? (const Vector3*)(source + (i + 2) * inputStride) : n0;
+			const Vector3* n3 = groupCount > 3 ? (const Vector3*)(source + (i + 3) * inputStride) : n0;
+
+			float4 u, v;
+			OctahedralEncode4(float4{ n0->X, n1->X, n2->X, n3->X }, float4{ n0->Y, n1->Y, n2->Y, n3->Y }, float4{ n0->Z, n1->Z, n2->Z, n3->Z }, &u, &v);
+			int4 packedU = ToSnorm16(u);
+			int4 packedV = ToSnorm16(v);
+
+			for (int k = 0; k < groupCount; k++)
+			{
+				int16_t* packed = (int16_t*)(destination + (i + k) * outputStride);
+				packed[0] = (int16_t)packedU[k];
+				packed[1] = (int16_t)packedV[k];
+			}
+		}
+	}
+
+	/*
+	* Vector4 tangent (xyz direction, w handedness) -> 4 x snorm16 (R16G16B16A16_SNorm): octahedral direction, handedness, 0.
+	*/
+	DLL_EXPORT_API void xnPackTangentOctahedral(const void* input, int inputStride, void* output, int outputStride, int count)
+	{
+		const uint8_t* source = (const uint8_t*)input;
+		uint8_t* destination = (uint8_t*)output;
+		for (int i = 0; i < count; i += 4)
+		{
+			int groupCount = count - i < 4 ? count - i : 4;
+			const Vector4* t0 = (const Vector4*)(source + i * inputStride);
+			const Vector4* t1 = groupCount > 1 ? (const Vector4*)(source + (i + 1) * inputStride) : t0;
+			const Vector4* t2 = groupCount > 2 ? (const Vector4*)(source + (i + 2) * inputStride) : t0;
+			const Vector4* t3 = groupCount > 3 ? (const Vector4*)(source + (i + 3) * inputStride) : t0;
+
+			float4 u, v;
+			OctahedralEncode4(float4{ t0->X, t1->X, t2->X, t3->X }, float4{ t0->Y, t1->Y, t2->Y, t3->Y }, float4{ t0->Z, t1->Z, t2->Z, t3->Z }, &u, &v);
+			int4 packedU = ToSnorm16(u);
+			int4 packedV = ToSnorm16(v);
+			int4 handedness = SelectI4(float4{ t0->W, t1->W, t2->W, t3->W } < 0.0f, (int4)-32767, (int4)32767);
+
+			for (int k = 0; k < groupCount; k++)
+			{
+				int16_t* packed = (int16_t*)(destination + (i + k) * outputStride);
+				packed[0] = (int16_t)packedU[k];
+				packed[1] = (int16_t)packedV[k];
+				packed[2] = (int16_t)handedness[k];
+				packed[3] = 0;
+			}
+		}
+	}
+
+	/*
+	* Vector3 position -> 4 x unorm16 (R16G16B16A16_UNorm) relative to bounds, decoded as bounds.minimum + value * (bounds.maximum - bounds.minimum).
+	*/
+	DLL_EXPORT_API void xnPackPositionUnorm16(const void* input, int inputStride, const BoundingBox* bounds, void* output, int outputStride, int count)
+	{
+		const uint8_t* source = (const uint8_t*)input;
+		uint8_t* destination = (uint8_t*)output;
+
+		float4 minimum = { bounds->minimum.X, bounds->minimum.Y, bounds->minimum.Z, 0.0f };
+		float4 size = float4{ bounds->maximum.X, bounds->maximum.Y, bounds->maximum.Z, 0.0f } - minimum;
+		// Flat axes map to 0
+		float4 scale = SelectF4(size > 0.0f, 65535.0f / size, 0.0f);
+
+		for (int i = 0; i < count; i++)
+		{
+			const Vector3* position = (const Vector3*)(source + i * inputStride);
+			float4 normalized = (float4{ position->X, position->Y, position->Z, 0.0f } - minimum) * scale;
+			normalized = SelectF4(normalized > 65535.0f, 65535.0f, SelectF4(normalized > 0.0f, normalized, 0.0f));
+			int4 quantized = RoundToInt(normalized);
+
+			uint16_t* packed = (uint16_t*)(destination + i * outputStride);
+			packed[0] = (uint16_t)quantized.x;
+			packed[1] = (uint16_t)quantized.y;
+			packed[2] = (uint16_t)quantized.z;
+			packed[3] = 0;
+		}
+	}
+}
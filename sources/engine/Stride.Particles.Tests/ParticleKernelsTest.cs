@@ -0,0 +1,378 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Animations;
+using Stride.Core.Mathematics;
+using Stride.Particles.Modules;
+using Stride.Particles.Updaters;
+using Stride.Particles.Updaters.FieldShapes;
+
+namespace Stride.Particles.Tests
+{
+    /// <summary>
+    /// Compares the native particle kernels with the per-particle loops they replaced in <see cref="ParticleEmitter"/> and the updaters.
+    /// </summary>
+    public class ParticleKernelsTest
+    {
+        private const int MaxParticles = 200;
+
+        [Theory]
+        [InlineData(false)]
+        [InlineData(true)]
+        public unsafe void UpdateLifetime(bool delayDeath)
+        {
+            var lifetime = new Vector2(0.5f, 2.0f);
+            const float dt = 0.1f;
+
+            var expectedPool = CreatePool(MaxParticles);
+            var pool = CreatePool(MaxParticles);
+
+            // Reference: the enumerator removes a particle by moving the last one in its place
+            {
+                var lifeField = expectedPool.GetField(ParticleFields.RemainingLife);
+                var randField = expectedPool.GetField(ParticleFields.RandomSeed);
+                var lifeStep = lifetime.Y - lifetime.X;
+
+                var particleEnumerator = expectedPool.GetEnumerator();
+                while (particleEnumerator.MoveNext())
+                {
+                    var particle = particleEnumerator.Current;
+
+                    var randSeed = *(RandomSeed*)particle[randField];
+                    var life = (float*)particle[lifeField];
+
+                    if (*life > 1)
+                        *life = 1;
+
+                    var startingLife = lifetime.X + lifeStep * randSeed.GetFloat(0);
+
+                    if (*life <= MathUtil.ZeroTolerance)
+                    {
+                        particleEnumerator.RemoveCurrent(ref particle);
+                    }
+                    else if ((*life -= dt / startingLife) <= MathUtil.ZeroTolerance)
+                    {
+                        if (delayDeath)
+                            *life = MathUtil.ZeroTolerance;
+                        else
+                            particleEnumerator.RemoveCurrent(ref particle);
+                    }
+                }
+            }
+
+            var dead = new byte[pool.ParticleCapacity];
+            fixed (byte* deadPtr = dead)
+            {
+                ParticleKernels.UpdateLifetime(pool, lifetime, dt, delayDeath, deadPtr);
+                pool.RemoveParticles(deadPtr);
+            }
+
+            Assert.Equal(expectedPool.LivingParticles, pool.LivingParticles);
+            Assert.True(pool.LivingParticles < MaxParticles, "Some particles should have died");
+
+            var expectedPositions = GetValues(expectedPool, ParticleFields.Position);
+            var positions = GetValues(pool, ParticleFields.Position);
+            var expectedLives = GetValues(expectedPool, ParticleFields.RemainingLife);
+            var lives = GetValues(pool, ParticleFields.RemainingLife);
+            for (int i = 0; i < pool.LivingParticles; i++)
+            {
+                // Positions are not touched, so they identify the surviving particles and their order
+                Assert.Equal(expectedPositions[i], positions[i]);
+                AssertNearEqual(expectedLives[i], lives[i]);
+            }
+        }
+
+        [Fact]
+        public void Integrate()
+        {
+            const float dt = 0.016f;
+
+            var pool = CreatePool(MaxParticles);
+            var positions = GetValues(pool, ParticleFields.Position);
+            var velocities = GetValues(pool, ParticleFields.Velocity);
+
+            ParticleKernels.Integrate(pool, dt);
+
+            var oldPositions = GetValues(pool, ParticleFields.OldPosition);
+            var newPositions = GetValues(pool, ParticleFields.Position);
+            for (int i = 0; i < MaxParticles; i++)
+            {
+                Assert.Equal(positions[i], oldPositions[i]);
+                AssertNearEqual(positions[i] + velocities[i] * dt, newPositions[i]);
+            }
+        }
+
+        [Fact]
+        public void ApplyGravity()
+        {
+            const float dt = 0.016f;
+
+            var pool = CreatePool(MaxParticles);
+            var positions = GetValues(pool, ParticleFields.Position);
+            var velocities = GetValues(pool, ParticleFields.Velocity);
+
+            var updater = new UpdaterGravity { GravitationalAcceleration = new Vector3(1, -9.8f, 3) };
+            updater.Update(dt, pool);
+
+            var deltaVel = updater.GravitationalAcceleration * dt;
+            var deltaPos = deltaVel * (dt * 0.5f);
+
+            var newPositions = GetValues(pool, ParticleFields.Position);
+            var newVelocities = GetValues(pool, ParticleFields.Velocity);
+            for (int i = 0; i < MaxParticles; i++)
+            {
+                AssertNearEqual(positions[i] + deltaPos, newPositions[i]);
+                AssertNearEqual(velocities[i] + deltaVel, newVelocities[i]);
+            }
+        }
+
+        [Theory]
+        [InlineData(false, 0.0f)]
+        [InlineData(true, 0.0f)]
+        [InlineData(true, 0.6f)]
+        public unsafe void ApplyForceField(bool sphere, float energyConservation)
+        {
+            const float dt = 0.016f;
+
+            var updater = new UpdaterForceField
+            {
+                FieldShape = sphere ? new Sphere { Radius = 8 } : null,
+                EnergyConservation = energyConservation,
+                ForceDirected = 2,
+                ForceVortex = 1.5f,
+                ForceRepulsive = -3,
+                ForceFixed = new Vector3(0.5f, -1, 0.25f),
+                Position = new Vector3(1, 2, -1),
+                Rotation = Quaternion.RotationYawPitchRoll(0.3f, -0.7f, 1.1f),
+                Scale = new Vector3(1, 0.5f, 2),
+            };
+            updater.FieldFalloff.FalloffStart = 0.2f;
+            updater.FieldFalloff.FalloffEnd = 0.8f;
+            updater.FieldFalloff.StrengthOutside = 0.25f;
+
+            var parent = new ParticleTransform { Position = new Vector3(-2, 0, 3), Rotation = Quaternion.RotationY(0.5f), ScaleUniform = 1.5f };
+            parent.SetParentTransform(null);
+            updater.SetParentTRS(parent, null);
+            var parentScale = parent.WorldScale.X;
+
+            var expectedPool = CreatePool(MaxParticles);
+            var pool = CreatePool(MaxParticles);
+
+            // Reference: UpdaterForceField before it used the native kernel
+            {
+                var posField = expectedPool.GetField(ParticleFields.Position);
+                var velField = expectedPool.GetField(ParticleFields.Velocity);
+                var directToPosition = 1f - updater.EnergyConservation;
+
+                foreach (var particle in expectedPool)
+                {
+                    var alongAxis = new Vector3(0, 1, 0);
+                    var awayAxis = new Vector3(0, 0, 1);
+                    var aroundAxis = new Vector3(1, 0, 0);
+
+                    var particlePos = *(Vector3*)particle[posField];
+                    var particleVel = *(Vector3*)particle[velField];
+
+                    var forceMagnitude = 1f;
+                    if (updater.FieldShape != null)
+                    {
+                        updater.FieldShape.PreUpdateField(updater.WorldPosition, updater.WorldRotation, updater.WorldScale);
+                        forceMagnitude = updater.FieldShape.GetDistanceToCenter(particlePos, particleVel, out alongAxis, out aroundAxis, out awayAxis);
+                        forceMagnitude = updater.FieldFalloff.GetStrength(forceMagnitude);
+                    }
+                    forceMagnitude *= dt * parentScale;
+
+                    var totalForceVector = updater.ForceFixed + alongAxis * updater.ForceDirected + aroundAxis * updater.ForceVortex + awayAxis * updater.ForceRepulsive;
+                    totalForceVector *= forceMagnitude;
+
+                    var vectorContribution = totalForceVector * updater.EnergyConservation;
+                    *(Vector3*)particle[velField] += vectorContribution;
+
+                    vectorContribution = (vectorContribution * (dt * 0.5f)) + (totalForceVector * directToPosition);
+                    *(Vector3*)particle[posField] += vectorContribution;
+                }
+            }
+
+            updater.Update(dt, pool);
+
+            var expectedPositions = GetValues(expectedPool, ParticleFields.Position);
+            var positions = GetValues(pool, ParticleFields.Position);
+            var expectedVelocities = GetValues(expectedPool, ParticleFields.Velocity);
+            var velocities = GetValues(pool, ParticleFields.Velocity);
+            for (int i = 0; i < MaxParticles; i++)
+            {
+                AssertNearEqual(expectedPositions[i], positions[i]);
+                AssertNearEqual(expectedVelocities[i], velocities[i]);
+            }
+        }
+
+        [Theory]
+        [InlineData(false)]
+        [InlineData(true)]
+        public void SizeOverTime(bool optionalSampler)
+        {
+            var updater = new UpdaterSizeOverTime
+            {
+                SamplerMain = CreateSampler(0.1f, 2.0f, 0.5f),
+                SamplerOptional = optionalSampler ? CreateSampler(1.0f, 0.2f, 3.0f) : null,
+                SeedOffset = 7,
+                ScaleUniform = 1.5f,
+            };
+            updater.SetParentTRS(null, null);
+            updater.PreUpdate();
+
+            var pool = CreatePool(MaxParticles);
+            ClampRemainingLife(pool);
+            updater.Update(0.016f, pool);
+
+            // Reference: UpdaterSizeOverTime before it used the native kernel
+            var lives = GetValues(pool, ParticleFields.RemainingLife);
+            var seeds = GetValues(pool, ParticleFields.RandomSeed);
+            var sizes = GetValues(pool, ParticleFields.Size);
+            for (int i = 0; i < MaxParticles; i++)
+            {
+                var life = 1f - lives[i];
+                var expected = updater.SamplerMain.Evaluate(life);
+                if (optionalSampler)
+                {
+                    var lerp = seeds[i].GetFloat(RandomOffset.Offset1A + updater.SeedOffset);
+                    var size2 = updater.SamplerOptional.Evaluate(life);
+                    expected += (size2 - expected) * lerp;
+                }
+
+                AssertNearEqual(updater.WorldScale.X * expected, sizes[i]);
+            }
+        }
+
+        [Theory]
+        [InlineData(false)]
+        [InlineData(true)]
+        public void ColorOverTime(bool optionalSampler)
+        {
+            var updater = new UpdaterColorOverTime
+            {
+                SamplerMain = CreateSampler(new Color4(1, 0.5f, 0, 1), new Color4(0, 1, 0.5f, 0.5f), new Color4(0.2f, 0.2f, 1, 0)),
+                SamplerOptional = optionalSampler ? CreateSampler(new Color4(0, 0, 1, 0.25f), new Color4(1, 1, 1, 1), new Color4(0.5f, 0, 0.5f, 0.75f)) : null,
+                SeedOffset = 3,
+            };
+            updater.PreUpdate();
+
+            var pool = CreatePool(MaxParticles);
+            ClampRemainingLife(pool);
+            updater.Update(0.016f, pool);
+
+            // Reference: UpdaterColorOverTime before it used the native kernel
+            var lives = GetValues(pool, ParticleFields.RemainingLife);
+            var seeds = GetValues(pool, ParticleFields.RandomSeed);
+            var colors = GetValues(pool, ParticleFields.Color);
+            for (int i = 0; i < MaxParticles; i++)
+            {
+                var life = 1f - lives[i];
+                var expected = updater.SamplerMain.Evaluate(life);
+                if (optionalSampler)
+                {
+                    var lerp = seeds[i].GetFloat(RandomOffset.Offset1A + updater.SeedOffset);
+                    expected = Color4.Lerp(expected, updater.SamplerOptional.Evaluate(life), lerp);
+                }
+
+                expected.R *= expected.A;
+                expected.G *= expected.A;
+                expected.B *= expected.A;
+
+                AssertNearEqual(new Vector3(expected.R, expected.G, expected.B), new Vector3(colors[i].R, colors[i].G, colors[i].B));
+                AssertNearEqual(expected.A, colors[i].A);
+            }
+        }
+
+        private static ComputeCurveSamplerFloat CreateSampler(float start, float middle, float end)
+        {
+            var curve = new ComputeAnimationCurveFloat();
+            curve.KeyFrames.Add(new AnimationKeyFrame<float> { Key = 0, Value = start });
+            curve.KeyFrames.Add(new AnimationKeyFrame<float> { Key = 0.4f, Value = middle });
+            curve.KeyFrames.Add(new AnimationKeyFrame<float> { Key = 1, Value = end });
+            return new ComputeCurveSamplerFloat { Curve = curve };
+        }
+
+        private static ComputeCurveSamplerColor4 CreateSampler(Color4 start, Color4 middle, Color4 end)
+        {
+            var curve = new ComputeAnimationCurveColor4();
+            curve.KeyFrames.Add(new AnimationKeyFrame<Color4> { Key = 0, Value = start });
+            curve.KeyFrames.Add(new AnimationKeyFrame<Color4> { Key = 0.6f, Value = middle });
+            curve.KeyFrames.Add(new AnimationKeyFrame<Color4> { Key = 1, Value = end });
+            return new ComputeCurveSamplerColor4 { Curve = curve };
+        }
+
+        private static ParticlePool CreatePool(int count)
+        {
+            var random = new Random(2718);
+            var pool = new ParticlePool(0, count, ParticlePool.ListPolicy.Stack);
+
+            const bool forceCreation = true;
+            pool.FieldExists(ParticleFields.Position, forceCreation);
+            pool.FieldExists(ParticleFields.OldPosition, forceCreation);
+            pool.FieldExists(ParticleFields.Velocity, forceCreation);
+            pool.FieldExists(ParticleFields.RemainingLife, forceCreation);
+            pool.FieldExists(ParticleFields.RandomSeed, forceCreation);
+            pool.FieldExists(ParticleFields.Size, forceCreation);
+            pool.FieldExists(ParticleFields.Color, forceCreation);
+
+            for (int i = 0; i < count; i++)
+                pool.AddParticle();
+
+            var positionField = pool.GetField(ParticleFields.Position);
+            var velocityField = pool.GetField(ParticleFields.Velocity);
+            var remainingLifeField = pool.GetField(ParticleFields.RemainingLife);
+            var randomField = pool.GetField(ParticleFields.RandomSeed);
+            foreach (var particle in pool)
+            {
+                particle.Set(positionField, new Vector3(NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10)));
+                particle.Set(velocityField, new Vector3(NextFloat(random, -5, 5), NextFloat(random, -5, 5), NextFloat(random, -5, 5)));
+                // A few particles are already dead, a few are above 1 and get clamped
+                particle.Set(remainingLifeField, random.Next(-2, 56) / 50.0f);
+                particle.Set(randomField, new RandomSeed((uint)random.Next()));
+            }
+
+            return pool;
+        }
+
+        // The emitter clamps the remaining life before the updaters run, and curve samplers only accept [0 .. 1]
+        private static void ClampRemainingLife(ParticlePool pool)
+        {
+            var lifeField = pool.GetField(ParticleFields.RemainingLife);
+            foreach (var particle in pool)
+                particle.Set(lifeField, Math.Clamp(particle.Get(lifeField), 0.0f, 1.0f));
+        }
+
+        private static T[] GetValues<T>(ParticlePool pool, ParticleFieldDescription<T> fieldDesc) where T : struct
+        {
+            var field = pool.GetField(fieldDesc);
+            var values = new T[pool.LivingParticles];
+            var i = 0;
+            foreach (var particle in pool)
+                values[i++] = particle.Get(field);
+            return values;
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(float expected, float actual)
+        {
+            var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected));
+            Assert.True(Math.Abs(expected - actual) <= tolerance, $"Expected {expected}, got {actual}");
+        }
+
+        private static void AssertNearEqual(Vector3 expected, Vector3 actual)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected[i]));
+                Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Component {i}: expected {expected}, got {actual}");
+            }
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Linq;
+using Xunit;
+using Stride.Core.Mathematics;
+using Stride.Particles.Sorters;
+
+namespace Stride.Particles.Tests
+{
+    /// <summary>
+    /// Compares the native radix sorts of <see cref="ParticleSorterDepth"/> and <see cref="ParticleSorterAge"/> with managed orderings.
+    /// </summary>
+    public class ParticleSortersTest
+    {
+        private const int MaxParticles = 200;
+
+        [Fact]
+        public void SortByDepth()
+        {
+            var pool = CreatePool(MaxParticles);
+            var depth = Vector3.Normalize(new Vector3(0.3f, -0.2f, -1));
+
+            var expected = GetValues(pool, ParticleFields.Position).Select(position => Vector3.Dot(depth, position)).OrderBy(key => key).ToArray();
+
+            var sorter = new ParticleSorterDepth(pool);
+            var sortedList = sorter.GetSortedList(depth);
+            var positionField = sortedList.GetField(ParticleFields.Position);
+
+            var i = 0;
+            foreach (Particle particle in sortedList)
+                AssertNearEqual(expected[i++], Vector3.Dot(depth, particle.Get(positionField)));
+            Assert.Equal(MaxParticles, i);
+
+            sorter.FreeSortedList(ref sortedList);
+        }
+
+        [Fact]
+        public void SortByAge()
+        {
+            var pool = CreatePool(MaxParticles);
+
+            var expected = GetValues(pool, ParticleFields.Life).OrderByDescending(life => life).ToArray();
+
+            var sorter = new ParticleSorterAge(pool);
+            var sortedList = sorter.GetSortedList(Vector3.UnitZ);
+            var lifeField = sortedList.GetField(ParticleFields.Life);
+
+            var i = 0;
+            foreach (Particle particle in sortedList)
+                Assert.Equal(expected[i++], particle.Get(lifeField));
+            Assert.Equal(MaxParticles, i);
+
+            sorter.FreeSortedList(ref sortedList);
+        }
+
+        private static ParticlePool CreatePool(int count)
+        {
+            var random = new Random(3141);
+            var pool = new ParticlePool(0, count, ParticlePool.ListPolicy.Stack);
+
+            const bool forceCreation = true;
+            pool.FieldExists(ParticleFields.Position, forceCreation);
+            pool.FieldExists(ParticleFields.Life, forceCreation);
+
+            for (int i = 0; i < count; i++)
+                pool.AddParticle();
+
+            var positionField = pool.GetField(ParticleFields.Position);
+            var lifeField = pool.GetField(ParticleFields.Life);
+            foreach (var particle in pool)
+            {
+                particle.Set(positionField, new Vector3(NextFloat(random, -10, 10), NextFloat(random, -10, 10), NextFloat(random, -10, 10)));
+                // Quantized so that the sort meets equal keys, some of them negative
+                particle.Set(lifeField, random.Next(-2, 56) / 50.0f);
+            }
+
+            return pool;
+        }
+
+        private static T[] GetValues<T>(ParticlePool pool, ParticleFieldDescription<T> fieldDesc) where T : struct
+        {
+            var field = pool.GetField(fieldDesc);
+            var values = new T[pool.LivingParticles];
+            var i = 0;
+            foreach (var particle in pool)
+                values[i++] = particle.Get(field);
+            return values;
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(float expected, float actual)
+        {
+            var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected));
+            Assert.True(Math.Abs(expected - actual) <= tolerance, $"Expected {expected}, got {actual}");
+        }
+    }
+}
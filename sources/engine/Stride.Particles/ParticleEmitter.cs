@@ -118,6 +118,12 @@ namespace Stride.Particles
         [DataMemberIgnore]
         public int DelayParticleDeath { get; set; } = 0;
 
+        /// <summary>
+        /// Per particle flags filled by the lifetime update, reused every frame
+        /// </summary>
+        [DataMemberIgnore]
+        private byte[] deadParticles = Array.Empty<byte>();
+
         // Draw location can be different than the particle position if we are using local coordinate system
         private readonly ParticleTransform drawTransform = new ParticleTransform();
         private readonly ParticleTransform identityTransform = new ParticleTransform();
@@ -717,68 +723,21 @@ namespace Stride.Particles
             // Hardcoded life update
             if (pool.FieldExists(ParticleFields.RemainingLife) && pool.FieldExists(ParticleFields.RandomSeed))
             {
-                var lifeField = pool.GetField(ParticleFields.RemainingLife);
-                var randField = pool.GetField(ParticleFields.RandomSeed);
-                var lifeStep = particleLifetime.Y - particleLifetime.X;
-
-                var particleEnumerator = pool.GetEnumerator();
-                while (particleEnumerator.MoveNext())
-                {
-                    var particle = particleEnumerator.Current;
-
-                    var randSeed = *(RandomSeed*)(particle[randField]);
-                    var life = (float*)particle[lifeField];
-
-                    if (*life > 1)
-                        *life = 1;
-
-                    var startingLife = particleLifetime.X + lifeStep * randSeed.GetFloat(0);
-
-                    if (*life <= MathUtil.ZeroTolerance)
-                    {
-                        particleEnumerator.RemoveCurrent(ref particle);
-                    }
-                    else
-                    if ((*life -= (dt / startingLife)) <= MathUtil.ZeroTolerance)
-                    {
-                        if (DelayParticleDeath > 0)
-                        {
-                            *life = MathUtil.ZeroTolerance;
-                        }
-                        else
-                        {
-                            particleEnumerator.RemoveCurrent(ref particle);
-                        }
-                    }
-                }
-            }
-
-            // Hardcoded position and old position updates
-            // If we have to preserve the particle's old position, do it before updating the position for the first time
-            if (pool.FieldExists(ParticleFields.Position) && pool.FieldExists(ParticleFields.OldPosition))
-            {
-                var posField = pool.GetField(ParticleFields.Position);
-                var oldField = pool.GetField(ParticleFields.OldPosition);
+                if (deadParticles.Length < pool.LivingParticles)
+                    deadParticles = new byte[pool.ParticleCapacity];
 
-                foreach (var particle in pool)
+                fixed (byte* dead = deadParticles)
                 {
-                    (*((Vector3*)particle[oldField])) = (*((Vector3*)particle[posField]));
+                    ParticleKernels.UpdateLifetime(pool, particleLifetime, dt, DelayParticleDeath > 0, dead);
+                    pool.RemoveParticles(dead);
                 }
             }
 
-            // Hardcoded position and velocity update
-            if (pool.FieldExists(ParticleFields.Position) && pool.FieldExists(ParticleFields.Velocity))
+            // Hardcoded position, old position and velocity update
+            // If we have to preserve the particle's old position, it is copied before updating the position for the first time
+            if (pool.FieldExists(ParticleFields.Position) && (pool.FieldExists(ParticleFields.OldPosition) || pool.FieldExists(ParticleFields.Velocity)))
             {
-                var posField = pool.GetField(ParticleFields.Position);
-                var velField = pool.GetField(ParticleFields.Velocity);
-
-                foreach (var particle in pool)
-                {
-                    var pos = ((Vector3*)particle[posField]);
-                    var vel = ((Vector3*)particle[velField]);
-
-                    *pos += *vel*dt;
-                }
+                ParticleKernels.Integrate(pool, dt);
             }
         }
 
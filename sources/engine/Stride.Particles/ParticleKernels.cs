@@ -0,0 +1,240 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Runtime.InteropServices;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Native;
+
+namespace Stride.Particles
+{
+    /// <summary>
+    /// Runs the native particle update kernels over the fields of a <see cref="ParticlePool"/>, splitting large pools across threads.
+    /// </summary>
+    internal static unsafe class ParticleKernels
+    {
+        /// <summary>
+        /// Pools with at least this many particles are updated on several threads
+        /// </summary>
+        public const int ParallelThreshold = 4096;
+
+        private struct LifetimeJob
+        {
+            public IntPtr Life;
+            public int LifeStride;
+            public IntPtr RandomSeeds;
+            public int SeedStride;
+            public float MinimumLifetime;
+            public float MaximumLifetime;
+            public float Dt;
+            public int DelayDeath;
+            public byte* Dead;
+        }
+
+        private struct IntegrateJob
+        {
+            public IntPtr Positions;
+            public int PositionStride;
+            public IntPtr OldPositions;
+            public int OldPositionStride;
+            public IntPtr Velocities;
+            public int VelocityStride;
+            public float Dt;
+        }
+
+        private struct GravityJob
+        {
+            public IntPtr Positions;
+            public int PositionStride;
+            public IntPtr Velocities;
+            public int VelocityStride;
+            public Vector3 Acceleration;
+            public float Dt;
+        }
+
+        // Same layout as ParticleForceField in the native code
+        [StructLayout(LayoutKind.Sequential, Pack = 4)]
+        public struct ForceField
+        {
+            public Vector3 Position;
+            public Quaternion InverseRotation;
+            public Vector3 Size;
+            public Vector3 MainAxis;
+            public float Radius;
+            /// <summary>
+            /// 0 without a shape, 1 for a sphere
+            /// </summary>
+            public int Shape;
+            public float StrengthInside;
+            public float FalloffStart;
+            public float StrengthOutside;
+            public float FalloffEnd;
+            public float EnergyConservation;
+            public float ForceDirected;
+            public float ForceVortex;
+            public float ForceRepulsive;
+            public Vector3 ForceFixed;
+            public float ParentScale;
+        }
+
+        private struct ForceFieldJob
+        {
+            public IntPtr Positions;
+            public int PositionStride;
+            public IntPtr Velocities;
+            public int VelocityStride;
+            public ForceField Field;
+            public float Dt;
+        }
+
+        private struct CurveJob
+        {
+            public IntPtr Life;
+            public int LifeStride;
+            public float* Curve;
+            public float* OptionalCurve;
+            public int Components;
+            public IntPtr RandomSeeds;
+            public int SeedStride;
+            public uint SeedOffset;
+            public float Scale;
+            public int PremultiplyAlpha;
+            public IntPtr Output;
+            public int OutputStride;
+        }
+
+        /// <summary>
+        /// Ages the particles and flags those which should be removed in <paramref name="dead"/> (one entry per living particle).
+        /// </summary>
+        public static void UpdateLifetime(ParticlePool pool, Vector2 lifetime, float dt, bool delayDeath, byte* dead)
+        {
+            var job = new LifetimeJob
+            {
+                Life = pool.GetFieldStream(ParticleFields.RemainingLife, out var lifeStride),
+                LifeStride = lifeStride,
+                RandomSeeds = pool.GetFieldStream(ParticleFields.RandomSeed, out var seedStride),
+                SeedStride = seedStride,
+                MinimumLifetime = lifetime.X,
+                MaximumLifetime = lifetime.Y,
+                Dt = dt,
+                DelayDeath = delayDeath ? 1 : 0,
+                Dead = dead,
+            };
+            Run(pool.LivingParticles, job, &UpdateLifetimeBatch);
+        }
+
+        /// <summary>
+        /// Copies the positions to the old positions if the pool has them, then moves the particles by their velocity if the pool has it.
+        /// </summary>
+        public static void Integrate(ParticlePool pool, float dt)
+        {
+            var job = new IntegrateJob { Dt = dt };
+            job.Positions = pool.GetFieldStream(ParticleFields.Position, out job.PositionStride);
+            if (pool.FieldExists(ParticleFields.OldPosition))
+                job.OldPositions = pool.GetFieldStream(ParticleFields.OldPosition, out job.OldPositionStride);
+            if (pool.FieldExists(ParticleFields.Velocity))
+                job.Velocities = pool.GetFieldStream(ParticleFields.Velocity, out job.VelocityStride);
+
+            Run(pool.LivingParticles, job, &IntegrateBatch);
+        }
+
+        /// <summary>
+        /// Applies a constant acceleration to the particles' velocity and position.
+        /// </summary>
+        public static void ApplyGravity(ParticlePool pool, Vector3 acceleration, float dt)
+        {
+            var job = new GravityJob { Acceleration = acceleration, Dt = dt };
+            job.Positions = pool.GetFieldStream(ParticleFields.Position, out job.PositionStride);
+            job.Velocities = pool.GetFieldStream(ParticleFields.Velocity, out job.VelocityStride);
+
+            Run(pool.LivingParticles, job, &ApplyGravityBatch);
+        }
+
+        /// <summary>
+        /// Applies a force field to the particles' velocity and position.
+        /// </summary>
+        public static void ApplyForceField(ParticlePool pool, in ForceField field, float dt)
+        {
+            var job = new ForceFieldJob { Field = field, Dt = dt };
+            job.Positions = pool.GetFieldStream(ParticleFields.Position, out job.PositionStride);
+            job.Velocities = pool.GetFieldStream(ParticleFields.Velocity, out job.VelocityStride);
+
+            Run(pool.LivingParticles, job, &ApplyForceFieldBatch);
+        }
+
+        /// <summary>
+        /// Writes a curve sampled at the particles' normalized age to <paramref name="outputField"/>, multiplied by <paramref name="scale"/>.
+        /// With <paramref name="optionalCurve"/>, each particle picks a value between both curves from its random seed at <paramref name="seedOffset"/>.
+        /// </summary>
+        /// <param name="curve">The baked data of a curve sampler, <paramref name="components"/> floats per value</param>
+        /// <param name="premultiplyAlpha">With 4 components, multiplies the first three by the fourth</param>
+        public static void SampleCurve(ParticlePool pool, ParticleFieldDescription outputField, ReadOnlySpan<float> curve, ReadOnlySpan<float> optionalCurve, int components, uint seedOffset, float scale, bool premultiplyAlpha)
+        {
+            fixed (float* curvePtr = curve)
+            fixed (float* optionalCurvePtr = optionalCurve)
+            {
+                var job = new CurveJob
+                {
+                    Curve = curvePtr,
+                    OptionalCurve = optionalCurvePtr,
+                    Components = components,
+                    SeedOffset = seedOffset,
+                    Scale = scale,
+                    PremultiplyAlpha = premultiplyAlpha ? 1 : 0,
+                };
+                job.Life = pool.GetFieldStream(ParticleFields.RemainingLife, out job.LifeStride);
+                if (optionalCurvePtr != null)
+                    job.RandomSeeds = pool.GetFieldStream(ParticleFields.RandomSeed, out job.SeedStride);
+                job.Output = pool.GetFieldStream(outputField, out job.OutputStride);
+
+                // Dispatcher.ForBatched returns once every batch is done, so the curves stay pinned long enough
+                Run(pool.LivingParticles, job, &SampleCurveBatch);
+            }
+        }
+
+        /// <summary>
+        /// Sorts the living particles in ascending order of the dot product of a float field with <paramref name="weights"/>.
+        /// </summary>
+        /// <param name="keys">Scratch memory for one key per living particle</param>
+        /// <param name="sortedIndices">Receives the sorted particle indices</param>
+        public static void SortByKey(ParticlePool pool, ParticleFieldDescription fieldDesc, float* weights, int components, uint* keys, uint* sortedIndices)
+        {
+            var values = pool.GetFieldStream(fieldDesc, out var stride);
+            NativeInvoke.ParticleSortByKey((void*)values, stride, components, weights, keys, sortedIndices, pool.LivingParticles);
+        }
+
+        private static void Run<T>(int count, in T job, delegate*<T, int, int, void> batch)
+        {
+            if (count >= ParallelThreshold)
+                Dispatcher.ForBatched(count, job, batch);
+            else if (count > 0)
+                batch(job, 0, count);
+        }
+
+        private static void UpdateLifetimeBatch(LifetimeJob job, int start, int end)
+        {
+            NativeInvoke.ParticleUpdateLifetimeRange((void*)job.Life, job.LifeStride, (void*)job.RandomSeeds, job.SeedStride, job.MinimumLifetime, job.MaximumLifetime, job.Dt, job.DelayDeath, job.Dead, start, end);
+        }
+
+        private static void IntegrateBatch(IntegrateJob job, int start, int end)
+        {
+            NativeInvoke.ParticleIntegrateRange((void*)job.Positions, job.PositionStride, (void*)job.OldPositions, job.OldPositionStride, (void*)job.Velocities, job.VelocityStride, job.Dt, start, end);
+        }
+
+        private static void ApplyGravityBatch(GravityJob job, int start, int end)
+        {
+            NativeInvoke.ParticleApplyGravityRange((void*)job.Positions, job.PositionStride, (void*)job.Velocities, job.VelocityStride, &job.Acceleration, job.Dt, start, end);
+        }
+
+        private static void ApplyForceFieldBatch(ForceFieldJob job, int start, int end)
+        {
+            NativeInvoke.ParticleApplyForceFieldRange((void*)job.Positions, job.PositionStride, (void*)job.Velocities, job.VelocityStride, &job.Field, job.Dt, start, end);
+        }
+
+        private static void SampleCurveBatch(CurveJob job, int start, int end)
+        {
+            NativeInvoke.ParticleSampleCurveRange((void*)job.Life, job.LifeStride, job.Curve, job.OptionalCurve, job.Components, (void*)job.RandomSeeds, job.SeedStride, job.SeedOffset, job.Scale, job.PremultiplyAlpha, (void*)job.Output, job.OutputStride, start, end);
+        }
+    }
+}
@@ -7,6 +7,7 @@ using System.Collections.Generic;
 using System.Diagnostics;
 using System.Runtime.CompilerServices;
 using Stride.Core;
+using Stride.Native;
 
 namespace Stride.Particles
 {
@@ -311,6 +312,34 @@ namespace Stride.Particles
             oldIndex--;
         }
 
+        /// <summary>
+        /// Removes the particles flagged in <paramref name="dead"/>, in the same order as removing them with <see cref="Enumerator.RemoveCurrent"/>
+        /// </summary>
+        /// <param name="dead">One flag per living particle, moved along with the particles</param>
+        internal unsafe void RemoveParticles(byte* dead)
+        {
+            // In case of a Ring list we don't bother to remove dead particles
+            if (listPolicy == ListPolicy.Ring)
+                return;
+
+#if PARTICLES_SOA
+            var streams = stackalloc IntPtr[fields.Count];
+            var sizes = stackalloc int[fields.Count];
+            var streamCount = 0;
+            foreach (var field in fields.Values)
+            {
+                streams[streamCount] = field.Offset;
+                sizes[streamCount++] = field.Size;
+            }
+
+            nextFreeIndex = NativeInvoke.ParticleRemoveDead(dead, nextFreeIndex, streams, sizes, streamCount);
+#else
+            var stream = ParticleData;
+            var size = ParticleSize;
+            nextFreeIndex = NativeInvoke.ParticleRemoveDead(dead, nextFreeIndex, &stream, &size, 1);
+#endif
+        }
+
 #region Fields
 
         /// <summary>
@@ -632,6 +661,24 @@ namespace Stride.Particles
             AddField(fieldDesc);
             return true;
         }
+
+        /// <summary>
+        /// Gets the address of an existing field for the first particle and the stride in bytes between particles, so that native code can process it as a stream
+        /// </summary>
+        /// <param name="fieldDesc">Description of the field</param>
+        /// <param name="stride">Distance in bytes between the field of two consecutive particles</param>
+        /// <returns>Address of the field of the first particle</returns>
+        internal IntPtr GetFieldStream(ParticleFieldDescription fieldDesc, out int stride)
+        {
+            var field = fields[fieldDesc];
+#if PARTICLES_SOA
+            stride = field.Size;
+            return field.Offset;
+#else
+            stride = ParticleSize;
+            return ParticleData + field.Offset;
+#endif
+        }
 #endregion
 
 #region Enumerator
@@ -2,8 +2,11 @@
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 using System.Reflection;
 using System.Resources;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 
+#pragma warning disable 436 // Stride.PublicKeys is defined in multiple assemblies
+
 // General Information about an assembly is controlled through the following 
 // set of attributes. Change these attribute values to modify the information
 // associated with an assembly.
@@ -15,3 +18,5 @@ using System.Runtime.InteropServices;
 
 // The following GUID is for the ID of the typelib if this project is exposed to COM
 [assembly: Guid("f32fda80-b6dd-47a8-8681-437e2c0d3f31")]
+
+[assembly: InternalsVisibleTo("Stride.Particles.Tests" + Stride.PublicKeys.Default)]
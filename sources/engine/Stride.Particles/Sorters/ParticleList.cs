@@ -9,6 +9,7 @@ namespace Stride.Particles.Sorters
     public struct ParticleList : IEnumerable
     {
         private readonly SortedParticle[] sortedList;
+        private readonly uint[] sortedIndices;
         private readonly int listCapacity;
         private readonly ParticlePool pool;
 
@@ -17,6 +18,21 @@ namespace Stride.Particles.Sorters
             this.pool = pool;
             this.listCapacity = capacity;
             this.sortedList = list;
+            this.sortedIndices = null;
+        }
+
+        /// <summary>
+        /// Creates a list which iterates the particles in the order given by a permutation of their indices in the pool
+        /// </summary>
+        /// <param name="pool">The <see cref="ParticlePool"/> containing the particles</param>
+        /// <param name="capacity">Number of particles in the list</param>
+        /// <param name="indices">Sorted particle indices</param>
+        public ParticleList(ParticlePool pool, int capacity, uint[] indices)
+        {
+            this.pool = pool;
+            this.listCapacity = capacity;
+            this.sortedList = null;
+            this.sortedIndices = indices;
         }
 
         public void Free(ConcurrentArrayPool<SortedParticle> sortedArrayPool)
@@ -27,6 +43,14 @@ namespace Stride.Particles.Sorters
             }
         }
 
+        public void Free(ConcurrentArrayPool<uint> indexArrayPool)
+        {
+            if (sortedIndices != null)
+            {
+                indexArrayPool.Free(sortedIndices);
+            }
+        }
+
         /// <summary>
         /// Returns a particle field accessor for the contained <see cref="ParticlePool"/>
         /// </summary>
@@ -42,20 +66,22 @@ namespace Stride.Particles.Sorters
 
         public Enumerator GetEnumerator()
         {
-            return new Enumerator(pool, listCapacity, sortedList);
+            return new Enumerator(pool, listCapacity, sortedList, sortedIndices);
         }
 
         public struct Enumerator : IEnumerator<Particle>
         {
             private readonly SortedParticle[] sortedList;
+            private readonly uint[] sortedIndices;
             private readonly int listCapacity;
             private readonly ParticlePool pool;
 
             private int index;
 
-            internal Enumerator(ParticlePool pool, int capacity, SortedParticle[] list)
+            internal Enumerator(ParticlePool pool, int capacity, SortedParticle[] list, uint[] indices)
             {
                 sortedList = list;
+                sortedIndices = indices;
                 listCapacity = capacity;
                 index = -1;
                 Current = Particle.Invalid();
@@ -73,7 +99,9 @@ namespace Stride.Particles.Sorters
             public bool MoveNext()
             {
                 bool moveNext = (++index < listCapacity);
-                Current = (moveNext) ? ((sortedList != null) ? sortedList[index].Particle : pool.FromIndex(index)) : Particle.Invalid();
+                Current = (moveNext) ?
+                    ((sortedList != null) ? sortedList[index].Particle : (sortedIndices != null) ? pool.FromIndex((int)sortedIndices[index]) : pool.FromIndex(index)) :
+                    Particle.Invalid();
                 return moveNext;
             }
 
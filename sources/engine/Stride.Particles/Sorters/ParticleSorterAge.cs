@@ -1,7 +1,6 @@
 // Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 
-using System;
 using Stride.Core.Mathematics;
 
 namespace Stride.Particles.Sorters
@@ -13,7 +12,7 @@ namespace Stride.Particles.Sorters
     {
         public ParticleSorterAge(ParticlePool pool) : base(pool, ParticleFields.Life) { }
 
-        public ParticleList GetSortedList(Vector3 depth)
+        public unsafe ParticleList GetSortedList(Vector3 depth)
         {
             var livingParticles = ParticlePool.LivingParticles;
 
@@ -25,18 +24,21 @@ namespace Stride.Particles.Sorters
                 return new ParticleList(ParticlePool, livingParticles);
             }
 
-            SortedParticle[] particleList = ArrayPool.Allocate(ParticlePool.ParticleCapacity);
+            // Descending order of Life
+            var weight = -1f;
 
-            var i = 0;
-            foreach (var particle in ParticlePool)
+            var sortedIndices = IndexPool.Allocate(ParticlePool.ParticleCapacity);
+            var keys = IndexPool.Allocate(ParticlePool.ParticleCapacity);
+
+            fixed (uint* sortedIndicesPtr = sortedIndices)
+            fixed (uint* keysPtr = keys)
             {
-                particleList[i] = new SortedParticle(particle, (-1f) * particle.Get(sortField));
-                i++;
+                ParticleKernels.SortByKey(ParticlePool, fieldDesc, &weight, 1, keysPtr, sortedIndicesPtr);
             }
 
-            Array.Sort(particleList, 0, livingParticles);
+            IndexPool.Free(keys);
 
-            return new ParticleList(ParticlePool, livingParticles, particleList);
+            return new ParticleList(ParticlePool, livingParticles, sortedIndices);
         }
 
         /// <summary>
@@ -45,7 +47,7 @@ namespace Stride.Particles.Sorters
         /// <param name="sortedList">Reference to the <see cref="ParticleList"/> to be freed</param>
         public void FreeSortedList(ref ParticleList sortedList)
         {
-            sortedList.Free(ArrayPool);
+            sortedList.Free(IndexPool);
         }
     }
 }
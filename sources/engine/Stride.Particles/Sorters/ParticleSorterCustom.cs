@@ -15,6 +15,8 @@ namespace Stride.Particles.Sorters
 
         protected readonly ConcurrentArrayPool<SortedParticle> ArrayPool = new ConcurrentArrayPool<SortedParticle>();
 
+        protected readonly ConcurrentArrayPool<uint> IndexPool = new ConcurrentArrayPool<uint>();
+
         protected readonly ParticlePool ParticlePool;
 
         protected ParticleSorterCustom(ParticlePool pool, ParticleFieldDescription<T> fieldDesc)
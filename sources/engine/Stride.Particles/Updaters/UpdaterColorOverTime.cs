@@ -1,6 +1,7 @@
 // Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 
+using System.Runtime.InteropServices;
 using Stride.Core;
 using Stride.Core.Annotations;
 using Stride.Core.Mathematics;
@@ -77,67 +78,9 @@ namespace Stride.Particles.Updaters
             if (!pool.FieldExists(ParticleFields.Color) || !pool.FieldExists(ParticleFields.Life))
                 return;
 
-            if (SamplerOptional == null)
-            {
-                UpdateSingleSampler(pool);
-                return;
-            }
-
-            UpdateDoubleSampler(pool);
-        }
-
-        /// <summary>
-        /// Updates the field by sampling a single value over the particle's lifetime
-        /// </summary>
-        /// <param name="pool">Target <see cref="ParticlePool"/></param>
-        private unsafe void UpdateSingleSampler(ParticlePool pool)
-        {
-            var colorField = pool.GetField(ParticleFields.Color);
-            var lifeField  = pool.GetField(ParticleFields.Life);
-
-            foreach (var particle in pool)
-            {
-                var life = 1f - (*((float*)particle[lifeField]));   // The Life field contains remaining life, so for sampling we take (1 - life)
-
-                var color = SamplerMain.Evaluate(life);
-
-                // Premultiply alpha
-                color.R *= color.A;
-                color.G *= color.A;
-                color.B *= color.A;
-
-                (*((Color4*)particle[colorField])) = color;
-            }
-        }
-
-        /// <summary>
-        /// Updates the field by interpolating between two sampled values over the particle's lifetime
-        /// </summary>
-        /// <param name="pool">Target <see cref="ParticlePool"/></param>
-        private unsafe void UpdateDoubleSampler(ParticlePool pool)
-        {
-            var colorField = pool.GetField(ParticleFields.Color);
-            var lifeField  = pool.GetField(ParticleFields.Life);
-            var randField  = pool.GetField(ParticleFields.RandomSeed);
-
-            foreach (var particle in pool)
-            {
-                var life = 1f - (*((float*)particle[lifeField]));   // The Life field contains remaining life, so for sampling we take (1 - life)
-
-                var randSeed = particle.Get(randField);
-                var lerp = randSeed.GetFloat(RandomOffset.Offset1A + SeedOffset);
-
-                var colorMin = SamplerMain.Evaluate(life);
-                var colorMax = SamplerOptional.Evaluate(life);                
-                var color    =  Color4.Lerp(colorMin, colorMax, lerp);
-
-                // Premultiply alpha
-                color.R *= color.A;
-                color.G *= color.A;
-                color.B *= color.A;
-
-                (*((Color4*)particle[colorField])) = color;
-            }
+            // With the optional sampler, particles pick a color between both curves. Alpha is premultiplied
+            var optionalCurve = SamplerOptional != null ? MemoryMarshal.Cast<Color4, float>(SamplerOptional.BakedData) : default;
+            ParticleKernels.SampleCurve(pool, ParticleFields.Color, MemoryMarshal.Cast<Color4, float>(SamplerMain.BakedData), optionalCurve, 4, RandomOffset.Offset1A + SeedOffset, 1.0f, true);
         }
     }
 }
@@ -1,6 +1,7 @@
 // Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
 // Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
 
+using System;
 using System.ComponentModel;
 using Stride.Core;
 using Stride.Core.Annotations;
@@ -117,6 +118,13 @@ namespace Stride.Particles.Modules
             if (!pool.FieldExists(ParticleFields.Position) || !pool.FieldExists(ParticleFields.Velocity))
                 return;
 
+            // The native kernel handles fields without a shape and spheres, other shapes are updated here
+            if (FieldShape == null || FieldShape is Sphere)
+            {
+                ParticleKernels.ApplyForceField(pool, CreateNativeField(FieldShape as Sphere), dt);
+                return;
+            }
+
             var posField = pool.GetField(ParticleFields.Position);
             var velField = pool.GetField(ParticleFields.Velocity);
 
@@ -162,6 +170,39 @@ namespace Stride.Particles.Modules
             }
         }
 
+        private ParticleKernels.ForceField CreateNativeField(Sphere sphere)
+        {
+            var field = new ParticleKernels.ForceField
+            {
+                StrengthInside = FieldFalloff.StrengthInside,
+                FalloffStart = FieldFalloff.FalloffStart,
+                StrengthOutside = FieldFalloff.StrengthOutside,
+                FalloffEnd = FieldFalloff.FalloffEnd,
+                EnergyConservation = EnergyConservation,
+                ForceDirected = ForceDirected,
+                ForceVortex = ForceVortex,
+                ForceRepulsive = ForceRepulsive,
+                ForceFixed = ForceFixed,
+                ParentScale = parentScale,
+            };
+
+            if (sphere != null)
+            {
+                // Same as Sphere.PreUpdateField
+                var rotation = WorldRotation;
+                field.Shape = 1;
+                field.Position = WorldPosition;
+                field.InverseRotation = new Quaternion(-rotation.X, -rotation.Y, -rotation.Z, rotation.W);
+                field.Size = WorldScale;
+                field.MainAxis = new Vector3(0, 1, 0);
+                rotation.Rotate(ref field.MainAxis);
+                // Radius reads 0 for the smallest radius, but the sphere never divides by less than MathUtil.ZeroTolerance
+                field.Radius = Math.Max(sphere.Radius, MathUtil.ZeroTolerance);
+            }
+
+            return field;
+        }
+
         /// <inheritdoc />
         public override void SetParentTRS(ParticleTransform transform, ParticleSystem parent)
         {
@@ -28,22 +28,12 @@ namespace Stride.Particles.Modules
             RequiredFields.Add(ParticleFields.Velocity);
         }
 
-        public override unsafe void Update(float dt, ParticlePool pool)
+        public override void Update(float dt, ParticlePool pool)
         {
             if (!pool.FieldExists(ParticleFields.Position) || !pool.FieldExists(ParticleFields.Velocity))
                 return;
 
-            var posField = pool.GetField(ParticleFields.Position);
-            var velField = pool.GetField(ParticleFields.Velocity);
-
-            var deltaVel = GravitationalAcceleration * dt;
-            var deltaPos = deltaVel * (dt * 0.5f);
-
-            foreach (var particle in pool)
-            {
-                (*((Vector3*)particle[posField])) += deltaPos;
-                (*((Vector3*)particle[velField])) += deltaVel;
-            }
+            ParticleKernels.ApplyGravity(pool, GravitationalAcceleration, dt);
         }
     }
 }
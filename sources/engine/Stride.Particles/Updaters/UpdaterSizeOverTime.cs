@@ -78,55 +78,9 @@ namespace Stride.Particles.Updaters
             if (!pool.FieldExists(ParticleFields.Size) || !pool.FieldExists(ParticleFields.Life))
                 return;
 
-            if (SamplerOptional == null)
-            {
-                UpdateSingleSampler(pool);
-                return;
-            }
-
-            UpdateDoubleSampler(pool);
-        }
-
-        /// <summary>
-        /// Updates the field by sampling a single value over the particle's lifetime
-        /// </summary>
-        /// <param name="pool">Target <see cref="ParticlePool"/></param>
-        private unsafe void UpdateSingleSampler(ParticlePool pool)
-        {
-            var sizeField = pool.GetField(ParticleFields.Size);
-            var lifeField = pool.GetField(ParticleFields.Life);
-
-            foreach (var particle in pool)
-            {
-                var life = 1f - (*((float*)particle[lifeField]));   // The Life field contains remaining life, so for sampling we take (1 - life)
-
-                (*((float*)particle[sizeField])) = WorldScale.X * SamplerMain.Evaluate(life);
-            }
+            // With the optional sampler, particles pick a size between both curves
+            var optionalCurve = SamplerOptional != null ? SamplerOptional.BakedData : default;
+            ParticleKernels.SampleCurve(pool, ParticleFields.Size, SamplerMain.BakedData, optionalCurve, 1, RandomOffset.Offset1A + SeedOffset, WorldScale.X, false);
         }
-
-        /// <summary>
-        /// Updates the field by interpolating between two sampled values over the particle's lifetime
-        /// </summary>
-        /// <param name="pool">Target <see cref="ParticlePool"/></param>
-        private unsafe void UpdateDoubleSampler(ParticlePool pool)
-        {
-            var sizeField = pool.GetField(ParticleFields.Size);
-            var lifeField = pool.GetField(ParticleFields.Life);
-            var randField = pool.GetField(ParticleFields.RandomSeed);
-
-            foreach (var particle in pool)
-            {
-                var life = 1f - (*((float*)particle[lifeField]));   // The Life field contains remaining life, so for sampling we take (1 - life)
-
-                var randSeed = particle.Get(randField);
-                var lerp = randSeed.GetFloat(RandomOffset.Offset1A + SeedOffset);
-
-                var size1 = SamplerMain.Evaluate(life);
-                var size2 = SamplerOptional.Evaluate(life);
-
-                (*((float*)particle[sizeField])) = WorldScale.X * (size1 + (size2 - size1) * lerp);
-            }
-        }
-
     }
 }
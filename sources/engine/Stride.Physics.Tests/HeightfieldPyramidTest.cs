@@ -0,0 +1,277 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Xunit;
+using Stride.Core;
+using Stride.Core.Mathematics;
+
+namespace Stride.Physics.Tests
+{
+    /// <summary>
+    /// Compares the native queries of <see cref="HeightfieldPyramid"/> with brute force managed sampling of the same height sticks.
+    /// </summary>
+    public class HeightfieldPyramidTest
+    {
+        // Not powers of two, so that the pyramid has partial nodes
+        private const int Width = 37;
+        private const int Length = 29;
+
+        private static readonly Vector3 Origin = new Vector3(-(Width - 1) * 0.5f, 0, -(Length - 1) * 0.5f);
+
+        [Fact]
+        public void GetHeights()
+        {
+            var random = new Random(1357);
+            var heights = CreateHeights();
+            using var shape = CreateShape(heights);
+            using var pyramid = new HeightfieldPyramid(shape);
+
+            // Some positions are outside of the heightfield and get clamped
+            var positions = new Vector2[301];
+            for (int i = 0; i < positions.Length; i++)
+                positions[i] = new Vector2(NextFloat(random, -Width * 0.6f, Width * 0.6f), NextFloat(random, -Length * 0.6f, Length * 0.6f));
+
+            var actualHeights = new float[positions.Length];
+            var actualNormals = new Vector3[positions.Length];
+            pyramid.GetHeights(positions, actualHeights, actualNormals);
+
+            for (int i = 0; i < positions.Length; i++)
+            {
+                var expectedHeight = SampleHeight(heights, positions[i].X, positions[i].Y, out var expectedNormal);
+                AssertNearEqual(expectedHeight, actualHeights[i]);
+                AssertNearEqual(expectedNormal, actualNormals[i]);
+            }
+        }
+
+        [Fact]
+        public void GetRegionRange()
+        {
+            var random = new Random(2468);
+            var heights = CreateHeights();
+            using var shape = CreateShape(heights);
+            using var pyramid = new HeightfieldPyramid(shape);
+
+            for (int i = 0; i < 200; i++)
+            {
+                var startX = random.Next(Width - 1);
+                var startZ = random.Next(Length - 1);
+                var endX = random.Next(startX + 1, Width);
+                var endZ = random.Next(startZ + 1, Length);
+
+                // Cells [start, end) are made of the height sticks [start, end]
+                var expected = new Vector2(float.MaxValue, float.MinValue);
+                for (int z = startZ; z <= endZ; z++)
+                {
+                    for (int x = startX; x <= endX; x++)
+                    {
+                        expected.X = Math.Min(expected.X, heights[z * Width + x]);
+                        expected.Y = Math.Max(expected.Y, heights[z * Width + x]);
+                    }
+                }
+
+                var actual = pyramid.GetRegionRange(new Int2(startX, startZ), new Int2(endX, endZ));
+                Assert.Equal(expected, actual);
+            }
+        }
+
+        [Fact]
+        public void ShapePyramidFollowsHeightChanges()
+        {
+            var random = new Random(8642);
+            var heights = CreateHeights();
+            using var shape = CreateShape(heights);
+
+            var pyramid = shape.Pyramid;
+            Assert.Same(pyramid, shape.Pyramid);
+
+            // Raise and lower a few patches of height sticks, then update the pyramid over each patch
+            for (int i = 0; i < 20; i++)
+            {
+                var start = new Int2(random.Next(Width), random.Next(Length));
+                var end = new Int2(random.Next(start.X + 1, Width + 1), random.Next(start.Y + 1, Length + 1));
+                var offset = NextFloat(random, -4, 4);
+
+                using (shape.LockToReadAndWriteHeights())
+                {
+                    for (int z = start.Y; z < end.Y; z++)
+                    {
+                        for (int x = start.X; x < end.X; x++)
+                        {
+                            heights[z * Width + x] += offset;
+                            shape.FloatArray[z * Width + x] = heights[z * Width + x];
+                        }
+                    }
+                }
+                pyramid.Update(start, end);
+
+                var expected = new Vector2(float.MaxValue, float.MinValue);
+                foreach (var height in heights)
+                {
+                    expected.X = Math.Min(expected.X, height);
+                    expected.Y = Math.Max(expected.Y, height);
+                }
+                Assert.Equal(expected, pyramid.GetRegionRange(Int2.Zero, new Int2(Width - 1, Length - 1)));
+            }
+
+            // Same ranges as a pyramid built from scratch
+            using var rebuilt = new HeightfieldPyramid(shape);
+            for (int i = 0; i < 200; i++)
+            {
+                var start = new Int2(random.Next(Width - 1), random.Next(Length - 1));
+                var end = new Int2(random.Next(start.X + 1, Width), random.Next(start.Y + 1, Length));
+                Assert.Equal(rebuilt.GetRegionRange(start, end), pyramid.GetRegionRange(start, end));
+            }
+        }
+
+        [Fact]
+        public void Raycast()
+        {
+            var random = new Random(9753);
+            var heights = CreateHeights();
+            using var shape = CreateShape(heights);
+            using var pyramid = new HeightfieldPyramid(shape);
+
+            var hitCount = 0;
+            for (int i = 0; i < 200; i++)
+            {
+                // Rays start inside and above the highest point, some of them leave the heightfield before reaching the surface
+                var position = new Vector3(NextFloat(random, -Width * 0.45f, Width * 0.45f), 5, NextFloat(random, -Length * 0.45f, Length * 0.45f));
+                var direction = Vector3.Normalize(new Vector3(NextFloat(random, -1, 1), NextFloat(random, -1, -0.4f), NextFloat(random, -1, 1)));
+                var ray = new Ray(position, direction);
+
+                var expectedHit = MarchRay(heights, ray, 40, out var expectedDistance);
+                var actualHit = pyramid.Raycast(ray, float.MaxValue, out var hit);
+                Assert.True(expectedHit == actualHit, $"Ray {i}: expected hit {expectedHit} at {expectedDistance}, got {actualHit} at {hit.Distance}");
+                if (!expectedHit)
+                    continue;
+
+                hitCount++;
+                Assert.True(Math.Abs(expectedDistance - hit.Distance) <= 1e-3f, $"Ray {i}: expected distance {expectedDistance}, got {hit.Distance}");
+                AssertNearEqual(position + direction * hit.Distance, hit.Position);
+
+                SampleHeight(heights, hit.Position.X, hit.Position.Z, out var expectedNormal);
+                AssertNearEqual(expectedNormal, hit.Normal);
+
+                var cellX = Math.Min((int)(hit.Position.X - Origin.X), Width - 2);
+                var cellZ = Math.Min((int)(hit.Position.Z - Origin.Z), Length - 2);
+                Assert.Equal(cellZ * (Width - 1) + cellX, hit.Cell);
+
+                // Nothing is hit before the first crossing
+                Assert.False(pyramid.Raycast(ray, expectedDistance * 0.5f, out _), $"Ray {i} hit before its first crossing");
+            }
+
+            Assert.True(hitCount > 0, "No ray hit the heightfield");
+        }
+
+        private static float[] CreateHeights()
+        {
+            // Smooth enough for the ray marching reference to be accurate
+            var heights = new float[Width * Length];
+            for (int z = 0; z < Length; z++)
+            {
+                for (int x = 0; x < Width; x++)
+                    heights[z * Width + x] = 3.0f * MathF.Sin(x * 0.3f) * MathF.Cos(z * 0.25f) + 0.5f * MathF.Sin(x * 0.7f + z * 0.4f);
+            }
+            return heights;
+        }
+
+        private static HeightfieldColliderShape CreateShape(float[] heights)
+        {
+            var data = new UnmanagedArray<float>(heights.Length);
+            data.Write(heights);
+            // Symmetric range so that the local origin is at a height of 0
+            return new HeightfieldColliderShape(Width, Length, data, 1.0f, -4.0f, 4.0f, false);
+        }
+
+        /// <summary>
+        /// Bilinear height and normal at a local XZ position, clamped to the heightfield.
+        /// </summary>
+        private static float SampleHeight(float[] heights, float positionX, float positionZ, out Vector3 normal)
+        {
+            var x = Math.Clamp(positionX - Origin.X, 0, Width - 1);
+            var z = Math.Clamp(positionZ - Origin.Z, 0, Length - 1);
+            var cellX = Math.Min((int)x, Width - 2);
+            var cellZ = Math.Min((int)z, Length - 2);
+            var u = x - cellX;
+            var v = z - cellZ;
+
+            var h00 = heights[cellZ * Width + cellX];
+            var h10 = heights[cellZ * Width + cellX + 1];
+            var h01 = heights[(cellZ + 1) * Width + cellX];
+            var h11 = heights[(cellZ + 1) * Width + cellX + 1];
+
+            var bottom = MathUtil.Lerp(h00, h10, u);
+            var top = MathUtil.Lerp(h01, h11, u);
+
+            var slopeX = MathUtil.Lerp(h10 - h00, h11 - h01, v);
+            var slopeZ = top - bottom;
+            normal = Vector3.Normalize(new Vector3(-slopeX, 1, -slopeZ));
+
+            return MathUtil.Lerp(bottom, top, v) + Origin.Y;
+        }
+
+        /// <summary>
+        /// Finds the first point where the ray goes under the surface by small steps, then refines it by bisection.
+        /// </summary>
+        private static bool MarchRay(float[] heights, Ray ray, float maxDistance, out float distance)
+        {
+            const float Step = 0.005f;
+
+            distance = -1;
+            for (var t = 0.0f; t <= maxDistance; t += Step)
+            {
+                var point = ray.Position + ray.Direction * t;
+
+                // The ray starts inside the heightfield, once it leaves it can't come back
+                if (!IsInside(point))
+                    return false;
+
+                if (point.Y > SampleHeight(heights, point.X, point.Z, out _))
+                    continue;
+
+                var above = Math.Max(t - Step, 0);
+                var below = t;
+                for (int i = 0; i < 30; i++)
+                {
+                    var middle = (above + below) * 0.5f;
+                    var middlePoint = ray.Position + ray.Direction * middle;
+                    if (middlePoint.Y <= SampleHeight(heights, middlePoint.X, middlePoint.Z, out _))
+                        below = middle;
+                    else
+                        above = middle;
+                }
+
+                distance = below;
+                return true;
+            }
+
+            return false;
+        }
+
+        private static bool IsInside(Vector3 point)
+        {
+            return point.X >= Origin.X && point.X <= -Origin.X && point.Z >= Origin.Z && point.Z <= -Origin.Z;
+        }
+
+        private static float NextFloat(Random random, float minimum, float maximum)
+        {
+            return minimum + (float)random.NextDouble() * (maximum - minimum);
+        }
+
+        private static void AssertNearEqual(float expected, float actual)
+        {
+            var tolerance = 1e-4f * Math.Max(1.0f, Math.Abs(expected));
+            Assert.True(Math.Abs(expected - actual) <= tolerance, $"Expected {expected}, got {actual}");
+        }
+
+        private static void AssertNearEqual(Vector3 expected, Vector3 actual)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                var tolerance = 1e-3f * Math.Max(1.0f, Math.Abs(expected[i]));
+                Assert.True(Math.Abs(expected[i] - actual[i]) <= tolerance, $"Component {i}: expected {expected}, got {actual}");
+            }
+        }
+    }
+}
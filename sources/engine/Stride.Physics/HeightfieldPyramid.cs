@@ -0,0 +1,226 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using System.Runtime.InteropServices;
+using Stride.Core;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Native;
+
+namespace Stride.Physics;
+
+/// <summary>
+/// Result of a raycast against a <see cref="HeightfieldPyramid"/>.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct HeightfieldHit
+{
+    /// <summary>
+    /// The hit position, in the heightfield local space.
+    /// </summary>
+    public Vector3 Position;
+
+    /// <summary>
+    /// The distance along the ray, in units of the ray direction. Negative when nothing was hit.
+    /// </summary>
+    public float Distance;
+
+    /// <summary>
+    /// The surface normal at the hit position.
+    /// </summary>
+    public Vector3 Normal;
+
+    /// <summary>
+    /// The index of the hit cell (z * (HeightStickWidth - 1) + x), -1 when nothing was hit.
+    /// </summary>
+    public int Cell;
+
+    public readonly bool Succeeded => Cell >= 0;
+}
+
+/// <summary>
+/// A min/max height pyramid over the height sticks of a <see cref="HeightfieldColliderShape"/>, answering batches of height,
+/// normal and raycast queries natively.
+/// </summary>
+/// <remarks>
+/// Positions, rays and hits are in the local space of the collider shape (centered like the physics engine does, before scaling).
+/// Heights are sampled bilinearly between height sticks.
+/// The pyramid keeps a copy of the heights: call <see cref="Update(Int2, Int2)"/> after modifying them.
+/// </remarks>
+public sealed unsafe class HeightfieldPyramid : IDisposable
+{
+    /// <summary>
+    /// Batches with at least this many queries are split across threads
+    /// </summary>
+    private const int ParallelThreshold = 1024;
+
+    private readonly HeightfieldColliderShape shape;
+    private UnmanagedArray<float> heights;
+    private UnmanagedArray<Vector2> pyramid;
+    private Vector3 origin;
+
+    private struct HeightsJob
+    {
+        public HeightfieldPyramid Pyramid;
+        public Vector2* Positions;
+        public float* Heights;
+        public Vector3* Normals;
+    }
+
+    private struct RaycastJob
+    {
+        public HeightfieldPyramid Pyramid;
+        public Ray* Rays;
+        public float* MaxDistances;
+        public HeightfieldHit* Hits;
+    }
+
+    public HeightfieldPyramid(HeightfieldColliderShape shape)
+    {
+        ArgumentNullException.ThrowIfNull(shape);
+
+        this.shape = shape;
+        HeightStickWidth = shape.HeightStickWidth;
+        HeightStickLength = shape.HeightStickLength;
+        origin = new Vector3(-(HeightStickWidth - 1) * 0.5f, -(shape.MinHeight + shape.MaxHeight) * 0.5f, -(HeightStickLength - 1) * 0.5f);
+
+        heights = new UnmanagedArray<float>(HeightStickWidth * HeightStickLength);
+        pyramid = new UnmanagedArray<Vector2>(NativeInvoke.HeightfieldPyramidSize(HeightStickWidth, HeightStickLength));
+
+        // A full build fills each level from the one below, instead of walking up from every cell like Update
+        CopyHeights(0, HeightStickLength);
+        NativeInvoke.HeightfieldBuildPyramid((float*)heights.Pointer, HeightStickWidth, HeightStickLength, (void*)pyramid.Pointer);
+    }
+
+    public int HeightStickWidth { get; }
+
+    public int HeightStickLength { get; }
+
+    /// <summary>
+    /// Copies the heights of the height sticks in [<paramref name="start"/>, <paramref name="end"/>) from the shape and updates the pyramid.
+    /// </summary>
+    /// <param name="start">The first modified height stick (X is width and Y is length)</param>
+    /// <param name="end">The end of the modified region, exclusive</param>
+    public void Update(Int2 start, Int2 end)
+    {
+        start = Int2.Max(start, Int2.Zero);
+        end = Int2.Min(end, new Int2(HeightStickWidth, HeightStickLength));
+        if (start.X >= end.X || start.Y >= end.Y)
+            return;
+
+        CopyHeights(start.Y, end.Y);
+
+        // Cells on both sides of a modified height stick
+        NativeInvoke.HeightfieldUpdatePyramid((float*)heights.Pointer, HeightStickWidth, HeightStickLength, (void*)pyramid.Pointer, start.X - 1, start.Y - 1, end.X, end.Y);
+    }
+
+    /// <summary>
+    /// Gets the lowest and highest heights (X and Y) of the cells in [<paramref name="start"/>, <paramref name="end"/>).
+    /// </summary>
+    public Vector2 GetRegionRange(Int2 start, Int2 end)
+    {
+        Vector2 range;
+        NativeInvoke.HeightfieldGetRegionRange((void*)pyramid.Pointer, HeightStickWidth, HeightStickLength, start.X, start.Y, end.X, end.Y, &range);
+        return new Vector2(range.X + origin.Y, range.Y + origin.Y);
+    }
+
+    /// <summary>
+    /// Samples the height, and the normal if <paramref name="normals"/> is not empty, at local XZ positions (X is local X and Y is local Z).
+    /// Positions outside of the heightfield are clamped to its border.
+    /// </summary>
+    public void GetHeights(ReadOnlySpan<Vector2> positions, Span<float> heights, Span<Vector3> normals = default)
+    {
+        if (heights.Length < positions.Length || (!normals.IsEmpty && normals.Length < positions.Length))
+            throw new ArgumentException("The output spans must have at least one element per position.");
+
+        fixed (Vector2* positionsPtr = positions)
+        fixed (float* heightsPtr = heights)
+        fixed (Vector3* normalsPtr = normals)
+        {
+            var job = new HeightsJob { Pyramid = this, Positions = positionsPtr, Heights = heightsPtr, Normals = normalsPtr };
+            if (positions.Length >= ParallelThreshold)
+                Dispatcher.ForBatched(positions.Length, job, &GetHeightsBatch);
+            else
+                GetHeightsBatch(job, 0, positions.Length);
+        }
+    }
+
+    /// <summary>
+    /// Finds the closest hit of each ray with the heightfield surface, within <paramref name="maxDistances"/> (infinite if empty).
+    /// </summary>
+    public void Raycast(ReadOnlySpan<Ray> rays, ReadOnlySpan<float> maxDistances, Span<HeightfieldHit> hits)
+    {
+        if (hits.Length < rays.Length || (!maxDistances.IsEmpty && maxDistances.Length < rays.Length))
+            throw new ArgumentException("The spans must have at least one element per ray.");
+
+        fixed (Ray* raysPtr = rays)
+        fixed (float* maxDistancesPtr = maxDistances)
+        fixed (HeightfieldHit* hitsPtr = hits)
+        {
+            var job = new RaycastJob { Pyramid = this, Rays = raysPtr, MaxDistances = maxDistancesPtr, Hits = hitsPtr };
+            if (rays.Length >= ParallelThreshold)
+                Dispatcher.ForBatched(rays.Length, job, &RaycastBatch);
+            else
+                RaycastBatch(job, 0, rays.Length);
+        }
+    }
+
+    /// <summary>
+    /// Finds the closest hit of a ray with the heightfield surface.
+    /// </summary>
+    public bool Raycast(Ray ray, float maxDistance, out HeightfieldHit hit)
+    {
+        hit = default;
+        fixed (HeightfieldHit* hitPtr = &hit)
+        {
+            RaycastBatch(new RaycastJob { Pyramid = this, Rays = &ray, MaxDistances = &maxDistance, Hits = hitPtr }, 0, 1);
+        }
+        return hit.Succeeded;
+    }
+
+    public void Dispose()
+    {
+        heights?.Dispose();
+        heights = null;
+        pyramid?.Dispose();
+        pyramid = null;
+    }
+
+    /// <summary>
+    /// Copies the heights of the rows of height sticks in [<paramref name="startZ"/>, <paramref name="endZ"/>) from the shape, as floats.
+    /// </summary>
+    private void CopyHeights(int startZ, int endZ)
+    {
+        // Whole rows are copied, they are contiguous in the source
+        var firstStick = startZ * HeightStickWidth;
+        var stickCount = (endZ - startZ) * HeightStickWidth;
+
+        using (shape.LockToReadHeights())
+        {
+            var (source, elementSize) = shape.HeightType switch
+            {
+                HeightfieldTypes.Short => (shape.ShortArray.Pointer, sizeof(short)),
+                HeightfieldTypes.Byte => (shape.ByteArray.Pointer, sizeof(byte)),
+                HeightfieldTypes.Float => (shape.FloatArray.Pointer, sizeof(float)),
+                _ => throw new NotSupportedException(),
+            };
+
+            NativeInvoke.HeightfieldConvertHeights((byte*)source + firstStick * elementSize, (int)shape.HeightType, shape.HeightScale, (float*)heights.Pointer + firstStick, stickCount);
+        }
+    }
+
+    private static void GetHeightsBatch(HeightsJob job, int start, int end)
+    {
+        var pyramid = job.Pyramid;
+        var origin = pyramid.origin;
+        NativeInvoke.HeightfieldGetHeightsRange((float*)pyramid.heights.Pointer, pyramid.HeightStickWidth, pyramid.HeightStickLength, &origin, job.Positions, job.Heights, job.Normals, start, end);
+    }
+
+    private static void RaycastBatch(RaycastJob job, int start, int end)
+    {
+        var pyramid = job.Pyramid;
+        var origin = pyramid.origin;
+        NativeInvoke.HeightfieldRaycastRange((float*)pyramid.heights.Pointer, pyramid.HeightStickWidth, pyramid.HeightStickLength, (void*)pyramid.pyramid.Pointer, &origin, job.Rays, job.MaxDistances, job.Hits, start, end);
+    }
+}
@@ -119,6 +119,17 @@ public class HeightfieldColliderShape : ColliderShape
     public float MinHeight { get; private set; }
     public float MaxHeight { get; private set; }
 
+    /// <summary>
+    /// Gets the min/max height pyramid of this shape, built on first use, to answer batches of height, normal and raycast
+    /// queries without going through the physics engine (e.g. to place objects on a terrain).
+    /// </summary>
+    /// <remarks>
+    /// The pyramid keeps its own copy of the heights: call <see cref="HeightfieldPyramid.Update(Int2, Int2)"/> after modifying them.
+    /// </remarks>
+    public HeightfieldPyramid Pyramid => LazyInitializer.EnsureInitialized(ref pyramid, () => new HeightfieldPyramid(this));
+
+    private HeightfieldPyramid pyramid;
+
     public override IDebugPrimitive CreateUpdatableDebugPrimitive(GraphicsDevice graphicsDevice)
     {
         return HeightfieldDebugPrimitive.New(graphicsDevice, this);
@@ -142,6 +153,9 @@ public class HeightfieldColliderShape : ColliderShape
     {
         base.Dispose();
 
+        pyramid?.Dispose();
+        pyramid = null;
+
         using (LockToReadAndWriteHeights())
         {
             ShortArray?.Dispose();
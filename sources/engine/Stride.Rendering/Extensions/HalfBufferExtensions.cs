@@ -7,6 +7,7 @@ using Stride.Core;
 using Stride.Core.Mathematics;
 using Stride.Graphics;
 using Stride.Graphics.Data;
+using Stride.Native;
 
 namespace Stride.Extensions
 {
@@ -126,6 +127,63 @@ namespace Stride.Extensions
             vertexBufferBinding = new VertexBufferBinding(new BufferData(BufferFlags.VertexBuffer, newBufferData).ToSerializableVersion(), vertexDeclaration, vertexBufferBinding.Count);
         }
 
+        /// <summary>
+        /// Converts the texture coordinates stored as 2 floats to 2 half floats (R16G16_Float), which the input assembler converts back to float without shader changes.
+        /// </summary>
+        /// <param name="vertexBufferBinding">The vertex buffer, replaced by a new one if any texture coordinate was converted.</param>
+        /// <returns>True if texture coordinates were converted.</returns>
+        /// <remarks>
+        /// Half floats have a step of 1/2048 between 0.5 and 1 that doubles with every power of 2 further from 0, so this suits textures up to 2048 pixels that aren't tiled many times.
+        /// </remarks>
+        public static unsafe bool CompactHalfTextureCoordinates(ref VertexBufferBinding vertexBufferBinding)
+        {
+            var vertexElements = vertexBufferBinding.Declaration.EnumerateWithOffsets().OrderBy(x => x.Offset).ToArray();
+            var converted = new bool[vertexElements.Length];
+            var newElements = new VertexElement[vertexElements.Length];
+
+            // Following elements move back by the size saved on the ones before them
+            var offsetShift = 0;
+            for (int index = 0; index < vertexElements.Length; index++)
+            {
+                var vertexElement = vertexElements[index].VertexElement;
+                converted[index] = vertexElement.SemanticName == VertexElementUsage.TextureCoordinate && vertexElement.Format == PixelFormat.R32G32_Float;
+                var format = converted[index] ? PixelFormat.R16G16_Float : vertexElement.Format;
+                newElements[index] = new VertexElement(vertexElement.SemanticName, vertexElement.SemanticIndex, format, vertexElements[index].Offset - offsetShift);
+                if (converted[index])
+                    offsetShift += Unsafe.SizeOf<Vector2>() - Unsafe.SizeOf<Half2>();
+            }
+
+            if (offsetShift == 0)
+                return false;
+
+            var vertexCount = vertexBufferBinding.Count;
+            var oldVertexStride = vertexBufferBinding.Stride;
+            var vertexDeclaration = new VertexDeclaration(newElements, vertexBufferBinding.Declaration.InstanceCount, oldVertexStride - offsetShift);
+            var newVertexStride = vertexDeclaration.VertexStride;
+            var newBufferData = new byte[vertexCount * newVertexStride];
+            fixed (byte* oldBuffer = &vertexBufferBinding.Buffer.GetSerializationData().Content[vertexBufferBinding.Offset])
+            fixed (byte* newBuffer = &newBufferData[0])
+            {
+                for (int index = 0; index < vertexElements.Length; index++)
+                {
+                    var oldElement = oldBuffer + vertexElements[index].Offset;
+                    var newElement = newBuffer + newElements[index].AlignedByteOffset;
+                    if (converted[index])
+                    {
+                        NativeInvoke.PackHalf2(oldElement, oldVertexStride, newElement, newVertexStride, vertexCount);
+                    }
+                    else
+                    {
+                        for (int i = 0; i < vertexCount; ++i)
+                            MemoryUtilities.CopyWithAlignmentFallback(newElement + i * newVertexStride, oldElement + i * oldVertexStride, (uint)vertexElements[index].Size);
+                    }
+                }
+            }
+
+            vertexBufferBinding = new VertexBufferBinding(new BufferData(BufferFlags.VertexBuffer, newBufferData).ToSerializableVersion(), vertexDeclaration, vertexCount);
+            return true;
+        }
+
         private struct VertexElementConvertInfo
         {
             public VertexElementWithOffset VertexElementWithOffset;
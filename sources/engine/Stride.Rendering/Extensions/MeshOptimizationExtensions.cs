@@ -0,0 +1,250 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+
+using System;
+using Stride.Core.Mathematics;
+using Stride.Graphics;
+using Stride.Graphics.Data;
+using Stride.Native;
+using Stride.Rendering;
+
+namespace Stride.Extensions
+{
+    public static class MeshOptimizationExtensions
+    {
+        // How much normal and texture coordinate changes cost when simplifying, relative to a distance of the size of the mesh
+        private const float SimplifyNormalWeight = 0.5f;
+        private const float SimplifyTextureWeight = 1.0f;
+
+        /// <summary>
+        /// Reorders the triangles of a mesh for the post transform vertex cache and to reduce overdraw, then its vertices in the order they are first used.
+        /// Vertices that are exact duplicates are merged and unused vertices are removed.
+        /// </summary>
+        /// <param name="meshData">The mesh data.</param>
+        /// <param name="overdrawThreshold">How much vertex cache efficiency can be traded for less overdraw (1.05 allows 5% more cache misses), 0 to skip overdraw sorting.</param>
+        /// <returns>True if the mesh was optimized, false if it is not an indexed triangle list with a single CPU side vertex buffer.</returns>
+        /// <remarks>
+        /// The vertex and index buffers are replaced rather than modified, so they can be shared with other meshes. Different meshes can be optimized concurrently.
+        /// </remarks>
+        public static unsafe bool Optimize(this MeshDraw meshData, float overdrawThreshold = 1.05f)
+        {
+            if (meshData.PrimitiveType != PrimitiveType.TriangleList || meshData.IndexBuffer == null || meshData.VertexBuffers.Length != 1
+                || meshData.StartLocation != 0 || meshData.DrawCount != meshData.IndexBuffer.Count)
+                return false;
+
+            var vertexBuffer = meshData.VertexBuffers[0];
+            var indexBuffer = meshData.IndexBuffer;
+            var vertexBufferData = vertexBuffer.Buffer.GetSerializationData()?.Content;
+            var indexBufferData = indexBuffer.Buffer.GetSerializationData()?.Content;
+            if (vertexBufferData == null || indexBufferData == null)
+                return false;
+
+            var stride = vertexBuffer.Stride;
+            var vertexCount = vertexBuffer.Count;
+            var indexCount = indexBuffer.Count - indexBuffer.Count % 3;
+            if (indexCount == 0)
+                return false;
+
+            var indices = ReadIndices(indexBuffer, indexBufferData, indexCount, vertexCount);
+            if (indices == null)
+                return false;
+
+            var vertices = new byte[vertexCount * stride];
+            Array.Copy(vertexBufferData, vertexBuffer.Offset, vertices, 0, vertices.Length);
+
+            // Welding and overdraw sorting need float positions
+            var positionOffset = -1;
+            foreach (var vertexElement in vertexBuffer.Declaration.EnumerateWithOffsets())
+            {
+                if (vertexElement.VertexElement.SemanticName == VertexElementUsage.Position && vertexElement.VertexElement.SemanticIndex == 0
+                    && (vertexElement.VertexElement.Format == PixelFormat.R32G32B32_Float || vertexElement.VertexElement.Format == PixelFormat.R32G32B32A32_Float))
+                {
+                    positionOffset = vertexElement.Offset;
+                    break;
+                }
+            }
+
+            var remap = new uint[vertexCount];
+            if (positionOffset >= 0)
+            {
+                // Only exact duplicates, a positive epsilon would move vertices
+                int weldedVertexCount;
+                fixed (uint* remapPtr = remap)
+                fixed (uint* indicesPtr = indices)
+                fixed (byte* verticesPtr = vertices)
+                {
+                    weldedVertexCount = NativeInvoke.WeldVertices(remapPtr, verticesPtr, vertexCount, stride, positionOffset, 0.0f);
+                    if (weldedVertexCount < 0)
+                        return false;
+                    NativeInvoke.RemapIndexBuffer(indicesPtr, indicesPtr, indexCount, remapPtr);
+                }
+
+                vertices = RemapVertices(vertices, vertexCount, stride, remap, weldedVertexCount);
+                vertexCount = weldedVertexCount;
+            }
+
+            var optimizedIndices = new uint[indexCount];
+            fixed (uint* indicesPtr = indices)
+            fixed (uint* optimizedIndicesPtr = optimizedIndices)
+            fixed (byte* verticesPtr = vertices)
+            {
+                if (!NativeInvoke.OptimizeVertexCache(optimizedIndicesPtr, indicesPtr, indexCount, vertexCount))
+                    return false;
+
+                if (positionOffset >= 0 && overdrawThreshold > 0.0f)
+                {
+                    if (!NativeInvoke.OptimizeOverdraw(indicesPtr, optimizedIndicesPtr, indexCount, verticesPtr + positionOffset, stride, vertexCount, overdrawThreshold))
+                        return false;
+                }
+                else
+                {
+                    Array.Copy(optimizedIndices, indices, indexCount);
+                }
+            }
+
+            int usedVertexCount;
+            fixed (uint* remapPtr = remap)
+            fixed (uint* indicesPtr = indices)
+            {
+                usedVertexCount = NativeInvoke.OptimizeVertexFetchRemap(remapPtr, indicesPtr, indexCount, vertexCount);
+                NativeInvoke.RemapIndexBuffer(indicesPtr, indicesPtr, indexCount, remapPtr);
+            }
+            vertices = RemapVertices(vertices, vertexCount, stride, remap, usedVertexCount);
+
+            // Keep the index size, the vertex count can only decrease
+            meshData.VertexBuffers[0] = new VertexBufferBinding(new BufferData(BufferFlags.VertexBuffer, vertices).ToSerializableVersion(), vertexBuffer.Declaration, usedVertexCount, stride);
+            meshData.IndexBuffer = CreateIndexBuffer(indices, indexCount, indexBuffer.Is32Bit);
+            meshData.DrawCount = indexCount;
+            return true;
+        }
+
+        /// <summary>
+        /// Removes triangles from a mesh by collapsing edges, until <paramref name="triangleRatio"/> of its triangles are left or collapses would exceed <paramref name="targetError"/>.
+        /// </summary>
+        /// <param name="meshData">The mesh data.</param>
+        /// <param name="triangleRatio">The fraction of triangles to keep.</param>
+        /// <param name="targetError">The largest error allowed, relative to the size of the mesh (0.01 is 1% of its largest side).</param>
+        /// <param name="resultError">The largest error introduced, relative to the size of the mesh.</param>
+        /// <returns>True if the mesh was simplified, false if it is not an indexed triangle list with a single CPU side vertex buffer with float positions.</returns>
+        /// <remarks>
+        /// Only the index buffer is replaced: vertices collapse onto existing vertices, so the vertex buffer is kept and can be shared by several levels of detail.
+        /// Open borders don't move and attribute seams stay closed. Positions, normals and first texture coordinates are taken into account.
+        /// Different meshes can be simplified concurrently.
+        /// </remarks>
+        public static unsafe bool Simplify(this MeshDraw meshData, float triangleRatio, float targetError, out float resultError)
+        {
+            resultError = 0.0f;
+            if (meshData.PrimitiveType != PrimitiveType.TriangleList || meshData.IndexBuffer == null || meshData.VertexBuffers.Length != 1
+                || meshData.StartLocation != 0 || meshData.DrawCount != meshData.IndexBuffer.Count)
+                return false;
+
+            var vertexBuffer = meshData.VertexBuffers[0];
+            var indexBuffer = meshData.IndexBuffer;
+            var vertexBufferData = vertexBuffer.Buffer.GetSerializationData()?.Content;
+            var indexBufferData = indexBuffer.Buffer.GetSerializationData()?.Content;
+            if (vertexBufferData == null || indexBufferData == null)
+                return false;
+
+            var vertexCount = vertexBuffer.Count;
+            var indexCount = indexBuffer.Count - indexBuffer.Count % 3;
+            var indices = ReadIndices(indexBuffer, indexBufferData, indexCount, vertexCount);
+            if (indices == null)
+                return false;
+
+            // The simplifier reads position, normal and texture coordinate, missing or non float attributes are left to 0
+            int positionOffset = -1, normalOffset = -1, textureCoordinateOffset = -1;
+            foreach (var vertexElement in vertexBuffer.Declaration.EnumerateWithOffsets())
+            {
+                var element = vertexElement.VertexElement;
+                if (element.SemanticIndex != 0)
+                    continue;
+                if (element.SemanticName == VertexElementUsage.Position && (element.Format == PixelFormat.R32G32B32_Float || element.Format == PixelFormat.R32G32B32A32_Float))
+                    positionOffset = vertexElement.Offset;
+                else if (element.SemanticName == VertexElementUsage.Normal && (element.Format == PixelFormat.R32G32B32_Float || element.Format == PixelFormat.R32G32B32A32_Float))
+                    normalOffset = vertexElement.Offset;
+                else if (element.SemanticName == VertexElementUsage.TextureCoordinate && element.Format == PixelFormat.R32G32_Float)
+                    textureCoordinateOffset = vertexElement.Offset;
+            }
+            if (positionOffset < 0)
+                return false;
+
+            var stride = vertexBuffer.Stride;
+            var attributes = new VertexPositionNormalTexture[vertexCount];
+            fixed (byte* vertexBufferStart = &vertexBufferData[vertexBuffer.Offset])
+            {
+                for (int v = 0; v < vertexCount; ++v)
+                {
+                    var vertex = vertexBufferStart + v * stride;
+                    attributes[v].Position = *(Vector3*)(vertex + positionOffset);
+                    if (normalOffset >= 0)
+                        attributes[v].Normal = *(Vector3*)(vertex + normalOffset);
+                    if (textureCoordinateOffset >= 0)
+                        attributes[v].TextureCoordinate = *(Vector2*)(vertex + textureCoordinateOffset);
+                }
+            }
+
+            var targetIndexCount = (int)(indexCount / 3 * Math.Clamp(triangleRatio, 0.0f, 1.0f)) * 3;
+            int newIndexCount;
+            fixed (uint* indicesPtr = indices)
+            fixed (VertexPositionNormalTexture* attributesPtr = attributes)
+            fixed (float* resultErrorPtr = &resultError)
+            {
+                newIndexCount = NativeInvoke.SimplifyMesh(indicesPtr, indicesPtr, indexCount, attributesPtr, vertexCount, targetIndexCount, targetError, SimplifyNormalWeight, SimplifyTextureWeight, resultErrorPtr);
+            }
+
+            meshData.IndexBuffer = CreateIndexBuffer(indices, newIndexCount, indexBuffer.Is32Bit);
+            meshData.DrawCount = newIndexCount;
+            return true;
+        }
+
+        /// <summary>
+        /// Reads the first <paramref name="indexCount"/> indices of a buffer, or returns null if any is out of range.
+        /// </summary>
+        private static unsafe uint[] ReadIndices(IndexBufferBinding indexBuffer, byte[] indexBufferData, int indexCount, int vertexCount)
+        {
+            var indices = new uint[indexCount];
+            if (indexCount == 0)
+                return indices;
+
+            fixed (byte* indexBufferStart = &indexBufferData[indexBuffer.Offset])
+            {
+                for (int i = 0; i < indexCount; ++i)
+                {
+                    var index = indexBuffer.Is32Bit ? ((uint*)indexBufferStart)[i] : ((ushort*)indexBufferStart)[i];
+                    if (index >= (uint)vertexCount)
+                        return null;
+                    indices[i] = index;
+                }
+            }
+            return indices;
+        }
+
+        private static unsafe IndexBufferBinding CreateIndexBuffer(uint[] indices, int indexCount, bool is32Bit)
+        {
+            var indexBufferData = new byte[indexCount * (is32Bit ? sizeof(uint) : sizeof(ushort))];
+            fixed (byte* indexBufferStart = indexBufferData)
+            {
+                for (int i = 0; i < indexCount; ++i)
+                {
+                    if (is32Bit)
+                        ((uint*)indexBufferStart)[i] = indices[i];
+                    else
+                        ((ushort*)indexBufferStart)[i] = (ushort)indices[i];
+                }
+            }
+            return new IndexBufferBinding(new BufferData(BufferFlags.IndexBuffer, indexBufferData).ToSerializableVersion(), is32Bit, indexCount);
+        }
+
+        private static unsafe byte[] RemapVertices(byte[] vertices, int vertexCount, int stride, uint[] remap, int newVertexCount)
+        {
+            var newVertices = new byte[newVertexCount * stride];
+            fixed (byte* verticesPtr = vertices)
+            fixed (byte* newVerticesPtr = newVertices)
+            fixed (uint* remapPtr = remap)
+            {
+                NativeInvoke.RemapVertexBuffer(newVerticesPtr, verticesPtr, vertexCount, stride, remapPtr);
+            }
+            return newVertices;
+        }
+    }
+}
@@ -0,0 +1,94 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+using System;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Native;
+
+namespace Stride.Rendering
+{
+    /// <summary>
+    /// A bounding volume hierarchy over bounding boxes, finding the closest box hit by rays natively (object level picking, probe visibility).
+    /// </summary>
+    /// <remarks>
+    /// A box is hit at the distance where the ray enters it, 0 when the ray starts inside. The hierarchy keeps a copy of the boxes,
+    /// and queries are thread-safe.
+    /// </remarks>
+    public sealed unsafe class BoundingBoxBvh
+    {
+        /// <summary>
+        /// Batches with at least this many rays are split across threads
+        /// </summary>
+        private const int ParallelThreshold = 1024;
+
+        private readonly BoundingBox[] boxes;
+        private readonly BvhBuilder.Node[] nodes;
+        private readonly uint[] primitiveIndices;
+
+        private struct RaycastJob
+        {
+            public BoundingBoxBvh Bvh;
+            public Ray* Rays;
+            public float* MaxDistances;
+            public BvhHit* Hits;
+        }
+
+        public BoundingBoxBvh(ReadOnlySpan<BoundingBox> boxes)
+        {
+            this.boxes = boxes.ToArray();
+            BvhBuilder.Build(this.boxes, out nodes, out primitiveIndices);
+        }
+
+        public int BoxCount => boxes.Length;
+
+        /// <summary>
+        /// Finds the closest box hit by a ray within <paramref name="maxDistance"/>.
+        /// </summary>
+        public bool Raycast(Ray ray, float maxDistance, out BvhHit hit)
+        {
+            hit = BvhHit.Miss;
+            fixed (BvhHit* hitPtr = &hit)
+            {
+                Raycast(new ReadOnlySpan<Ray>(&ray, 1), new ReadOnlySpan<float>(&maxDistance, 1), new Span<BvhHit>(hitPtr, 1));
+            }
+            return hit.Succeeded;
+        }
+
+        /// <summary>
+        /// Finds the closest box hit by each ray, within <paramref name="maxDistances"/> (infinite if empty).
+        /// </summary>
+        public void Raycast(ReadOnlySpan<Ray> rays, ReadOnlySpan<float> maxDistances, Span<BvhHit> hits)
+        {
+            if (hits.Length < rays.Length || (!maxDistances.IsEmpty && maxDistances.Length < rays.Length))
+                throw new ArgumentException("The spans must have at least one element per ray.");
+
+            if (boxes.Length == 0)
+            {
+                hits.Slice(0, rays.Length).Fill(BvhHit.Miss);
+                return;
+            }
+
+            fixed (Ray* raysPtr = rays)
+            fixed (float* maxDistancesPtr = maxDistances)
+            fixed (BvhHit* hitsPtr = hits)
+            {
+                var job = new RaycastJob { Bvh = this, Rays = raysPtr, MaxDistances = maxDistancesPtr, Hits = hitsPtr };
+                if (rays.Length >= ParallelThreshold)
+                    Dispatcher.ForBatched(rays.Length, job, &RaycastBatch);
+                else
+                    RaycastBatch(job, 0, rays.Length);
+            }
+        }
+
+        private static void RaycastBatch(RaycastJob job, int start, int end)
+        {
+            var bvh = job.Bvh;
+            fixed (BvhBuilder.Node* nodesPtr = bvh.nodes)
+            fixed (uint* primitiveIndicesPtr = bvh.primitiveIndices)
+            fixed (BoundingBox* boxesPtr = bvh.boxes)
+            {
+                NativeInvoke.BvhIntersectBoxesRange(nodesPtr, primitiveIndicesPtr, boxesPtr, job.Rays, job.MaxDistances, job.Hits, start, end);
+            }
+        }
+    }
+}
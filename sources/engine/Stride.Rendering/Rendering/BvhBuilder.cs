@@ -0,0 +1,84 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+using System;
+using System.Runtime.InteropServices;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Native;
+
+namespace Stride.Rendering
+{
+    /// <summary>
+    /// Builds the native bounding volume hierarchy shared by <see cref="TriangleBvh"/> and <see cref="BoundingBoxBvh"/>.
+    /// </summary>
+    internal static unsafe class BvhBuilder
+    {
+        /// <summary>
+        /// Hierarchies over at least this many primitives build their subtrees on several threads
+        /// </summary>
+        private const int ParallelThreshold = 16384;
+
+        private const int MaxTasks = 64;
+
+        // Same layout as BvhNode in the native code
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct Node
+        {
+            public Vector3 Minimum;
+            public uint LeftOrFirst;
+            public Vector3 Maximum;
+            public uint Count;
+        }
+
+        // Same layout as BvhBuildTask in the native code
+        [StructLayout(LayoutKind.Sequential)]
+        private struct BuildTask
+        {
+            public uint NodeIndex;
+            public uint DescendantStart;
+            public uint First;
+            public uint Count;
+        }
+
+        private struct BuildJob
+        {
+            public BoundingBox* Bounds;
+            public Node* Nodes;
+            public uint* PrimitiveIndices;
+            public BuildTask* Tasks;
+        }
+
+        /// <summary>
+        /// Builds a hierarchy over <paramref name="bounds"/>, with 2 * count - 1 nodes (none when there are no primitives).
+        /// </summary>
+        public static void Build(ReadOnlySpan<BoundingBox> bounds, out Node[] nodes, out uint[] primitiveIndices)
+        {
+            nodes = new Node[Math.Max(2 * bounds.Length - 1, 0)];
+            primitiveIndices = new uint[bounds.Length];
+            if (bounds.IsEmpty)
+                return;
+
+            fixed (BoundingBox* boundsPtr = bounds)
+            fixed (Node* nodesPtr = nodes)
+            fixed (uint* primitiveIndicesPtr = primitiveIndices)
+            {
+                if (bounds.Length < ParallelThreshold)
+                {
+                    NativeInvoke.BvhBuild(boundsPtr, bounds.Length, nodesPtr, primitiveIndicesPtr);
+                    return;
+                }
+
+                // The top of the tree is built first, the subtrees below it don't share any node
+                var tasks = stackalloc BuildTask[MaxTasks];
+                var taskCount = NativeInvoke.BvhBuildTopLevel(boundsPtr, bounds.Length, nodesPtr, primitiveIndicesPtr, tasks, MaxTasks);
+                var job = new BuildJob { Bounds = boundsPtr, Nodes = nodesPtr, PrimitiveIndices = primitiveIndicesPtr, Tasks = tasks };
+                Dispatcher.ForBatched(taskCount, job, &BuildBatch);
+            }
+        }
+
+        private static void BuildBatch(BuildJob job, int start, int end)
+        {
+            NativeInvoke.BvhBuildTasks(job.Bounds, job.Nodes, job.PrimitiveIndices, job.Tasks, start, end);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+using System.Runtime.InteropServices;
+
+namespace Stride.Rendering
+{
+    /// <summary>
+    /// Result of a raycast against a <see cref="TriangleBvh"/> or a <see cref="BoundingBoxBvh"/>.
+    /// </summary>
+    // Same layout as BvhHit in the native code
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BvhHit
+    {
+        internal static readonly BvhHit Miss = new BvhHit { Distance = float.PositiveInfinity, PrimitiveIndex = -1 };
+
+        /// <summary>
+        /// The distance along the ray, in units of the ray direction. Infinite when nothing was hit.
+        /// </summary>
+        public float Distance;
+
+        /// <summary>
+        /// The index of the hit triangle or box, -1 when nothing was hit.
+        /// </summary>
+        public int PrimitiveIndex;
+
+        /// <summary>
+        /// The barycentric coordinate of the hit relative to the second vertex of the triangle, 0 for boxes.
+        /// </summary>
+        public float U;
+
+        /// <summary>
+        /// The barycentric coordinate of the hit relative to the third vertex of the triangle, 0 for boxes.
+        /// </summary>
+        public float V;
+
+        public readonly bool Succeeded => PrimitiveIndex >= 0;
+    }
+}
@@ -3,11 +3,14 @@
 
 using System;
 using System.Collections.Generic;
+using System.Runtime.InteropServices;
 using Stride.Core;
 using Stride.Core.Collections;
 using Stride.Core.Mathematics;
+using Stride.Core.Threading;
 using Stride.Engine;
 using Stride.Graphics;
+using Stride.Native;
 using Stride.Rendering.Shadows;
 using Stride.Shaders;
 using Buffer = Stride.Graphics.Buffer;
@@ -155,11 +158,18 @@ namespace Stride.Rendering.Lights
             // Artifically increase range of first slice to not waste too much slices in very short area
             public float SpecialNearPlane = 2.0f;
 
-            private FastListStruct<LightClusterLinkedNode> lightNodes = new FastListStruct<LightClusterLinkedNode>(8);
-            private FastListStruct<Int2> clusterInfos = new FastListStruct<Int2>(8);
+            /// <summary>
+            /// Views with at least this many lights assign them to the depth slices in parallel
+            /// </summary>
+            private const int ParallelLightThreshold = 256;
+
+            private FastListStruct<ClusterLight> clusterPointLights = new FastListStruct<ClusterLight>(8);
+            private FastListStruct<ClusterLight> clusterSpotLights = new FastListStruct<ClusterLight>(8);
+            private int[] sliceIndices = Array.Empty<int>();
+            private int[] sliceIndexCounts = Array.Empty<int>();
+            private int sliceCapacity = 1024;
             private RenderViewInfo[] renderViewInfos;
             private Int2 maxClusterCount;
-            //private Plane[] zPlanes;
 
             public PointLightShaderGroupData(RenderContext renderContext, LightClusteredPointSpotGroupRenderer clusteredGroupRenderer)
                 : base(renderContext, null)
@@ -240,7 +250,7 @@ namespace Stride.Rendering.Lights
                 return lightCount;
             }
 
-            public void ComputeViewParameter(int viewIndex)
+            public unsafe void ComputeViewParameter(int viewIndex)
             {
                 ref var renderViewInfo = ref renderViewInfos[viewIndex];
                 var renderView = renderViewInfo.RenderView;
@@ -258,39 +268,6 @@ namespace Stride.Rendering.Lights
                 if (renderViewInfo.LightClusters == null || totalClusterCount > renderViewInfo.LightClusters.Length)
                     renderViewInfo.LightClusters = new Int2[totalClusterCount];
 
-                // TODO: Additional culling on x/y (to remove corner clusters)
-                // Prepare planes for culling
-                //var viewProjection = renderView.ViewProjection;
-                //Array.Resize(ref zPlanes, ClusterSlices + 1);
-                //for (int z = 0; z <= ClusterSlices; ++z)
-                //{
-                //    var zFactor = (float)z / (float)ClusterSlices;
-                //
-                //    // Build planes between nearplane and -farplane (see BoundingFrustum code)
-                //    zPlanes[z] = new Plane(
-                //        viewProjection.M13 - zFactor * viewProjection.M14,
-                //        viewProjection.M23 - zFactor * viewProjection.M24,
-                //        viewProjection.M33 - zFactor * viewProjection.M34,
-                //        viewProjection.M43 - zFactor * viewProjection.M44);
-                //
-                //    zPlanes[z].Normalize();
-                //}
-
-                // Initialize cluster with no light (-1)
-                {
-                    int totalLightNodes = maxClusterCount.X * maxClusterCount.Y * ClusterSlices;
-                    lightNodes.EnsureCapacity(totalLightNodes);
-                    var lightNodesArray = lightNodes.Items;
-                    for (int i = 0; i < totalLightNodes; ++i)
-                    {
-                        lightNodesArray[i] = new LightClusterLinkedNode(InternalLightType.Point, -1, -1);
-                    }
-                    lightNodes.Count = totalLightNodes;
-                }
-
-                // List of clusters moved by this light
-                var movedClusters = new Dictionary<LightClusterLinkedNode, int>();
-
                 // Try to use SpecialNearPlane to not waste too much slices in very small depth
                 // Make sure we don't go to more than 10% of max depth
                 var nearPlane = Math.Max(Math.Min(SpecialNearPlane, renderView.FarClipPlane * 0.1f), renderView.NearClipPlane);
@@ -304,6 +281,7 @@ namespace Stride.Rendering.Lights
                 float clusterDepthBias = renderViewInfo.ClusterDepthBias = 2.0f - clusterDepthScale * nearPlane;
 
                 //---------------- SPOT LIGHTS -------------------
+                clusterSpotLights.Clear();
                 var lightRange = clusteredGroupRenderer.spotGroup.LightRanges[viewIndex];
                 for (int i = lightRange.Start; i < lightRange.End; ++i)
                 {
@@ -322,43 +300,19 @@ namespace Stride.Rendering.Lights
                     // Fill list of spot lights
                     renderViewInfo.SpotLights.Add(spotLightData);
 
-                    movedClusters.Clear();
-
-                    var radius = MathF.Sqrt(1.0f / spotLightData.AngleOffsetAndInvSquareRadius.Z);
-
-                    Vector3 positionVS;
-                    Vector3.TransformCoordinate(ref spotLightData.PositionWS, ref renderView.View, out positionVS);
-
-                    // TODO: culling (first do it on PointLight, then backport it to SpotLight and improve for SpotLight case)
-                    // Find x/y ranges
-                    Vector2 clipMin, clipMax;
-                    ComputeClipRegion(ref positionVS, radius, ref renderView.Projection, out clipMin, out clipMax);
-
-                    var tileStartX = MathUtil.Clamp((int)((clipMin.X * 0.5f + 0.5f) * viewSize.X / ClusterSize), 0, clusterCountX);
-                    var tileEndX = MathUtil.Clamp((int)((clipMax.X * 0.5f + 0.5f) * viewSize.X / ClusterSize) + 1, 0, clusterCountX);
-                    var tileStartY = MathUtil.Clamp((int)((-clipMax.Y * 0.5f + 0.5f) * viewSize.Y / ClusterSize), 0, clusterCountY);
-                    var tileEndY = MathUtil.Clamp((int)((-clipMin.Y * 0.5f + 0.5f) * viewSize.Y / ClusterSize) + 1, 0, clusterCountY);
-
-                    // Find z range (project using Projection matrix)
-                    var startZ = -positionVS.Z - radius;
-                    var endZ = -positionVS.Z + radius;
-
-                    var tileStartZ = MathUtil.Clamp((int)Math.Log(startZ * clusterDepthScale + clusterDepthBias, 2.0f), 0, ClusterSlices);
-                    var tileEndZ = MathUtil.Clamp((int)Math.Log(endZ * clusterDepthScale + clusterDepthBias, 2.0f) + 1, 0, ClusterSlices);
-
-                    for (int z = tileStartZ; z < tileEndZ; ++z)
+                    var clusterLight = new ClusterLight
                     {
-                        for (int y = tileStartY; y < tileEndY; ++y)
-                        {
-                            for (int x = tileStartX; x < tileEndX; ++x)
-                            {
-                                AddLightToCluster(movedClusters, InternalLightType.Spot, i - lightRange.Start, x + (y + z * clusterCountY) * clusterCountX);
-                            }
-                        }
-                    }
+                        Radius = MathF.Sqrt(1.0f / spotLightData.AngleOffsetAndInvSquareRadius.Z),
+                        CosAngle = MathF.Cos(spotLight.AngleOuterInRadians * 0.5f),
+                    };
+                    Vector3.TransformCoordinate(ref spotLightData.PositionWS, ref renderView.View, out clusterLight.Position);
+                    Vector3.TransformNormal(ref spotLightData.DirectionWS, ref renderView.View, out clusterLight.Direction);
+                    clusterLight.Direction.Normalize();
+                    clusterSpotLights.Add(clusterLight);
                 }
 
                 //---------------- POINT LIGHTS -------------------
+                clusterPointLights.Clear();
                 lightRange = lightRanges[viewIndex];
                 for (int i = lightRange.Start; i < lightRange.End; ++i)
                 {
@@ -376,71 +330,84 @@ namespace Stride.Rendering.Lights
                     // Fill list of point lights
                     renderViewInfo.PointLights.Add(pointLightData);
 
-                    movedClusters.Clear();
-
-                    var radius = MathF.Sqrt(1.0f / pointLightData.InvSquareRadius);
-
-                    Vector3 positionVS;
-                    Vector3.TransformCoordinate(ref pointLightData.PositionWS, ref renderView.View, out positionVS);
+                    var clusterLight = new ClusterLight { Radius = MathF.Sqrt(1.0f / pointLightData.InvSquareRadius) };
+                    Vector3.TransformCoordinate(ref pointLightData.PositionWS, ref renderView.View, out clusterLight.Position);
+                    clusterPointLights.Add(clusterLight);
+                }
 
-                    //Vector3 positionScreen;
-                    //Vector3.TransformCoordinate(ref pointLightData.PositionWS, ref renderView.ViewProjection, out positionScreen);
+                // Assign lights to the clusters of each slice, each slice getting its own range of light indices
+                var grid = new ClusterGrid
+                {
+                    Projection = renderView.Projection,
+                    ClusterCountX = clusterCountX,
+                    ClusterCountY = clusterCountY,
+                    ClusterSlices = ClusterSlices,
+                    ClusterSize = ClusterSize,
+                    ViewSize = viewSize,
+                    DepthScale = clusterDepthScale,
+                    DepthBias = clusterDepthBias,
+                };
+
+                if (sliceIndexCounts.Length != ClusterSlices)
+                    sliceIndexCounts = new int[ClusterSlices];
+
+                fixed (ClusterLight* pointLightsPtr = clusterPointLights.Items)
+                fixed (ClusterLight* spotLightsPtr = clusterSpotLights.Items)
+                fixed (Int2* lightClustersPtr = renderViewInfo.LightClusters)
+                fixed (int* sliceIndexCountsPtr = sliceIndexCounts)
+                {
+                    var job = new AssignLightsJob
+                    {
+                        Grid = &grid,
+                        PointLights = pointLightsPtr,
+                        PointLightCount = clusterPointLights.Count,
+                        SpotLights = spotLightsPtr,
+                        SpotLightCount = clusterSpotLights.Count,
+                        LightClusters = lightClustersPtr,
+                        SliceIndexCounts = sliceIndexCountsPtr,
+                    };
 
-                    // Find x/y ranges
-                    Vector2 clipMin, clipMax;
-                    ComputeClipRegion(ref positionVS, radius, ref renderView.Projection, out clipMin, out clipMax);
+                    while (true)
+                    {
+                        if (sliceIndices.Length < sliceCapacity * ClusterSlices)
+                            sliceIndices = new int[sliceCapacity * ClusterSlices];
 
-                    var tileStartX = MathUtil.Clamp((int)((clipMin.X * 0.5f + 0.5f) * viewSize.X / ClusterSize), 0, clusterCountX);
-                    var tileEndX = MathUtil.Clamp((int)((clipMax.X * 0.5f + 0.5f) * viewSize.X / ClusterSize) + 1, 0, clusterCountX);
-                    var tileStartY = MathUtil.Clamp((int)((-clipMax.Y * 0.5f + 0.5f) * viewSize.Y / ClusterSize), 0, clusterCountY);
-                    var tileEndY = MathUtil.Clamp((int)((-clipMin.Y * 0.5f + 0.5f) * viewSize.Y / ClusterSize) + 1, 0, clusterCountY);
+                        fixed (int* sliceIndicesPtr = sliceIndices)
+                        {
+                            job.SliceIndices = sliceIndicesPtr;
+                            job.SliceCapacity = sliceCapacity;
+                            if (job.PointLightCount + job.SpotLightCount >= ParallelLightThreshold)
+                                Dispatcher.ForBatched(ClusterSlices, job, &AssignLightsBatch);
+                            else
+                                AssignLightsBatch(job, 0, ClusterSlices);
+                        }
 
-                    // Find z range (project using Projection matrix)
-                    var startZ = -positionVS.Z - radius;
-                    var endZ = -positionVS.Z + radius;
+                        // Retry with enough room for the largest slice if one didn't fit
+                        var maxSliceIndexCount = 0;
+                        var totalIndexCount = 0;
+                        for (int z = 0; z < ClusterSlices; ++z)
+                        {
+                            maxSliceIndexCount = Math.Max(maxSliceIndexCount, sliceIndexCounts[z]);
+                            totalIndexCount += sliceIndexCounts[z];
+                        }
 
-                    //var centerZ = (int)(positionVS.Z * ClusterDepthScale + ClusterDepthBias);
-                    var tileStartZ = MathUtil.Clamp((int)Math.Log(startZ * clusterDepthScale + clusterDepthBias, 2.0f), 0, ClusterSlices);
-                    var tileEndZ = MathUtil.Clamp((int)Math.Log(endZ * clusterDepthScale + clusterDepthBias, 2.0f) + 1, 0, ClusterSlices);
+                        if (maxSliceIndexCount > sliceCapacity)
+                        {
+                            sliceCapacity = MathUtil.NextPowerOfTwo(maxSliceIndexCount);
+                            continue;
+                        }
 
-                    for (int z = tileStartZ; z < tileEndZ; ++z)
-                    {
-                        // TODO: Additional culling on x/y (to remove corner clusters)
-                        // See "Practical Clustered Shading" for details
-                        //if (z != centerZ)
-                        //{
-                        //    var plane = z < centerZ ? zPlanes[z + 1] : -zPlanes[z];
-                        //
-                        //    positionScreen = Plane.DotCoordinate(ref plane, ref positionScreen, out )
-                        //}
-
-                        for (int y = tileStartY; y < tileEndY; ++y)
+                        // Concatenate the light indices of all slices
+                        renderViewInfo.LightIndices.EnsureCapacity(totalIndexCount);
+                        renderViewInfo.LightIndices.Count = totalIndexCount;
+                        fixed (int* sliceIndicesPtr = sliceIndices)
+                        fixed (int* lightIndicesPtr = renderViewInfo.LightIndices.Items)
                         {
-                            for (int x = tileStartX; x < tileEndX; ++x)
-                            {
-                                AddLightToCluster(movedClusters, InternalLightType.Point, i - lightRange.Start, x + (y + z * clusterCountY) * clusterCountX);
-                            }
+                            NativeInvoke.LightClusterMerge(&grid, lightClustersPtr, sliceIndicesPtr, sliceCapacity, sliceIndexCountsPtr, lightIndicesPtr);
                         }
+                        break;
                     }
                 }
-
-                // Finish clusters by making their last element unique and building clusterInfos
-                movedClusters.Clear();
-                for (int i = 0; i < totalClusterCount; ++i)
-                {
-                    FinishCluster(movedClusters, ref renderViewInfo.LightIndices, i);
-                }
-
-                // Prepare light clusters
-                for (int i = 0; i < totalClusterCount; ++i)
-                {
-                    var clusterId = lightNodes[i].NextNode;
-                    renderViewInfo.LightClusters[i] = clusterId != -1 ? clusterInfos[clusterId] : new Int2(0, 0);
-                }
-
-                // Clear data
-                lightNodes.Clear();
-                clusterInfos.Clear();
             }
 
             public unsafe void ComputeViewsParameter(RenderDrawContext drawContext)
@@ -573,177 +540,46 @@ namespace Stride.Rendering.Lights
                 }
             }
 
-            private void FinishCluster(Dictionary<LightClusterLinkedNode, int> movedClusters, ref FastListStruct<int> lightIndices, int clusterIndex)
-            {
-                var clusterId = -1;
-                if (lightNodes.Items[clusterIndex].LightIndex != -1)
-                {
-                    var movedCluster = lightNodes.Items[clusterIndex];
-
-                    // Try to check if same linked-list doesn't already exist
-                    if (!movedClusters.TryGetValue(movedCluster, out clusterId))
-                    {
-                        // First time, let's add it
-                        clusterId = movedClusters.Count;
-                        movedClusters.Add(movedCluster, clusterId);
-
-                        int lightIndex = lightNodes.Count;
-                        lightNodes.Add(movedCluster);
-
-                        // Build light indices
-                        int pointLightCounter = 0;
-                        int spotLightCounter = 0;
-
-                        while (lightIndex != -1)
-                        {
-                            movedCluster = lightNodes[lightIndex];
-                            lightIndices.Add(movedCluster.LightIndex);
-                            switch (movedCluster.LightType)
-                            {
-                                case InternalLightType.Point:
-                                    pointLightCounter++;
-                                    break;
-                                case InternalLightType.Spot:
-                                    spotLightCounter++;
-                                    break;
-                            }
-                            lightIndex = movedCluster.NextNode;
-                        }
-
-                        // Add new light cluster range
-                        // Stored in the format:
-                        //   x          = start_index
-                        //   y & 0xFFFF = point_light_count
-                        //   y >> 16    =  spot_light_count
-                        clusterInfos.Add(new Int2(lightIndices.Count - pointLightCounter - spotLightCounter, pointLightCounter | (spotLightCounter << 16)));
-                    }
-                }
-
-                // Last pass: store cluster id (instead of next node)
-                lightNodes.Items[clusterIndex] = new LightClusterLinkedNode(InternalLightType.Point, -1, clusterId);
-            }
-
-            private void AddLightToCluster(Dictionary<LightClusterLinkedNode, int> movedClusters, InternalLightType lightType, int lightIndex, int clusterIndex)
+            private static unsafe void AssignLightsBatch(AssignLightsJob job, int start, int end)
             {
-                var nextNode = -1;
-                if (lightNodes.Items[clusterIndex].LightIndex != -1)
-                {
-                    var movedCluster = lightNodes.Items[clusterIndex];
-
-                    // Try to check if same linked-list doesn't already exist
-                    if (!movedClusters.TryGetValue(movedCluster, out nextNode))
-                    {
-                        // First time, let's add it
-                        nextNode = lightNodes.Count;
-                        movedClusters.Add(movedCluster, nextNode);
-                        lightNodes.Add(movedCluster);
-                    }
-                }
-
-                // Replace new linked-list head
-                lightNodes.Items[clusterIndex] = new LightClusterLinkedNode(lightType, lightIndex, nextNode);
+                NativeInvoke.LightClusterAssignRange(job.Grid, job.PointLights, job.PointLightCount, job.SpotLights, job.SpotLightCount, job.LightClusters, job.SliceIndices, job.SliceCapacity, job.SliceIndexCounts, start, end);
             }
 
-            private static void UpdateClipRegionRoot(
-                    float nc,          // Tangent plane x/y normal coordinate (view space)
-                    float lc,          // Light x/y coordinate (view space)
-                    float lz,          // Light z coordinate (view space)
-                    float lightRadius,
-                    float cameraScale, // Project scale for coordinate (_11 or _22 for x/y respectively)
-                    float cameraOffset, // Project offset for coordinate (_31 or _32 for x/y respectively)
-                    ref float clipMin,
-                    ref float clipMax)
+            // Same layout as LightClusterLight in the native code
+            [StructLayout(LayoutKind.Sequential)]
+            private struct ClusterLight
             {
-                float nz = (lightRadius - nc * lc) / lz;
-                float pz = (lc * lc + lz * lz - lightRadius * lightRadius) /
-                            (lz - (nz / nc) * lc);
-
-                if (pz > 0.0f)
-                {
-                    float c = -nz * cameraScale / nc - cameraOffset;
-
-                    if (nc > 0.0f)
-                    {
-                        // Left side boundary
-                        clipMin = Math.Max(clipMin, c);
-                    }
-                    else
-                    {
-                        // Right side boundary
-                        clipMax = Math.Min(clipMax, c);
-                    }
-                }
+                public Vector3 Position;
+                public float Radius;
+                public Vector3 Direction;
+                public float CosAngle;
             }
 
-            private static void UpdateClipRegion(
-                        float lc,          // Light x/y coordinate (view space)
-                        float lz,          // Light z coordinate (view space)
-                        float lightRadius,
-                        float cameraScale, // Project scale for coordinate (_11 or _22 for x/y respectively)
-                        float cameraOffset, // Project offset for coordinate (_31 or _32 for x/y respectively)
-                        ref float clipMin,
-                        ref float clipMax)
+            // Same layout as LightClusterGrid in the native code
+            [StructLayout(LayoutKind.Sequential)]
+            private struct ClusterGrid
             {
-                float rSq = lightRadius * lightRadius;
-                float lcSqPluslzSq = lc * lc + lz * lz;
-                float d = rSq * lc * lc - lcSqPluslzSq * (rSq - lz * lz);
-
-                if (d > 0)
-                {
-                    float a = lightRadius * lc;
-                    float b = MathF.Sqrt(d);
-                    float nx0 = (a + b) / lcSqPluslzSq;
-                    float nx1 = (a - b) / lcSqPluslzSq;
-
-                    UpdateClipRegionRoot(nx0, lc, lz, lightRadius, cameraScale, cameraOffset, ref clipMin, ref clipMax);
-                    UpdateClipRegionRoot(nx1, lc, lz, lightRadius, cameraScale, cameraOffset, ref clipMin, ref clipMax);
-                }
+                public Matrix Projection;
+                public int ClusterCountX;
+                public int ClusterCountY;
+                public int ClusterSlices;
+                public int ClusterSize;
+                public Vector2 ViewSize;
+                public float DepthScale;
+                public float DepthBias;
             }
 
-            private static void ComputeClipRegion(ref Vector3 lightPosView, float lightRadius, ref Matrix projection, out Vector2 clipMin, out Vector2 clipMax)
+            private unsafe struct AssignLightsJob
             {
-                clipMin = new Vector2(-1.0f, -1.0f);
-                clipMax = new Vector2(1.0f, 1.0f);
-
-                UpdateClipRegion(lightPosView.X, -lightPosView.Z, lightRadius, projection.M11, projection.M31, ref clipMin.X, ref clipMax.X);
-                UpdateClipRegion(lightPosView.Y, -lightPosView.Z, lightRadius, projection.M22, projection.M32, ref clipMin.Y, ref clipMax.Y);
-            }
-
-            // Single linked list of lights (stored in an array)
-            private struct LightClusterLinkedNode : IEquatable<LightClusterLinkedNode>
-            {
-                public readonly InternalLightType LightType;
-                public readonly int LightIndex;
-                public readonly int NextNode;
-
-                public LightClusterLinkedNode(InternalLightType lightType, int lightIndex, int nextNode)
-                {
-                    LightType = lightType;
-                    LightIndex = lightIndex;
-                    NextNode = nextNode;
-                }
-
-                public bool Equals(LightClusterLinkedNode other)
-                {
-                    return LightType == other.LightType && LightIndex == other.LightIndex && NextNode == other.NextNode;
-                }
-
-                public override bool Equals(object obj)
-                {
-                    if (ReferenceEquals(null, obj)) return false;
-                    return obj is LightClusterLinkedNode && Equals((LightClusterLinkedNode)obj);
-                }
-
-                public override int GetHashCode()
-                {
-                    unchecked
-                    {
-                        var hashCode = (int)LightType;
-                        hashCode = (hashCode * 397) ^ LightIndex;
-                        hashCode = (hashCode * 397) ^ NextNode;
-                        return hashCode;
-                    }
-                }
+                public ClusterGrid* Grid;
+                public ClusterLight* PointLights;
+                public int PointLightCount;
+                public ClusterLight* SpotLights;
+                public int SpotLightCount;
+                public Int2* LightClusters;
+                public int* SliceIndices;
+                public int SliceCapacity;
+                public int* SliceIndexCounts;
             }
 
             private struct RenderViewInfo
@@ -774,11 +610,5 @@ namespace Stride.Rendering.Lights
 
             public FastListStruct<LightDynamicEntry> Lights => lights;
         }
-
-        private enum InternalLightType
-        {
-            Point,
-            Spot,
-        }
     }
 }
@@ -0,0 +1,294 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+using System;
+using System.Runtime.InteropServices;
+using Stride.Core.Collections;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Native;
+
+namespace Stride.Rendering
+{
+    /// <summary>
+    /// A small software depth buffer used to cull objects hidden behind occluders.
+    /// </summary>
+    /// <remarks>
+    /// Occluders are low-poly meshes fully contained in the objects they stand for (walls, buildings, terrain), added every frame
+    /// after <see cref="Begin"/>, then drawn by <see cref="Rasterize"/>. Boxes can then be tested with <see cref="IsVisible"/> or, in batches, <see cref="TestBoxes"/>,
+    /// which are thread-safe. Assign it to <see cref="RenderView.OcclusionBuffer"/> to cull the render objects of a view.
+    /// The depth buffer stores two depth layers per 8x4 pixel tile, as in Masked Software Occlusion Culling, and expects a projection
+    /// with depth going from 0 at the near plane to 1 at the far plane.
+    /// </remarks>
+    public sealed unsafe class OcclusionBuffer
+    {
+        /// <summary>
+        /// Occluders with at least this many vertices are transformed on several threads
+        /// </summary>
+        private const int ParallelVertexThreshold = 4096;
+
+        /// <summary>
+        /// Occluders with at least this many triangles are set up and rasterized on several threads, each one drawing bands of tile rows
+        /// </summary>
+        private const int ParallelTriangleThreshold = 256;
+
+        private const int TileWidth = 8;
+        private const int TileHeight = 4;
+
+        /// <summary>
+        /// Tile rows per band; triangles are binned by band so that each band only walks the triangles overlapping it
+        /// </summary>
+        private const int BandTileRows = 2;
+
+        private readonly Tile[] tiles;
+        private readonly int[] binStarts;
+        private FastListStruct<Vector4> clipPositions = new FastListStruct<Vector4>(256);
+        private FastListStruct<int> indices = new FastListStruct<int>(256);
+        private FastListStruct<ScreenTriangle> screenTriangles = new FastListStruct<ScreenTriangle>(256);
+        private FastListStruct<int> binTriangles = new FastListStruct<int>(256);
+        private Matrix viewProjection;
+        private bool rasterized;
+
+        // Same layout as OcclusionTile in the native code
+        [StructLayout(LayoutKind.Sequential)]
+        private struct Tile
+        {
+            public uint Mask;
+            public float FarDepth;
+            public float LayerDepth;
+        }
+
+        // Same layout as OcclusionTriangle in the native code
+        [StructLayout(LayoutKind.Sequential)]
+        private struct ScreenTriangle
+        {
+            public Vector3 Vertex0;
+            public Vector3 Vertex1;
+            public Vector3 Vertex2;
+            public int TileRowStart;
+            public int TileRowEnd;
+        }
+
+        private struct TransformJob
+        {
+            public Matrix* WorldViewProjection;
+            public Vector3* Positions;
+            public Vector4* ClipPositions;
+        }
+
+        private struct SetupJob
+        {
+            public int Width;
+            public int Height;
+            public Vector4* ClipPositions;
+            public int* Indices;
+            public ScreenTriangle* Triangles;
+        }
+
+        private struct RasterizeJob
+        {
+            public Tile* Tiles;
+            public int Width;
+            public int Height;
+            public ScreenTriangle* Triangles;
+            public int* BinStarts;
+            public int* BinTriangles;
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="OcclusionBuffer"/> class.
+        /// </summary>
+        /// <param name="width">The width in pixels, rounded up to a multiple of 8.</param>
+        /// <param name="height">The height in pixels, rounded up to a multiple of 4.</param>
+        public OcclusionBuffer(int width = 256, int height = 128)
+        {
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(width);
+            ArgumentOutOfRangeException.ThrowIfNegativeOrZero(height);
+
+            Width = (width + TileWidth - 1) / TileWidth * TileWidth;
+            Height = (height + TileHeight - 1) / TileHeight * TileHeight;
+            tiles = new Tile[Width / TileWidth * (Height / TileHeight)];
+            binStarts = new int[BandCount + 1];
+        }
+
+        /// <summary>
+        /// Gets the width of the depth buffer, in pixels.
+        /// </summary>
+        public int Width { get; }
+
+        /// <summary>
+        /// Gets the height of the depth buffer, in pixels.
+        /// </summary>
+        public int Height { get; }
+
+        private int BandCount => (Height / TileHeight + BandTileRows - 1) / BandTileRows;
+
+        /// <summary>
+        /// Clears the depth buffer and the occluders, and sets the view projection used by the next occluders and tests.
+        /// </summary>
+        public void Begin(ref Matrix viewProjection)
+        {
+            this.viewProjection = viewProjection;
+            clipPositions.Clear();
+            indices.Clear();
+            rasterized = false;
+        }
+
+        /// <summary>
+        /// Adds an occluder mesh, transformed by <paramref name="world"/>.
+        /// </summary>
+        /// <param name="positions">The vertex positions.</param>
+        /// <param name="triangleIndices">The triangle list indices, 3 per triangle.</param>
+        /// <param name="world">The world matrix of the occluder.</param>
+        public void AddOccluder(ReadOnlySpan<Vector3> positions, ReadOnlySpan<int> triangleIndices, ref Matrix world)
+        {
+            if (triangleIndices.Length % 3 != 0)
+                throw new ArgumentException("Occluders must be triangle lists.", nameof(triangleIndices));
+
+            Matrix.Multiply(ref world, ref viewProjection, out var worldViewProjection);
+
+            var firstVertex = clipPositions.Count;
+            clipPositions.EnsureCapacity(firstVertex + positions.Length);
+            clipPositions.Count = firstVertex + positions.Length;
+
+            fixed (Vector3* positionsPtr = positions)
+            fixed (Vector4* clipPositionsPtr = clipPositions.Items)
+            {
+                var job = new TransformJob { WorldViewProjection = &worldViewProjection, Positions = positionsPtr, ClipPositions = clipPositionsPtr + firstVertex };
+                if (positions.Length >= ParallelVertexThreshold)
+                    Dispatcher.ForBatched(positions.Length, job, &TransformBatch);
+                else
+                    TransformBatch(job, 0, positions.Length);
+            }
+
+            var firstIndex = indices.Count;
+            indices.EnsureCapacity(firstIndex + triangleIndices.Length);
+            for (int i = 0; i < triangleIndices.Length; i++)
+            {
+                var index = triangleIndices[i];
+                if ((uint)index >= (uint)positions.Length)
+                    throw new ArgumentOutOfRangeException(nameof(triangleIndices));
+                indices.Items[firstIndex + i] = firstVertex + index;
+            }
+            indices.Count = firstIndex + triangleIndices.Length;
+        }
+
+        /// <summary>
+        /// Draws the occluders into the depth buffer.
+        /// </summary>
+        public void Rasterize()
+        {
+            var triangleCount = indices.Count / 3;
+            screenTriangles.EnsureCapacity(2 * triangleCount);
+            screenTriangles.Count = 2 * triangleCount;
+
+            fixed (Tile* tilesPtr = tiles)
+            fixed (Vector4* clipPositionsPtr = clipPositions.Items)
+            fixed (int* indicesPtr = indices.Items)
+            fixed (ScreenTriangle* trianglesPtr = screenTriangles.Items)
+            fixed (int* binStartsPtr = binStarts)
+            {
+                NativeInvoke.OcclusionClearRange(tilesPtr, 0, tiles.Length);
+
+                // Clip and project each triangle once, then bin them by band
+                var setupJob = new SetupJob { Width = Width, Height = Height, ClipPositions = clipPositionsPtr, Indices = indicesPtr, Triangles = trianglesPtr };
+                if (triangleCount >= ParallelTriangleThreshold)
+                    Dispatcher.ForBatched(triangleCount, setupJob, &SetupBatch);
+                else if (triangleCount > 0)
+                    SetupBatch(setupJob, 0, triangleCount);
+
+                var bandCount = BandCount;
+                var binCount = BinTriangles(trianglesPtr, bandCount, binStartsPtr);
+                if (binCount > binTriangles.Items.Length)
+                {
+                    binTriangles.EnsureCapacity(binCount);
+                    BinTriangles(trianglesPtr, bandCount, binStartsPtr);
+                }
+                binTriangles.Count = binCount;
+
+                fixed (int* binTrianglesPtr = binTriangles.Items)
+                {
+                    var job = new RasterizeJob
+                    {
+                        Tiles = tilesPtr,
+                        Width = Width,
+                        Height = Height,
+                        Triangles = trianglesPtr,
+                        BinStarts = binStartsPtr,
+                        BinTriangles = binTrianglesPtr,
+                    };
+
+                    if (triangleCount >= ParallelTriangleThreshold)
+                        Dispatcher.ForBatched(bandCount, job, &RasterizeBatch);
+                    else if (binCount > 0)
+                        RasterizeBatch(job, 0, bandCount);
+                }
+            }
+
+            rasterized = true;
+        }
+
+        /// <summary>
+        /// Determines whether a box might be visible, i.e. is not entirely hidden by the occluders.
+        /// </summary>
+        /// <returns><c>false</c> if the box is hidden; <c>true</c> otherwise, or if the occluders were not rasterized.</returns>
+        public bool IsVisible(ref BoundingBoxExt boundingBox)
+        {
+            if (!rasterized)
+                return true;
+
+            var box = (BoundingBox)boundingBox;
+            fixed (Tile* tilesPtr = tiles)
+            fixed (Matrix* viewProjectionPtr = &viewProjection)
+            {
+                return NativeInvoke.OcclusionTestBox(tilesPtr, Width, Height, viewProjectionPtr, &box) != 0;
+            }
+        }
+
+        /// <summary>
+        /// Tests several boxes at once, setting <paramref name="visibility"/> to 1 for the boxes that might be visible and 0 for hidden ones.
+        /// </summary>
+        public void TestBoxes(ReadOnlySpan<BoundingBox> boxes, Span<byte> visibility)
+        {
+            if (visibility.Length < boxes.Length)
+                throw new ArgumentException("The visibility span must have one element per box.", nameof(visibility));
+
+            if (!rasterized)
+            {
+                visibility.Slice(0, boxes.Length).Fill(1);
+                return;
+            }
+
+            fixed (Tile* tilesPtr = tiles)
+            fixed (Matrix* viewProjectionPtr = &viewProjection)
+            fixed (BoundingBox* boxesPtr = boxes)
+            fixed (byte* visibilityPtr = visibility)
+            {
+                NativeInvoke.OcclusionTestBoxesRange(tilesPtr, Width, Height, viewProjectionPtr, boxesPtr, visibilityPtr, 0, boxes.Length);
+            }
+        }
+
+        private static void TransformBatch(TransformJob job, int start, int end)
+        {
+            NativeInvoke.OcclusionTransformVerticesRange(job.WorldViewProjection, job.Positions, job.ClipPositions, start, end);
+        }
+
+        /// <returns>The number of bin entries, which were only written when <see cref="binTriangles"/> is large enough.</returns>
+        private int BinTriangles(ScreenTriangle* trianglesPtr, int bandCount, int* binStartsPtr)
+        {
+            fixed (int* binTrianglesPtr = binTriangles.Items)
+            {
+                return NativeInvoke.OcclusionBinTriangles(trianglesPtr, screenTriangles.Count, BandTileRows, bandCount, binStartsPtr, binTrianglesPtr, binTriangles.Items.Length);
+            }
+        }
+
+        private static void SetupBatch(SetupJob job, int start, int end)
+        {
+            NativeInvoke.OcclusionSetupTrianglesRange(job.Width, job.Height, job.ClipPositions, job.Indices, job.Triangles, start, end);
+        }
+
+        private static void RasterizeBatch(RasterizeJob job, int start, int end)
+        {
+            NativeInvoke.OcclusionRasterizeBinsRange(job.Tiles, job.Width, job.Height, job.Triangles, job.BinStarts, job.BinTriangles, BandTileRows, start, end);
+        }
+    }
+}
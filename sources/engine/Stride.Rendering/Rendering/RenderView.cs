@@ -103,6 +103,11 @@ namespace Stride.Rendering
         /// </summary>
         public CameraCullingMode CullingMode { get; set; } = CameraCullingMode.Frustum;
 
+        /// <summary>
+        /// The occlusion buffer used to cull objects hidden by occluders, in addition to frustum culling (optional).
+        /// </summary>
+        public OcclusionBuffer OcclusionBuffer { get; set; }
+
         public RenderViewFlags Flags { get; set; }
 
         /// <summary>
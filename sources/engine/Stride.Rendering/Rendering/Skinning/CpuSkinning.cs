@@ -0,0 +1,76 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+using System;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Graphics;
+using Stride.Native;
+
+namespace Stride.Rendering
+{
+    /// <summary>
+    /// Skins <see cref="VertexPositionNormalTexture"/> vertices on the CPU, the same way as <c>TransformationSkinning</c> and
+    /// <c>NormalMeshSkinning</c> do on the GPU, for consumers that need the skinned mesh without rendering it (picking, physics, servers).
+    /// </summary>
+    public static unsafe class CpuSkinning
+    {
+        /// <summary>
+        /// Meshes with at least this many vertices are skinned on several threads
+        /// </summary>
+        public const int ParallelThreshold = 4096;
+
+        private struct SkinJob
+        {
+            public Matrix* BonePalette;
+            public ushort* BlendIndices;
+            public float* BlendWeights;
+            public VertexPositionNormalTexture* Input;
+            public VertexPositionNormalTexture* Output;
+        }
+
+        /// <summary>
+        /// Skins <paramref name="input"/> into <paramref name="output"/>, which may be the same array.
+        /// </summary>
+        /// <param name="bonePalette">The blend matrices, as given to <c>BlendMatrixArray</c></param>
+        /// <param name="blendIndices">4 bone indices per vertex</param>
+        /// <param name="blendWeights">4 bone weights per vertex</param>
+        public static void SkinVertices(ReadOnlySpan<Matrix> bonePalette, ReadOnlySpan<ushort> blendIndices, ReadOnlySpan<float> blendWeights, ReadOnlySpan<VertexPositionNormalTexture> input, Span<VertexPositionNormalTexture> output)
+        {
+            var count = input.Length;
+            if (output.Length < count || blendIndices.Length < 4 * count || blendWeights.Length < 4 * count)
+                throw new ArgumentException("The output and blend streams must hold as many vertices as the input.");
+
+            foreach (var index in blendIndices.Slice(0, 4 * count))
+            {
+                if (index >= bonePalette.Length)
+                    throw new ArgumentOutOfRangeException(nameof(blendIndices), "A blend index is outside of the bone palette.");
+            }
+
+            fixed (Matrix* bonePalettePtr = bonePalette)
+            fixed (ushort* blendIndicesPtr = blendIndices)
+            fixed (float* blendWeightsPtr = blendWeights)
+            fixed (VertexPositionNormalTexture* inputPtr = input)
+            fixed (VertexPositionNormalTexture* outputPtr = output)
+            {
+                var job = new SkinJob
+                {
+                    BonePalette = bonePalettePtr,
+                    BlendIndices = blendIndicesPtr,
+                    BlendWeights = blendWeightsPtr,
+                    Input = inputPtr,
+                    Output = outputPtr,
+                };
+
+                if (count >= ParallelThreshold)
+                    Dispatcher.ForBatched(count, job, &SkinBatch);
+                else if (count > 0)
+                    SkinBatch(job, 0, count);
+            }
+        }
+
+        private static void SkinBatch(SkinJob job, int start, int end)
+        {
+            NativeInvoke.SkinVertices(job.BonePalette, job.BlendIndices, job.BlendWeights, job.Input, job.Output, start, end);
+        }
+    }
+}
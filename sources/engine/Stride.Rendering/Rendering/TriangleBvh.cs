@@ -0,0 +1,167 @@
+// Copyright (c) .NET Foundation and Contributors (https://dotnetfoundation.org/ & https://stride3d.net) and Silicon Studio Corp. (https://www.siliconstudio.co.jp)
+// Distributed under the MIT license. See the LICENSE.md file in the project root for more information.
+using System;
+using Stride.Core.Mathematics;
+using Stride.Core.Threading;
+using Stride.Native;
+
+namespace Stride.Rendering
+{
+    /// <summary>
+    /// A bounding volume hierarchy over a triangle list, answering triangle accurate raycasts natively (picking, line of sight, baking).
+    /// </summary>
+    /// <remarks>
+    /// Triangles are hit on both sides and the ones with no area are never hit. The hierarchy keeps a copy of the positions and indices,
+    /// and queries are thread-safe. Batches of rays are traced in packets, which is fastest when neighbouring rays are coherent.
+    /// </remarks>
+    public sealed unsafe class TriangleBvh
+    {
+        /// <summary>
+        /// Batches with at least this many rays are split across threads
+        /// </summary>
+        private const int ParallelThreshold = 1024;
+
+        private readonly Vector3[] positions;
+        private readonly uint[] indices;
+        private readonly BvhBuilder.Node[] nodes;
+        private readonly uint[] primitiveIndices;
+
+        private struct RaycastJob
+        {
+            public TriangleBvh Bvh;
+            public Ray* Rays;
+            public float* MaxDistances;
+            public BvhHit* Hits;
+            public byte* Occluded;
+        }
+
+        /// <param name="positions">The vertex positions.</param>
+        /// <param name="triangleIndices">The triangle list indices, 3 per triangle.</param>
+        public TriangleBvh(ReadOnlySpan<Vector3> positions, ReadOnlySpan<int> triangleIndices)
+        {
+            if (triangleIndices.Length % 3 != 0)
+                throw new ArgumentException("Triangles must be given as a triangle list.", nameof(triangleIndices));
+
+            this.positions = positions.ToArray();
+            indices = new uint[triangleIndices.Length];
+            for (int i = 0; i < triangleIndices.Length; i++)
+            {
+                var index = triangleIndices[i];
+                if ((uint)index >= (uint)positions.Length)
+                    throw new ArgumentOutOfRangeException(nameof(triangleIndices));
+                indices[i] = (uint)index;
+            }
+
+            TriangleCount = triangleIndices.Length / 3;
+            var bounds = new BoundingBox[TriangleCount];
+            fixed (Vector3* positionsPtr = this.positions)
+            fixed (uint* indicesPtr = indices)
+            fixed (BoundingBox* boundsPtr = bounds)
+            {
+                NativeInvoke.BvhComputeTriangleBounds(positionsPtr, sizeof(Vector3), indicesPtr, TriangleCount, boundsPtr);
+            }
+
+            BvhBuilder.Build(bounds, out nodes, out primitiveIndices);
+        }
+
+        public int TriangleCount { get; }
+
+        /// <summary>
+        /// Finds the closest triangle hit by a ray within <paramref name="maxDistance"/>.
+        /// </summary>
+        public bool Raycast(Ray ray, float maxDistance, out BvhHit hit)
+        {
+            hit = BvhHit.Miss;
+            if (TriangleCount == 0)
+                return false;
+
+            fixed (BvhBuilder.Node* nodesPtr = nodes)
+            fixed (uint* primitiveIndicesPtr = primitiveIndices)
+            fixed (Vector3* positionsPtr = positions)
+            fixed (uint* indicesPtr = indices)
+            fixed (BvhHit* hitPtr = &hit)
+            {
+                return NativeInvoke.BvhIntersectRay(nodesPtr, primitiveIndicesPtr, positionsPtr, sizeof(Vector3), indicesPtr, &ray, maxDistance, hitPtr);
+            }
+        }
+
+        /// <summary>
+        /// Finds the closest triangle hit by each ray, within <paramref name="maxDistances"/> (infinite if empty).
+        /// </summary>
+        public void Raycast(ReadOnlySpan<Ray> rays, ReadOnlySpan<float> maxDistances, Span<BvhHit> hits)
+        {
+            if (hits.Length < rays.Length || (!maxDistances.IsEmpty && maxDistances.Length < rays.Length))
+                throw new ArgumentException("The spans must have at least one element per ray.");
+
+            if (TriangleCount == 0)
+            {
+                hits.Slice(0, rays.Length).Fill(BvhHit.Miss);
+                return;
+            }
+
+            fixed (Ray* raysPtr = rays)
+            fixed (float* maxDistancesPtr = maxDistances)
+            fixed (BvhHit* hitsPtr = hits)
+            {
+                var job = new RaycastJob { Bvh = this, Rays = raysPtr, MaxDistances = maxDistancesPtr, Hits = hitsPtr };
+                if (rays.Length >= ParallelThreshold)
+                    Dispatcher.ForBatched(rays.Length, job, &RaycastBatch);
+                else
+                    RaycastBatch(job, 0, rays.Length);
+            }
+        }
+
+        /// <summary>
+        /// Sets <paramref name="occluded"/> to 1 for the rays hitting any triangle within <paramref name="maxDistances"/> (infinite if empty), and 0 for the others.
+        /// </summary>
+        /// <remarks>
+        /// Cheaper than <see cref="Raycast(ReadOnlySpan{Ray}, ReadOnlySpan{float}, Span{BvhHit})"/> since rays stop at their first hit, for line of sight tests.
+        /// </remarks>
+        public void TestOcclusion(ReadOnlySpan<Ray> rays, ReadOnlySpan<float> maxDistances, Span<byte> occluded)
+        {
+            if (occluded.Length < rays.Length || (!maxDistances.IsEmpty && maxDistances.Length < rays.Length))
+                throw new ArgumentException("The spans must have at least one element per ray.");
+
+            if (TriangleCount == 0)
+            {
+                occluded.Slice(0, rays.Length).Clear();
+                return;
+            }
+
+            fixed (Ray* raysPtr = rays)
+            fixed (float* maxDistancesPtr = maxDistances)
+            fixed (byte* occludedPtr = occluded)
+            {
+                var job = new RaycastJob { Bvh = this, Rays = raysPtr, MaxDistances = maxDistancesPtr, Occluded = occludedPtr };
+                if (rays.Length >= ParallelThreshold)
+                    Dispatcher.ForBatched(rays.Length, job, &OcclusionBatch);
+                else
+                    OcclusionBatch(job, 0, rays.Length);
+            }
+        }
+
+        private static void RaycastBatch(RaycastJob job, int start, int end)
+        {
+            var bvh = job.Bvh;
+            fixed (BvhBuilder.Node* nodesPtr = bvh.nodes)
+            fixed (uint* primitiveIndicesPtr = bvh.primitiveIndices)
+            fixed (Vector3* positionsPtr = bvh.positions)
+            fixed (uint* indicesPtr = bvh.indices)
+            {
+                NativeInvoke.BvhIntersectRaysRange(nodesPtr, primitiveIndicesPtr, positionsPtr, sizeof(Vector3), indicesPtr, job.Rays, job.MaxDistances, job.Hits, start, end);
+            }
+        }
+
+        private static void OcclusionBatch(RaycastJob job, int start, int end)
+        {
+            var bvh = job.Bvh;
+            fixed (BvhBuilder.Node* nodesPtr = bvh.nodes)
+            fixed (uint* primitiveIndicesPtr = bvh.primitiveIndices)
+            fixed (Vector3* positionsPtr = bvh.positions)
+            fixed (uint* indicesPtr = bvh.indices)
+            {
+                NativeInvoke.BvhOccludedRaysRange(nodesPtr, primitiveIndicesPtr, positionsPtr, sizeof(Vector3), indicesPtr, job.Rays, job.MaxDistances, job.Occluded, start, end);
+            }
+        }
+    }
+}
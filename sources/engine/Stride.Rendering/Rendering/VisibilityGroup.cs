@@ -11,6 +11,7 @@ using Stride.Core.Extensions;
 using Stride.Core.Mathematics;
 using Stride.Core.Threading;
 using Stride.Core.Diagnostics;
+using Stride.Native;
 
 namespace Stride.Rendering
 {
@@ -20,10 +21,19 @@ namespace Stride.Rendering
     public class VisibilityGroup : IDisposable
     {
         private readonly List<RenderObject> renderObjectsWithoutFeatures = new List<RenderObject>();
-        private readonly ThreadLocal<ConcurrentCollectorCache<RenderObject>> collectorCache = new ThreadLocal<ConcurrentCollectorCache<RenderObject>>(() => new ConcurrentCollectorCache<RenderObject>(32));
+        private readonly ThreadLocal<CollectState> collectState = new ThreadLocal<CollectState>(() => new CollectState());
 
         private static readonly ProfilingKey TryCollectKey = new ProfilingKey("VisibilityGroup.Collect");
 
+        /// <summary>
+        /// Groups with at least this many objects are frustum culled on several threads
+        /// </summary>
+        private const int ParallelCullingThreshold = 1024;
+
+        // Bounding boxes of RenderObjects as SoA center/extent arrays, and their frustum visibility, one bit per object
+        private float[] cullingBoxes = Array.Empty<float>();
+        private byte[] frustumVisibility = Array.Empty<byte>();
+
         private int stageMaskMultiplier;
 
         // TODO GRAPHICS REFACTOR not thread-safe
@@ -123,16 +133,21 @@ namespace Stride.Rendering
             // TODO GRAPHICS REFACTOR frustum culling is currently hardcoded (cf previous TODO, we should make this more modular and move it out of here)
             var frustum = new BoundingFrustum(ref view.ViewProjection);
             var cullingMode = DisableCulling ? CameraCullingMode.None : view.CullingMode;
+            var occlusionBuffer = cullingMode == CameraCullingMode.Frustum ? view.OcclusionBuffer : null;
 
             // TODO GRAPHICS REFACTOR we currently forward SceneCameraRenderer.CullingMask
             // Note sure this is really a good mechanism long term (it forces to recreate multiple time the same view, instead of using RenderStage + selectors or a similar mechanism)
             // This is still supported so that existing gizmo code kept working with new graphics refactor. Might be reconsidered at some point.
             var cullingMask = view.CullingMask;
 
+            // Test all the bounding boxes against the frustum at once
+            if (cullingMode == CameraCullingMode.Frustum)
+                CullFrustum(ref frustum, view.VisiblityIgnoreDepthPlanes);
+
             // Process objects
             //foreach (var renderObject in RenderObjects)
             //Dispatcher.ForEach(RenderObjects, renderObject =>
-            Dispatcher.For(0, RenderObjects.Count, () => collectorCache.Value, (index, cache) =>
+            Dispatcher.For(0, RenderObjects.Count, () => collectState.Value, (index, state) =>
             {
                 var renderObject = RenderObjects[index];
 
@@ -171,25 +186,52 @@ namespace Stride.Rendering
                 // Compute transformed AABB (by world)
                 if (cullingMode == CameraCullingMode.Frustum
                     && renderObject.BoundingBox.Extent != Vector3.Zero
-                    && !FrustumContainsBox(ref frustum, ref renderObject.BoundingBox, view.VisiblityIgnoreDepthPlanes))
+                    && (frustumVisibility[index >> 3] & (1 << (index & 7))) == 0)
                 {
                     return;
                 }
 
-                // Add object to list of visible objects
-                // TODO GRAPHICS REFACTOR we should be able to push multiple elements with future VisibilityObject
-                view.RenderObjects.Add(renderObject, cache);
+                // Objects that can be hidden behind occluders are tested together at the end of the batch
+                if (occlusionBuffer != null && renderObject.BoundingBox.Extent != Vector3.Zero)
+                {
+                    state.AddOcclusionCandidate(renderObject);
+                    return;
+                }
 
-                // Calculate bounding box of all render objects in the view
-                if (renderObject.BoundingBox.Extent != Vector3.Zero)
+                AddVisibleObject(view, renderObject, state.Cache, ref plane);
+            }, state =>
+            {
+                if (state.OcclusionCandidateCount > 0)
                 {
-                    CalculateMinMaxDistance(ref plane, ref renderObject.BoundingBox, ref view.MinimumDistance, ref view.MaximumDistance);
+                    // Skip objects hidden behind occluders
+                    occlusionBuffer.TestBoxes(state.OcclusionBoxes.AsSpan(0, state.OcclusionCandidateCount), state.OcclusionVisibility);
+                    for (int i = 0; i < state.OcclusionCandidateCount; i++)
+                    {
+                        if (state.OcclusionVisibility[i] != 0)
+                            AddVisibleObject(view, state.OcclusionCandidates[i], state.Cache, ref plane);
+                    }
+                    state.ClearOcclusionCandidates();
                 }
-            }, cache => cache.Flush());
+
+                state.Cache.Flush();
+            });
 
             view.RenderObjects.Close();
         }
 
+        private static void AddVisibleObject(RenderView view, RenderObject renderObject, ConcurrentCollectorCache<RenderObject> cache, ref Plane plane)
+        {
+            // Add object to list of visible objects
+            // TODO GRAPHICS REFACTOR we should be able to push multiple elements with future VisibilityObject
+            view.RenderObjects.Add(renderObject, cache);
+
+            // Calculate bounding box of all render objects in the view
+            if (renderObject.BoundingBox.Extent != Vector3.Zero)
+            {
+                CalculateMinMaxDistance(ref plane, ref renderObject.BoundingBox, ref view.MinimumDistance, ref view.MaximumDistance);
+            }
+        }
+
         public void Copy(RenderView source, RenderView target)
         {
             // Mark view as collected
@@ -205,6 +247,70 @@ namespace Stride.Rendering
             target.RenderObjects.Close();
         }
 
+        /// <summary>
+        /// Sets the bits of <see cref="frustumVisibility"/> for the objects whose bounding box is at least partially inside the frustum.
+        /// </summary>
+        /// <remarks>
+        /// Same test as <see cref="FrustumContainsBox"/>, done by the native kernel 8 boxes at a time.
+        /// </remarks>
+        private unsafe void CullFrustum(ref BoundingFrustum frustum, bool ignoreDepthPlanes)
+        {
+            var count = RenderObjects.Count;
+            var blockCount = (count + 7) / 8;
+            if (frustumVisibility.Length < blockCount)
+            {
+                // Padded to whole blocks of 8 boxes
+                cullingBoxes = new float[6 * blockCount * 8];
+                frustumVisibility = new byte[blockCount];
+            }
+
+            fixed (Plane* planes = &frustum.LeftPlane)
+            fixed (float* boxes = cullingBoxes)
+            fixed (byte* visibility = frustumVisibility)
+            {
+                var job = new FrustumCullingJob
+                {
+                    RenderObjects = RenderObjects,
+                    Planes = planes,
+                    PlaneCount = ignoreDepthPlanes ? 4 : 6,
+                    Boxes = boxes,
+                    Capacity = 8 * frustumVisibility.Length,
+                    Visibility = visibility,
+                };
+
+                // Batches are made of whole blocks, so that they never write the same visibility byte
+                if (count >= ParallelCullingThreshold)
+                    Dispatcher.ForBatched(blockCount, job, &FrustumCullingBatch);
+                else if (count > 0)
+                    FrustumCullingBatch(job, 0, blockCount);
+            }
+        }
+
+        private static unsafe void FrustumCullingBatch(FrustumCullingJob job, int startBlock, int endBlock)
+        {
+            var start = startBlock * 8;
+            var end = Math.Min(endBlock * 8, job.RenderObjects.Count);
+
+            var centerX = job.Boxes;
+            var centerY = centerX + job.Capacity;
+            var centerZ = centerY + job.Capacity;
+            var extentX = centerZ + job.Capacity;
+            var extentY = extentX + job.Capacity;
+            var extentZ = extentY + job.Capacity;
+            for (int i = start; i < end; i++)
+            {
+                ref var boundingBox = ref job.RenderObjects[i].BoundingBox;
+                centerX[i] = boundingBox.Center.X;
+                centerY[i] = boundingBox.Center.Y;
+                centerZ[i] = boundingBox.Center.Z;
+                extentX[i] = boundingBox.Extent.X;
+                extentY[i] = boundingBox.Extent.Y;
+                extentZ[i] = boundingBox.Extent.Z;
+            }
+
+            NativeInvoke.FrustumCullBoxes(job.Planes, job.PlaneCount, centerX, centerY, centerZ, extentX, extentY, extentZ, job.Visibility, start, end);
+        }
+
         public static bool FrustumContainsBox(ref BoundingFrustum frustum, ref BoundingBoxExt boundingBoxExt, bool ignoreDepthPlanes)
         {
             unsafe
@@ -410,5 +516,51 @@ namespace Stride.Rendering
                     break;
             }
         }
+
+        private unsafe struct FrustumCullingJob
+        {
+            public RenderObjectCollection RenderObjects;
+            public Plane* Planes;
+            public int PlaneCount;
+            // Center X/Y/Z then extent X/Y/Z arrays of Capacity floats each
+            public float* Boxes;
+            public int Capacity;
+            public byte* Visibility;
+        }
+
+        /// <summary>
+        /// Per thread state of <see cref="TryCollect"/>: the visible objects waiting to be flushed, and the objects of the current batch
+        /// waiting for a single <see cref="OcclusionBuffer.TestBoxes"/> call.
+        /// </summary>
+        private sealed class CollectState
+        {
+            public readonly ConcurrentCollectorCache<RenderObject> Cache = new ConcurrentCollectorCache<RenderObject>(32);
+
+            public RenderObject[] OcclusionCandidates = new RenderObject[32];
+            public BoundingBox[] OcclusionBoxes = new BoundingBox[32];
+            public byte[] OcclusionVisibility = new byte[32];
+            public int OcclusionCandidateCount;
+
+            public void AddOcclusionCandidate(RenderObject renderObject)
+            {
+                if (OcclusionCandidateCount == OcclusionCandidates.Length)
+                {
+                    var capacity = OcclusionCandidateCount * 2;
+                    Array.Resize(ref OcclusionCandidates, capacity);
+                    Array.Resize(ref OcclusionBoxes, capacity);
+                    Array.Resize(ref OcclusionVisibility, capacity);
+                }
+
+                OcclusionCandidates[OcclusionCandidateCount] = renderObject;
+                OcclusionBoxes[OcclusionCandidateCount] = (BoundingBox)renderObject.BoundingBox;
+                OcclusionCandidateCount++;
+            }
+
+            public void ClearOcclusionCandidates()
+            {
+                Array.Clear(OcclusionCandidates, 0, OcclusionCandidateCount);
+                OcclusionCandidateCount = 0;
+            }
+        }
     }
 }